@@ -22,8 +22,14 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "thread_pool.h"
 #include <CL/cl.h>
 #include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include <emmintrin.h>
+#include <atomic>
+#include <functional>
 
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK color_convert_input_validator(vx_node node, vx_uint32 index)
@@ -37,7 +43,7 @@ static vx_status VX_CALLBACK color_convert_input_validator(vx_node node, vx_uint
 	{ // image of format UYVY or Y210 or Y216
 		vx_df_image format = VX_DF_IMAGE_VIRT;
 		ERROR_CHECK_STATUS(vxQueryImage((vx_image)ref, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format)));
-		if (format == VX_DF_IMAGE_UYVY || format == VX_DF_IMAGE_YUYV || format == VX_DF_IMAGE_Y210_AMD || format == VX_DF_IMAGE_Y216_AMD || format == VX_DF_IMAGE_RGB) {
+		if (format == VX_DF_IMAGE_UYVY || format == VX_DF_IMAGE_YUYV || format == VX_DF_IMAGE_Y210_AMD || format == VX_DF_IMAGE_Y212_AMD || format == VX_DF_IMAGE_Y216_AMD || format == VX_DF_IMAGE_RGB) {
 			status = VX_SUCCESS;
 		}
 		else {
@@ -79,7 +85,7 @@ static vx_status VX_CALLBACK color_convert_output_validator(vx_node node, vx_uin
 			output_width = input_width;
 			output_height = input_height;
 		}
-		if ((input_format == VX_DF_IMAGE_UYVY || input_format == VX_DF_IMAGE_YUYV || input_format == VX_DF_IMAGE_Y210_AMD || input_format == VX_DF_IMAGE_Y216_AMD) && output_format != VX_DF_IMAGE_RGB && output_format != VX_DF_IMAGE_RGBX) {
+		if ((input_format == VX_DF_IMAGE_UYVY || input_format == VX_DF_IMAGE_YUYV || input_format == VX_DF_IMAGE_Y210_AMD || input_format == VX_DF_IMAGE_Y212_AMD || input_format == VX_DF_IMAGE_Y216_AMD) && output_format != VX_DF_IMAGE_RGB && output_format != VX_DF_IMAGE_RGBX) {
 			// pick RGBX as default
 			output_format = VX_DF_IMAGE_RGBX;
 		}
@@ -102,7 +108,7 @@ static vx_status VX_CALLBACK color_convert_query_target_support(vx_graph graph,
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -323,7 +329,7 @@ static vx_status VX_CALLBACK color_convert_opencl_codegen(
 			}
 		}
 	}
-	else if (input_format == VX_DF_IMAGE_Y210_AMD || input_format == VX_DF_IMAGE_Y216_AMD)
+	else if (input_format == VX_DF_IMAGE_Y210_AMD || input_format == VX_DF_IMAGE_Y212_AMD || input_format == VX_DF_IMAGE_Y216_AMD)
 	{
 		if (input_format == VX_DF_IMAGE_Y210_AMD) {
 			opencl_kernel_code +=
@@ -331,6 +337,12 @@ static vx_status VX_CALLBACK color_convert_opencl_codegen(
 				"    float2 cG = (float2)(-0.18785088f, -0.46947676f);\n"
 				"    float2 cB = (float2)( 1.86105765f,  0.00000000f);\n";
 		}
+		else if (input_format == VX_DF_IMAGE_Y212_AMD) {
+			opencl_kernel_code +=
+				"    float2 cR = (float2)( 0.00000000f,  1.58059007f);\n"
+				"    float2 cG = (float2)(-0.18798772f, -0.46982118f);\n"
+				"    float2 cB = (float2)( 1.86242206f,  0.00000000f);\n";
+		}
 		else {
 			opencl_kernel_code +=
 				"    float2 cR = (float2)( 0.00000000f,  1.5809516f);\n"
@@ -583,10 +595,289 @@ static vx_status VX_CALLBACK color_convert_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief The YUV to RGB conversion coefficients of the CPU path: sample scale/offset and matrix.
+typedef struct {
+	float ys, yo;        // luma = Y * ys + yo
+	float cs, co;        // chroma = C * cs + co
+	float rv, gu, gv, bu; // R = y + rv*v; G = y + gu*u + gv*v; B = y + bu*u
+} ColorConvertYUVCoeff;
+
+//! \brief Get the same conversion coefficients as the OpenCL code for a YUV 4:2:2 input format.
+static void color_convert_get_yuv_coeff(vx_df_image format, vx_color_space_e color_space, vx_channel_range_e channel_range, ColorConvertYUVCoeff& c)
+{
+	if (format == VX_DF_IMAGE_UYVY || format == VX_DF_IMAGE_YUYV) {
+		if (color_space == VX_COLOR_SPACE_BT601_525 || color_space == VX_COLOR_SPACE_BT601_625) {
+			c.rv = 1.4030f; c.gu = -0.3440f; c.gv = -0.7140f; c.bu = 1.7730f;
+		}
+		else { // VX_COLOR_SPACE_BT709
+			c.rv = 1.5748f; c.gu = -0.1873f; c.gv = -0.4681f; c.bu = 1.8556f;
+		}
+		if (channel_range == VX_CHANNEL_RANGE_RESTRICTED) {
+			c.ys = 256.0f / 219.0f; c.yo = -16.0f * 256.0f / 219.0f; c.cs = 256.0f / 224.0f; c.co = -128.0f * 256.0f / 224.0f;
+		}
+		else { // VX_CHANNEL_RANGE_FULL
+			c.ys = 1.0f; c.yo = 0.0f; c.cs = 1.0f; c.co = -128.0f;
+		}
+	}
+	else { // 16-bit containers, BT709: samples are scaled to 8-bit range
+		if (format == VX_DF_IMAGE_Y210_AMD) {
+			c.rv = 1.57943176f; c.gu = -0.18785088f; c.gv = -0.46947676f; c.bu = 1.86105765f;
+		}
+		else if (format == VX_DF_IMAGE_Y212_AMD) {
+			c.rv = 1.58059007f; c.gu = -0.18798772f; c.gv = -0.46982118f; c.bu = 1.86242206f;
+		}
+		else {
+			c.rv = 1.5809516f; c.gu = -0.18803164f; c.gv = -0.46992852f; c.bu = 1.86284844f;
+		}
+		c.ys = 1.0f / 256.0f; c.yo = 0.0f; c.cs = 1.0f / 256.0f; c.co = -128.0f;
+	}
+}
+
+//! \brief Convert 4 macro-pixels (u, y0, v, y1 in 32-bit lanes) into 8 RGBX pixels (X holds luma).
+static inline void color_convert_yuv_to_rgbx_x8(const ColorConvertYUVCoeff& c, __m128i iu, __m128i iy0, __m128i iv, __m128i iy1, __m128i& pix0123, __m128i& pix4567)
+{
+	__m128 u = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(iu), _mm_set1_ps(c.cs)), _mm_set1_ps(c.co));
+	__m128 v = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(iv), _mm_set1_ps(c.cs)), _mm_set1_ps(c.co));
+	__m128 y0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(iy0), _mm_set1_ps(c.ys)), _mm_set1_ps(c.yo));
+	__m128 y1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(iy1), _mm_set1_ps(c.ys)), _mm_set1_ps(c.yo));
+	__m128 dr = _mm_mul_ps(v, _mm_set1_ps(c.rv));
+	__m128 dg = _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(c.gu)), _mm_mul_ps(v, _mm_set1_ps(c.gv)));
+	__m128 db = _mm_mul_ps(u, _mm_set1_ps(c.bu));
+	__m128i pix[2];
+	for (int k = 0; k < 2; k++) {
+		__m128 y = k ? y1 : y0;
+		__m128i r = _mm_cvtps_epi32(_mm_add_ps(y, dr)), g = _mm_cvtps_epi32(_mm_add_ps(y, dg));
+		__m128i b = _mm_cvtps_epi32(_mm_add_ps(y, db)), x = _mm_cvtps_epi32(y);
+		// saturate into [R0..3 B0..3 G0..3 X0..3] and transpose into R,G,B,X per pixel
+		__m128i t = _mm_packus_epi16(_mm_packs_epi32(r, b), _mm_packs_epi32(g, x));
+		t = _mm_unpacklo_epi8(t, _mm_srli_si128(t, 8));
+		pix[k] = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8));
+	}
+	// interleave even and odd pixels
+	pix0123 = _mm_unpacklo_epi32(pix[0], pix[1]);
+	pix4567 = _mm_unpackhi_epi32(pix[0], pix[1]);
+}
+
+//! \brief Load one macro-pixel of a YUV 4:2:2 row as u, y0, v, y1 sample values.
+static inline void color_convert_load_macro_pixel(vx_df_image format, const vx_uint8 * src, vx_uint32 m, vx_int32 yuv[4])
+{
+	if (format == VX_DF_IMAGE_UYVY) {
+		yuv[0] = src[m * 4 + 0]; yuv[1] = src[m * 4 + 1]; yuv[2] = src[m * 4 + 2]; yuv[3] = src[m * 4 + 3];
+	}
+	else if (format == VX_DF_IMAGE_YUYV) {
+		yuv[0] = src[m * 4 + 1]; yuv[1] = src[m * 4 + 0]; yuv[2] = src[m * 4 + 3]; yuv[3] = src[m * 4 + 2];
+	}
+	else {
+		const vx_uint16 * s16 = (const vx_uint16 *)src + m * 4;
+		yuv[0] = s16[0]; yuv[1] = s16[1]; yuv[2] = s16[2]; yuv[3] = s16[3];
+	}
+}
+
+//! \brief Convert one YUV 4:2:2 row into RGBX pixels.
+static void color_convert_yuv_row_to_rgbx(vx_df_image format, const ColorConvertYUVCoeff& c, const vx_uint8 * src, vx_uint32 * dst, vx_uint32 width)
+{
+	const __m128i mask8 = _mm_set1_epi32(0xff), mask16 = _mm_set1_epi32(0xffff);
+	vx_uint32 x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i u, y0, v, y1;
+		if (format == VX_DF_IMAGE_UYVY || format == VX_DF_IMAGE_YUYV) {
+			__m128i L = _mm_loadu_si128((const __m128i *)(src + x * 2));
+			__m128i b0 = _mm_and_si128(L, mask8), b1 = _mm_and_si128(_mm_srli_epi32(L, 8), mask8);
+			__m128i b2 = _mm_and_si128(_mm_srli_epi32(L, 16), mask8), b3 = _mm_srli_epi32(L, 24);
+			if (format == VX_DF_IMAGE_UYVY) { u = b0; y0 = b1; v = b2; y1 = b3; }
+			else { y0 = b0; u = b1; y1 = b2; v = b3; }
+		}
+		else {
+			// two macro-pixels per 16 bytes: [U Y0 V Y1] with 16-bit samples
+			__m128i L0 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(src + x * 4)), _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i L1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(src + x * 4 + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i uy = _mm_unpacklo_epi64(L0, L1), vy = _mm_unpackhi_epi64(L0, L1);
+			u = _mm_and_si128(uy, mask16); y0 = _mm_srli_epi32(uy, 16);
+			v = _mm_and_si128(vy, mask16); y1 = _mm_srli_epi32(vy, 16);
+		}
+		__m128i p0, p1;
+		color_convert_yuv_to_rgbx_x8(c, u, y0, v, y1, p0, p1);
+		_mm_storeu_si128((__m128i *)(dst + x), p0);
+		_mm_storeu_si128((__m128i *)(dst + x + 4), p1);
+	}
+	for (; x + 2 <= width; x += 2) {
+		vx_int32 yuv[4];
+		color_convert_load_macro_pixel(format, src, x >> 1, yuv);
+		__m128i p0, p1;
+		color_convert_yuv_to_rgbx_x8(c, _mm_set1_epi32(yuv[0]), _mm_set1_epi32(yuv[1]), _mm_set1_epi32(yuv[2]), _mm_set1_epi32(yuv[3]), p0, p1);
+		_mm_storel_epi64((__m128i *)(dst + x), p0);
+	}
+}
+
+//! \brief Average 2x2 blocks of two RGBX rows into one RGBX row of half width.
+static void color_convert_rgbx_downscale_row(const vx_uint32 * row0, const vx_uint32 * row1, vx_uint32 * dst, vx_uint32 dst_width)
+{
+	const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi16(2);
+	vx_uint32 x = 0;
+	for (; x + 2 <= dst_width; x += 2) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(row0 + x * 2)), b = _mm_loadu_si128((const __m128i *)(row1 + x * 2));
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+		hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+		__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+		_mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(sum, sum));
+	}
+	for (; x < dst_width; x++) {
+		const vx_uint8 * p0 = (const vx_uint8 *)(row0 + x * 2), *p1 = (const vx_uint8 *)(row1 + x * 2);
+		vx_uint8 * d = (vx_uint8 *)(dst + x);
+		for (int i = 0; i < 4; i++)
+			d[i] = (vx_uint8)((p0[i] + p0[i + 4] + p1[i] + p1[i + 4] + 2) >> 2);
+	}
+}
+
+//! \brief Store a row of RGBX pixels into an RGBX or RGB output row.
+static inline void color_convert_store_rgbx_row(vx_df_image format, const vx_uint32 * src, vx_uint8 * dst, vx_uint32 width)
+{
+	if (format == VX_DF_IMAGE_RGBX) {
+		memcpy(dst, src, width * 4);
+	}
+	else {
+		for (vx_uint32 x = 0; x < width; x++, dst += 3) {
+			vx_uint32 p = src[x];
+			dst[0] = (vx_uint8)p; dst[1] = (vx_uint8)(p >> 8); dst[2] = (vx_uint8)(p >> 16);
+		}
+	}
+}
+
+//! \brief Convert one RGB row into UYVY or YUYV (BT709, chroma taken at even pixel locations like the OpenCL code).
+static void color_convert_rgb_row_to_422(vx_df_image format, const vx_uint8 * src, vx_uint8 * dst, vx_uint32 width)
+{
+	const __m128 cY0 = _mm_set1_ps(0.2126f), cY1 = _mm_set1_ps(0.7152f), cY2 = _mm_set1_ps(0.0722f);
+	const __m128 cU0 = _mm_set1_ps(-0.1146f), cU1 = _mm_set1_ps(-0.3854f), cU2 = _mm_set1_ps(0.5f);
+	const __m128 cV0 = _mm_set1_ps(0.5f), cV1 = _mm_set1_ps(-0.4542f), cV2 = _mm_set1_ps(-0.0458f);
+	const __m128 c128 = _mm_set1_ps(128.0f);
+	for (vx_uint32 x = 0; x + 2 <= width; x += 8) {
+		vx_uint32 n = std::min(4u, (width - x) >> 1);
+		float e[3][4] = { { 0 } }, o[3][4] = { { 0 } };
+		for (vx_uint32 m = 0; m < n; m++) {
+			const vx_uint8 * p = src + (x + m * 2) * 3;
+			e[0][m] = p[0]; e[1][m] = p[1]; e[2][m] = p[2];
+			o[0][m] = p[3]; o[1][m] = p[4]; o[2][m] = p[5];
+		}
+		__m128 er = _mm_loadu_ps(e[0]), eg = _mm_loadu_ps(e[1]), eb = _mm_loadu_ps(e[2]);
+		__m128 or_ = _mm_loadu_ps(o[0]), og = _mm_loadu_ps(o[1]), ob = _mm_loadu_ps(o[2]);
+		__m128i y0 = _mm_cvtps_epi32(_mm_add_ps(_mm_add_ps(_mm_mul_ps(er, cY0), _mm_mul_ps(eg, cY1)), _mm_mul_ps(eb, cY2)));
+		__m128i y1 = _mm_cvtps_epi32(_mm_add_ps(_mm_add_ps(_mm_mul_ps(or_, cY0), _mm_mul_ps(og, cY1)), _mm_mul_ps(ob, cY2)));
+		__m128i u = _mm_cvtps_epi32(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(er, cU0), _mm_mul_ps(eg, cU1)), _mm_mul_ps(eb, cU2)), c128));
+		__m128i v = _mm_cvtps_epi32(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(er, cV0), _mm_mul_ps(eg, cV1)), _mm_mul_ps(eb, cV2)), c128));
+		// saturate into [A0..3 B0..3 C0..3 D0..3] and transpose into A,C,B,D per macro-pixel
+		__m128i t = (format == VX_DF_IMAGE_UYVY) ?
+			_mm_packus_epi16(_mm_packs_epi32(u, v), _mm_packs_epi32(y0, y1)) :
+			_mm_packus_epi16(_mm_packs_epi32(y0, y1), _mm_packs_epi32(u, v));
+		t = _mm_unpacklo_epi8(t, _mm_srli_si128(t, 8));
+		t = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8));
+		if (n == 4) _mm_storeu_si128((__m128i *)(dst + x * 2), t);
+		else {
+			vx_uint32 tmp[4];
+			_mm_storeu_si128((__m128i *)tmp, t);
+			memcpy(dst + x * 2, tmp, n * 4);
+		}
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK color_convert_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_SUPPORTED;
+	vx_image input_image = (vx_image)parameters[0];
+	vx_image output_image = (vx_image)parameters[1];
+	vx_uint32 input_width = 0, input_height = 0, output_width = 0, output_height = 0;
+	vx_df_image input_format = VX_DF_IMAGE_VIRT, output_format = VX_DF_IMAGE_VIRT;
+	vx_channel_range_e input_channel_range = VX_CHANNEL_RANGE_FULL;
+	vx_color_space_e input_color_space = VX_COLOR_SPACE_BT709;
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_WIDTH, &input_width, sizeof(input_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &input_height, sizeof(input_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_FORMAT, &input_format, sizeof(input_format)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_RANGE, &input_channel_range, sizeof(input_channel_range)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_SPACE, &input_color_space, sizeof(input_color_space)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &output_width, sizeof(output_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &output_height, sizeof(output_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_FORMAT, &output_format, sizeof(output_format)));
+	bool downscale = (output_width != input_width || output_height != input_height);
+
+	vx_rectangle_t ip_rect = { 0, 0, input_width, input_height };
+	vx_rectangle_t op_rect = { 0, 0, output_width, output_height };
+	vx_imagepatch_addressing_t ip_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &ip_rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &op_rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+	vx_int32 ip_stride = ip_addr.stride_y, op_stride = op_addr.stride_y;
+
+	// each iteration converts a pair of input rows: the unpack, color matrix and optional 2x2 reduction are done in one pass
+	// the row pairs are pulled from an atomic counter by a pool of threads, each with its own row buffers
+	int row_pairs = (int)((input_height + 1) / 2);
+	std::atomic<int> next_pair(0);
+	std::function<void()> pair_thread_func;
+	ColorConvertYUVCoeff coeff;
+	if (input_format != VX_DF_IMAGE_RGB)
+	{ // YUV 4:2:2 to RGB/RGBX
+		color_convert_get_yuv_coeff(input_format, input_color_space, input_channel_range, coeff);
+		pair_thread_func = [&]() {
+			std::vector<vx_uint32> rgbx(input_width * 2 + 8);
+			for (int gy = next_pair++; gy < row_pairs; gy = next_pair++) {
+				vx_uint32 * rgbx0 = &rgbx[0], *rgbx1 = &rgbx[input_width];
+				if (!downscale && output_format == VX_DF_IMAGE_RGBX) {
+					// convert straight into the output rows
+					for (vx_uint32 r = 0; r < 2 && (vx_uint32)gy * 2 + r < output_height; r++)
+						color_convert_yuv_row_to_rgbx(input_format, coeff, ip_buf + (gy * 2 + r) * ip_stride, (vx_uint32 *)(op_buf + (gy * 2 + r) * op_stride), input_width);
+					continue;
+				}
+				for (vx_uint32 r = 0; r < 2; r++) {
+					vx_uint32 y = std::min((vx_uint32)gy * 2 + r, input_height - 1);
+					color_convert_yuv_row_to_rgbx(input_format, coeff, ip_buf + y * ip_stride, r ? rgbx1 : rgbx0, input_width);
+				}
+				if (downscale) {
+					// the 2x2 reduction is done in place: each output pixel only overwrites already consumed pixels
+					if ((vx_uint32)gy < output_height) {
+						color_convert_rgbx_downscale_row(rgbx0, rgbx1, rgbx0, output_width);
+						color_convert_store_rgbx_row(output_format, rgbx0, op_buf + gy * op_stride, output_width);
+					}
+				}
+				else {
+					for (vx_uint32 r = 0; r < 2 && (vx_uint32)gy * 2 + r < output_height; r++)
+						color_convert_store_rgbx_row(output_format, r ? rgbx1 : rgbx0, op_buf + (gy * 2 + r) * op_stride, output_width);
+				}
+			}
+		};
+	}
+	else
+	{ // RGB to UYVY/YUYV
+		pair_thread_func = [&]() {
+			std::vector<vx_uint8> yuv(input_width * 4 + 16);
+			for (int gy = next_pair++; gy < row_pairs; gy = next_pair++) {
+				if (!downscale) {
+					for (vx_uint32 r = 0; r < 2 && (vx_uint32)gy * 2 + r < output_height; r++)
+						color_convert_rgb_row_to_422(output_format, ip_buf + (gy * 2 + r) * ip_stride, op_buf + (gy * 2 + r) * op_stride, input_width);
+				}
+				else if ((vx_uint32)gy < output_height) {
+					// average two macro-pixels from each of the two rows into one output macro-pixel
+					vx_uint8 * yuv0 = &yuv[0], *yuv1 = &yuv[input_width * 2 + 8];
+					color_convert_rgb_row_to_422(output_format, ip_buf + (gy * 2) * ip_stride, yuv0, input_width);
+					color_convert_rgb_row_to_422(output_format, ip_buf + std::min((vx_uint32)gy * 2 + 1, input_height - 1) * ip_stride, yuv1, input_width);
+					vx_uint32 ci = (output_format == VX_DF_IMAGE_UYVY) ? 0 : 1, yi = 1 - ci;
+					vx_uint8 * dst = op_buf + gy * op_stride;
+					for (vx_uint32 m = 0; m < output_width / 2; m++) {
+						const vx_uint8 * a = yuv0 + m * 8, *b = yuv1 + m * 8;
+						dst[m * 4 + ci + 0] = (vx_uint8)((a[ci + 0] + a[ci + 4] + b[ci + 0] + b[ci + 4] + 2) >> 2);
+						dst[m * 4 + ci + 2] = (vx_uint8)((a[ci + 2] + a[ci + 6] + b[ci + 2] + b[ci + 6] + 2) >> 2);
+						dst[m * 4 + yi + 0] = (vx_uint8)((a[yi + 0] + a[yi + 2] + b[yi + 0] + b[yi + 2] + 2) >> 2);
+						dst[m * 4 + yi + 2] = (vx_uint8)((a[yi + 4] + a[yi + 6] + b[yi + 4] + b[yi + 6] + 2) >> 2);
+					}
+				}
+			}
+		};
+	}
+	stitch_thread_pool_run(node, (int)row_pairs, pair_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &op_rect, 0, &op_addr, op_buf));
+
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel publisher.
@@ -599,8 +890,8 @@ vx_status color_convert_publish(vx_context context)
 		2,
 		color_convert_input_validator,
 		color_convert_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = color_convert_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = color_convert_opencl_codegen;
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "exp_comp.h"
 #include <algorithm>
 #include <thread>
+#include <emmintrin.h>
 
 /////////////////////////////////////////////////////////////////////////////////////
 //! \brief Exposure compensation C reference model. Not used in active stitching lib.
@@ -280,6 +281,43 @@ static vx_status VX_CALLBACK exposure_compensation_input_validator(vx_node node,
 			status = VX_SUCCESS;
 		}
 	}
+	else if (index == 5)
+	{ // scalar of type VX_TYPE_UINT32: 0 - gain per image, 1 - gains per block
+		vx_enum type = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &type, sizeof(type)));
+		ERROR_CHECK_STATUS(vxReleaseScalar((vx_scalar *)&ref));
+		if (type == VX_TYPE_UINT32) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation mode scalar type should be an uint32\n");
+		}
+	}
+	else if (index == 6)
+	{ // array of format float32: R, G, B gain factors of each image
+		vx_array arr = (vx_array)avxGetNodeParamRef(node, 2);
+		ERROR_CHECK_OBJECT(arr);
+		vx_size numCameras = 0;
+		ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &numCameras, sizeof(numCameras)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&arr));
+		vx_enum itemtype = VX_TYPE_INVALID;
+		vx_size capacity = 0;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+		if (itemtype != VX_TYPE_FLOAT32) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation channel gains array type should be float32\n");
+		}
+		else if (capacity < numCameras * 3) {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation channel gains array capacity should be at least 3 x %d\n", (vx_uint32)numCameras);
+		}
+		else {
+			status = VX_SUCCESS;
+		}
+	}
 	return status;
 }
 
@@ -324,6 +362,13 @@ static vx_status VX_CALLBACK exposure_compensation_initialize(vx_node node, cons
 	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
 	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &exp_comp, sizeof(exp_comp)))
 		ERROR_CHECK_STATUS(exp_comp->Initialize(node, alpha, beta, arr, img_in, img_out));
+	vx_uint32 mode = 0;
+	if (num > 5 && parameters[5]) {
+		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[5], &mode));
+	}
+	if (mode == 1) {
+		ERROR_CHECK_STATUS(exp_comp->EnableBlockGains());
+	}
 	return VX_SUCCESS;
 }
 
@@ -354,6 +399,22 @@ static vx_status VX_CALLBACK exposure_compensation_kernel(vx_node node, const vx
 		CExpCompensator * exp_comp = nullptr;
 		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &exp_comp, sizeof(exp_comp)));
 		if (exp_comp){
+			vx_array arr = (num > 6) ? (vx_array)parameters[6] : nullptr;
+			if (arr) {
+				// optional R, G, B gain factors of each image, read every frame so that they can be changed while running
+				vx_size num_items = 0;
+				ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+				if (num_items >= 3) {
+					vx_float32 * pGains = nullptr; vx_size stride = sizeof(vx_float32);
+					ERROR_CHECK_STATUS(vxAccessArrayRange(arr, 0, num_items, &stride, (void **)&pGains, VX_READ_ONLY));
+					vx_uint32 num_images = (vx_uint32)std::min(num_items / 3, (vx_size)MAX_NUM_IMAGES_IN_STITCHED_OUTPUT);
+					for (vx_uint32 i = 0; i < num_images; i++) {
+						ERROR_CHECK_STATUS(exp_comp->SetChannelGains(i, vxArrayItem(vx_float32, pGains, i * 3 + 0, stride),
+							vxArrayItem(vx_float32, pGains, i * 3 + 1, stride), vxArrayItem(vx_float32, pGains, i * 3 + 2, stride)));
+					}
+					ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, num_items, pGains));
+				}
+			}
 			status = exp_comp->Process();
 		}
 		//	delete exp_comp;
@@ -368,7 +429,7 @@ vx_status exposure_compensation_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.exposure_compensation_model",
 		AMDOVX_KERNEL_STITCHING_EXPOSURE_COMPENSATION_MODEL,
 		exposure_compensation_kernel,
-		5,
+		7,
 		exposure_compensation_input_validator,
 		exposure_compensation_output_validator,
 		exposure_compensation_initialize,
@@ -381,6 +442,8 @@ vx_status exposure_compensation_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
 	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
@@ -393,13 +456,31 @@ CExpCompensator::CExpCompensator()
 	m_pblockgainInfo = nullptr;
 	m_NMat = nullptr;
 	m_IMat = nullptr;
-	m_AMat = nullptr;
+	m_maxImages = 0;
+	m_LDLMat = nullptr;
+	m_LDLRhs = nullptr;
 	m_Gains = nullptr;
+	m_GainsValid = false;
+	for (int i = 0; i < MAX_NUM_IMAGES_IN_STITCHED_OUTPUT; i++)
+		m_ChannelGains[i][0] = m_ChannelGains[i][1] = m_ChannelGains[i][2] = 1.0f;
+	m_workers = nullptr;
+	m_numWorkers = 0;
+	m_workerGeneration = 0;
+	m_workerPending = 0;
+	m_workerStatus = VX_SUCCESS;
+	m_workerExit = false;
+	m_workerInBase = nullptr;
+	m_blockMode = false;
+	m_blocksX = m_blocksY = m_blockW = m_blockH = 0;
+	m_blockI = m_blockN = m_cellI = nullptr;
+	m_blockRawGains = m_blockGains = m_blockScratch = nullptr;
+	m_blockGainsValid = false;
 }
 
 CExpCompensator::~CExpCompensator()
 {
-
+	shutdown_workers();
+	release_block_solver();
 }
 
 vx_status CExpCompensator::Initialize(vx_node node, vx_float32 alpha, vx_float32 beta, vx_array valid_roi, vx_image input, vx_image output)
@@ -409,7 +490,7 @@ vx_status CExpCompensator::Initialize(vx_node node, vx_float32 alpha, vx_float32
 	vx_enum itemtype = VX_TYPE_INVALID;
 	ERROR_CHECK_STATUS(vxQueryArray(valid_roi, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 	ERROR_CHECK_STATUS(vxQueryArray(valid_roi, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
-	if (!capacity) return VX_ERROR_INVALID_PARAMETERS;
+	if (!capacity || capacity > MAX_NUM_IMAGES_IN_STITCHED_OUTPUT) return VX_ERROR_INVALID_PARAMETERS;
 	m_numImages = (vx_uint32)capacity;		// assuming the array has one entry for each image
 	if (input != nullptr){
 		ERROR_CHECK_STATUS(vxQueryImage(input, VX_IMAGE_ATTRIBUTE_WIDTH, &m_width, sizeof(m_width)));
@@ -455,38 +536,135 @@ vx_status CExpCompensator::Initialize(vx_node node, vx_float32 alpha, vx_float32
 		m_pblockgainInfo[i].num_blocks_col = (rect_I->end_y - rect_I->start_y + 31) >> 5;
 		memcpy(&mValidRect[i], rect_I, sizeof(vx_rectangle_t));
 	}
-	// allocate N, I A and B arrays
+	ERROR_CHECK_STATUS(vxCommitArrayRange(m_valid_roi, 0, capacity, base_array));
+	// allocate N and I arrays (contiguous rows so that they can be passed to the solver as one matrix)
 	m_NMat = new vx_uint32*[m_numImages];
 	m_IMat = new vx_uint32*[m_numImages];
-	m_AMat = new vx_float64*[m_numImages];
-	m_Gains = new vx_float32[m_numImages];
-	for (i = 0; i < m_numImages; i++){
-		m_NMat[i] = new vx_uint32[m_numImages];
-		m_IMat[i] = new vx_uint32[m_numImages];
-		m_AMat[i] = new vx_float64[m_numImages + 1];	// enough for the augmented matrix [a|b]
-		memset(&m_AMat[i][0], 0, (m_numImages + 1)*sizeof(vx_float64));
+	m_NMat[0] = new vx_uint32[m_numImages*m_numImages];
+	m_IMat[0] = new vx_uint32[m_numImages*m_numImages];
+	for (i = 1; i < m_numImages; i++){
+		m_NMat[i] = m_NMat[0] + i*m_numImages;
+		m_IMat[i] = m_IMat[0] + i*m_numImages;
 	}
-	memset(&m_Gains[0], 0x00000001, m_numImages*sizeof(vx_float32));
+	ERROR_CHECK_STATUS(InitializeSolver(m_numImages));
 	m_node = node;
+	// start the ApplyGains workers once, they are reused for every frame
+	shutdown_workers();
+	m_workerExit = false;
+	m_workerGeneration = 0;
+	m_numWorkers = m_numImages - 1;
+	if (m_numWorkers > 0) {
+		m_workers = new std::thread[m_numWorkers];
+		for (i = 0; i < m_numWorkers; i++)
+			m_workers[i] = std::thread(&CExpCompensator::applygains_worker, this, (vx_int32)i);
+	}
 	return VX_SUCCESS;
 
 }
 
 vx_status CExpCompensator::DeInitialize()
 {
+	shutdown_workers();
 	// free all allocated buffers
-	for (int i = 0; i < (int)m_numImages; i++)
-	{
-		if (m_pblockgainInfo[i].block_gain_buf)
-			delete[] m_pblockgainInfo[i].block_gain_buf;
-		if (m_NMat[i]) delete[] m_NMat[i];
-		if (m_IMat[i]) delete[] m_IMat[i];
-		if (m_AMat[i]) delete[] m_AMat[i];
-	}
-	delete m_pblockgainInfo;
-	delete m_NMat;
-	delete m_IMat;
-	delete m_AMat;
+	if (m_pblockgainInfo) {
+		for (int i = 0; i < (int)m_numImages; i++) {
+			if (m_pblockgainInfo[i].block_gain_buf)
+				delete[] m_pblockgainInfo[i].block_gain_buf;
+		}
+		delete[] m_pblockgainInfo;
+		m_pblockgainInfo = nullptr;
+	}
+	if (m_NMat) {
+		delete[] m_NMat[0];
+		delete[] m_NMat;
+		m_NMat = nullptr;
+	}
+	if (m_IMat) {
+		delete[] m_IMat[0];
+		delete[] m_IMat;
+		m_IMat = nullptr;
+	}
+	if (m_LDLMat) delete[] m_LDLMat;
+	if (m_LDLRhs) delete[] m_LDLRhs;
+	if (m_Gains) delete[] m_Gains;
+	m_LDLMat = nullptr;
+	m_LDLRhs = nullptr;
+	m_Gains = nullptr;
+	m_maxImages = 0;
+	m_GainsValid = false;
+	release_block_solver();
+	return VX_SUCCESS;
+}
+
+//! \brief Allocates the solver buffers once for up to max_images cameras, so that SolveForGains doesn't allocate per frame.
+vx_status CExpCompensator::InitializeSolver(vx_uint32 max_images)
+{
+	if (!max_images) return VX_ERROR_INVALID_PARAMETERS;
+	if (max_images > m_maxImages) {
+		if (m_LDLMat) delete[] m_LDLMat;
+		if (m_LDLRhs) delete[] m_LDLRhs;
+		if (m_Gains) delete[] m_Gains;
+		m_LDLMat = new vx_float64[max_images*max_images];
+		m_LDLRhs = new vx_float64[max_images];
+		m_Gains = new vx_float32[max_images];
+		m_maxImages = max_images;
+	}
+	for (vx_uint32 i = 0; i < m_maxImages; i++)
+		m_Gains[i] = 1.0f;
+	m_GainsValid = false;
+	return VX_SUCCESS;
+}
+
+//! \brief Sets R, G and B gain factors for an image, applied on top of the solved exposure gain (default 1.0).
+// The exposure_compensation_model node sets them every frame from its optional channel gains array (parameter 6).
+vx_status CExpCompensator::SetChannelGains(vx_uint32 img_num, vx_float32 r_gain, vx_float32 g_gain, vx_float32 b_gain)
+{
+	if (img_num >= MAX_NUM_IMAGES_IN_STITCHED_OUTPUT) return VX_ERROR_INVALID_PARAMETERS;
+	m_ChannelGains[img_num][0] = r_gain;
+	m_ChannelGains[img_num][1] = g_gain;
+	m_ChannelGains[img_num][2] = b_gain;
+	return VX_SUCCESS;
+}
+
+//! \brief Allocates the block gains buffers for a grid of blocks_x x blocks_y blocks of block_width x block_height pixels per image.
+vx_status CExpCompensator::InitializeBlockSolver(vx_uint32 num_images, vx_uint32 blocks_x, vx_uint32 blocks_y, vx_uint32 block_width, vx_uint32 block_height)
+{
+	if (!num_images || num_images > 32 || !blocks_x || !blocks_y || !block_width || !block_height) return VX_ERROR_INVALID_PARAMETERS;
+	ERROR_CHECK_STATUS(InitializeSolver(num_images));
+	release_block_solver();
+	vx_uint32 num_blocks = blocks_x * blocks_y;
+	m_blockI = new vx_uint32[num_blocks * num_images * num_images];
+	m_blockN = new vx_uint32[num_blocks * num_images * num_images];
+	m_cellI = new vx_uint32[num_images * num_images];
+	m_blockRawGains = new vx_float32[num_images * num_blocks];
+	m_blockGains = new vx_float32[num_images * num_blocks];
+	m_blockScratch = new vx_float32[num_blocks];
+	m_blocksX = blocks_x, m_blocksY = blocks_y;
+	m_blockW = block_width, m_blockH = block_height;
+	m_blockGainsValid = false;
+	return VX_SUCCESS;
+}
+
+void CExpCompensator::release_block_solver()
+{
+	if (m_blockI) delete[] m_blockI;
+	if (m_blockN) delete[] m_blockN;
+	if (m_cellI) delete[] m_cellI;
+	if (m_blockRawGains) delete[] m_blockRawGains;
+	if (m_blockGains) delete[] m_blockGains;
+	if (m_blockScratch) delete[] m_blockScratch;
+	m_blockI = m_blockN = m_cellI = nullptr;
+	m_blockRawGains = m_blockGains = m_blockScratch = nullptr;
+	m_blocksX = m_blocksY = 0;
+	m_blockGainsValid = false;
+}
+
+//! \brief Switches the CPU model to block gains using the 32x32 block_gain_info grid. Call after Initialize.
+vx_status CExpCompensator::EnableBlockGains()
+{
+	if (!m_pblockgainInfo) return VX_ERROR_NOT_ALLOCATED;
+	ERROR_CHECK_STATUS(InitializeBlockSolver(m_numImages, m_blockgainsStride, (m_height + 31) >> 5, 32, 32));
+	m_blockMode = true;
 	return VX_SUCCESS;
 }
 
@@ -545,19 +723,40 @@ vx_status CExpCompensator::CompensateGains()
 			}
 		}
 	}
-	// generate augmented matrix[A/b] for solving gains
-	for (int i = 0; i < (int)m_numImages; i++){
-		for (int j = 0; j < (int)m_numImages; ++j) {
-			m_AMat[i][m_numImages] += m_beta * m_NMat[i][j];		// b matrix
-			m_AMat[i][i] += m_beta * m_NMat[i][j];
-			if (j == i)			continue;
-			m_AMat[i][i] += 2 * m_alpha * m_IMat[i][j] * m_IMat[i][j] * m_NMat[i][j];
-			m_AMat[i][j] -= 2 * m_alpha * m_IMat[i][j] * m_IMat[j][i] * m_NMat[i][j];
+	//solve the linear equation A*gains_ = B (gains of the previous frame are kept if the system is degenerate)
+	build_normal_equations(m_alpha, m_beta, m_IMat[0], m_NMat[0], m_numImages, m_numImages, nullptr);
+	if (solve_ldlt(m_numImages, m_Gains, m_GainsValid))
+		m_GainsValid = true;
+	if (m_blockMode) {
+		// overlap statistics per block of the block_gain_info grid
+		vx_uint32 n = m_numImages;
+		memset(m_blockI, 0, m_blocksX * m_blocksY * n * n * sizeof(vx_uint32));
+		memset(m_blockN, 0, m_blocksX * m_blocksY * n * n * sizeof(vx_uint32));
+		for (vx_uint32 ci = 0; ci < n; ci++) {
+			for (vx_uint32 cj = ci + 1; cj < n; cj++) {
+				const vx_rectangle_t * r = &m_pRoi_rect[ci][cj];
+				if (r->start_x == (vx_uint32)-1) continue;
+				for (vx_uint32 by = r->start_y / m_blockH; by * m_blockH < r->end_y; by++) {
+					vx_uint32 y0 = std::max(r->start_y, by * m_blockH), y1 = std::min(r->end_y, (by + 1) * m_blockH);
+					for (vx_uint32 bx = r->start_x / m_blockW; bx * m_blockW < r->end_x; bx++) {
+						vx_uint32 x0 = std::max(r->start_x, bx * m_blockW), x1 = std::min(r->end_x, (bx + 1) * m_blockW);
+						vx_uint32 *pI = (vx_uint32 *)(base_ptr + (m_height*ci + y0)*m_stride + x0*m_stride_x);
+						vx_uint32 *pJ = (vx_uint32 *)(base_ptr + (m_height*cj + y0)*m_stride + x0*m_stride_x);
+						vx_uint32 sumI = 0, sumJ = 0;
+						vx_uint32 cnt = count_nz_mean_double(pI, pJ, (m_stride >> 2), x1 - x0, y1 - y0, &sumI, &sumJ);
+						vx_uint32 base = (by * m_blocksX + bx) * n * n;
+						m_blockI[base + ci * n + cj] += sumI;
+						m_blockI[base + cj * n + ci] += sumJ;
+						m_blockN[base + ci * n + cj] += cnt;
+						m_blockN[base + cj * n + ci] += cnt;
+					}
+				}
+			}
 		}
+		solve_block_gains(m_alpha, m_beta, m_Gains);
+		for (vx_uint32 ci = 0; ci < n; ci++)
+			memcpy(m_pblockgainInfo[ci].block_gain_buf, m_blockGains + ci * m_blocksX * m_blocksY, m_blocksX * m_blocksY * sizeof(vx_float32));
 	}
-
-	//solve the linear equation A*gains_ = B
-	solve_gauss(m_AMat, m_Gains, m_numImages);
 	// Apply gains to all images
 	status = ApplyGains(base_ptr);
 	// commit image patch
@@ -571,8 +770,12 @@ vx_status CExpCompensator::CompensateGains()
 vx_status CExpCompensator::SolveForGains(vx_float32 alpha, vx_float32 beta, vx_uint32 *pIMat, vx_uint32 *pNMat, vx_uint32 num_images, vx_array Gains_arr, vx_uint32 rows, vx_uint32 cols)
 {
 	unsigned int i, N = rows*cols;
+	if (num_images > rows || num_images > cols) return VX_ERROR_INVALID_DIMENSION;
+	if (num_images > m_maxImages) {
+		// fallback for callers that didn't preallocate the solver
+		ERROR_CHECK_STATUS(InitializeSolver(num_images));
+	}
 	m_numImages = num_images;
-	float *gains = new float[num_images];
 
 	// normalize intensity 
 	for (i = 0; i < N; i++){
@@ -580,95 +783,317 @@ vx_status CExpCompensator::SolveForGains(vx_float32 alpha, vx_float32 beta, vx_u
 			pIMat[i] =(vx_uint32) (pIMat[i]*16.0/ pNMat[i]);			// I values are scaled
 		}
 	}
-	// generate augmented matrix[A/b] for solving gains
-	m_AMat = new vx_float64*[m_numImages];
-	for (i = 0; i < m_numImages; i++){
-		m_AMat[i] = new vx_float64[m_numImages + 1];	// enough for the augmented matrix [a|b]
-		memset(&m_AMat[i][0], 0, (m_numImages + 1)*sizeof(vx_float64));
-	}
-	for (i = 0; i < (int)num_images; i++){
-		vx_uint32 *pI = pIMat + i*cols;
-		vx_uint32 *pN = pNMat + i*cols;
-		for (int j = 0; j < (int)num_images; ++j) {
-			int N = pN[j] ? pN[j] : 1;
-			m_AMat[i][m_numImages] += beta * N;		// b matrix
-			m_AMat[i][i] += beta * N;
-			if (j == i)			continue;
-			m_AMat[i][i] += 2 * alpha * pI[j] * pI[j] * N;
-			m_AMat[i][j] -= 2 * alpha * pI[j] * pIMat[j*num_images + i] * N;
-		}
-	}
-	solve_gauss(m_AMat, gains, m_numImages);
+	// solve the normal equations: gains of the last frame are used as warm start
+	build_normal_equations(alpha, beta, pIMat, pNMat, m_numImages, cols, nullptr);
+	if (solve_ldlt(m_numImages, m_Gains, m_GainsValid))
+		m_GainsValid = true;
 	ERROR_CHECK_STATUS(vxTruncateArray(Gains_arr, 0));
-	ERROR_CHECK_STATUS(vxAddArrayItems(Gains_arr, m_numImages, gains, sizeof(float)));
-	delete gains;
-	for (i = 0; i < (int)num_images; i++){
-		delete m_AMat[i];
+	ERROR_CHECK_STATUS(vxAddArrayItems(Gains_arr, m_numImages, m_Gains, sizeof(vx_float32)));
+	return VX_SUCCESS;
+}
+
+//! \brief Solves gains per block from per overlap entry statistics and writes the smoothed gains as [image][block_y][block_x].
+//! The gains from the last SolveForGains call are used as the prior of each block.
+vx_status CExpCompensator::SolveForBlockGains(vx_float32 alpha, vx_float32 beta, const StitchOverlapPixelEntry *pEntries, const StitchExpCompBlockStats *pStats, vx_size num_entries, vx_array block_gains_arr)
+{
+	vx_uint32 n = m_numImages;
+	if (!m_blockI || !n) return VX_ERROR_NOT_ALLOCATED;
+	memset(m_blockI, 0, m_blocksX * m_blocksY * n * n * sizeof(vx_uint32));
+	memset(m_blockN, 0, m_blocksX * m_blocksY * n * n * sizeof(vx_uint32));
+	for (vx_size k = 0; k < num_entries; k++) {
+		const StitchOverlapPixelEntry * e = &pEntries[k];
+		vx_uint32 ci = e->camId0, cj = e->camId1;
+		if (ci >= n || cj >= n || !pStats[k].count) continue;
+		// entries are not aligned to the grid: use the block containing the entry center
+		vx_uint32 bx = std::min((vx_uint32)(e->start_x + (e->end_x >> 1)) / m_blockW, m_blocksX - 1);
+		vx_uint32 by = std::min((vx_uint32)(e->start_y + (e->end_y >> 1)) / m_blockH, m_blocksY - 1);
+		vx_uint32 base = (by * m_blocksX + bx) * n * n;
+		m_blockI[base + ci * n + cj] += pStats[k].sumI;
+		m_blockI[base + cj * n + ci] += pStats[k].sumJ;
+		m_blockN[base + ci * n + cj] += pStats[k].count;
+		m_blockN[base + cj * n + ci] += pStats[k].count;
 	}
-	delete m_AMat;
+	solve_block_gains(alpha, beta, m_Gains);
+	ERROR_CHECK_STATUS(vxTruncateArray(block_gains_arr, 0));
+	ERROR_CHECK_STATUS(vxAddArrayItems(block_gains_arr, n * m_blocksX * m_blocksY, m_blockGains, sizeof(vx_float32)));
 	return VX_SUCCESS;
 }
 
-// solving linear equation of Augmented matrix[A|b] using gaussian elemination method
-void CExpCompensator::solve_gauss(vx_float64 **A, vx_float32 *g, int num)
+// solve each block of m_blockI/m_blockN with the gains regularized towards global_gains, then smooth the grid
+void CExpCompensator::solve_block_gains(vx_float32 alpha, vx_float32 beta, const vx_float32 *global_gains)
 {
-	int n = num;
+	vx_uint32 n = m_numImages, num_blocks = m_blocksX * m_blocksY;
+	vx_float32 gains[32];
+	for (vx_uint32 b = 0; b < num_blocks; b++) {
+		const vx_uint32 *pI = m_blockI + b * n * n;
+		const vx_uint32 *pN = m_blockN + b * n * n;
+		bool overlap = false;
+		for (vx_uint32 k = 0; k < n * n; k++) {
+			m_cellI[k] = pN[k] ? pI[k] / pN[k] : 0;
+			overlap |= (pN[k] != 0);
+		}
+		for (vx_uint32 i = 0; i < n; i++)
+			gains[i] = m_blockGainsValid ? m_blockRawGains[i * num_blocks + b] : global_gains[i];
+		if (overlap) {
+			build_normal_equations(alpha, beta, m_cellI, pN, n, n, global_gains);
+			solve_ldlt(n, gains, m_blockGainsValid);
+		}
+		else {
+			// no overlap in this block: follow the image gain
+			for (vx_uint32 i = 0; i < n; i++)
+				gains[i] = global_gains[i];
+		}
+		for (vx_uint32 i = 0; i < n; i++)
+			m_blockRawGains[i * num_blocks + b] = gains[i];
+	}
+	m_blockGainsValid = true;
+	memcpy(m_blockGains, m_blockRawGains, n * num_blocks * sizeof(vx_float32));
+	smooth_block_gains();
+}
 
-	for (int i = 0; i < n; i++) {
-		// Search for maximum in this column
-		double maxEl = abs(A[i][i]);
-		int maxRow = i;
-		for (int k = i + 1; k<n; k++) {
-			if (abs(A[k][i]) > maxEl) {
-				maxEl = abs(A[k][i]);
-				maxRow = k;
+// separable [1 2 1]/4 filter over the block grid of each image (edges are replicated)
+void CExpCompensator::smooth_block_gains()
+{
+	vx_uint32 bw = m_blocksX, bh = m_blocksY;
+	for (vx_uint32 i = 0; i < m_numImages; i++) {
+		vx_float32 *g = m_blockGains + i * bw * bh;
+		for (int pass = 0; pass < EXPCOMP_BLOCK_GAIN_SMOOTH_PASSES; pass++) {
+			for (vx_uint32 y = 0; y < bh; y++) {
+				const vx_float32 *row = g + y * bw;
+				for (vx_uint32 x = 0; x < bw; x++)
+					m_blockScratch[y * bw + x] = 0.25f * (row[x > 0 ? x - 1 : 0] + 2.0f * row[x] + row[x + 1 < bw ? x + 1 : x]);
 			}
-		}
-		// Swap maximum row with current row (column by column)
-		for (int k = i; k < n + 1; k++) {
-			double tmp = A[maxRow][k];
-			A[maxRow][k] = A[i][k];
-			A[i][k] = tmp;
-		}
-		// Make all rows below this one 0 in current column: scale
-		for (int k = i + 1; k < n; k++) {
-			double c = -A[k][i] / A[i][i];
-			for (int j = i; j < n + 1; j++) {
-				if (i == j) {
-					A[k][j] = 0;
-				}
-				else {
-					A[k][j] += c * A[i][j];
-				}
+			for (vx_uint32 y = 0; y < bh; y++) {
+				const vx_float32 *r0 = m_blockScratch + (y > 0 ? y - 1 : 0) * bw;
+				const vx_float32 *r1 = m_blockScratch + y * bw;
+				const vx_float32 *r2 = m_blockScratch + (y + 1 < bh ? y + 1 : y) * bw;
+				for (vx_uint32 x = 0; x < bw; x++)
+					g[y * bw + x] = 0.25f * (r0[x] + 2.0f * r1[x] + r2[x]);
 			}
 		}
 	}
+}
 
-	// Solve equation Ax=b for an upper triangular matrix A
-	for (int i = n - 1; i >= 0; i--) {
-		double gain = (A[i][n] / A[i][i]);
-		for (int k = i - 1; k >= 0; k--) {
-			A[k][n] -= A[k][i] * gain;
+// generate the normal equations A*g = b of the gain error function into m_LDLMat and m_LDLRhs.
+// gains are regularized towards prior (1.0 when prior is nullptr)
+void CExpCompensator::build_normal_equations(vx_float32 alpha, vx_float32 beta, const vx_uint32 *pIMat, const vx_uint32 *pNMat, vx_uint32 num, vx_uint32 cols, const vx_float32 *prior)
+{
+	vx_float64 *A = m_LDLMat, *b = m_LDLRhs;
+	memset(A, 0, num*num*sizeof(vx_float64));
+	for (vx_uint32 i = 0; i < num; i++){
+		const vx_uint32 *pI = pIMat + i*cols;
+		const vx_uint32 *pN = pNMat + i*cols;
+		vx_float64 *Ai = A + i*num;
+		b[i] = 0;
+		for (vx_uint32 j = 0; j < num; j++) {
+			vx_float64 n = pN[j] ? pN[j] : 1;
+			b[i] += beta * n * (prior ? prior[i] : 1.0f);
+			Ai[i] += beta * n;
+			if (j == i)			continue;
+			Ai[i] += 2 * alpha * (vx_float64)pI[j] * pI[j] * n;
+			Ai[j] -= 2 * alpha * (vx_float64)pI[j] * pIMat[j*cols + i] * n;
 		}
-		g[i] = (vx_float32)gain;
 	}
-	return;
+}
+
+// solve the symmetric positive definite system in m_LDLMat/m_LDLRhs with an in-place LDL' factorization.
+// only the lower triangle of A is used. gains holds the previous solution on entry; it is returned
+// unchanged when it already satisfies the system (warm_start) or when the system is degenerate.
+bool CExpCompensator::solve_ldlt(vx_uint32 num, vx_float32 *gains, bool warm_start)
+{
+	vx_float64 *A = m_LDLMat, *b = m_LDLRhs;
+	const vx_float64 eps = 1e-12;
+
+	// warm start: skip the factorization if last frame's gains still solve the system
+	if (warm_start) {
+		vx_float64 rnorm = 0, bnorm = 0;
+		for (vx_uint32 i = 0; i < num; i++) {
+			const vx_float64 *Ai = A + i*num;
+			vx_float64 r = b[i];
+			for (vx_uint32 j = 0; j < i; j++) r -= Ai[j] * gains[j];
+			for (vx_uint32 j = i; j < num; j++) r -= A[j*num + i] * gains[j];
+			rnorm += r * r;
+			bnorm += b[i] * b[i];
+		}
+		if (rnorm <= bnorm * 1e-12)
+			return true;
+	}
+
+	// factorize A = L*D*L': D is stored on the diagonal, L (unit diagonal) below it
+	for (vx_uint32 j = 0; j < num; j++) {
+		vx_float64 *Aj = A + j*num;
+		vx_float64 d = Aj[j];
+		for (vx_uint32 k = 0; k < j; k++)
+			d -= Aj[k] * Aj[k] * A[k*num + k];
+		if (!(d > eps * (std::abs(Aj[j]) + eps)))
+			return false;	// not positive definite: keep previous gains
+		Aj[j] = d;
+		for (vx_uint32 i = j + 1; i < num; i++) {
+			vx_float64 *Ai = A + i*num;
+			vx_float64 s = Ai[j];
+			for (vx_uint32 k = 0; k < j; k++)
+				s -= Ai[k] * Aj[k] * A[k*num + k];
+			Ai[j] = s / d;
+		}
+	}
+	// forward substitution: L*y = b
+	for (vx_uint32 i = 0; i < num; i++) {
+		const vx_float64 *Ai = A + i*num;
+		vx_float64 s = b[i];
+		for (vx_uint32 k = 0; k < i; k++)
+			s -= Ai[k] * b[k];
+		b[i] = s;
+	}
+	// diagonal and backward substitution: D*L'*x = y
+	for (vx_uint32 i = num; i-- > 0;) {
+		vx_float64 s = b[i] / A[i*num + i];
+		for (vx_uint32 k = i + 1; k < num; k++)
+			s -= A[k*num + i] * b[k];
+		b[i] = s;
+	}
+	for (vx_uint32 i = 0; i < num; i++)
+		gains[i] = (vx_float32)b[i];
+	return true;
 }
 
 vx_status CExpCompensator::ApplyGains(void *in_base_addr)
 {
-	uint32_t num_threads = m_numImages - 1;
-	std::thread *thread_apply_gains = new std::thread[num_threads];
-	for (int i = 0; i < (int)m_numImages - 1; i++)
+	// wake up the persistent workers for images [0..m_numImages-2] and process the last image here
 	{
-		thread_apply_gains[i] = std::thread(&CExpCompensator::applygains_thread_func, this, i, (char *)in_base_addr);
+		std::lock_guard<std::mutex> lock(m_workerMutex);
+		m_workerInBase = (char *)in_base_addr;
+		m_workerStatus = VX_SUCCESS;
+		m_workerPending = m_numWorkers;
+		m_workerGeneration++;
 	}
-	applygains_thread_func(num_threads, (char *)in_base_addr);
-	//Join the threads with the main thread
-	for (int i = 0; i < (int)m_numImages - 1; i++) {
-		thread_apply_gains[i].join();
+	m_workerStart.notify_all();
+	vx_status status = applygains_thread_func(m_numWorkers, (char *)in_base_addr);
+	// wait for the workers to finish
+	std::unique_lock<std::mutex> lock(m_workerMutex);
+	m_workerDone.wait(lock, [this] { return m_workerPending == 0; });
+	if (status == VX_SUCCESS)
+		status = m_workerStatus;
+	return status;
+}
+
+void CExpCompensator::applygains_worker(vx_int32 img_num)
+{
+	vx_uint32 generation = 0;
+	for (;;) {
+		char * in_base_addr = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_workerMutex);
+			m_workerStart.wait(lock, [&] { return m_workerExit || m_workerGeneration != generation; });
+			if (m_workerExit)
+				break;
+			generation = m_workerGeneration;
+			in_base_addr = m_workerInBase;
+		}
+		vx_status status = applygains_thread_func(img_num, in_base_addr);
+		{
+			std::lock_guard<std::mutex> lock(m_workerMutex);
+			if (status != VX_SUCCESS)
+				m_workerStatus = status;
+			if (--m_workerPending == 0)
+				m_workerDone.notify_one();
+		}
+	}
+}
+
+void CExpCompensator::shutdown_workers()
+{
+	if (m_workers) {
+		{
+			std::lock_guard<std::mutex> lock(m_workerMutex);
+			m_workerExit = true;
+		}
+		m_workerStart.notify_all();
+		for (vx_uint32 i = 0; i < m_numWorkers; i++) {
+			if (m_workers[i].joinable())
+				m_workers[i].join();
+		}
+		delete[] m_workers;
+		m_workers = nullptr;
+	}
+	m_numWorkers = 0;
+}
+
+// scales 4 RGBX pixels with a gain vector per pixel; pixels equal to 0x80000000 are invalid and kept as is
+static inline __m128i apply_gains_4px(__m128i px, __m128 g0, __m128 g1, __m128 g2, __m128 g3)
+{
+	const __m128i invalid = _mm_set1_epi32((int)0x80000000);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i mask = _mm_cmpeq_epi32(px, invalid);
+	__m128i lo = _mm_unpacklo_epi8(px, zero);
+	__m128i hi = _mm_unpackhi_epi8(px, zero);
+	__m128i p0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), g0));
+	__m128i p1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), g1));
+	__m128i p2 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), g2));
+	__m128i p3 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), g3));
+	__m128i res = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+	return _mm_or_si128(_mm_and_si128(mask, px), _mm_andnot_si128(mask, res));
+}
+
+static inline void apply_gains_1px(const vx_uint32 *pSrc, vx_uint32 *pDst, const vx_float32 gain[4])
+{
+	if (*pSrc != 0x80000000){
+		const uint8_t *p = (const uint8_t *)pSrc;
+		uint8_t *d = (uint8_t *)pDst;
+		d[0] = saturate_char((int)(p[0] * gain[0]));
+		d[1] = saturate_char((int)(p[1] * gain[1]));
+		d[2] = saturate_char((int)(p[2] * gain[2]));
+		d[3] = saturate_char((int)(p[3] * gain[3]));
+	}
+	else
+		*pDst = *pSrc;
+}
+
+// applies per channel gains to 4 RGBX pixels at a time
+static void apply_gains_row(const vx_uint32 *pSrc, vx_uint32 *pDst, vx_int32 width, const vx_float32 gain[4])
+{
+	const __m128 g = _mm_loadu_ps(gain);
+	vx_int32 j = 0;
+	for (; j <= width - 4; j += 4) {
+		__m128i px = _mm_loadu_si128((const __m128i *)&pSrc[j]);
+		_mm_storeu_si128((__m128i *)&pDst[j], apply_gains_4px(px, g, g, g, g));
+	}
+	for (; j < width; j++)
+		apply_gains_1px(&pSrc[j], &pDst[j], gain);
+}
+
+// bilinear interpolation of the block gains at pixel x between two block rows (fy: weight of grow1).
+// block gains are located at the block centers and clamped at the grid borders.
+static inline vx_float32 block_gain_at(const vx_float32 *grow0, const vx_float32 *grow1, vx_float32 fy, vx_int32 x, vx_int32 blocks_x, vx_float32 inv_block_w)
+{
+	vx_float32 fx = std::min(std::max((x + 0.5f) * inv_block_w - 0.5f, 0.0f), (vx_float32)(blocks_x - 1));
+	vx_int32 x0 = (vx_int32)fx, x1 = std::min(x0 + 1, blocks_x - 1);
+	fx -= x0;
+	vx_float32 g0 = grow0[x0] + (grow0[x1] - grow0[x0]) * fx;
+	vx_float32 g1 = grow1[x0] + (grow1[x1] - grow1[x0]) * fx;
+	return g0 + (g1 - g0) * fy;
+}
+
+// applies block gains interpolated per pixel and per channel factors; x_start is the x-coordinate of pSrc[0]
+static void apply_block_gains_row(const vx_uint32 *pSrc, vx_uint32 *pDst, vx_int32 width, vx_int32 x_start,
+	const vx_float32 *grow0, const vx_float32 *grow1, vx_float32 fy, vx_int32 blocks_x, vx_int32 block_w, const vx_float32 factor[4])
+{
+	const __m128 f = _mm_loadu_ps(factor);
+	const vx_float32 inv_block_w = 1.0f / block_w;
+	vx_int32 j = 0;
+	for (; j <= width - 4; j += 4) {
+		vx_int32 x = x_start + j;
+		__m128 g0 = _mm_mul_ps(f, _mm_set1_ps(block_gain_at(grow0, grow1, fy, x + 0, blocks_x, inv_block_w)));
+		__m128 g1 = _mm_mul_ps(f, _mm_set1_ps(block_gain_at(grow0, grow1, fy, x + 1, blocks_x, inv_block_w)));
+		__m128 g2 = _mm_mul_ps(f, _mm_set1_ps(block_gain_at(grow0, grow1, fy, x + 2, blocks_x, inv_block_w)));
+		__m128 g3 = _mm_mul_ps(f, _mm_set1_ps(block_gain_at(grow0, grow1, fy, x + 3, blocks_x, inv_block_w)));
+		__m128i px = _mm_loadu_si128((const __m128i *)&pSrc[j]);
+		_mm_storeu_si128((__m128i *)&pDst[j], apply_gains_4px(px, g0, g1, g2, g3));
+	}
+	for (; j < width; j++) {
+		vx_float32 g = block_gain_at(grow0, grow1, fy, x_start + j, blocks_x, inv_block_w);
+		vx_float32 gain[4] = { factor[0] * g, factor[1] * g, factor[2] * g, factor[3] * g };
+		apply_gains_1px(&pSrc[j], &pDst[j], gain);
 	}
-	return VX_SUCCESS;
 }
 
 vx_status CExpCompensator::applygains_thread_func(vx_int32 img_num, char *in_base_addr)
@@ -688,25 +1113,27 @@ vx_status CExpCompensator::applygains_thread_func(vx_int32 img_num, char *in_bas
 	vx_int32 height = mValidRect[img_num].end_y - mValidRect[img_num].start_y;
 	vx_uint32 *pRGB = (vx_uint32 *)(in_base_addr + (img_num*m_height + mValidRect[img_num].start_y)*m_stride + (mValidRect[img_num].start_x*m_stride_x));
 	vx_uint32 *pDst = (vx_uint32 *)(base_ptr + mValidRect[img_num].start_y*addr.stride_y + mValidRect[img_num].start_x*addr.stride_x);
-	float g_y = m_Gains[img_num];
-	float g_r = g_y, g_g = g_y, g_b = g_y;	// todo: check if we need to apply gain factor for RGB
-	// todo:: if we do the following code in CPU, need to optimize using SSE
-	for (int i = 0; i < height; i++){
-		for (int j = 0; j < width; j++){
-			// apply gain only to valid pixels : todo: multiply with approapriate gain factors for R, G and B
-			if (pRGB[j] != 0x80000000){
-				uint8_t *p = (uint8_t *)&pRGB[j];
-				uint8_t *d = (uint8_t *)&pDst[j];
-				d[0] = saturate_char((int)(p[0] * g_r));
-				d[1] = saturate_char((int)(p[1] * g_g));
-				d[2] = saturate_char((int)(p[2] * g_b));
-				d[3] = saturate_char((int)(p[3] * g_y));
-			}
-			else
-				pDst[j] = pRGB[j];
+	if (m_blockMode) {
+		const vx_float32 factor[4] = { m_ChannelGains[img_num][0], m_ChannelGains[img_num][1], m_ChannelGains[img_num][2], 1.0f };
+		const vx_float32 *pGains = m_pblockgainInfo[img_num].block_gain_buf;
+		for (int i = 0; i < height; i++){
+			vx_int32 y = mValidRect[img_num].start_y + i;
+			vx_float32 fy = std::min(std::max((y + 0.5f) / m_blockH - 0.5f, 0.0f), (vx_float32)(m_blocksY - 1));
+			vx_int32 y0 = (vx_int32)fy, y1 = std::min(y0 + 1, (vx_int32)m_blocksY - 1);
+			apply_block_gains_row(pRGB, pDst, width, mValidRect[img_num].start_x,
+				pGains + y0 * m_blocksX, pGains + y1 * m_blocksX, fy - y0, m_blocksX, m_blockW, factor);
+			pRGB += (m_stride >> 2);
+			pDst += (addr.stride_y >> 2);
+		}
+	}
+	else {
+		float g_y = m_Gains[img_num];
+		vx_float32 gain[4] = { g_y * m_ChannelGains[img_num][0], g_y * m_ChannelGains[img_num][1], g_y * m_ChannelGains[img_num][2], g_y };
+		for (int i = 0; i < height; i++){
+			apply_gains_row(pRGB, pDst, width, gain);
+			pRGB += (m_stride >> 2);
+			pDst += (addr.stride_y >> 2);
 		}
-		pRGB += (m_stride >> 2);
-		pDst += (addr.stride_y >> 2);
 	}
 	// commit image patch
 	if ((status = vxCommitImagePatch(m_OutputImage, &rect, 0, &addr, (void *)base_ptr) != VX_SUCCESS)) {
@@ -714,4 +1141,4 @@ vx_status CExpCompensator::applygains_thread_func(vx_int32 img_num, char *in_bas
 		return VX_FAILURE;
 	}
 	return status;
-}
\ No newline at end of file
+}
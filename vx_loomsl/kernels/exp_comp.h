@@ -22,9 +22,13 @@ THE SOFTWARE.
 
 // header file for exposure compensation implementation on CPU prototype
 #include "kernels.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #define MAX_NUM_IMAGES_IN_STITCHED_OUTPUT	16
 #define USE_LUMA_VALUES_FOR_GAIN			1
+#define EXPCOMP_BLOCK_GAIN_SMOOTH_PASSES	2	// number of [1 2 1]/4 smoothing passes over the block gains grid
 
 typedef struct _block_gain_info
 {
@@ -42,7 +46,12 @@ public:
 	virtual vx_status Process();
 	virtual vx_status Initialize(vx_node node, vx_float32 alpha, vx_float32 beta, vx_array valid_roi, vx_image input, vx_image output);
 	virtual vx_status DeInitialize();
+	virtual vx_status InitializeSolver(vx_uint32 max_images);
+	virtual vx_status SetChannelGains(vx_uint32 img_num, vx_float32 r_gain, vx_float32 g_gain, vx_float32 b_gain);
 	virtual vx_status SolveForGains(vx_float32 alpha, vx_float32 beta, vx_uint32 *IMat, vx_uint32 *NMat, vx_uint32 num_images, vx_array pGains, vx_uint32 rows, vx_uint32 cols);
+	virtual vx_status InitializeBlockSolver(vx_uint32 num_images, vx_uint32 blocks_x, vx_uint32 blocks_y, vx_uint32 block_width, vx_uint32 block_height);
+	virtual vx_status SolveForBlockGains(vx_float32 alpha, vx_float32 beta, const StitchOverlapPixelEntry *pEntries, const StitchExpCompBlockStats *pStats, vx_size num_entries, vx_array block_gains_arr);
+	virtual vx_status EnableBlockGains();
 
 protected:
 	vx_uint32	m_numImages;
@@ -55,8 +64,21 @@ protected:
 	vx_rectangle_t m_pRoi_rect[MAX_NUM_IMAGES_IN_STITCHED_OUTPUT][MAX_NUM_IMAGES_IN_STITCHED_OUTPUT];	// assuming 
 	block_gain_info *m_pblockgainInfo;
 	vx_uint32 **m_NMat, **m_IMat;
-	vx_float64 **m_AMat;
-	vx_float32 *m_Gains;
+	vx_uint32	m_maxImages;		// capacity of the solver buffers
+	vx_float64 *m_LDLMat;			// [m_maxImages x m_maxImages] normal equations, factored in place
+	vx_float64 *m_LDLRhs;			// [m_maxImages] right hand side and solution scratch
+	vx_float32 *m_Gains;			// [m_maxImages] gains of the last solve (warm start)
+	bool		m_GainsValid;
+	vx_float32	m_ChannelGains[MAX_NUM_IMAGES_IN_STITCHED_OUTPUT][3];	// R, G, B factors on top of the solved gain
+	// block gains: the image is split into a grid of blocks and a gain is solved per block per image
+	bool		m_blockMode;
+	vx_uint32	m_blocksX, m_blocksY, m_blockW, m_blockH;
+	vx_uint32	*m_blockI, *m_blockN;		// [block][image][image] luma sums and pixel counts of overlaps
+	vx_uint32	*m_cellI;					// [image][image] mean luma of a block
+	vx_float32	*m_blockRawGains;			// [image][block] solved gains (warm start)
+	vx_float32	*m_blockGains;				// [image][block] smoothed gains
+	vx_float32	*m_blockScratch;			// [block] smoothing scratch
+	bool		m_blockGainsValid;
 	vx_rectangle_t mValidRect[MAX_NUM_IMAGES_IN_STITCHED_OUTPUT];
 
 // functions
@@ -64,6 +86,22 @@ protected:
 	virtual vx_status ApplyGains(void *in_base_addr);
 
 private:
-	void solve_gauss(vx_float64 **A, vx_float32* g, int num);
+	void build_normal_equations(vx_float32 alpha, vx_float32 beta, const vx_uint32 *pIMat, const vx_uint32 *pNMat, vx_uint32 num, vx_uint32 cols, const vx_float32 *prior);
+	bool solve_ldlt(vx_uint32 num, vx_float32 *gains, bool warm_start);
+	void solve_block_gains(vx_float32 alpha, vx_float32 beta, const vx_float32 *global_gains);
+	void smooth_block_gains();
+	void release_block_solver();
 	vx_status applygains_thread_func(vx_int32 img_num, char *in_base_addr);
+	void applygains_worker(vx_int32 img_num);
+	void shutdown_workers();
+
+	// persistent ApplyGains workers: one per image except the last, which runs on the calling thread
+	std::thread *m_workers;
+	vx_uint32	m_numWorkers;
+	std::mutex	m_workerMutex;
+	std::condition_variable m_workerStart, m_workerDone;
+	vx_uint32	m_workerGeneration, m_workerPending;
+	vx_status	m_workerStatus;
+	bool		m_workerExit;
+	char		*m_workerInBase;
 };
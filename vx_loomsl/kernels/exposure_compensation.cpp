@@ -130,6 +130,32 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_output_validator(vx_node
 		}
 		ERROR_CHECK_STATUS(vxReleaseMatrix((vx_matrix *)&ref));
 	}
+	else if (index == 5)
+	{ // array of StitchExpCompBlockStats: one item per exp_data entry
+		vx_size itemsize = 0, capacity = 0, entries = 0;
+		vx_enum itemtype = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		vx_array exp_data = (vx_array)avxGetNodeParamRef(node, 2);
+		ERROR_CHECK_OBJECT(exp_data);
+		ERROR_CHECK_STATUS(vxQueryArray(exp_data, VX_ARRAY_ATTRIBUTE_CAPACITY, &entries, sizeof(entries)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&exp_data));
+		if (itemsize != sizeof(StitchExpCompBlockStats)) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp block stats array item size should be sizeof(StitchExpCompBlockStats)\n");
+		}
+		else if (capacity < entries) {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp block stats array capacity should be at least %d\n", (int)entries);
+		}
+		else {
+			ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+			ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+			status = VX_SUCCESS;
+		}
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+	}
 	return status;
 }
 
@@ -211,6 +237,7 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 		ERROR_CHECK_STATUS(vxQueryImage(mask_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &input_height, sizeof(input_height)));
 		ERROR_CHECK_STATUS(vxQueryImage(mask_image, VX_IMAGE_ATTRIBUTE_FORMAT, &input_format, sizeof(input_format)));
 	}
+	vx_array block_stats = (vx_array)avxGetNodeParamRef(node, 5);	// optional StitchExpCompBlockStats output for block gains
 
 	// set kernel configuration
 	vx_uint32 height_one = (vx_uint32)(input_height / num_cameras);
@@ -231,26 +258,28 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"			uint	pIn_width, uint	pIn_height, __global uchar *pIn_buf, uint pIn_stride, uint	pIn_offs,\n"
 			"			__global uchar * exp_data, uint	exp_data_offs, uint exp_data_num,\n"
 			"			uint	pWt_width, uint	pWt_height, __global uchar *pWt_buf, uint pWt_stride, uint	pWt_offs,\n"
-			"			__global int * pAMat, uint cols, uint rows)\n"
+			"			__global int * pAMat, uint cols, uint rows%s)\n"
 			"{\n"
 			"	int grp_id = get_global_id(0)>>4;\n"
 			"   if (grp_id < exp_data_num) {\n"
-			"	__local uint  sumI[256], sumJ[256];\n"
+			"	__local uint  sumI[256], sumJ[256]%s;\n"
 			"	uint2 offs = ((__global uint2 *)(exp_data+exp_data_offs))[grp_id];\n"
 			"	uint size = (uint)(pIn_stride*%d);\n"
 			"	uint wt_size = (uint)(pWt_stride*%d);\n"
-			, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name, height_one, height_one);
+			, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name,
+			block_stats ? ",\n			__global uchar * pStats_buf, uint pStats_offs, uint pStats_num" : "", block_stats ? ", sumN[256]" : "", height_one, height_one);
 		opencl_kernel_code = item;
 		opencl_kernel_code +=
 			"	int lx = get_local_id(0);\n"
 			"	int ly = get_local_id(1);\n"
-			"	int lid = mad24(ly, (int)get_local_size(0), lx);\n"
-			"   sumI[lid] = 0; sumJ[lid] = 0;\n"
+			"	int lid = mad24(ly, (int)get_local_size(0), lx);\n";
+		opencl_kernel_code += block_stats ? "   sumI[lid] = 0; sumJ[lid] = 0; sumN[lid] = 0;\n" : "   sumI[lid] = 0; sumJ[lid] = 0;\n";
+		opencl_kernel_code +=
 			"	bool isValid = ((lx<<3) < (int)(offs.s1&0x7f)) && (ly*2 < (int)((offs.s1>>7)&0x1f));\n"
 			"	if (isValid) {\n"
 			"		global uint *pI, *pJ;\n"
 			"		uint4 maskSrc, I, J, mask; \n"
-			"		uint4 Isum4, Jsum4;\n"
+			"		uint4 Isum4, Jsum4, Nsum4;\n"
 			"		int   gx = (lx<<3) + ((offs.s0 >> 5) & 0x3FFF);\n"
 			"		int   gy = (ly<<1) + (offs.s0 >> 19);\n"
 			"		uint2 cam_id = (uint2)((offs.s0 & 0x1f), ((offs.s1>>12) & 0x1f));\n"
@@ -269,7 +298,7 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000))) & (int)maskIJ.s1;\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000))) & (int)maskIJ.s2;\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000))) & (int)maskIJ.s3;\n"
-			"		Isum4	= (I&mask)>>24; Jsum4 = (J & mask)>>24;\n"
+			"		Isum4	= (I&mask)>>24; Jsum4 = (J & mask)>>24; Nsum4 = mask>>31;\n"
 			"		I = vload4(1, pI);\n"
 			"		J = vload4(1, pJ); \n"
 			"		maskIJ = as_char4(maskSrc.s1);\n"
@@ -277,7 +306,7 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000))) & (int)maskIJ.s1;\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000))) & (int)maskIJ.s2;\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000))) & (int)maskIJ.s3;\n"
-			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24;\n"
+			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24; Nsum4 += mask>>31;\n"
 			"		pI += (pIn_stride>>2); pJ += (pIn_stride>>2);\n"
 			"		I = vload4(0, pI);\n"
 			"		J = vload4(0, pJ); \n"
@@ -286,7 +315,7 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000))) & (int)maskIJ.s1;\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000))) & (int)maskIJ.s2;\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000))) & (int)maskIJ.s3;\n"
-			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24;\n"
+			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24; Nsum4 += mask>>31;\n"
 			"		I = vload4(1, pI); \n"
 			"		J = vload4(1, pJ); \n"
 			"		maskIJ = as_char4(maskSrc.s3);\n"
@@ -294,10 +323,11 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000))) & (int)maskIJ.s1;\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000))) & (int)maskIJ.s2;\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000))) & (int)maskIJ.s3;\n"
-			"		Isum4 += ((I&mask) >> 24); Jsum4 += ((J & mask) >> 24); \n"
+			"		Isum4 += ((I&mask) >> 24); Jsum4 += ((J & mask) >> 24); Nsum4 += mask>>31;\n"
 			"		sumI[lid] = mad24(Isum4.s3, (uint)1, mad24(Isum4.s2, (uint)1, mad24(Isum4.s1, (uint)1, Isum4.s0)));\n"
-			"		sumJ[lid] = mad24(Jsum4.s3, (uint)1, mad24(Jsum4.s2, (uint)1, mad24(Jsum4.s1, (uint)1, Jsum4.s0)));\n"
-			"		barrier(CLK_LOCAL_MEM_FENCE);\n";
+			"		sumJ[lid] = mad24(Jsum4.s3, (uint)1, mad24(Jsum4.s2, (uint)1, mad24(Jsum4.s1, (uint)1, Jsum4.s0)));\n";
+		if (block_stats) opencl_kernel_code += "		sumN[lid] = Nsum4.s0 + Nsum4.s1 + Nsum4.s2 + Nsum4.s3;\n";
+		opencl_kernel_code += "		barrier(CLK_LOCAL_MEM_FENCE);\n";
 	}
 	else
 	{
@@ -308,25 +338,27 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"__kernel void %s(uint num_cameras,\n" // opencl_kernel_function_name
 			"			uint	pIn_width, uint	pIn_height, __global uchar *pIn_buf, uint pIn_stride, uint	pIn_offs,\n"
 			"			__global uchar * exp_data, uint	exp_data_offs, uint exp_data_num,\n"
-			"			__global int * pAMat, uint cols, uint rows)\n"
+			"			__global int * pAMat, uint cols, uint rows%s)\n"
 			"{\n"
 			"	int grp_id = get_global_id(0)>>4;\n"
 			"   if (grp_id < exp_data_num) {\n"
-			"	__local uint  sumI[256], sumJ[256];\n"
+			"	__local uint  sumI[256], sumJ[256]%s;\n"
 			"	uint2 offs = ((__global uint2 *)(exp_data+exp_data_offs))[grp_id];\n"
 			"	uint size = (uint)(pIn_stride*%d);\n"
-			, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name, height_one);
+			, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name,
+			block_stats ? ",\n			__global uchar * pStats_buf, uint pStats_offs, uint pStats_num" : "", block_stats ? ", sumN[256]" : "", height_one);
 		opencl_kernel_code = item;
 		opencl_kernel_code +=
 			"	int lx = get_local_id(0);\n"
 			"	int ly = get_local_id(1);\n"
-			"	int lid = mad24(ly, (int)get_local_size(0), lx);\n"
-			"   sumI[lid] = 0; sumJ[lid] = 0;\n"
+			"	int lid = mad24(ly, (int)get_local_size(0), lx);\n";
+		opencl_kernel_code += block_stats ? "   sumI[lid] = 0; sumJ[lid] = 0; sumN[lid] = 0;\n" : "   sumI[lid] = 0; sumJ[lid] = 0;\n";
+		opencl_kernel_code +=
 			"	bool isValid = ((lx<<3) < (int)(offs.s1&0x7f)) && (ly*2 < (int)((offs.s1>>7)&0x1f));\n"
 			"	if (isValid) {\n"
 			"		global uint *pI, *pJ;\n"
 			"		uint4  I, J, mask; \n"
-			"		uint4 Isum4, Jsum4;\n"
+			"		uint4 Isum4, Jsum4, Nsum4;\n"
 			"		int   gx = (lx<<3) + ((offs.s0 >> 5) & 0x3FFF);\n"
 			"		int   gy = (ly<<1) + (offs.s0 >> 19);\n"
 			"		uint2 cam_id = (uint2)((offs.s0 & 0x1f), ((offs.s1>>12) & 0x1f));\n"
@@ -339,14 +371,14 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000)));\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000)));\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000)));\n"
-			"		Isum4	= (I&mask)>>24; Jsum4 = (J & mask)>>24;\n"
+			"		Isum4	= (I&mask)>>24; Jsum4 = (J & mask)>>24; Nsum4 = mask>>31;\n"
 			"		I = vload4(1, pI);\n"
 			"		J = vload4(1, pJ);\n"
 			"		mask.s0	= select(0xff000000, 0u, ((I.s0==0x80000000) | (J.s0==0x80000000)));\n"
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000)));\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000)));\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000)));\n"
-			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24;\n"
+			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24; Nsum4 += mask>>31;\n"
 			"		pI += (pIn_stride>>2); pJ += (pIn_stride>>2);\n"
 			"		I = vload4(0, pI);\n"
 			"		J = vload4(0, pJ); \n"
@@ -354,17 +386,18 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000)));\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000)));\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000)));\n"
-			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24;\n"
+			"		Isum4	+= (I&mask)>>24; Jsum4 += (J & mask)>>24; Nsum4 += mask>>31;\n"
 			"		I = vload4(1, pI); \n"
 			"		J = vload4(1, pJ); \n"
 			"		mask.s0	= select(0xff000000, 0u, ((I.s0==0x80000000) | (J.s0==0x80000000)));\n"
 			"		mask.s1	= select(0xff000000, 0u, ((I.s1==0x80000000) | (J.s1==0x80000000)));\n"
 			"		mask.s2	= select(0xff000000, 0u, ((I.s2==0x80000000) | (J.s2==0x80000000)));\n"
 			"		mask.s3	= select(0xff000000, 0u, ((I.s3==0x80000000) | (J.s3==0x80000000)));\n"
-			"		Isum4 += ((I&mask) >> 24); Jsum4 += ((J & mask) >> 24); \n"
+			"		Isum4 += ((I&mask) >> 24); Jsum4 += ((J & mask) >> 24); Nsum4 += mask>>31;\n"
 			"		sumI[lid] = mad24(Isum4.s3, (uint)1, mad24(Isum4.s2, (uint)1, mad24(Isum4.s1, (uint)1, Isum4.s0)));\n"
-			"		sumJ[lid] = mad24(Jsum4.s3, (uint)1, mad24(Jsum4.s2, (uint)1, mad24(Jsum4.s1, (uint)1, Jsum4.s0)));\n"
-			"		barrier(CLK_LOCAL_MEM_FENCE);\n";
+			"		sumJ[lid] = mad24(Jsum4.s3, (uint)1, mad24(Jsum4.s2, (uint)1, mad24(Jsum4.s1, (uint)1, Jsum4.s0)));\n";
+		if (block_stats) opencl_kernel_code += "		sumN[lid] = Nsum4.s0 + Nsum4.s1 + Nsum4.s2 + Nsum4.s3;\n";
+		opencl_kernel_code += "		barrier(CLK_LOCAL_MEM_FENCE);\n";
 	}
 	opencl_kernel_code +=
 		"		// aggregate sum and count from all threads\n"
@@ -399,7 +432,21 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 		"			sumI[lid]	+= sumI[lid+8];\n"
 		"			sumJ[lid]	+= sumJ[lid+8];\n"
 		"		}\n"
-		"		barrier(CLK_LOCAL_MEM_FENCE);\n"
+		"		barrier(CLK_LOCAL_MEM_FENCE);\n";
+	if (block_stats) {
+		opencl_kernel_code +=
+			"		if (lid < 128) sumN[lid] += sumN[lid+128];\n"
+			"		barrier(CLK_LOCAL_MEM_FENCE);\n"
+			"		if (lid < 64) sumN[lid] += sumN[lid+64];\n"
+			"		barrier(CLK_LOCAL_MEM_FENCE);\n"
+			"		if (lid < 32) sumN[lid] += sumN[lid+32];\n"
+			"		barrier(CLK_LOCAL_MEM_FENCE);\n"
+			"		if (lid < 16) sumN[lid] += sumN[lid+16];\n"
+			"		barrier(CLK_LOCAL_MEM_FENCE);\n"
+			"		if (lid < 8) sumN[lid] += sumN[lid+8];\n"
+			"		barrier(CLK_LOCAL_MEM_FENCE);\n";
+	}
+	opencl_kernel_code +=
 		"		uint idx1, s1; uint4 t1;\n"
 		"		if (!lid)\n"
 		"		{\n"
@@ -413,11 +460,24 @@ static vx_status VX_CALLBACK exposure_comp_calcErrorFn_opencl_codegen(
 		"			t1 = ((local uint4*)sumJ)[0] + ((local uint4*)sumJ)[1];\n"
 		"			s1 = t1.s0 + t1.s1 + t1.s2 + t1.s3;\n"
 		"			atomic_add(&pAMat[idx1], (int)(s1*0.0625f));\n"
-		"		}\n"
+		"		}\n";
+	if (block_stats) {
+		// per entry luma sums and pixel count for the block gains solver
+		opencl_kernel_code +=
+			"		if (!lid) {\n"
+			"			uint4 stats = (uint4)0;\n"
+			"			t1 = ((local uint4*)sumI)[0] + ((local uint4*)sumI)[1]; stats.s0 = t1.s0 + t1.s1 + t1.s2 + t1.s3;\n"
+			"			t1 = ((local uint4*)sumJ)[0] + ((local uint4*)sumJ)[1]; stats.s1 = t1.s0 + t1.s1 + t1.s2 + t1.s3;\n"
+			"			t1 = ((local uint4*)sumN)[0] + ((local uint4*)sumN)[1]; stats.s2 = t1.s0 + t1.s1 + t1.s2 + t1.s3;\n"
+			"			((__global uint4 *)(pStats_buf + pStats_offs))[grp_id] = stats;\n"
+			"		}\n";
+	}
+	opencl_kernel_code +=
 		"	}\n"
 		"	}\n"
 		"}\n";
 	if (mask_image)ERROR_CHECK_STATUS(vxReleaseImage(&mask_image));
+	if (block_stats)ERROR_CHECK_STATUS(vxReleaseArray(&block_stats));
 	return VX_SUCCESS;
 }
 
@@ -428,7 +488,7 @@ vx_status exposure_comp_calcErrorFn_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.expcomp_compute_gainmatrix",
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_COMPUTE_GAINMAT,
 		exposure_comp_calcErrorFn_kernel,
-		5,
+		6,
 		exposure_comp_calcErrorFn_input_validator,
 		exposure_comp_calcErrorFn_output_validator,
 		nullptr,
@@ -447,6 +507,7 @@ vx_status exposure_comp_calcErrorFn_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_OUTPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
 	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
@@ -526,6 +587,36 @@ static vx_status VX_CALLBACK exposure_comp_applygains_input_validator(vx_node no
 		}
 		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
 	}
+	else if (index == 4)
+	{ // array object for block gains: one EXPCOMP_GAIN_BLOCK_WIDTH x EXPCOMP_GAIN_BLOCK_HEIGHT grid per camera
+		vx_image image = (vx_image)avxGetNodeParamRef(node, 0);
+		vx_array arr = (vx_array)avxGetNodeParamRef(node, 1);
+		ERROR_CHECK_OBJECT(image);
+		ERROR_CHECK_OBJECT(arr);
+		vx_uint32 width = 0, height = 0;
+		vx_size num_cam = 0, capacity = 0;
+		vx_enum itemtype = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+		ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+		ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &num_cam, sizeof(num_cam)));
+		ERROR_CHECK_STATUS(vxReleaseImage(&image));
+		ERROR_CHECK_STATUS(vxReleaseArray(&arr));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		vx_size num_blocks = num_cam ? ((width + EXPCOMP_GAIN_BLOCK_WIDTH - 1) / EXPCOMP_GAIN_BLOCK_WIDTH) * ((height / num_cam + EXPCOMP_GAIN_BLOCK_HEIGHT - 1) / EXPCOMP_GAIN_BLOCK_HEIGHT) : 0;
+		if (itemtype != VX_TYPE_FLOAT32) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation block gains array type should be float32\n");
+		}
+		else if (capacity != num_cam * num_blocks) {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation block gains array capacity should be %d\n", (int)(num_cam * num_blocks));
+		}
+		else {
+			status = VX_SUCCESS;
+		}
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+	}
 	return status;
 }
 
@@ -630,6 +721,8 @@ static vx_status VX_CALLBACK exposure_comp_applygains_opencl_codegen(
 	ERROR_CHECK_STATUS(vxQueryArray(gain_array, VX_ARRAY_ATTRIBUTE_CAPACITY, &num_cam, sizeof(num_cam)));
 	ERROR_CHECK_STATUS(vxReleaseArray(&gain_array));
 	if (!num_cam) num_cam = 1;	// has to be atleast 1
+	vx_array block_gains = (vx_array)avxGetNodeParamRef(node, 4);	// optional per block gains
+	if (block_gains) ERROR_CHECK_STATUS(vxReleaseArray(&block_gains));
 
 	// set kernel configuration
 	strcpy(opencl_kernel_function_name, "exposure_comp_apply_gains");
@@ -651,18 +744,44 @@ static vx_status VX_CALLBACK exposure_comp_applygains_opencl_codegen(
 		"{\n"
 		"	return (float4)(amd_unpack0(src), amd_unpack1(src), amd_unpack2(src), amd_unpack3(src));\n"
 		"}\n"
-		"\n"
+		"\n");
+	opencl_kernel_code = item;
+	if (block_gains) {
+		// bilinear interpolation of the block gains: gains are sampled at the block centers
+		vx_uint32 blocks_x = (input_width + EXPCOMP_GAIN_BLOCK_WIDTH - 1) / EXPCOMP_GAIN_BLOCK_WIDTH;
+		vx_uint32 blocks_y = (height_one_in + EXPCOMP_GAIN_BLOCK_HEIGHT - 1) / EXPCOMP_GAIN_BLOCK_HEIGHT;
+		sprintf(item,
+			"float4 block_gain(__global float * pBG, int x, int y)\n"
+			"{\n"
+			"	float fx = clamp(((float)x + 0.5f) * %.9ff - 0.5f, 0.0f, %d.0f);\n"
+			"	float fy = clamp(((float)y + 0.5f) * %.9ff - 0.5f, 0.0f, %d.0f);\n"
+			"	int x0 = (int)fx, y0 = (int)fy;\n"
+			"	int x1 = min(x0 + 1, %d), y1 = min(y0 + 1, %d);\n"
+			"	fx -= (float)x0; fy -= (float)y0;\n"
+			"	float g0 = mix(pBG[y0*%d + x0], pBG[y0*%d + x1], fx);\n"
+			"	float g1 = mix(pBG[y1*%d + x0], pBG[y1*%d + x1], fx);\n"
+			"	return (float4)((float3)mix(g0, g1, fy), 1.0f);\n"
+			"}\n"
+			"\n"
+			, 1.0f / EXPCOMP_GAIN_BLOCK_WIDTH, blocks_x - 1, 1.0f / EXPCOMP_GAIN_BLOCK_HEIGHT, blocks_y - 1, blocks_x - 1, blocks_y - 1
+			, blocks_x, blocks_x, blocks_x, blocks_x);
+		opencl_kernel_code += item;
+		sprintf(item, "#define BLOCK_GAINS_PER_CAM %d\n\n", blocks_x * blocks_y);
+		opencl_kernel_code += item;
+	}
+	sprintf(item,
 		"__kernel __attribute__((reqd_work_group_size(%d, %d, 1)))\n"
 		"void %s(uint pIn_width, uint pIn_height, __global uchar * pIn_buf, uint pIn_stride, uint pIn_offset,\n"
 		"        __global uchar * pG_buf, uint pG_offs, uint pG_num,\n"
 		"        __global uchar * pExpData_buf, uint pExpData_offset, uint pExpData_num,\n"
-		"        uint pOut_width, uint pOut_height, __global uchar * pOut_buf, uint pOut_stride, uint pOut_offset)\n"
+		"        uint pOut_width, uint pOut_height, __global uchar * pOut_buf, uint pOut_stride, uint pOut_offset%s)\n"
 		"{\n"
 		"	int grp_id = get_global_id(0)>>4;\n"
 		"   if (grp_id < pExpData_num) {\n"
 		"	uint2 size = (uint2)((pIn_stride*%d), (pOut_stride*%d));\n"
-		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name, height_one_in, height_one_out);
-		opencl_kernel_code = item;
+		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name
+		, block_gains ? ",\n        __global uchar * pBG_buf, uint pBG_offs, uint pBG_num" : "", height_one_in, height_one_out);
+		opencl_kernel_code += item;
 		opencl_kernel_code +=
 				"	uint2 offs = ((__global uint2 *)(pExpData_buf+pExpData_offset))[grp_id];\n"
 				"	pG_buf += pG_offs; int cam_id = offs.s0&0x3f;\n"
@@ -678,7 +797,21 @@ static vx_status VX_CALLBACK exposure_comp_applygains_opencl_codegen(
 				"	uint8 r0, r1; float4 f4;\n"
 				"	float4 g4 = (float4)((float3)g, (float)1.0f);\n"
 				"	r0 =  *(__global uint8 *)pIn_buf;\n"
-				"	r1 =  *(__global uint8 *)(pIn_buf+pIn_stride);\n"
+				"	r1 =  *(__global uint8 *)(pIn_buf+pIn_stride);\n";
+	if (block_gains) {
+		// per pixel gain factor: the block gains already include the camera gain
+		opencl_kernel_code +=
+				"	__global float * pBG = (__global float *)(pBG_buf + pBG_offs) + cam_id*BLOCK_GAINS_PER_CAM;\n"
+				"	int px = gx<<3, py = gy<<1;\n";
+		for (int row = 0; row < 2; row++) {
+			for (int k = 0; k < 8; k++) {
+				sprintf(item, "	f4 = amd_unpack(r%d.s%d)*block_gain(pBG, px+%d, py+%d); r%d.s%d = amd_pack(f4); \n", row, k, k, row, row, k);
+				opencl_kernel_code += item;
+			}
+		}
+	}
+	else {
+		opencl_kernel_code +=
 				"	f4 = amd_unpack(r0.s0)*g4; r0.s0 = amd_pack(f4); \n"
 				"	f4 = amd_unpack(r0.s1)*g4; r0.s1 = amd_pack(f4); \n"
 				"	f4 = amd_unpack(r0.s2)*g4; r0.s2 = amd_pack(f4); \n"
@@ -694,7 +827,9 @@ static vx_status VX_CALLBACK exposure_comp_applygains_opencl_codegen(
 				"	f4 = amd_unpack(r1.s4)*g4; r1.s4 = amd_pack(f4); \n"
 				"	f4 = amd_unpack(r1.s5)*g4; r1.s5 = amd_pack(f4); \n"
 				"	f4 = amd_unpack(r1.s6)*g4; r1.s6 = amd_pack(f4); \n"
-				"	f4 = amd_unpack(r1.s7)*g4; r1.s7 = amd_pack(f4); \n"
+				"	f4 = amd_unpack(r1.s7)*g4; r1.s7 = amd_pack(f4); \n";
+	}
+	opencl_kernel_code +=
 				"	*(__global uint8 *)(pOut_buf) = r0;\n"
 				"	*(__global uint8 *)(pOut_buf+pOut_stride) = r1;\n"
 				"}\n"
@@ -710,7 +845,7 @@ vx_status exposure_comp_applygains_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.expcomp_applygains",
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_APPLYGAINS,
 		exposure_comp_applygains_kernel,
-		4,
+		5,
 		exposure_comp_applygains_input_validator,
 		exposure_comp_applygains_output_validator,
 		nullptr,
@@ -727,6 +862,7 @@ vx_status exposure_comp_applygains_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
 	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
@@ -799,6 +935,36 @@ static vx_status VX_CALLBACK exposure_comp_solvegains_input_validator(vx_node no
 			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve matrix data types are not valid\n");
 		}
 	}
+	else if (index == 5)
+	{ // scalar of type VX_TYPE_UINT32: number of gain blocks per row
+		vx_enum type = VX_TYPE_INVALID;
+		vx_uint32 width = 0;
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &type, sizeof(type)));
+		if (type == VX_TYPE_UINT32) {
+			ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)ref, &width));
+		}
+		if (type != VX_TYPE_UINT32 || !width) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve block gain width should be a non-zero uint32 scalar\n");
+		}
+		else {
+			status = VX_SUCCESS;
+		}
+		ERROR_CHECK_STATUS(vxReleaseScalar((vx_scalar *)&ref));
+	}
+	else if (index == 6 || index == 7)
+	{ // array of StitchOverlapPixelEntry and StitchExpCompBlockStats
+		vx_size itemsize = 0;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+		if (itemsize == (index == 6 ? sizeof(StitchOverlapPixelEntry) : sizeof(StitchExpCompBlockStats))) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve block stats array item size is not valid\n");
+		}
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+	}
 	return status;
 }
 
@@ -826,6 +992,96 @@ static vx_status VX_CALLBACK exposure_comp_solvegains_output_validator(vx_node n
 			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve array type are not valid\n");
 		}
 	}
+	else if (index == 8)
+	{ // array of format float32: block gains of each camera
+		vx_array arr = (vx_array)avxGetNodeParamRef(node, index);
+		vx_enum itemtype = VX_TYPE_INVALID;
+		vx_size capacity = 0, num_cameras = 0;
+		vx_uint32 width = 0;
+		ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+		ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&arr));
+		vx_array gains = (vx_array)avxGetNodeParamRef(node, 4);
+		ERROR_CHECK_OBJECT(gains);
+		ERROR_CHECK_STATUS(vxQueryArray(gains, VX_ARRAY_ATTRIBUTE_CAPACITY, &num_cameras, sizeof(num_cameras)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&gains));
+		vx_scalar scalar = (vx_scalar)avxGetNodeParamRef(node, 5);
+		if (scalar) {
+			ERROR_CHECK_STATUS(vxReadScalarValue(scalar, &width));
+			ERROR_CHECK_STATUS(vxReleaseScalar(&scalar));
+		}
+		if (itemtype != VX_TYPE_FLOAT32) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve block gains array type should be float32\n");
+		}
+		else if (!width || !num_cameras || (capacity % (num_cameras * width)) != 0 || capacity < num_cameras * width) {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: exp_comp_solve block gains array capacity should be a multiple of num_cameras x block gain width\n");
+		}
+		else {
+			ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
+			ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+			status = VX_SUCCESS;
+		}
+	}
+	return status;
+}
+
+//! \brief The exposure_comp_solvegains node local data: solver and matrix buffers allocated once at initialize.
+struct exp_comp_solvegains_data {
+	CExpCompensator * exp_comp;
+	vx_uint32 * pIMat;
+	vx_uint32 * pNMat;
+	vx_size rows, columns;
+};
+
+//! \brief The kernel initialize.
+static vx_status VX_CALLBACK exposure_comp_solvegains_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size columns = 0, rows = 0, capacity = 0;
+	ERROR_CHECK_STATUS(vxQueryMatrix((vx_matrix)parameters[2], VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns)));
+	ERROR_CHECK_STATUS(vxQueryMatrix((vx_matrix)parameters[2], VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows)));
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[4], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+	if (!capacity) return VX_ERROR_INVALID_DIMENSION;
+	exp_comp_solvegains_data * data = new exp_comp_solvegains_data;
+	data->exp_comp = new CExpCompensator();
+	data->pIMat = new vx_uint32[rows*columns];
+	data->pNMat = new vx_uint32[rows*columns];
+	data->rows = rows;
+	data->columns = columns;
+	ERROR_CHECK_STATUS(data->exp_comp->InitializeSolver((vx_uint32)capacity));
+	if (num > 8 && parameters[5] && parameters[8]) {
+		// block gains mode: grid of EXPCOMP_GAIN_BLOCK_WIDTH x EXPCOMP_GAIN_BLOCK_HEIGHT blocks per camera
+		vx_uint32 blocks_x = 0;
+		vx_size num_block_gains = 0;
+		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[5], &blocks_x));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[8], VX_ARRAY_ATTRIBUTE_CAPACITY, &num_block_gains, sizeof(num_block_gains)));
+		vx_uint32 blocks_y = (vx_uint32)(num_block_gains / (capacity * blocks_x));
+		ERROR_CHECK_STATUS(data->exp_comp->InitializeBlockSolver((vx_uint32)capacity, blocks_x, blocks_y, EXPCOMP_GAIN_BLOCK_WIDTH, EXPCOMP_GAIN_BLOCK_HEIGHT));
+	}
+	vx_size size = sizeof(exp_comp_solvegains_data);
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK exposure_comp_solvegains_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_status status = VX_FAILURE;
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(exp_comp_solvegains_data)))
+	{
+		exp_comp_solvegains_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) {
+			status = data->exp_comp->DeInitialize();
+			delete data->exp_comp;
+			delete[] data->pIMat;
+			delete[] data->pNMat;
+			delete data;
+		}
+	}
 	return status;
 }
 
@@ -833,9 +1089,12 @@ static vx_status VX_CALLBACK exposure_comp_solvegains_kernel(vx_node node, const
 {
 	vx_status status = VX_FAILURE;
 	vx_float32 alpha = 0, beta = 0;
-	vx_uint32 *pIMat, *pNMat;
 	vx_uint32 numCameras;
-	CExpCompensator* exp_comp = new CExpCompensator();
+	exp_comp_solvegains_data * data = nullptr;
+	vx_size size = 0;
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	if (!data || size != sizeof(exp_comp_solvegains_data)) return VX_FAILURE;
 	vx_scalar scalar = (vx_scalar)parameters[0];
 	ERROR_CHECK_STATUS(vxReadScalarValue(scalar, &alpha));
 	scalar = (vx_scalar)parameters[1];
@@ -844,13 +1103,13 @@ static vx_status VX_CALLBACK exposure_comp_solvegains_kernel(vx_node node, const
 	vx_matrix mat = (vx_matrix)parameters[2];
 	ERROR_CHECK_STATUS(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns)));
 	ERROR_CHECK_STATUS(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows)));
-	pIMat = new vx_uint32[rows*columns];
-	ERROR_CHECK_STATUS(vxReadMatrix(mat, (void *)pIMat));
+	if (rows*columns > data->rows*data->columns) return VX_ERROR_INVALID_DIMENSION;
+	ERROR_CHECK_STATUS(vxReadMatrix(mat, (void *)data->pIMat));
 	mat = (vx_matrix)parameters[3];
 	ERROR_CHECK_STATUS(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns)));
 	ERROR_CHECK_STATUS(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows)));
-	pNMat = new vx_uint32[rows*columns];
-	ERROR_CHECK_STATUS(vxReadMatrix(mat, (void *)pNMat));
+	if (rows*columns > data->rows*data->columns) return VX_ERROR_INVALID_DIMENSION;
+	ERROR_CHECK_STATUS(vxReadMatrix(mat, (void *)data->pNMat));
 	// get output array pointer
 	vx_array arr = (vx_array)parameters[4];
 	// set the capacity and item_type of the array
@@ -861,18 +1120,32 @@ static vx_status VX_CALLBACK exposure_comp_solvegains_kernel(vx_node node, const
 	if (itemtype != VX_TYPE_FLOAT32) {
 		status = VX_ERROR_INVALID_TYPE;
 		vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation_gain array type should be of float32\n");
+		return status;
 	}
 	else if (!capacity) {
 		status = VX_ERROR_INVALID_DIMENSION;
 		vxAddLogEntry((vx_reference)node, status, "ERROR: exposure_compensation_gain array capacity not enough\n");
+		return status;
 	}
 	numCameras = (vx_uint32)capacity;
-	vx_size stride = 0;
-	void *base = NULL;
-	status = exp_comp->SolveForGains(alpha, beta, pIMat, pNMat, numCameras, arr, (vx_uint32)rows, (vx_uint32)columns);
-	delete pIMat;
-	delete pNMat;
-	delete exp_comp;
+	status = data->exp_comp->SolveForGains(alpha, beta, data->pIMat, data->pNMat, numCameras, arr, (vx_uint32)rows, (vx_uint32)columns);
+	if (status == VX_SUCCESS && num > 8 && parameters[6] && parameters[7] && parameters[8]) {
+		// block gains from the per overlap entry statistics, regularized towards the camera gains
+		vx_array arr_entries = (vx_array)parameters[6], arr_stats = (vx_array)parameters[7];
+		vx_size num_entries = 0, num_stats = 0, stride_entries = sizeof(StitchOverlapPixelEntry), stride_stats = sizeof(StitchExpCompBlockStats);
+		ERROR_CHECK_STATUS(vxQueryArray(arr_entries, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_entries, sizeof(num_entries)));
+		ERROR_CHECK_STATUS(vxQueryArray(arr_stats, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_stats, sizeof(num_stats)));
+		num_entries = std::min(num_entries, num_stats);
+		if (num_entries > 0) {
+			StitchOverlapPixelEntry * pEntries = nullptr;
+			StitchExpCompBlockStats * pStats = nullptr;
+			ERROR_CHECK_STATUS(vxAccessArrayRange(arr_entries, 0, num_entries, &stride_entries, (void **)&pEntries, VX_READ_ONLY));
+			ERROR_CHECK_STATUS(vxAccessArrayRange(arr_stats, 0, num_entries, &stride_stats, (void **)&pStats, VX_READ_ONLY));
+			status = data->exp_comp->SolveForBlockGains(alpha, beta, pEntries, pStats, num_entries, (vx_array)parameters[8]);
+			ERROR_CHECK_STATUS(vxCommitArrayRange(arr_stats, 0, num_entries, pStats));
+			ERROR_CHECK_STATUS(vxCommitArrayRange(arr_entries, 0, num_entries, pEntries));
+		}
+	}
 	return status;
 }
 
@@ -883,11 +1156,11 @@ vx_status exposure_comp_solvegains_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.expcomp_solvegains",
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_SOLVE,
 		exposure_comp_solvegains_kernel,
-		5,
+		9,
 		exposure_comp_solvegains_input_validator,
 		exposure_comp_solvegains_output_validator,
-		nullptr,
-		nullptr);
+		exposure_comp_solvegains_initialize,
+		exposure_comp_solvegains_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	// set kernel parameters
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
@@ -895,6 +1168,10 @@ vx_status exposure_comp_solvegains_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 8, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
 	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
@@ -21,13 +21,20 @@ THE SOFTWARE.
 */
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "projection.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
+#include <vector>
+#include <atomic>
+#include <thread>
 
 //Developer Debug Variables
 #define INITIALIZE_STITCH_DEBUG 0
 
+//! \brief The number of output rows per warp table work item (multiple of 8 so that no remap entry spans two bands).
+#define INITIALIZE_STITCH_BAND_HEIGHT 32
+
 //! \brief The local data to calculate the overlapping images.
 #define MAX_CAM_OVERLAP 6
 struct stitch_init_data {
@@ -36,36 +43,42 @@ struct stitch_init_data {
 	float Z_value[MAX_CAM_OVERLAP];
 };
 
-//! \brief Function to Compute M.
-static void ComputeM(float * M, float th, float fi, float sy)
-{
-	float sth = sinf(th), cth = cosf(th);
-	float sfi = sinf(fi), cfi = cosf(fi);
-	float ssy = sinf(sy), csy = cosf(sy);
-	M[0] = sth*ssy*sfi + cth*csy; M[1] = ssy*cfi; M[2] = cth*ssy*sfi - sth*csy;
-	M[3] = sth*csy*sfi - cth*ssy; M[4] = csy*cfi; M[5] = cth*csy*sfi + sth*ssy;
-	M[6] = sth    *cfi;          M[7] = -sfi;     M[8] = cth    *cfi;
-}
+//! \brief The equirectangular pixel covered by a camera.
+struct stitch_init_footprint {
+	vx_uint32 ID;
+	float Z_value;
+};
 
-//! \brief Matix Multiplication Function.
-static void MatMul3x3(float * C, const float * A, const float * B)
-{
-	const float * At = A;
-	for (int i = 0; i < 3; i++, At += 3) {
-		const float * Bt = B;
-		for (int j = 0; j < 3; j++, Bt++, C++) {
-			*C = At[0] * Bt[0] + At[1] * Bt[3] + At[2] * Bt[6];
-		}
-	}
-}
+//! \brief The warp tables and footprint of a camera kept across executions.
+struct stitch_init_camera_cache {
+	bool valid = false;                                  // true if the tables below match par
+	camera_params par;                                   // camera parameters used to compute the tables
+	vx_rectangle_t rect;                                 // valid region of the camera in the output
+	std::vector<StitchValidPixelEntry> valid_entry;      // warp valid pixel entries of the camera
+	std::vector<StitchWarpRemapEntry> remap_entry;       // warp remap entries of the camera
+	std::vector<stitch_init_footprint> footprint;        // valid pixels of the camera
+	std::vector<stitch_init_footprint> padding;          // multiband reflect/replicate pixels of the camera
+	vx_size upload_offset = 0, upload_count = 0;         // position of the camera entries in the warp arrays
+};
 
-//! \brief Matix Multiplication Function.
-static void MatMul3x1(float * Y, const float * M, const float * X)
-{
-	Y[0] = M[0] * X[0] + M[1] * X[1] + M[2] * X[2];
-	Y[1] = M[3] * X[0] + M[4] * X[1] + M[5] * X[2];
-	Y[2] = M[6] * X[0] + M[7] * X[1] + M[8] * X[2];
-}
+//! \brief The warp tables and footprint of a band of rows of a camera.
+struct stitch_init_warp_band {
+	int cam, y_start, y_end;                             // camera and rows of the band
+	int min_x, max_x, min_y, max_y;                      // valid region of the band in the output
+	std::vector<StitchValidPixelEntry> valid_entry;      // warp valid pixel entries of the band
+	std::vector<StitchWarpRemapEntry> remap_entry;       // warp remap entries of the band
+	std::vector<stitch_init_footprint> footprint;        // valid pixels of the band
+	std::vector<stitch_init_footprint> padding;          // multiband reflect/replicate pixels of the band
+};
+
+//! \brief The local data to re-initialize only the cameras with updated parameters.
+struct stitch_init_cache {
+	rig_params rig_par;                                  // rig parameters used to compute the camera tables
+	vx_uint32 config[7];                                 // buffer configuration used to compute the camera tables
+	std::vector<stitch_init_camera_cache> camera;        // per camera tables
+	bool uploaded = false;                               // true if the warp arrays hold the cached tables
+	vx_size upload_count = 0;                            // number of entries in the warp arrays
+};
 
 //! \brief The validator callback.
 static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_meta_format metas[])
@@ -256,16 +269,14 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 		SeamFindSizeInfo size_var_1;	vx_uint32 mode_1 = 2;
 		vx_uint32 src_width = (cam_buffer_width / num_buff_cols);
 		vx_uint32 src_height = (cam_buffer_height / num_buff_rows);
-		ERROR_CHECK_STATUS(seamfind_accurate_utility(mode_1, num_cam, src_width, src_height, width_eqr, (vx_matrix)parameters[5], (vx_array)parameters[6], &size_var_1));
+		ERROR_CHECK_STATUS(seamfind_accurate_utility(mode_1, num_cam, num_buff_cols, src_width, src_height, width_eqr, (vx_matrix)parameters[5], (vx_array)parameters[6], &size_var_1));
 		printf("Valid:%d, weight:%d, Accum:%d, Pref:Info:%d, Path:%d\n", size_var_1.valid_entry, size_var_1.weight_entry, size_var_1.accum_entry, size_var_1.pref_entry, size_var_1.path_entry);
 	}
 #endif
-	//get seamfind variable sizes from the utility functiion
-	SeamFindSizeInfo size_var;	vx_uint32 mode = 0;
+	// seamfind arrays are sized by the application (see seamfind_accurate_utility)
 	// seamfind valid pixel array
 	if (parameters[21]) {
-		ERROR_CHECK_STATUS(seamfind_utility(mode, width_eqr, num_cam, &size_var));
-		capacity = size_var.valid_entry;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[21], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 		type = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[21], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[21], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
@@ -279,13 +290,13 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 	}
 	// seamfind edge accumulate array.
 	if (parameters[22]) {
-		capacity = size_var.accum_entry;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[22], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 		type = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[22], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[22], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
 		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[22], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
 		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[22], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
-		if (size != sizeof(StitchSeamFindAccumEntry)) {
+		if (size != sizeof(vx_int32)) {
 			vx_status status = VX_ERROR_INVALID_TYPE;
 			vxAddLogEntry((vx_reference)node, status, "ERROR: initialize_stitch_config: seamfind edge accumulate array type is not valid\n");
 			return status;
@@ -293,7 +304,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 	}
 	// seamfind valid weight array
 	if (parameters[23]) {
-		capacity = size_var.weight_entry;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[23], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 		type = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[23], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[23], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
@@ -307,7 +318,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 	}
 	// seamfind preference array
 	if (parameters[24]) {
-		capacity = size_var.pref_entry;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[24], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 		type = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[24], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[24], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
@@ -321,7 +332,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 	}
 	// seamfind Info array
 	if (parameters[25]) {
-		capacity = size_var.info_entry;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[25], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 		type = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[25], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[25], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
@@ -347,10 +358,298 @@ static vx_status VX_CALLBACK initialize_stitch_config_validate(vx_node node, con
 		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[26], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
 		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[26], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
 	}
+	// seamfind edge accumulate parent array
+	if (parameters[27]) {
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[27], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		type = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[27], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[27], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+		if (size != sizeof(vx_uint8)) {
+			vx_status status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: initialize_stitch_config: seamfind edge accumulate parent array type is not valid\n");
+			return status;
+		}
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[27], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[27], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+	}
+	// seamfind cost generate tile array
+	if (parameters[28]) {
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[28], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+		type = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[28], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[28], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+		if (size != sizeof(StitchSeamFindCostTile)) {
+			vx_status status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: initialize_stitch_config: seamfind cost tile array type is not valid\n");
+			return status;
+		}
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[28], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[28], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+	}
 
 	return VX_SUCCESS;
 }
 
+//! \brief Function to compute the warp tables and footprint of a band of rows of a camera.
+static void Compute_StitchWarpBandEntry(stitch_init_warp_band * band, const camera_params * par, const stitch_projection_camera * proj,
+	const stitch_projection_columns * columns, vx_uint32 num_buff_cols, vx_uint32 cam_buffer_width, int src_width, int height,
+	vx_uint32 width_eqr, vx_uint32 height_eqr, vx_int32 padding_depth, vx_int32 MODE_REFLECT, vx_int32 MODE_REPLICATE)
+{
+	vx_uint32 widthDst = width_eqr, heightDstCamera = height_eqr;
+	int cam = band->cam;
+	int min_x = widthDst, max_x = 0, min_y = heightDstCamera, max_y = 0;
+	int bit_counter = 0, empty_set = 0;
+	int src_width_start = ((cam % num_buff_cols) * src_width);
+	int src_width_end = (((cam % num_buff_cols) + 1) * src_width) - 1;
+	StitchValidPixelEntry valid_entry = { 0 };
+	StitchWarpRemapEntry remap_entry;
+	vx_size padded_width = columns->sin_te.size();
+	std::vector<float> row_xd(padded_width), row_yd(padded_width), row_rr(padded_width), row_z(padded_width);
+
+	band->valid_entry.clear();
+	band->remap_entry.clear();
+	band->footprint.clear();
+	band->padding.clear();
+
+	for (int y = band->y_start; y < band->y_end; y++)
+	{
+		stitchProjectRow(proj, columns, y, &row_xd[0], &row_yd[0], &row_rr[0], &row_z[0]);
+		for (int x = 0; x < (int)width_eqr; x++)
+		{
+			bit_counter++;
+			float xd = row_xd[x], yd = row_yd[x], rr = row_rr[x];
+			float z = row_z[x];
+
+			if (z > 0.0f)
+			{
+				if (xd >= src_width_start && xd < src_width_end && yd >= 0 && yd < height - 1 && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
+				{
+					if (x < min_x)	min_x = x;	if (x > max_x)	max_x = x;
+					if (y < min_y)	min_y = y;	if (y > max_y)	max_y = y;
+
+					stitch_init_footprint pixel = { (vx_uint32)((y * widthDst) + x), z };
+					band->footprint.push_back(pixel);
+				}
+				else if (MODE_REFLECT && ((xd >= src_width_start - padding_depth) && (xd < src_width_end + padding_depth) && (yd >= -padding_depth && yd < height + padding_depth)) && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
+				{
+					if (xd < src_width_start) xd = abs((src_width_start - xd) + src_width_start);
+					else  if (ceil(xd) >= src_width_end) xd = src_width_end - (xd - src_width_end);
+
+					if (yd < 0) yd = abs(yd);
+					else if (ceil(yd) >= height) yd = (height - 1) - (yd - (height - 1));
+
+					stitch_init_footprint pixel = { (vx_uint32)((y * widthDst) + x), z };
+					band->padding.push_back(pixel);
+				}
+				else if (MODE_REPLICATE && (xd >= src_width_start - padding_depth && xd < src_width_end + padding_depth) && (yd >= -padding_depth && yd < height + padding_depth) && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
+				{
+					if (xd < src_width_start) xd = (float)src_width_start;
+					else  if (ceil(xd) >= src_width_end) xd = (float)src_width_end;
+
+					if (yd < 0) yd = 0;
+					else if (ceil(yd) >= height) yd = (float)(height - 1);
+
+					stitch_init_footprint pixel = { (vx_uint32)((y * widthDst) + x), z };
+					band->padding.push_back(pixel);
+				}
+				else
+				{
+					xd = -1; yd = -1;
+				}
+			}
+			else { xd = -1; yd = -1; }
+			/***********************************************************************************************************************************
+			Enter the xd & yd values calulated into warp data structure in Q13.3 format
+			************************************************************************************************************************************/
+			vx_uint16 bit_var_x = (vx_uint16)xd;
+			vx_uint16 bit_var_y = (vx_uint16)yd;
+
+			if (xd >= 0 && xd < (cam_buffer_width + padding_depth) && yd >= 0 && yd < height + padding_depth)
+			{
+				//Q13.3 format
+				bit_var_x = (bit_var_x << 3);
+				bit_var_y = (bit_var_y << 3);
+				//X fractional Value
+				float rem_x = xd - int(xd);
+				if (rem_x >= 0.125 && rem_x < 0.25) bit_var_x = bit_var_x | 0x0001;
+				if (rem_x >= 0.25 && rem_x < 0.375) bit_var_x = bit_var_x | 0x0002;
+				if (rem_x >= 0.375 && rem_x < 0.5)  bit_var_x = bit_var_x | 0x0003;
+				if (rem_x >= 0.5 && rem_x < 0.625)  bit_var_x = bit_var_x | 0x0004;
+				if (rem_x >= 0.625 && rem_x < 0.750)bit_var_x = bit_var_x | 0x0005;
+				if (rem_x >= 0.750 && rem_x < 0.875)bit_var_x = bit_var_x | 0x0006;
+				if (rem_x >= 0.875 && rem_x < 1.0)  bit_var_x = bit_var_x | 0x0007;
+				//y fractional Value
+				float rem_y = yd - int(yd);
+				if (rem_y >= 0.125 && rem_y < 0.25) bit_var_y = bit_var_y | 0x0001;
+				if (rem_y >= 0.25 && rem_y < 0.375) bit_var_y = bit_var_y | 0x0002;
+				if (rem_y >= 0.375 && rem_y < 0.5)  bit_var_y = bit_var_y | 0x0003;
+				if (rem_y >= 0.5 && rem_y < 0.625)  bit_var_y = bit_var_y | 0x0004;
+				if (rem_y >= 0.625 && rem_y < 0.750)bit_var_y = bit_var_y | 0x0005;
+				if (rem_y >= 0.750 && rem_y < 0.875)bit_var_y = bit_var_y | 0x0006;
+				if (rem_y >= 0.875 && rem_y < 1.0)  bit_var_y = bit_var_y | 0x0007;
+				//Check if there is a Valid Pixel in the set
+				empty_set++;
+			}
+
+			if (bit_counter == 1)
+			{
+				memset(&remap_entry, 0xff, sizeof(remap_entry));
+				valid_entry.camId = cam;
+				valid_entry.reserved0 = 0;
+				valid_entry.dstX = x >> 3;
+				valid_entry.dstY = y;
+				valid_entry.allValid = 1;
+				remap_entry.srcX0 = bit_var_x;
+				remap_entry.srcY0 = bit_var_y;
+			}
+			else if (bit_counter == 2)
+			{
+				remap_entry.srcX1 = bit_var_x;
+				remap_entry.srcY1 = bit_var_y;
+			}
+			else if (bit_counter == 3)
+			{
+				remap_entry.srcX2 = bit_var_x;
+				remap_entry.srcY2 = bit_var_y;
+			}
+			else if (bit_counter == 4)
+			{
+				remap_entry.srcX3 = bit_var_x;
+				remap_entry.srcY3 = bit_var_y;
+			}
+			else if (bit_counter == 5)
+			{
+				remap_entry.srcX4 = bit_var_x;
+				remap_entry.srcY4 = bit_var_y;
+			}
+			else if (bit_counter == 6)
+			{
+				remap_entry.srcX5 = bit_var_x;
+				remap_entry.srcY5 = bit_var_y;
+			}
+			else if (bit_counter == 7)
+			{
+				remap_entry.srcX6 = bit_var_x;
+				remap_entry.srcY6 = bit_var_y;
+			}
+			else if (bit_counter == 8)
+			{
+				remap_entry.srcX7 = bit_var_x;
+				remap_entry.srcY7 = bit_var_y;
+
+				bit_counter = 0;
+				if (empty_set != 0) {
+					band->valid_entry.push_back(valid_entry);
+					band->remap_entry.push_back(remap_entry);
+				}
+				empty_set = 0;
+			}
+		}
+	}
+	if (bit_counter != 0) {
+		band->valid_entry.push_back(valid_entry);
+		band->remap_entry.push_back(remap_entry);
+	}
+
+	band->min_x = min_x; band->max_x = max_x;
+	band->min_y = min_y; band->max_y = max_y;
+}
+
+//! \brief Function to overwrite a range of array items in place.
+template <typename T>
+static vx_status Write_StitchArrayRange(vx_array arr, vx_size start, const std::vector<T>& items)
+{
+	if (items.empty()) return VX_SUCCESS;
+	vx_size end = start + items.size(), stride = sizeof(T);
+	vx_uint8 * ptr = nullptr;
+	ERROR_CHECK_STATUS(vxAccessArrayRange(arr, start, end, &stride, (void **)&ptr, VX_WRITE_ONLY));
+	for (vx_size i = 0; i < items.size(); i++)
+		memcpy(ptr + i * stride, &items[i], sizeof(T));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, start, end, ptr));
+	return VX_SUCCESS;
+}
+
+//! \brief Function to get the capacity of an optional array, or the default when the array is not present.
+static vx_size Get_StitchArrayCapacity(vx_array arr, vx_size default_capacity)
+{
+	vx_size capacity = 0;
+	if (!arr || vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)) != VX_SUCCESS)
+		return default_capacity;
+	return capacity;
+}
+
+//! \brief Function to compute the list of seamfind cost tiles covering the overlap rectangles of every camera pair.
+// The cost generated one pixel around an overlap is used by the accumulate, so the rectangles are grown by one pixel.
+static vx_status Compute_StitchSeamFindCostTiles(vx_array arr_tiles, const vx_rectangle_t * overlap_roi, vx_uint32 num_cam, vx_uint32 width_eqr, vx_uint32 height_eqr)
+{
+	vx_uint32 tiles_x = (width_eqr + SEAMFIND_COST_TILE_WIDTH - 1) / SEAMFIND_COST_TILE_WIDTH;
+	vx_uint32 tiles_y = (height_eqr * num_cam + SEAMFIND_COST_TILE_HEIGHT - 1) / SEAMFIND_COST_TILE_HEIGHT;
+	std::vector<vx_uint8> covered(tiles_x * tiles_y, 0);
+	for (vx_uint32 i = 0; i < num_cam; i++) {
+		for (vx_uint32 j = i + 1; j < num_cam; j++) {
+			const vx_rectangle_t& roi = overlap_roi[i * num_cam + j];
+			if (roi.start_x > roi.end_x || roi.start_y > roi.end_y || roi.start_x >= width_eqr || roi.start_y >= height_eqr)
+				continue;
+			vx_uint32 x0 = roi.start_x > 0 ? roi.start_x - 1 : 0, x1 = std::min(roi.end_x + 1, width_eqr - 1);
+			vx_uint32 y0 = roi.start_y > 0 ? roi.start_y - 1 : 0, y1 = std::min(roi.end_y + 1, height_eqr - 1);
+			vx_uint32 cam[2] = { i, j };
+			for (int k = 0; k < 2; k++) {
+				for (vx_uint32 ty = (y0 + cam[k] * height_eqr) / SEAMFIND_COST_TILE_HEIGHT; ty <= (y1 + cam[k] * height_eqr) / SEAMFIND_COST_TILE_HEIGHT; ty++)
+					for (vx_uint32 tx = x0 / SEAMFIND_COST_TILE_WIDTH; tx <= x1 / SEAMFIND_COST_TILE_WIDTH; tx++)
+						covered[ty * tiles_x + tx] = 1;
+			}
+		}
+	}
+	// compact the covered tiles in raster order
+	std::vector<StitchSeamFindCostTile> tiles;
+	for (vx_uint32 ty = 0; ty < tiles_y; ty++) {
+		for (vx_uint32 tx = 0; tx < tiles_x; tx++) {
+			if (covered[ty * tiles_x + tx]) {
+				StitchSeamFindCostTile tile = { tx * SEAMFIND_COST_TILE_WIDTH, ty * SEAMFIND_COST_TILE_HEIGHT };
+				tiles.push_back(tile);
+			}
+		}
+	}
+	if (tiles.size() > Get_StitchArrayCapacity(arr_tiles, 0)) {
+		vxAddLogEntry((vx_reference)arr_tiles, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindCostTile has more Entries than Expected. Invalid Array Size for parameter 28\n");
+		return VX_ERROR_INVALID_DIMENSION;
+	}
+	ERROR_CHECK_STATUS(vxTruncateArray(arr_tiles, 0));
+	if (tiles.size() > 0)
+		ERROR_CHECK_STATUS(vxAddArrayItems(arr_tiles, tiles.size(), &tiles[0], sizeof(StitchSeamFindCostTile)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel initialize.
+// The camera tables are only kept in node local data when the re-initialization is enabled: otherwise
+// the kernel builds them in a cache on the stack that is released at the end of the execution.
+static vx_status VX_CALLBACK initialize_stitch_config_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	InitializeStitchAttributes attr = { 0 };
+	if (parameters[7])
+		ERROR_CHECK_STATUS(vxReadMatrix((vx_matrix)parameters[7], &attr));
+	if (!attr.reinitialize)
+		return VX_SUCCESS;
+	vx_size size = sizeof(stitch_init_cache);
+	stitch_init_cache * cache = new stitch_init_cache();
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &cache, sizeof(cache)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK initialize_stitch_config_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(stitch_init_cache)))
+	{
+		stitch_init_cache * cache = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &cache, sizeof(cache)));
+		if (cache) delete cache;
+	}
+	return VX_SUCCESS;
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
@@ -395,7 +694,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	Get InitializeStitchConfig Prefrence - Variables 7 and set default settings for seamfind
 	************************************************************************************************************************************/
 	vx_int32 SEAM_FIND = 1, SEAM_FREQUENCY = 600, SEAM_STAGGER = 1, HORIZONTAL_SEAM_PRIORITY = 1, VERTICAL_SEAM_PRIORITY = 1, SEAM_QUALITY = 1, SEAM_LOCK = 0, SEAM_FLAG = 0;
-	vx_uint32  OVERLAP_RECT = 0, MULTI_BAND = 0, NUM_BANDS = 4;
+	vx_uint32  OVERLAP_RECT = 0, MULTI_BAND = 0, NUM_BANDS = 4, MULTI_BAND_INTERIOR = 0;
 	#if !ENABLE_HORIZONTAL_SEAM 	
 	HORIZONTAL_SEAM_PRIORITY = -1;	
 	#endif
@@ -417,6 +716,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 		if (attr.seam_quality)				SEAM_QUALITY = (vx_uint32)attr.seam_quality;
 		if (attr.multi_band)				MULTI_BAND = (vx_uint32)attr.multi_band;
 		if (attr.num_bands)					NUM_BANDS = (vx_uint32)attr.num_bands;
+		if (attr.multi_band_interior)		MULTI_BAND_INTERIOR = (vx_uint32)attr.multi_band_interior;
 	}
 	//MultiBand Blend Replicate/Reflect
 	vx_int32 padding_depth = 0, MODE_REPLICATE = 0, MODE_REFLECT = 0;
@@ -465,14 +765,9 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	//Size for Variables 8 & 9
 	vx_size warp_size_arr = vx_size(ceil(((widthDst * heightDstCamera) * numCamera) / 8));;
 
-	//Variables 8 & 9 mapped to a local vector datatype
+	//Variables 8 & 9 uploaded from the per camera tables
 	vx_array arr_stitchValidPixelEntry = (vx_array)parameters[8];
-	std::vector<StitchValidPixelEntry> RemapDestination;
-	RemapDestination.resize(warp_size_arr);
-
 	vx_array arr_stitchWarpRemapEntry = (vx_array)parameters[9];
-	std::vector<StitchWarpRemapEntry> RemapEntry;
-	RemapEntry.resize(warp_size_arr);
 
 	//Internal Data Variables - Overlap Calculate Data & Valid Region Rectangles
 	std::vector<stitch_init_data> stitch_component;
@@ -505,305 +800,198 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	/***********************************************************************************************************************************
 	Generate Warp tables for each Camera using warp and lens parameters
 	************************************************************************************************************************************/
-	// pre-compute M & T of each camera
-	float * Mcam = new float[num_cam * 9];
-	float * Tcam = new float[num_cam * 3];
-	float * fcam = new float[num_cam * 2];
-	float Mr[9];
-	float deg2rad = (float)M_PI / 180.0f;
-	ComputeM(Mr, rig_par.yaw * deg2rad, rig_par.pitch * deg2rad, rig_par.roll * deg2rad);
-
+	// get the tables cached from the previous execution (if any)
+	stitch_init_cache local_cache, *cache = &local_cache;
+	vx_size cache_size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &cache_size, sizeof(cache_size)) && (cache_size == sizeof(stitch_init_cache)))
+	{
+		stitch_init_cache * node_cache = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &node_cache, sizeof(node_cache)));
+		if (node_cache) cache = node_cache;
+	}
+	// setup the projection of each camera
+	std::vector<stitch_projection_camera> proj(num_cam);
 	for (int cam = 0; cam < num_cam; cam++)
 	{
-		float Mc[9];
-		ComputeM(Mc, cam_par[cam].focal.yaw * deg2rad, cam_par[cam].focal.pitch * deg2rad, cam_par[cam].focal.roll * deg2rad);
-		MatMul3x3(&Mcam[cam * 9], Mc, Mr);
-		if (rig_par.d > 0.0f) {
-			Tcam[cam * 3 + 0] = cam_par[cam].focal.tx / rig_par.d;
-			Tcam[cam * 3 + 1] = cam_par[cam].focal.ty / rig_par.d;
-			Tcam[cam * 3 + 2] = cam_par[cam].focal.tz / rig_par.d;
-		}
-		else {
-			Tcam[cam * 3 + 0] = Tcam[cam * 3 + 1] = Tcam[cam * 3 + 2] = 0.0f;
-		}
-		if (cam_par[cam].lens.lens_type == 0) { // ptgui rectilinear
-			fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else if (cam_par[cam].lens.lens_type == 1 || cam_par[cam].lens.lens_type == 2) { // ptgui fisheye
-			fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-			if (cam_par[cam].lens.lens_type == 2 && cam_par[cam].lens.r_crop <= 0.0f)
-				vxAddLogEntry((vx_reference)array_cam, VX_ERROR_INVALID_TYPE, "WARNING: initialize_stitch_config: Camera:%d -- Circular Fisheye Lens without r_crop=%0.2f is not fully supported.\n", cam, cam_par[cam].lens.r_crop);
-		}
-		else if (cam_par[cam].lens.lens_type == 3) { // adobe rectilinear
-			fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else if (cam_par[cam].lens.lens_type == 4) { // adobe fisheye
-			fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else{ // unsupported lens
+		if (stitchProjectionSetup(&proj[cam], &rig_par, &cam_par[cam], cam, num_buff_cols, src_width, src_height) != VX_SUCCESS) { // unsupported lens
 			vxAddLogEntry((vx_reference)array_cam, VX_ERROR_INVALID_TYPE, "ERROR: initialize_stitch_config: lens_type = %d not supported [cam#%d]\n", cam_par[cam].lens.lens_type, cam);
 			return VX_ERROR_INVALID_TYPE;
 		}
+		if (cam_par[cam].lens.lens_type == ptgui_lens_fisheye_circ && cam_par[cam].lens.r_crop <= 0.0f)
+			vxAddLogEntry((vx_reference)array_cam, VX_ERROR_INVALID_TYPE, "WARNING: initialize_stitch_config: Camera:%d -- Circular Fisheye Lens without r_crop=%0.2f is not fully supported.\n", cam, cam_par[cam].lens.r_crop);
 	}
-	// compute warp pixel map
-	float pi_by_h = (float)M_PI / (float)height_eqr;
-	float width2 = (float)width * 0.5f, height2 = (float)height * 0.5f;
-	const float * T = Tcam, *M = Mcam, *f = fcam;
-	int  array_var_counter = 0; // optimized warp variable
-
-	for (int cam = 0; cam < num_cam; cam++, T += 3, M += 9, f += 2)
+	// drop the cached tables when the rig or the buffer configuration has changed
+	vx_uint32 config[7] = { num_buff_rows, num_buff_cols, cam_buffer_width, cam_buffer_height, width_eqr, (vx_uint32)padding_depth, (vx_uint32)MODE_REFLECT };
+	if (cache->camera.size() != numCamera || memcmp(&cache->rig_par, &rig_par, sizeof(rig_params)) || memcmp(cache->config, config, sizeof(config)))
 	{
-		vx_uint32 yw_offset = cam * heightDstCamera;
-		int min_x = widthDst, max_x = 0, min_y = heightDstCamera, max_y = 0;
-		int bit_counter = 0, empty_set = 0;
-		int src_width_start = ((cam % num_buff_cols) * src_width);
-		int src_width_end = (((cam % num_buff_cols) + 1) * src_width) - 1;
-		int src_camera_center = (cam_buffer_width / (2 * num_buff_cols));
-
-		for (int y = 0; y < (int)height_eqr; y++)
+		cache->camera.clear();
+		cache->camera.resize(numCamera);
+		cache->rig_par = rig_par;
+		memcpy(cache->config, config, sizeof(config));
+		cache->uploaded = false;
+	}
+	// compute warp pixel map only for the cameras with updated parameters:
+	// each camera is split into bands of rows processed by a pool of threads
+	std::vector<vx_uint8> camera_updated(numCamera, 0);
+	std::vector<stitch_init_warp_band> band;
+	for (int cam = 0; cam < num_cam; cam++)
+	{
+		stitch_init_camera_cache * camera = &cache->camera[cam];
+		if (!camera->valid || memcmp(&camera->par, &cam_par[cam], sizeof(camera_params)))
 		{
-			float pe = (float)y * pi_by_h - (float)M_PI_2;
-			float sin_pe = sinf(pe);
-			float cos_pe = cosf(pe);
-			for (int x = 0; x < (int)width_eqr; x++)
+			camera_updated[cam] = 1;
+			for (int y = 0; y < (int)height_eqr; y += INITIALIZE_STITCH_BAND_HEIGHT)
 			{
-				bit_counter++;
-				float xd, yd;
-
-				float te = (float)x * pi_by_h - (float)M_PI;
-				float sin_te = sinf(te);
-				float cos_te = cosf(te);
-				float X[3] = { sin_te*cos_pe, sin_pe, cos_te*cos_pe };
-
-				const camera_params * par = &cam_par[cam];
-				float Xt[3] = { X[0] - T[0], X[1] - T[1], X[2] - T[2] };
-				float nfactor = sqrtf(Xt[0] * Xt[0] + Xt[1] * Xt[1] + Xt[2] * Xt[2]);
-				Xt[0] /= nfactor;
-				Xt[1] /= nfactor;
-				Xt[2] /= nfactor;
-				float Y[3];
-				MatMul3x1(Y, M, Xt);
-
-				if (Y[2] > 0.0f)
-				{
-					float ph = atan2f(Y[1], Y[0]);
-					float th = asinf(sqrtf(Y[0] * Y[0] + Y[1] * Y[1]));
-					float rd = 0.0f;
-					if (par->lens.lens_type == 0)
-					{ // ptgui rectilinear
-						float a = par->lens.k1;
-						float b = par->lens.k2;
-						float c = par->lens.k3;
-						float d = 1.0f - a - b - c;
-						float r = tanf(th) * f[0];
-						rd = r * (d + r * (c + r * (b + r * a)));
-					}
-					else if (par->lens.lens_type == 1 || par->lens.lens_type == 2)
-					{ // ptgui fisheye circ
-						float a = par->lens.k1;
-						float b = par->lens.k2;
-						float c = par->lens.k3;
-						float d = 1.0f - a - b - c;
-						float r = th * f[0];
-						rd = r * (d + r * (c + r * (b + r * a)));
-					}
-					else if (par->lens.lens_type == 3)
-					{ // adobe rectilinear
-						float r = tanf(th) * f[0], r2 = r * r;
-						rd = r * (1 + r2 * (par->lens.k1 + r2 * (par->lens.k2 + r2 * par->lens.k3)));
-					}
-					else if (par->lens.lens_type == 4)
-					{ // adobe fisheye
-						float r = th * f[0], r2 = r * r;
-						rd = r * (1 + r2 * (par->lens.k1 + r2 * par->lens.k2));
-					}
-					xd = f[1] * rd * cosf(ph);
-					yd = f[1] * rd * sinf(ph);
-					float rr = sqrtf(xd*xd + yd*yd);
-
-					float du0 = par->lens.du0;
-					if (num_buff_cols > 1){ du0 += (src_camera_center + src_width_start); }
-					else{ du0 += width2; }
-
-					xd = du0 + xd;
-					yd = height2 + par->lens.dv0 + yd;
-
-					if (xd >= src_width_start && xd < src_width_end && yd >= 0 && yd < height - 1 && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
-					{
-						if (x < min_x)	min_x = x;	if (x > max_x)	max_x = x;
-						if (y < min_y)	min_y = y;	if (y > max_y)	max_y = y;
-
-						int ID = (y * widthDst) + x;
-						if (stitch_component[ID].Num_camera >= 5){
-							vxAddLogEntry((vx_reference)mask_image, VX_ERROR_INVALID_VALUE, "ERROR: initialize_stitch_config: check camera parameters, camera overlaps greater than 5 not supported in this release\n");
-							return VX_ERROR_INVALID_VALUE;
-						}
-
-						stitch_component[ID].Camera_ID[stitch_component[ID].Num_camera] = cam;
-						stitch_component[ID].Z_value[stitch_component[ID].Num_camera] = Y[2];
-						stitch_component[ID].Num_camera++;
-						// if Relection/Replicate in Multiband Mode
-						if (MULTI_BAND){
-							multiband_count_variable[ID].Camera_ID[multiband_count_variable[ID].Num_camera] = cam;
-							multiband_count_variable[ID].Z_value[multiband_count_variable[ID].Num_camera] = Y[2];
-							multiband_count_variable[ID].Num_camera++;
-						}
-						// set mask image
-						if (mask_image != NULL){
-							int MASK_ID = ((y + yw_offset)*widthDst) + x;
-							MASK_ptr[MASK_ID] = 255;
-						}
-					}
-
-					else if (MODE_REFLECT && ((xd >= src_width_start - padding_depth) && (xd < src_width_end + padding_depth) && (yd >= -padding_depth && yd < height + padding_depth)) && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
-					{
-						if (xd < src_width_start) xd = abs((src_width_start - xd) + src_width_start);
-						else  if (ceil(xd) >= src_width_end) xd = src_width_end - (xd - src_width_end);
-
-						if (yd < 0) yd = abs(yd);
-						else if (ceil(yd) >= height) yd = (height - 1) - (yd - (height - 1));
-
-						int ID = (y * widthDst) + x;
-						multiband_count_variable[ID].Camera_ID[multiband_count_variable[ID].Num_camera] = cam;
-						multiband_count_variable[ID].Z_value[multiband_count_variable[ID].Num_camera] = Y[2];
-						multiband_count_variable[ID].Num_camera++;
-					}
-					else if (MODE_REPLICATE && (xd >= src_width_start - padding_depth && xd < src_width_end + padding_depth) && (yd >= -padding_depth && yd < height + padding_depth) && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
-					{
-						if (xd < src_width_start) xd = (float)src_width_start;
-						else  if (ceil(xd) >= src_width_end) xd = (float)src_width_end;
-
-						if (yd < 0) yd = 0;
-						else if (ceil(yd) >= height) yd = (float)(height - 1);
-
-						int ID = (y * widthDst) + x;
-						multiband_count_variable[ID].Camera_ID[multiband_count_variable[ID].Num_camera] = cam;
-						multiband_count_variable[ID].Z_value[multiband_count_variable[ID].Num_camera] = Y[2];
-						multiband_count_variable[ID].Num_camera++;
-					}
-					else
-					{
-						xd = -1; yd = -1;
-					}
-				}
-				else { xd = -1; yd = -1; }
-				/***********************************************************************************************************************************
-				Enter the xd & yd values calulated into warp data structure in Q13.3 format
-				************************************************************************************************************************************/
-				vx_uint16 bit_var_x = (vx_uint16)xd;
-				vx_uint16 bit_var_y = (vx_uint16)yd;
-
-				if (xd >= 0 && xd < (cam_buffer_width + padding_depth) && yd >= 0 && yd < height + padding_depth)
-				{
-					//Q13.3 format
-					bit_var_x = (bit_var_x << 3);
-					bit_var_y = (bit_var_y << 3);
-					//X fractional Value
-					float rem_x = xd - int(xd);
-					if (rem_x >= 0.125 && rem_x < 0.25) bit_var_x = bit_var_x | 0x0001;
-					if (rem_x >= 0.25 && rem_x < 0.375) bit_var_x = bit_var_x | 0x0002;
-					if (rem_x >= 0.375 && rem_x < 0.5)  bit_var_x = bit_var_x | 0x0003;
-					if (rem_x >= 0.5 && rem_x < 0.625)  bit_var_x = bit_var_x | 0x0004;
-					if (rem_x >= 0.625 && rem_x < 0.750)bit_var_x = bit_var_x | 0x0005;
-					if (rem_x >= 0.750 && rem_x < 0.875)bit_var_x = bit_var_x | 0x0006;
-					if (rem_x >= 0.875 && rem_x < 1.0)  bit_var_x = bit_var_x | 0x0007;
-					//y fractional Value
-					float rem_y = yd - int(yd);
-					if (rem_y >= 0.125 && rem_y < 0.25) bit_var_y = bit_var_y | 0x0001;
-					if (rem_y >= 0.25 && rem_y < 0.375) bit_var_y = bit_var_y | 0x0002;
-					if (rem_y >= 0.375 && rem_y < 0.5)  bit_var_y = bit_var_y | 0x0003;
-					if (rem_y >= 0.5 && rem_y < 0.625)  bit_var_y = bit_var_y | 0x0004;
-					if (rem_y >= 0.625 && rem_y < 0.750)bit_var_y = bit_var_y | 0x0005;
-					if (rem_y >= 0.750 && rem_y < 0.875)bit_var_y = bit_var_y | 0x0006;
-					if (rem_y >= 0.875 && rem_y < 1.0)  bit_var_y = bit_var_y | 0x0007;
-					//Check if there is a Valid Pixel in the set
-					empty_set++;
-				}
+				stitch_init_warp_band item;
+				item.cam = cam;
+				item.y_start = y;
+				item.y_end = std::min(y + INITIALIZE_STITCH_BAND_HEIGHT, (int)height_eqr);
+				band.push_back(item);
+			}
+		}
+	}
+	if (band.size() > 0)
+	{
+		stitch_projection_columns columns;
+		stitchProjectionColumns(&columns, width_eqr, height_eqr);
+		std::atomic<int> next_band(0);
+		int num_bands = (int)band.size();
+		auto band_thread_func = [&]() {
+			for (int i = next_band++; i < num_bands; i = next_band++) {
+				int cam = band[i].cam;
+				Compute_StitchWarpBandEntry(&band[i], &cam_par[cam], &proj[cam], &columns,
+					num_buff_cols, cam_buffer_width, src_width, height, width_eqr, height_eqr, padding_depth, MODE_REFLECT, MODE_REPLICATE);
+			}
+		};
+		int num_threads = std::min((int)std::thread::hardware_concurrency(), num_bands);
+		std::vector<std::thread> band_thread;
+		for (int i = 1; i < num_threads; i++)
+			band_thread.push_back(std::thread(band_thread_func));
+		band_thread_func();
+		for (size_t i = 0; i < band_thread.size(); i++)
+			band_thread[i].join();
+		// merge the bands in camera and row order so that the tables match a sequential scan
+		for (size_t i = 0; i < band.size(); i++)
+		{
+			stitch_init_camera_cache * camera = &cache->camera[band[i].cam];
+			if (band[i].y_start == 0)
+			{
+				camera->valid_entry.clear(); camera->remap_entry.clear();
+				camera->footprint.clear(); camera->padding.clear();
+				camera->rect.start_x = widthDst; camera->rect.end_x = 0;
+				camera->rect.start_y = heightDstCamera; camera->rect.end_y = 0;
+				camera->par = cam_par[band[i].cam];
+				camera->valid = true;
+			}
+			camera->valid_entry.insert(camera->valid_entry.end(), band[i].valid_entry.begin(), band[i].valid_entry.end());
+			camera->remap_entry.insert(camera->remap_entry.end(), band[i].remap_entry.begin(), band[i].remap_entry.end());
+			camera->footprint.insert(camera->footprint.end(), band[i].footprint.begin(), band[i].footprint.end());
+			camera->padding.insert(camera->padding.end(), band[i].padding.begin(), band[i].padding.end());
+			if (band[i].min_x < (int)camera->rect.start_x) camera->rect.start_x = band[i].min_x;
+			if (band[i].max_x > (int)camera->rect.end_x) camera->rect.end_x = band[i].max_x;
+			if (band[i].min_y < (int)camera->rect.start_y) camera->rect.start_y = band[i].min_y;
+			if (band[i].max_y > (int)camera->rect.end_y) camera->rect.end_y = band[i].max_y;
+		}
+	}
 
-				if (bit_counter == 1)
-				{
-					RemapDestination[array_var_counter].camId = cam;
-					RemapDestination[array_var_counter].reserved0 = 0;
-					RemapDestination[array_var_counter].dstX = x >> 3;
-					RemapDestination[array_var_counter].dstY = y;
-					RemapDestination[array_var_counter].allValid = 1;
-					RemapEntry[array_var_counter].srcX0 = bit_var_x;
-					RemapEntry[array_var_counter].srcY0 = bit_var_y;
-				}
-				else if (bit_counter == 2)
-				{
-					RemapEntry[array_var_counter].srcX1 = bit_var_x;
-					RemapEntry[array_var_counter].srcY1 = bit_var_y;
-				}
-				else if (bit_counter == 3)
-				{
-					RemapEntry[array_var_counter].srcX2 = bit_var_x;
-					RemapEntry[array_var_counter].srcY2 = bit_var_y;
-				}
-				else if (bit_counter == 4)
-				{
-					RemapEntry[array_var_counter].srcX3 = bit_var_x;
-					RemapEntry[array_var_counter].srcY3 = bit_var_y;
-				}
-				else if (bit_counter == 5)
-				{
-					RemapEntry[array_var_counter].srcX4 = bit_var_x;
-					RemapEntry[array_var_counter].srcY4 = bit_var_y;
-				}
-				else if (bit_counter == 6)
-				{
-					RemapEntry[array_var_counter].srcX5 = bit_var_x;
-					RemapEntry[array_var_counter].srcY5 = bit_var_y;
-				}
-				else if (bit_counter == 7)
-				{
-					RemapEntry[array_var_counter].srcX6 = bit_var_x;
-					RemapEntry[array_var_counter].srcY6 = bit_var_y;
-				}
-				else if (bit_counter == 8)
-				{
-					RemapEntry[array_var_counter].srcX7 = bit_var_x;
-					RemapEntry[array_var_counter].srcY7 = bit_var_y;
+	// merge the camera footprints into the overlap data and mask image
+	for (int cam = 0; cam < num_cam; cam++)
+	{
+		const stitch_init_camera_cache * camera = &cache->camera[cam];
+		vx_uint32 mask_offset = cam * widthDst * heightDstCamera;
+		for (size_t k = 0; k < camera->footprint.size(); k++)
+		{
+			vx_uint32 ID = camera->footprint[k].ID;
+			if (stitch_component[ID].Num_camera >= 5){
+				vxAddLogEntry((vx_reference)mask_image, VX_ERROR_INVALID_VALUE, "ERROR: initialize_stitch_config: check camera parameters, camera overlaps greater than 5 not supported in this release\n");
+				return VX_ERROR_INVALID_VALUE;
+			}
 
-					bit_counter = 0;
-					if (empty_set != 0)	array_var_counter++;
-					empty_set = 0;
-				}
+			stitch_component[ID].Camera_ID[stitch_component[ID].Num_camera] = cam;
+			stitch_component[ID].Z_value[stitch_component[ID].Num_camera] = camera->footprint[k].Z_value;
+			stitch_component[ID].Num_camera++;
+			// if Relection/Replicate in Multiband Mode
+			if (MULTI_BAND){
+				multiband_count_variable[ID].Camera_ID[multiband_count_variable[ID].Num_camera] = cam;
+				multiband_count_variable[ID].Z_value[multiband_count_variable[ID].Num_camera] = camera->footprint[k].Z_value;
+				multiband_count_variable[ID].Num_camera++;
+			}
+			// set mask image
+			if (mask_image != NULL){
+				MASK_ptr[ID + mask_offset] = 255;
 			}
 		}
-		if (bit_counter != 0) array_var_counter++;
-
-		//Setting Warp image ROI in the output Image
-		Rectangle[cam].start_x = min_x;
-		Rectangle[cam].start_y = min_y;
-		Rectangle[cam].end_x = max_x;
-		Rectangle[cam].end_y = max_y;
+		for (size_t k = 0; k < camera->padding.size(); k++)
+		{
+			vx_uint32 ID = camera->padding[k].ID;
+			multiband_count_variable[ID].Camera_ID[multiband_count_variable[ID].Num_camera] = cam;
+			multiband_count_variable[ID].Z_value[multiband_count_variable[ID].Num_camera] = camera->padding[k].Z_value;
+			multiband_count_variable[ID].Num_camera++;
+		}
+		Rectangle[cam] = camera->rect;
 	}
-
-	delete[] Mcam;
-	delete[] Tcam;
-	delete[] fcam;
 	/***********************************************************************************************************************************
 	Warp Kernel Variables - Variables 8 & 9
 	************************************************************************************************************************************/
+	vx_size array_var_counter = 0;
+	for (int cam = 0; cam < num_cam; cam++)
+		array_var_counter += cache->camera[cam].valid_entry.size();
 	//Remap Warp Entry Table Size Check 
 	if (array_var_counter >= warp_size_arr)
 	{
 		vxAddLogEntry((vx_reference)arr_stitchWarpRemapEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: Warp Entry has more Entries than Expected. Invalid Array Sizes for Parameters 8 & 9\n");
 		return VX_ERROR_INVALID_DIMENSION;
 	}
-	//Remap Warp Entry Table 
-	StitchWarpRemapEntry *Remap_ptr = &RemapEntry[0];
-	ERROR_CHECK_STATUS(vxTruncateArray(arr_stitchWarpRemapEntry, 0));
-	ERROR_CHECK_STATUS(vxAddArrayItems(arr_stitchWarpRemapEntry, array_var_counter, Remap_ptr, sizeof(StitchWarpRemapEntry)));
-	//Remap Valid Pixel Table 
-	StitchValidPixelEntry *Remap_valid_ptr = &RemapDestination[0];
-	ERROR_CHECK_STATUS(vxTruncateArray(arr_stitchValidPixelEntry, 0));
-	ERROR_CHECK_STATUS(vxAddArrayItems(arr_stitchValidPixelEntry, array_var_counter, Remap_valid_ptr, sizeof(StitchValidPixelEntry)));
+	// upload only the entries of the updated cameras: in place when no camera changed its entry count,
+	// otherwise from the first updated camera onwards
+	vx_size num_valid_items = 0, num_remap_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(arr_stitchValidPixelEntry, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_valid_items, sizeof(num_valid_items)));
+	ERROR_CHECK_STATUS(vxQueryArray(arr_stitchWarpRemapEntry, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_remap_items, sizeof(num_remap_items)));
+	bool upload_in_place = cache->uploaded && num_valid_items == cache->upload_count && num_remap_items == cache->upload_count;
+	int upload_start_cam = 0;
+	if (upload_in_place)
+	{
+		upload_start_cam = num_cam;
+		for (int cam = 0; cam < num_cam; cam++)
+		{
+			if (camera_updated[cam] && upload_start_cam == num_cam) upload_start_cam = cam;
+			if (camera_updated[cam] && cache->camera[cam].valid_entry.size() != cache->camera[cam].upload_count) upload_in_place = false;
+		}
+	}
+	if (upload_in_place)
+	{
+		for (int cam = 0; cam < num_cam; cam++)
+		{
+			const stitch_init_camera_cache * camera = &cache->camera[cam];
+			if (camera_updated[cam])
+			{
+				ERROR_CHECK_STATUS(Write_StitchArrayRange(arr_stitchValidPixelEntry, camera->upload_offset, camera->valid_entry));
+				ERROR_CHECK_STATUS(Write_StitchArrayRange(arr_stitchWarpRemapEntry, camera->upload_offset, camera->remap_entry));
+			}
+		}
+	}
+	else
+	{
+		vx_size upload_offset = cache->camera[upload_start_cam].upload_offset;
+		if (upload_start_cam == 0) upload_offset = 0;
+		ERROR_CHECK_STATUS(vxTruncateArray(arr_stitchValidPixelEntry, upload_offset));
+		ERROR_CHECK_STATUS(vxTruncateArray(arr_stitchWarpRemapEntry, upload_offset));
+		for (int cam = upload_start_cam; cam < num_cam; cam++)
+		{
+			stitch_init_camera_cache * camera = &cache->camera[cam];
+			vx_size count = camera->valid_entry.size();
+			if (count > 0)
+			{
+				ERROR_CHECK_STATUS(vxAddArrayItems(arr_stitchValidPixelEntry, count, &camera->valid_entry[0], sizeof(StitchValidPixelEntry)));
+				ERROR_CHECK_STATUS(vxAddArrayItems(arr_stitchWarpRemapEntry, count, &camera->remap_entry[0], sizeof(StitchWarpRemapEntry)));
+			}
+			camera->upload_offset = upload_offset;
+			camera->upload_count = count;
+			upload_offset += count;
+		}
+	}
+	cache->uploaded = true;
+	cache->upload_count = array_var_counter;
 	/***********************************************************************************************************************************
 	Exposure Comp Variables - Variables 18 & 26
 	************************************************************************************************************************************/
@@ -817,7 +1005,28 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	if (arr_StitchBlendOffsets != NULL)
 	{
 		if (MULTI_BAND != 0)
-			ERROR_CHECK_STATUS(Compute_StitchMultiBandCalcValidEntry(Rectangle_ptr, arr_StitchBlendOffsets, numCamera, NUM_BANDS, widthDst, heightDstCamera));
+		{
+			// camera owner map: the tiles away from the overlaps skip the pyramid
+			std::vector<vx_uint8> cell_owner;
+			if (MULTI_BAND_INTERIOR)
+			{
+				vx_uint32 cells_x = (widthDst + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL;
+				cell_owner.resize(cells_x * ((heightDstCamera + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL));
+				for (vx_uint32 ye = 0; ye < heightDstCamera; ye++)
+				for (vx_uint32 xe = 0; xe < widthDst; xe++)
+				{
+					int ID = (ye*widthDst) + xe;
+					vx_uint8 owner = MULTIBAND_OWNER_MIXED;
+					if (stitch_component[ID].Num_camera == 0) owner = MULTIBAND_OWNER_NONE;
+					else if (stitch_component[ID].Num_camera == 1) owner = (vx_uint8)stitch_component[ID].Camera_ID[0];
+					vx_uint8& cell = cell_owner[(ye / MULTIBAND_OWNER_CELL) * cells_x + (xe / MULTIBAND_OWNER_CELL)];
+					if (ye % MULTIBAND_OWNER_CELL == 0 && xe % MULTIBAND_OWNER_CELL == 0) cell = owner;
+					else if (cell != owner) cell = MULTIBAND_OWNER_MIXED;
+				}
+			}
+			ERROR_CHECK_STATUS(Compute_StitchMultiBandCalcValidEntry(Rectangle_ptr, arr_StitchBlendOffsets, numCamera, NUM_BANDS, widthDst, heightDstCamera,
+				MULTI_BAND_INTERIOR ? &cell_owner[0] : nullptr));
+		}
 	}
 	/***********************************************************************************************************************************
 	Initial weight image & overlap matrix - Variables 11 & 14
@@ -921,12 +1130,17 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	}
 
 	/***********************************************************************************************************************************
-	SeamFind Entry used to calculate - Variable 21, 22, 23, 24 & 25 -- Vertical Seam and Horizontal Seam
+	SeamFind Entry used to calculate - Variable 21, 22, 23, 24, 25 & 27 -- Vertical Seam and Horizontal Seam
 	************************************************************************************************************************************/
 	if (SEAM_FIND)
 	{
-		SeamFindSizeInfo size_var;	vx_uint32 mode = 0;
-		ERROR_CHECK_STATUS(seamfind_utility(mode, width_eqr, num_cam, &size_var));
+		// the entry tables are bounded by the capacity of the arrays allocated by the application
+		SeamFindSizeInfo size_var;
+		size_var.valid_entry = (vx_uint32)Get_StitchArrayCapacity((vx_array)parameters[21], 0);
+		size_var.accum_entry = (vx_uint32)Get_StitchArrayCapacity((vx_array)parameters[22], 0);
+		size_var.weight_entry = (vx_uint32)Get_StitchArrayCapacity((vx_array)parameters[23], 0);
+		size_var.pref_entry = (vx_uint32)Get_StitchArrayCapacity((vx_array)parameters[24], numCamera * numCamera);
+		size_var.info_entry = (vx_uint32)Get_StitchArrayCapacity((vx_array)parameters[25], numCamera * numCamera);
 
 		vx_array Array_SeamFindValidEntry = (vx_array)parameters[21];
 		vx_size seamfind_valid_entry_count = 0;
@@ -1020,8 +1234,13 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 			for (vx_uint32 j = i + 1; j < numCamera; j++)
 			{
 				vx_uint32 ID = (i * numCamera) + j;
-				if (pixel_matrix[ID] != 0)
+				if (pixel_matrix[ID] != 0 && VX_Overlap_ROI[ID].start_x <= VX_Overlap_ROI[ID].end_x && VX_Overlap_ROI[ID].start_y <= VX_Overlap_ROI[ID].end_y)
 				{
+					//Entry Table Size Check 
+					if (overlap_number >= (int)size_var.info_entry || overlap_number >= (int)size_var.pref_entry){
+						vxAddLogEntry((vx_reference)Array_SeamFindInfoEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindInfo/PrefEntry has more Entries than Expected. Invalid Array Size\n");
+						return VX_ERROR_INVALID_DIMENSION;
+					}
 					vx_int16 y_dir = VX_Overlap_ROI[ID].end_y - VX_Overlap_ROI[ID].start_y;
 					vx_int16 x_dir = VX_Overlap_ROI[ID].end_x - VX_Overlap_ROI[ID].start_x;
 					vx_uint32 offset_1 = i * heightDstCamera;
@@ -1036,6 +1255,11 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 
 						for (vx_uint32 xe = VX_Overlap_ROI[ID].start_x; xe <= VX_Overlap_ROI[ID].end_x; xe++)
 						{
+							//Entry Table Size Check 
+							if (seamfind_valid_entry_count >= size_var.valid_entry){
+								vxAddLogEntry((vx_reference)Array_SeamFindValidEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindValidEntry has more Entries than Expected. Invalid Array Size\n");
+								return VX_ERROR_INVALID_DIMENSION;
+							}
 							Valid_Entry[seamfind_valid_entry_count].dstX = (vx_int16)xe;
 							Valid_Entry[seamfind_valid_entry_count].dstY = (vx_int16)ye;
 							Valid_Entry[seamfind_valid_entry_count].height = (vx_int16)y_dir;
@@ -1046,11 +1270,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 							Valid_Entry[seamfind_valid_entry_count].ID = (vx_int16)overlap_number;
 
 							seamfind_valid_entry_count++;
-							//Entry Table Size Check 
-							if (seamfind_valid_entry_count >= size_var.valid_entry){
-								vxAddLogEntry((vx_reference)Array_SeamFindValidEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindValidEntry has more Entries than Expected. Invalid Array Size\n");
-								return VX_ERROR_INVALID_DIMENSION;
-							}
 						}
 
 						if (Array_SeamFindWeightEntry != NULL)
@@ -1063,6 +1282,11 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 								vx_uint32 pixel_id_2 = ((ye + offset_2) * widthDst) + xe;
 								if (MASK_ptr[pixel_id_1] && MASK_ptr[pixel_id_2])
 								{
+									//Entry Table Size Check 
+									if (seamfind_weight_entry_count >= size_var.weight_entry){
+										vxAddLogEntry((vx_reference)Array_SeamFindWeightEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindWeightEntry has more Entries than Expected. Invalid Array Size\n");
+										return VX_ERROR_INVALID_DIMENSION;
+									}
 									Valid_Weight_Entry[seamfind_weight_entry_count].x = xe;
 									Valid_Weight_Entry[seamfind_weight_entry_count].y = ye;
 									Valid_Weight_Entry[seamfind_weight_entry_count].cam_id_1 = i;
@@ -1071,11 +1295,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 									Valid_Weight_Entry[seamfind_weight_entry_count].overlap_type = VERTICAL_SEAM;
 
 									seamfind_weight_entry_count++;
-									//Entry Table Size Check 
-									if (seamfind_weight_entry_count >= size_var.weight_entry){
-										vxAddLogEntry((vx_reference)Array_SeamFindWeightEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindWeightEntry has more Entries than Expected. Invalid Array Size\n");
-										return VX_ERROR_INVALID_DIMENSION;
-									}
 								}
 							}
 						}
@@ -1112,6 +1331,11 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 						vx_uint32 xe = VX_Overlap_ROI[ID].start_x;
 						for (vx_uint32 ye = VX_Overlap_ROI[ID].start_y; ye <= VX_Overlap_ROI[ID].end_y; ye++)
 						{
+							//Entry Table Size Check 
+							if (seamfind_valid_entry_count >= size_var.valid_entry){
+								vxAddLogEntry((vx_reference)Array_SeamFindValidEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindValidEntry has more Entries than Expected. Invalid Array Size\n");
+								return VX_ERROR_INVALID_DIMENSION;
+							}
 							Valid_Entry[seamfind_valid_entry_count].dstX = (vx_int16)xe;
 							Valid_Entry[seamfind_valid_entry_count].dstY = (vx_int16)ye;
 							Valid_Entry[seamfind_valid_entry_count].height = (vx_int16)y_dir;
@@ -1122,11 +1346,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 							Valid_Entry[seamfind_valid_entry_count].ID = (vx_int16)overlap_number;
 
 							seamfind_valid_entry_count++;
-							//Entry Table Size Check 
-							if (seamfind_valid_entry_count >= size_var.valid_entry){
-								vxAddLogEntry((vx_reference)Array_SeamFindValidEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindValidEntry has more Entries than Expected. Invalid Array Size\n");
-								return VX_ERROR_INVALID_DIMENSION;
-							}
 						}
 
 						if (Array_SeamFindWeightEntry != NULL)
@@ -1139,6 +1358,11 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 								vx_uint32 pixel_id_2 = ((ye + offset_2) * widthDst) + xe;
 								if (MASK_ptr[pixel_id_1] && MASK_ptr[pixel_id_2])
 								{
+									//Entry Table Size Check 
+									if (seamfind_weight_entry_count >= size_var.weight_entry){
+										vxAddLogEntry((vx_reference)Array_SeamFindWeightEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindWeightEntry has more Entries than Expected. Invalid Array Size\n");
+										return VX_ERROR_INVALID_DIMENSION;
+									}
 									Valid_Weight_Entry[seamfind_weight_entry_count].x = xe;
 									Valid_Weight_Entry[seamfind_weight_entry_count].y = ye;
 									Valid_Weight_Entry[seamfind_weight_entry_count].cam_id_1 = i;
@@ -1147,11 +1371,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 									Valid_Weight_Entry[seamfind_weight_entry_count].overlap_type = HORIZONTAL_SEAM;
 
 									seamfind_weight_entry_count++;
-									//Entry Table Size Check 
-									if (seamfind_weight_entry_count >= size_var.weight_entry){
-										vxAddLogEntry((vx_reference)Array_SeamFindWeightEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindWeightEntry has more Entries than Expected. Invalid Array Size\n");
-										return VX_ERROR_INVALID_DIMENSION;
-									}
 								}
 							}
 						}
@@ -1183,11 +1402,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 					}
 					//Number of Overlaps
 					overlap_number++;
-					//Entry Table Size Check 
-					if (overlap_number >= (int)size_var.info_entry || overlap_number >= (int)size_var.pref_entry){
-						vxAddLogEntry((vx_reference)Array_SeamFindInfoEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindInfo/PrefEntry has more Entries than Expected. Invalid Array Size\n");
-						return VX_ERROR_INVALID_DIMENSION;
-					}
 				}
 			}
 
@@ -1198,24 +1412,32 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 				ERROR_CHECK_STATUS(vxTruncateArray(Array_SeamFindValidEntry, 0));
 				ERROR_CHECK_STATUS(vxAddArrayItems(Array_SeamFindValidEntry, seamfind_valid_entry_count, SeamFindValid_ptr, sizeof(StitchSeamFindValidEntry)));
 			}
-			//SeamFind Accum Entry set to -1 variable 22
+			//SeamFind Accum value and parent Entries set to -1 variable 22 & 27
 			vx_array Array_SeamFindAccumEntry = (vx_array)parameters[22];
+			vx_array Array_SeamFindAccumParent = (vx_array)parameters[27];
 			if (Array_SeamFindAccumEntry != NULL)
 			{
 				//Entry Table Size Check 
-				if (accumulation_entry_offset >= size_var.accum_entry){
+				if (accumulation_entry_offset > size_var.accum_entry){
 					vxAddLogEntry((vx_reference)Array_SeamFindAccumEntry, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindAccumEntry has more Entries than Expected. Invalid Array Size for parameter 22\n");
 					return VX_ERROR_INVALID_DIMENSION;
 				}
-				std::vector<StitchSeamFindAccumEntry> Accum_Entry;
-				Accum_Entry.resize(accumulation_entry_offset);
-				int accum_data_size = (sizeof(StitchSeamFindAccumEntry) / sizeof(vx_int8));
-				memset(&Accum_Entry[0], -1, (accumulation_entry_offset * accum_data_size));
-
-				StitchSeamFindAccumEntry *SeamFindAccum_ptr = &Accum_Entry[0];
+				std::vector<vx_int32> Accum_Entry(accumulation_entry_offset, -1);
 				ERROR_CHECK_STATUS(vxTruncateArray(Array_SeamFindAccumEntry, 0));
 				if (accumulation_entry_offset)
-					ERROR_CHECK_STATUS(vxAddArrayItems(Array_SeamFindAccumEntry, (vx_size)accumulation_entry_offset, SeamFindAccum_ptr, sizeof(StitchSeamFindAccumEntry)));
+					ERROR_CHECK_STATUS(vxAddArrayItems(Array_SeamFindAccumEntry, (vx_size)accumulation_entry_offset, &Accum_Entry[0], sizeof(vx_int32)));
+			}
+			if (Array_SeamFindAccumParent != NULL)
+			{
+				//Entry Table Size Check 
+				if (accumulation_entry_offset > Get_StitchArrayCapacity(Array_SeamFindAccumParent, 0)){
+					vxAddLogEntry((vx_reference)Array_SeamFindAccumParent, VX_ERROR_INVALID_DIMENSION, "ERROR: initialize_stitch_config: SeamFindAccumEntry has more Entries than Expected. Invalid Array Size for parameter 27\n");
+					return VX_ERROR_INVALID_DIMENSION;
+				}
+				std::vector<vx_uint8> Accum_Parent(accumulation_entry_offset, (vx_uint8)(SEAMFIND_PARENT_NONE | SEAMFIND_PARENT_PROPAGATE));
+				ERROR_CHECK_STATUS(vxTruncateArray(Array_SeamFindAccumParent, 0));
+				if (accumulation_entry_offset)
+					ERROR_CHECK_STATUS(vxAddArrayItems(Array_SeamFindAccumParent, (vx_size)accumulation_entry_offset, &Accum_Parent[0], sizeof(vx_uint8)));
 			}
 			//SeamFind Weight Entry used to calculate variable 23
 			if (Array_SeamFindWeightEntry != NULL)
@@ -1241,7 +1463,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 		}
 	}
 	/***********************************************************************************************************************************
-	ROI ARRAY Variables - Variables  10 & 20
+	ROI ARRAY Variables - Variables  10, 20 & 28
 	************************************************************************************************************************************/
 	vx_rectangle_t *Overlap_Rectangle_ptr = &VX_Overlap_ROI[0];
 
@@ -1259,6 +1481,13 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 		ERROR_CHECK_STATUS(vxTruncateArray(arr_Overlap_ROI, 0));
 		ERROR_CHECK_STATUS(vxAddArrayItems(arr_Overlap_ROI, max_roi, Overlap_Rectangle_ptr, sizeof(vx_rectangle_t)));
 	}
+
+	//Seamfind Cost Tile Array -- Variable 28
+	vx_array arr_SeamFindCostTile = (vx_array)parameters[28];
+	if (arr_SeamFindCostTile != NULL)
+	{
+		ERROR_CHECK_STATUS(Compute_StitchSeamFindCostTiles(arr_SeamFindCostTile, Overlap_Rectangle_ptr, numCamera, widthDst, heightDstCamera));
+	}
 	/***********************************************************************************************************************************
 	Weight Image, Mask Image and Overlap Pixel Count - commit access
 	************************************************************************************************************************************/
@@ -1411,7 +1640,6 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 	ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam, 0, num_cam, cam_par));
 	//Release Memory
 	stitch_component.clear(); multiband_count_variable.clear();
-	RemapDestination.clear(); RemapEntry.clear();
 	VX_Overlap_ROI.clear();
 	delete[] pixel_matrix;
 
@@ -1422,7 +1650,7 @@ static vx_status VX_CALLBACK initialize_stitch_config_kernel(vx_node node, const
 vx_status initialize_stitch_config_publish(vx_context context)
 {
 	// add kernel to the context with callbacks
-	vx_kernel kernel = vxAddUserKernel(context, "com.amd.loomsl.initialize_stitch_config", AMDOVX_KERNEL_STITCHING_INITIALIZE_STITCH_CONFIG, initialize_stitch_config_kernel, 27, initialize_stitch_config_validate, nullptr, nullptr);
+	vx_kernel kernel = vxAddUserKernel(context, "com.amd.loomsl.initialize_stitch_config", AMDOVX_KERNEL_STITCHING_INITIALIZE_STITCH_CONFIG, initialize_stitch_config_kernel, 29, initialize_stitch_config_validate, initialize_stitch_config_initialize, initialize_stitch_config_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 
 	// set kernel parameters
@@ -1453,6 +1681,8 @@ vx_status initialize_stitch_config_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 24, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 25, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 26, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 27, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 28, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
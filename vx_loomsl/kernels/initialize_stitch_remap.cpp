@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "projection.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
@@ -29,37 +30,6 @@ THE SOFTWARE.
 
 #define COMPUTE_REMAP_DEBUG 0
 
-//! \brief Function to Compute M.
-static void ComputeM(float * M, float th, float fi, float sy)
-{
-	float sth = sinf(th), cth = cosf(th);
-	float sfi = sinf(fi), cfi = cosf(fi);
-	float ssy = sinf(sy), csy = cosf(sy);
-	M[0] = sth*ssy*sfi + cth*csy; M[1] = ssy*cfi; M[2] = cth*ssy*sfi - sth*csy;
-	M[3] = sth*csy*sfi - cth*ssy; M[4] = csy*cfi; M[5] = cth*csy*sfi + sth*ssy;
-	M[6] = sth    *cfi;          M[7] = -sfi;     M[8] = cth    *cfi;
-}
-
-//! \brief Matix Multiplication Function.
-static void MatMul3x3(float * C, const float * A, const float * B)
-{
-	const float * At = A;
-	for (int i = 0; i < 3; i++, At += 3) {
-		const float * Bt = B;
-		for (int j = 0; j < 3; j++, Bt++, C++) {
-			*C = At[0] * Bt[0] + At[1] * Bt[3] + At[2] * Bt[6];
-		}
-	}
-}
-
-//! \brief Matix Multiplication Function.
-static void MatMul3x1(float * Y, const float * M, const float * X)
-{
-	Y[0] = M[0] * X[0] + M[1] * X[1] + M[2] * X[2];
-	Y[1] = M[3] * X[0] + M[4] * X[1] + M[5] * X[2];
-	Y[2] = M[6] * X[0] + M[7] * X[1] + M[8] * X[2];
-}
-
 //! \brief The validator callback.
 static vx_status VX_CALLBACK initialize_stitch_remap_validate(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_meta_format metas[])
 {
@@ -166,7 +136,6 @@ static vx_status VX_CALLBACK initialize_stitch_remap_kernel(vx_node node, const
 	vx_array array_cam = (vx_array)parameters[6];
 	vx_remap remap = (vx_remap)parameters[7];
 
-	int width = src_width;
 	int height = src_height;
 
 	// get rig and camera parameters
@@ -202,118 +171,39 @@ static vx_status VX_CALLBACK initialize_stitch_remap_kernel(vx_node node, const
 	printf("**************************************\n");
 #endif
 
-	// pre-compute M & T of each camera
-	float * Mcam = new float[num_cam * 9];
-	float * Tcam = new float[num_cam * 3];
-	float * fcam = new float[num_cam * 2];
-	float Mr[9];
-	float deg2rad = (float)M_PI / 180.0f;
-	ComputeM(Mr, rig_par.yaw * deg2rad, rig_par.pitch * deg2rad, rig_par.roll * deg2rad);
+	// setup the projection of each camera
+	std::vector<stitch_projection_camera> proj(num_cam);
 	for (vx_uint32 cam = 0; cam < num_cam; cam++) {
-		float Mc[9];
-		ComputeM(Mc, cam_par[cam].focal.yaw * deg2rad, cam_par[cam].focal.pitch * deg2rad, cam_par[cam].focal.roll * deg2rad);
-		MatMul3x3(&Mcam[cam * 9], Mc, Mr);
-		if (rig_par.d > 0.0f) {
-			Tcam[cam * 3 + 0] = cam_par[cam].focal.tx / rig_par.d;
-			Tcam[cam * 3 + 1] = cam_par[cam].focal.ty / rig_par.d;
-			Tcam[cam * 3 + 2] = cam_par[cam].focal.tz / rig_par.d;
-		}
-		else {
-			Tcam[cam * 3 + 0] = Tcam[cam * 3 + 1] = Tcam[cam * 3 + 2] = 0.0f;
-		}
-
-		if (cam_par[cam].lens.lens_type == 0) { // ptgui rectilinear
-			fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else if (cam_par[cam].lens.lens_type == 1 || cam_par[cam].lens.lens_type == 2) { // ptgui fisheye
-			fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else if (cam_par[cam].lens.lens_type == 3) { // adobe rectilinear
-			fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else if (cam_par[cam].lens.lens_type == 4) { // adobe fisheye
-			fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-			fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-		}
-		else{ // Unsupported Lens
+		if (stitchProjectionSetup(&proj[cam], &rig_par, &cam_par[cam], cam, num_buff_cols, src_width, src_height) != VX_SUCCESS) { // Unsupported Lens
 			vxAddLogEntry((vx_reference)array_cam, VX_ERROR_INVALID_TYPE, "ERROR: initialize_stitch_remap: lens_type = %d not supported [cam#%d]\n", cam_par[cam].lens.lens_type, cam);
 			return VX_ERROR_INVALID_TYPE;
 		}
 	}
 
-	// compute warp pixel map
-	float pi_by_h = (float)M_PI / (float)dst_height;
-	float width2 = (float)width * 0.5f, height2 = (float)height * 0.5f;
+	// compute warp pixel map: each row is projected into all the cameras and the camera closest to its optical axis is picked
+	stitch_projection_columns columns;
+	stitchProjectionColumns(&columns, dst_width, dst_height);
+	vx_size padded_width = columns.sin_te.size();
+	std::vector<float> row_xd(padded_width * num_cam), row_yd(padded_width * num_cam), row_rr(padded_width * num_cam), row_z(padded_width * num_cam);
 	for (int y = 0; y < (int)dst_height; y++) {
-		float pe = (float)y * pi_by_h - (float)M_PI_2;
-		float sin_pe = sinf(pe);
-		float cos_pe = cosf(pe);
+		for (vx_uint32 cam = 0; cam < num_cam; cam++) {
+			vx_size offset = cam * padded_width;
+			stitchProjectRow(&proj[cam], &columns, y, &row_xd[offset], &row_yd[offset], &row_rr[offset], &row_z[offset]);
+		}
 		for (int x = 0; x < (int)dst_width; x++) {
-			float te = (float)x * pi_by_h - (float)M_PI;
-			float sin_te = sinf(te);
-			float cos_te = cosf(te);
-			float X[3] = { sin_te*cos_pe, sin_pe, cos_te*cos_pe };
-			const float * T = Tcam, *M = Mcam, *f = fcam;
-			float best_xd = -1, best_yd = -1, best_rd = 1e20f;
+			float best_xd = -1, best_yd = -1, best_z = 0.0f;
 			int best_cam = -1;
-			for (vx_uint32 cam = 0; cam < num_cam; cam++, T += 3, M += 9, f += 2) {
+			for (vx_uint32 cam = 0; cam < num_cam; cam++) {
 				const camera_params * par = &cam_par[cam];
-				float Xt[3] = { X[0] - T[0], X[1] - T[1], X[2] - T[2] };
-				float nfactor = sqrtf(Xt[0] * Xt[0] + Xt[1] * Xt[1] + Xt[2] * Xt[2]);
-				Xt[0] /= nfactor;
-				Xt[1] /= nfactor;
-				Xt[2] /= nfactor;
-				float Y[3];
-				MatMul3x1(Y, M, Xt);
-				if (Y[2] > 0.0f) {
-					float ph = atan2f(Y[1], Y[0]);
-					float th = asinf(sqrtf(Y[0] * Y[0] + Y[1] * Y[1]));
-					float rd = 0.0f;
-					if (par->lens.lens_type == 0) { // ptgui rectilinear
-						float a = par->lens.k1;
-						float b = par->lens.k2;
-						float c = par->lens.k3;
-						float d = 1.0f - a - b - c;
-						float r = tanf(th) * f[0];
-						rd = r * (d + r * (c + r * (b + r * a)));
-					}
-					else if (par->lens.lens_type == 1 || par->lens.lens_type == 2) { // ptgui fisheye circ
-						float a = par->lens.k1;
-						float b = par->lens.k2;
-						float c = par->lens.k3;
-						float d = 1.0f - a - b - c;
-						float r = th * f[0];
-						rd = r * (d + r * (c + r * (b + r * a)));
-					}
-					else if (par->lens.lens_type == 3) { // adobe rectilinear
-						float r = tanf(th) * f[0], r2 = r * r;
-						rd = r * (1 + r2 * (par->lens.k1 + r2 * (par->lens.k2 + r2 * par->lens.k3)));
-					}
-					else if (par->lens.lens_type == 4) { // adobe fisheye
-						float r = th * f[0], r2 = r * r;
-						rd = r * (1 + r2 * (par->lens.k1 + r2 * par->lens.k2));
-					}
-
-					float xd = f[1] * rd * cosf(ph);
-					float yd = f[1] * rd * sinf(ph);
-					float rr = sqrtf(xd*xd + yd*yd);
-								
-					float du0 = par->lens.du0;
-					if (num_buff_cols > 1){	du0 += ((cam_buffer_width /(2 * num_buff_cols)) + ((cam % num_buff_cols) * src_width));}
-					else{ du0 += width2;}
-					
-					xd = du0 + xd;
-					yd = height2 + par->lens.dv0 + yd;
-					if (xd >= 0 && xd < (cam_buffer_width - 1) && yd >= 0 && yd < height - 1 && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop)) {
-						if (best_cam < 0 || th < best_rd) {
-							best_rd = th;
-							best_xd = xd;
-							best_yd = yd;
-							best_cam = cam;
-						}
+				vx_size i = cam * padded_width + x;
+				float xd = row_xd[i], yd = row_yd[i], rr = row_rr[i], z = row_z[i];
+				if (z > 0.0f && xd >= 0 && xd < (cam_buffer_width - 1) && yd >= 0 && yd < height - 1 && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop)) {
+					// the smallest incidence angle is the largest z
+					if (best_cam < 0 || z > best_z) {
+						best_z = z;
+						best_xd = xd;
+						best_yd = yd;
+						best_cam = cam;
 					}
 				}
 			}
@@ -328,9 +218,6 @@ static vx_status VX_CALLBACK initialize_stitch_remap_kernel(vx_node node, const
 	}
 
 	ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam, 0, num_cam, cam_par));
-	delete[] Mcam;
-	delete[] Tcam;
-	delete[] fcam;
 
 	return VX_SUCCESS;
 }
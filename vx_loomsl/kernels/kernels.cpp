@@ -70,12 +70,14 @@ SHARED_PUBLIC vx_status VX_API_CALL vxPublishKernels(vx_context context)
 	ERROR_CHECK_STATUS(upscale_gaussian_subtract_publish(context));
 	ERROR_CHECK_STATUS(upscale_gaussian_add_publish(context));
 	ERROR_CHECK_STATUS(laplacian_reconstruct_publish(context));
+	ERROR_CHECK_STATUS(multiband_fused_publish(context));
 	ERROR_CHECK_STATUS(seamfind_model_publish(context));
 	ERROR_CHECK_STATUS(seamfind_scene_detect_publish(context));
 	ERROR_CHECK_STATUS(seamfind_cost_generate_publish(context));
 	ERROR_CHECK_STATUS(seamfind_cost_accumulate_publish(context));
 	ERROR_CHECK_STATUS(seamfind_path_trace_publish(context));
 	ERROR_CHECK_STATUS(seamfind_set_weights_publish(context));
+	ERROR_CHECK_STATUS(seamfind_analyze_publish(context));
 	return VX_SUCCESS;
 }
 
@@ -192,7 +194,7 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchConfigNode(vx_graph graph
 	vx_image camera_id_image, vx_image group1_image, vx_image group2_image, 
 	vx_array exp_comp_calc, vx_image mask_image, vx_array overlap_rect, 
 	vx_array seamfind_valid, vx_array seamfind_accum, vx_array seamfind_weight, vx_array seamfind_pref, vx_array seamfind_info,
-	vx_array twoband_blend)
+	vx_array twoband_blend, vx_array seamfind_parent, vx_array seamfind_cost_tiles)
 {
 	vx_context context = vxGetContext((vx_reference)graph);
 	vx_scalar s_num_rows = vxCreateScalar(context, VX_TYPE_UINT32, &num_buff_rows);
@@ -229,6 +231,8 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchConfigNode(vx_graph graph
 		(vx_reference)seamfind_pref,
 		(vx_reference)seamfind_info,
 		(vx_reference)twoband_blend,
+		(vx_reference)seamfind_parent,
+		(vx_reference)seamfind_cost_tiles,
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_INITIALIZE_STITCH_CONFIG,
@@ -261,6 +265,39 @@ VX_API_ENTRY vx_node VX_API_CALL stitchColorConvertNode(vx_graph graph, vx_image
 	return node;
 }
 
+/**
+* \brief Function to create Lens Distortion Remap node
+*/
+VX_API_ENTRY vx_node VX_API_CALL stitchLensDistortionRemapNode(vx_graph graph, vx_uint32 num_buff_rows, vx_uint32 num_buff_cols,
+	vx_uint32 cam_buffer_width, vx_uint32 cam_buffer_height, vx_array camera_param, vx_array ValidPixelEntry, vx_array WarpRemapEntry)
+{
+	vx_context context = vxGetContext((vx_reference)graph);
+	vx_scalar s_buff_rows = vxCreateScalar(context, VX_TYPE_UINT32, &num_buff_rows);
+	vx_scalar s_buff_cols = vxCreateScalar(context, VX_TYPE_UINT32, &num_buff_cols);
+	vx_scalar s_buffer_width = vxCreateScalar(context, VX_TYPE_UINT32, &cam_buffer_width);
+	vx_scalar s_buffer_height = vxCreateScalar(context, VX_TYPE_UINT32, &cam_buffer_height);
+
+	vx_reference params[] = {
+		(vx_reference)s_buff_rows,
+		(vx_reference)s_buff_cols,
+		(vx_reference)s_buffer_width,
+		(vx_reference)s_buffer_height,
+		(vx_reference)camera_param,
+		(vx_reference)ValidPixelEntry,
+		(vx_reference)WarpRemapEntry
+	};
+	vx_node node = stitchCreateNode(graph,
+		AMDOVX_KERNEL_STITCHING_LENS_DISTORTION_REMAP,
+		params,
+		dimof(params));
+
+	vxReleaseScalar(&s_buff_rows);
+	vxReleaseScalar(&s_buff_cols);
+	vxReleaseScalar(&s_buffer_width);
+	vxReleaseScalar(&s_buffer_height);
+	return node;
+}
+
 /**
 * \brief Function to create Stitch Warp node
 */
@@ -372,7 +409,7 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchRemapNode(vx_graph graph,
 /**
 * \brief Function to create Calculate Error Function node
 */
-VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph graph, vx_uint32 numCameras, vx_image input, vx_array exp_data, vx_image mask, vx_matrix out_intensity)
+VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph graph, vx_uint32 numCameras, vx_image input, vx_array exp_data, vx_image mask, vx_matrix out_intensity, vx_array out_block_stats)
 {
 	vx_scalar Num_Camera = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &numCameras);
 
@@ -382,6 +419,7 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph grap
 		(vx_reference)exp_data,
 		(vx_reference)mask,
 		(vx_reference)out_intensity,
+		(vx_reference)out_block_stats,
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_COMPUTE_GAINMAT,
@@ -395,10 +433,12 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph grap
 /**
 * \brief Function to create Calculate Gains node
 */
-VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph graph, vx_float32 alpha, vx_float32 beta, vx_matrix in_intensity, vx_matrix in_count, vx_array out_gains)
+VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph graph, vx_float32 alpha, vx_float32 beta, vx_matrix in_intensity, vx_matrix in_count, vx_array out_gains,
+	vx_uint32 block_gain_width, vx_array in_overlap_pixel, vx_array in_block_stats, vx_array out_block_gains)
 {
 	vx_scalar Alpha = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_FLOAT32, &alpha);
 	vx_scalar Beta = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_FLOAT32, &beta);
+	vx_scalar BlockGainWidth = out_block_gains ? vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &block_gain_width) : nullptr;
 
 	vx_reference params[] = {
 		(vx_reference)Alpha,
@@ -406,6 +446,10 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph gra
 		(vx_reference)in_intensity,
 		(vx_reference)in_count,
 		(vx_reference)out_gains,
+		(vx_reference)BlockGainWidth,
+		(vx_reference)in_overlap_pixel,
+		(vx_reference)in_block_stats,
+		(vx_reference)out_block_gains,
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_SOLVE,
@@ -414,13 +458,14 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph gra
 
 	vxReleaseScalar(&Alpha);
 	vxReleaseScalar(&Beta);
+	if (BlockGainWidth) vxReleaseScalar(&BlockGainWidth);
 	return node;
 }
 
 /**
 * \brief Function to create Apply Gains node
 */
-VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompApplyGainNode(vx_graph graph, vx_image input, vx_array in_gains, vx_array in_offsets, vx_image output)
+VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompApplyGainNode(vx_graph graph, vx_image input, vx_array in_gains, vx_array in_offsets, vx_image output, vx_array in_block_gains)
 {
 
 	vx_reference params[] = {
@@ -428,6 +473,7 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompApplyGainNode(vx_graph graph,
 		(vx_reference)in_gains,
 		(vx_reference)in_offsets,
 		(vx_reference)output,
+		(vx_reference)in_block_gains,
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_EXPCOMP_APPLYGAINS,
@@ -499,32 +545,40 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindModelNode(vx_graph graph, vx_uint
 
 //*\brief Function to create SeamFind Scene Change Detect Node - CPU/GPU
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSceneDetectNode(vx_graph graph, vx_scalar current_frame, vx_scalar scene_threshold,
-	vx_image input_image, vx_array seam_info, vx_array seam_pref, vx_array seam_scene_change)
+	vx_image input_image, vx_array seam_info, vx_array seam_pref, vx_array seam_scene_change, vx_uint32 scene_duration, vx_uint32 view_scene_change)
 {
+	vx_scalar SCENE_DURATION = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &scene_duration);
+	vx_scalar VIEW_SCENE_CHANGE = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &view_scene_change);
 	vx_reference params[] = {
 		(vx_reference)current_frame,
 		(vx_reference)scene_threshold,
 		(vx_reference)input_image,
 		(vx_reference)seam_info,
 		(vx_reference)seam_pref,
-		(vx_reference)seam_scene_change
+		(vx_reference)seam_scene_change,
+		(vx_reference)SCENE_DURATION,
+		(vx_reference)VIEW_SCENE_CHANGE
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_SCENE_DETECT,
 		params,
 		dimof(params));
 
+	vxReleaseScalar(&SCENE_DURATION);
+	vxReleaseScalar(&VIEW_SCENE_CHANGE);
 	return node;
 }
 
 //*\brief Function to create SeamFind Cost Generate node - GPU
-VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostGenerateNode(vx_graph graph, vx_scalar executeFlag, vx_image input_weight_image, vx_image magnitude_image, vx_image phase_image)
+VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostGenerateNode(vx_graph graph, vx_scalar executeFlag, vx_image input_weight_image, vx_image magnitude_image, vx_image phase_image,
+	vx_array cost_tiles)
 {
 	vx_reference params[] = {
 		(vx_reference)executeFlag,
 		(vx_reference)input_weight_image,
 		(vx_reference)magnitude_image,
 		(vx_reference)phase_image,
+		(vx_reference)cost_tiles,
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_GENERATE,
@@ -536,10 +590,13 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostGenerateNode(vx_graph graph,
 
 //*\brief Function to create SeamFind Cost Accumulate Node - GPU 
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostAccumulateNode(vx_graph graph, vx_scalar current_frame, vx_uint32 output_width, vx_uint32 output_height,
-	vx_image magnitude_img, vx_image phase_img, vx_image mask_img, vx_array valid_seam, vx_array pref_seam, vx_array info_seam, vx_array accum_seam)
+	vx_image magnitude_img, vx_image phase_img, vx_image mask_img, vx_array valid_seam, vx_array pref_seam, vx_array info_seam, vx_array accum_seam, vx_array parent_seam,
+	vx_uint32 corridor, vx_uint32 coarse_scale)
 {
 	vx_scalar OUTPUT_WIDTH = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &output_width);
 	vx_scalar OUTPUT_HEIGHT = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &output_height);
+	vx_scalar CORRIDOR = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &corridor);
+	vx_scalar COARSE_SCALE = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &coarse_scale);
 
 	vx_reference params[] = {
 		(vx_reference)current_frame,
@@ -551,7 +608,10 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostAccumulateNode(vx_graph graph
 		(vx_reference)valid_seam,
 		(vx_reference)pref_seam,
 		(vx_reference)info_seam,
-		(vx_reference)accum_seam
+		(vx_reference)accum_seam,
+		(vx_reference)parent_seam,
+		(vx_reference)CORRIDOR,
+		(vx_reference)COARSE_SCALE
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_ACCUMULATE,
@@ -560,12 +620,14 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostAccumulateNode(vx_graph graph
 
 	vxReleaseScalar(&OUTPUT_WIDTH);
 	vxReleaseScalar(&OUTPUT_HEIGHT);
+	vxReleaseScalar(&CORRIDOR);
+	vxReleaseScalar(&COARSE_SCALE);
 	return node;
 }
 
 //*\brief Function to create SeamFind Path Trace node - GPU/CPU
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindPathTraceNode(vx_graph graph, vx_scalar current_frame, vx_image weight_image, vx_array seam_info,
-	vx_array seam_accum, vx_array seam_pref, vx_array paths)
+	vx_array seam_accum, vx_array seam_pref, vx_array paths, vx_array seam_parent)
 {
 	vx_reference params[] = {
 		(vx_reference)current_frame,
@@ -573,7 +635,8 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindPathTraceNode(vx_graph graph, vx_
 		(vx_reference)seam_info,
 		(vx_reference)seam_accum,
 		(vx_reference)seam_pref,
-		(vx_reference)paths
+		(vx_reference)paths,
+		(vx_reference)seam_parent
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_PATH_TRACE,
@@ -585,11 +648,12 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindPathTraceNode(vx_graph graph, vx_
 
 //*\brief Function to create SeamFind Set Weights node - GPU
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSetWeightsNode(vx_graph graph, vx_scalar current_frame, vx_uint32 NumCam, vx_uint32 output_width, vx_uint32 output_height, vx_array seam_weight, vx_array seam_path,
-	vx_array seam_pref, vx_image weight_image)
+	vx_array seam_pref, vx_image weight_image, vx_uint32 view_scene_change)
 {
 	vx_scalar NUM_CAM = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &NumCam);
 	vx_scalar OUTPUT_WIDTH = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &output_width);
 	vx_scalar OUTPUT_HEIGHT = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &output_height);
+	vx_scalar VIEW_SCENE_CHANGE = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &view_scene_change);
 
 	vx_reference params[] = {
 		(vx_reference)current_frame,
@@ -599,7 +663,8 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSetWeightsNode(vx_graph graph, vx
 		(vx_reference)seam_weight,
 		(vx_reference)seam_path,
 		(vx_reference)seam_pref,
-		(vx_reference)weight_image
+		(vx_reference)weight_image,
+		(vx_reference)VIEW_SCENE_CHANGE
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_SET_WEIGHTS,
@@ -609,6 +674,23 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSetWeightsNode(vx_graph graph, vx
 	vxReleaseScalar(&NUM_CAM);
 	vxReleaseScalar(&OUTPUT_WIDTH);
 	vxReleaseScalar(&OUTPUT_HEIGHT);
+	vxReleaseScalar(&VIEW_SCENE_CHANGE);
+	return node;
+}
+
+//*\brief Function to create SeamFind Analyze Node - CPU
+VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindAnalyzeNode(vx_graph graph, vx_scalar current_frame, vx_array seam_pref, vx_scalar flag)
+{
+	vx_reference params[] = {
+		(vx_reference)current_frame,
+		(vx_reference)seam_pref,
+		(vx_reference)flag
+	};
+	vx_node node = stitchCreateNode(graph,
+		AMDOVX_KERNEL_STITCHING_SEAMFIND_ANALYZE,
+		params,
+		dimof(params));
+
 	return node;
 }
 
@@ -715,10 +797,13 @@ VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandUpscaleGaussianAddNode(vx_graph
 }
 
 VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandLaplacianReconstructNode(vx_graph graph, vx_uint32 num_cameras, vx_uint32 blend_array_offs,
-	vx_image input1, vx_image input2, vx_array valid_arr, vx_image output)
+	vx_image input1, vx_image input2, vx_array valid_arr, vx_image output, vx_image interior_input, vx_uint32 interior_array_offs)
 {
 	vx_scalar numCam = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &num_cameras);
 	vx_scalar array_offs = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &blend_array_offs);
+	vx_scalar interior_offs = nullptr;
+	if (interior_input && interior_array_offs)
+		interior_offs = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &interior_array_offs);
 
 	vx_reference params[] = {
 		(vx_reference)numCam,
@@ -726,7 +811,9 @@ VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandLaplacianReconstructNode(vx_grap
 		(vx_reference)input1,
 		(vx_reference)input2,
 		(vx_reference)valid_arr,
-		(vx_reference)output
+		(vx_reference)output,
+		(vx_reference)(interior_offs ? interior_input : nullptr),
+		(vx_reference)interior_offs
 	};
 	vx_node node = stitchCreateNode(graph,
 		AMDOVX_KERNEL_STITCHING_LAPLACIAN_RECONSTRUCT,
@@ -735,10 +822,43 @@ VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandLaplacianReconstructNode(vx_grap
 
 	vxReleaseScalar(&numCam);
 	vxReleaseScalar(&array_offs);
+	if (interior_offs) vxReleaseScalar(&interior_offs);
 	return node;
 
 }
 
+VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandFusedNode(vx_graph graph, vx_uint32 num_cameras, vx_uint32 blend_array_offs, vx_uint32 num_bands,
+	vx_image input, vx_image weight_img, vx_array valid_arr, vx_image output, vx_uint32 interior_array_offs)
+{
+	vx_scalar numCam = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &num_cameras);
+	vx_scalar array_offs = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &blend_array_offs);
+	vx_scalar numBands = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &num_bands);
+	vx_scalar interior_offs = nullptr;
+	if (interior_array_offs)
+		interior_offs = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_UINT32, &interior_array_offs);
+
+	vx_reference params[] = {
+		(vx_reference)numCam,
+		(vx_reference)array_offs,
+		(vx_reference)numBands,
+		(vx_reference)input,
+		(vx_reference)weight_img,
+		(vx_reference)valid_arr,
+		(vx_reference)output,
+		(vx_reference)interior_offs
+	};
+	vx_node node = stitchCreateNode(graph,
+		AMDOVX_KERNEL_STITCHING_MULTIBAND_FUSED,
+		params,
+		dimof(params));
+
+	vxReleaseScalar(&numCam);
+	vxReleaseScalar(&array_offs);
+	vxReleaseScalar(&numBands);
+	if (interior_offs) vxReleaseScalar(&interior_offs);
+	return node;
+}
+
 #if _WIN32
 #pragma comment(lib, "OpenCL.lib")
 #endif
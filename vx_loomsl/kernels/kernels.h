@@ -135,7 +135,10 @@ enum vx_kernel_stitching_amd_e {
 	AMDOVX_KERNEL_STITCHING_SEAMFIND_SET_WEIGHTS = VX_KERNEL_BASE(VX_ID_AMD, AMDOVX_LIBRARY_STITCHING) + 0x016,
 
 	//! \brief The Seam Finding kernel. Kernel name is "com.amd.stitching.seamfind_analyze".
-	AMDOVX_KERNEL_STITCHING_SEAMFIND_ANALYZE = VX_KERNEL_BASE(VX_ID_AMD, AMDOVX_LIBRARY_STITCHING) + 0x017
+	AMDOVX_KERNEL_STITCHING_SEAMFIND_ANALYZE = VX_KERNEL_BASE(VX_ID_AMD, AMDOVX_LIBRARY_STITCHING) + 0x017,
+
+	//! \brief The fused Multiband Blend kernel. Kernel name is "com.amd.loomsl.multiband_fused".
+	AMDOVX_KERNEL_STITCHING_MULTIBAND_FUSED = VX_KERNEL_BASE(VX_ID_AMD, AMDOVX_LIBRARY_STITCHING) + 0x018
 
 };
 
@@ -173,6 +176,18 @@ typedef struct {
 	unsigned int  end_y : 8;		// ending pixel y-coordinate within the 128x32 block
 } StitchExpCompCalcEntry;
 
+//////////////////////////////////////////////////////////////////////
+//! \brief The exposure comp block statistics for one StitchOverlapPixelEntry (block gains mode).
+//  Luma sums are over pixels valid in both cameras of the entry.
+#define EXPCOMP_GAIN_BLOCK_WIDTH    128 // block gains grid cell width (same as StitchOverlapPixelEntry blocks)
+#define EXPCOMP_GAIN_BLOCK_HEIGHT   32  // block gains grid cell height
+typedef struct {
+	vx_uint32 sumI;     // luma sum of camId0
+	vx_uint32 sumJ;     // luma sum of camId1
+	vx_uint32 count;    // number of pixels in the overlap
+	vx_uint32 reserved; // reserved (shall be zero)
+} StitchExpCompBlockStats;
+
 typedef struct {
 	unsigned int camId : 5; // destination buffer/camera ID
 	unsigned int dstX : 14; // destination pixel x-coordinate (integer)
@@ -183,6 +198,11 @@ typedef struct {
 	unsigned int start_y : 8; // starting pixel y-coordinate within the 64x16 block
 } StitchBlendValidEntry;
 
+//! \brief The camera owner map of the multiband blend: one byte per cell of the equirectangular output.
+#define MULTIBAND_OWNER_CELL		16		// cell size in pixels
+#define MULTIBAND_OWNER_NONE		0xfe	// no camera covers the cell
+#define MULTIBAND_OWNER_MIXED		0xff	// more than one camera covers the cell
+
 //////////////////////////////////////////////////////////////////////
 //! \brief The warp pixel remap entry for 8 consecutive pixel locations.
 //  Entry is invalid if srcX and srcY has all bits set to 1s.
@@ -238,6 +258,8 @@ typedef struct {
 	vx_float32 seam_stagger;
 	vx_float32 multi_band;
 	vx_float32 num_bands;
+	vx_float32 multi_band_interior;
+	vx_float32 reinitialize;             // keep the camera tables in node local data for the re-initializations
 } InitializeStitchAttributes;
 
 //! \brief The Seam Size Information struct.
@@ -295,13 +317,14 @@ typedef struct {
 	vx_int16 overlap_type;	// Overlap Type: 0: Vert Seam 1: Hort Seam 2: Diag Seam
 } StitchSeamFindWeightEntry;
 
-//! \brief The Output Accum entry for Seam Find.
-typedef struct{
-	vx_int16 parent_x;		//pixel x-coordinate of parent (integer)
-	vx_int16 parent_y;		//pixel y-coordinate of parent (integer)
-	vx_int32 value;			//value accumulated
-	vx_int32 propagate;		//propogate paths from start to finish
-}StitchSeamFindAccumEntry;
+//! \brief The packed parent offset of a Seam Find accumulate entry.
+// The accumulate output is kept as two arrays with the same indexing: the accumulated values (vx_int32)
+// and the parent offsets (vx_uint8). Bits 0-1 of the parent offset select the lane of the parent in the
+// previous step of the seam (0: lane-1, 1: same lane, 2: lane+1, 3: no parent) and bit 2 is set when the
+// path propagates from the start of the seam.
+#define SEAMFIND_PARENT_LANE_MASK	0x03
+#define SEAMFIND_PARENT_NONE		0x03
+#define SEAMFIND_PARENT_PROPAGATE	0x04
 
 //! \brief The path entry for Seam Find.
 typedef struct {
@@ -309,6 +332,14 @@ typedef struct {
 	vx_int16 weight_value_i;    //mask Value             (integer)
 } StitchSeamFindPathEntry;
 
+//! \brief The tile entry for Seam Find cost generation: only the tiles that cover an overlap are processed.
+#define SEAMFIND_COST_TILE_WIDTH	128
+#define SEAMFIND_COST_TILE_HEIGHT	16
+typedef struct {
+	vx_uint32 x;				// x-coordinate of the top-left pixel of the tile (multiple of SEAMFIND_COST_TILE_WIDTH)
+	vx_uint32 y;				// y-coordinate of the top-left pixel of the tile in the stacked camera image (multiple of SEAMFIND_COST_TILE_HEIGHT)
+} StitchSeamFindCostTile;
+
 //! \brief The Scene Change Segments for Seam Find.
 #define MAX_SEGMENTS 24
 #define MAX_SEAM_BYTES 8
@@ -383,6 +414,7 @@ vx_status half_scale_gaussian_publish(vx_context context);
 vx_status upscale_gaussian_subtract_publish(vx_context context);
 vx_status upscale_gaussian_add_publish(vx_context context);
 vx_status laplacian_reconstruct_publish(vx_context context);
+vx_status multiband_fused_publish(vx_context context);
 
 //SeamFind Kernels
 vx_status seamfind_model_publish(vx_context context);
@@ -417,7 +449,7 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchConfigNode(vx_graph graph
 	vx_image camera_id_image, vx_image group1_image, vx_image group2_image,
 	vx_array exp_comp_calc, vx_image mask_image, vx_array overlap_rect,
 	vx_array seamfind_valid, vx_array seamfind_accum, vx_array seamfind_weight, vx_array seamfind_pref, vx_array seamfind_info,
-	vx_array twoband_blend);
+	vx_array twoband_blend, vx_array seamfind_parent, vx_array seamfind_cost_tiles);
 
 /*! \brief [Graph] Creates a Color Convert node.
 * \param [in] graph The reference to the graph.
@@ -429,15 +461,23 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchConfigNode(vx_graph graph
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchColorConvertNode(vx_graph graph, vx_image input, vx_image output);
 
-/*! \brief [Graph] Creates a Lens Distortion node.
+/*! \brief [Graph] Creates a Lens Distortion Remap node: the remap of the undistorted image of each camera in the warp table layout.
 * \param [in] graph The reference to the graph.
-* \param [in] input The input lens param matrix.
-* \param [out] output The output remap table.
+* \param [in] num_buff_rows The number of camera rows in the input buffer.
+* \param [in] num_buff_cols The number of camera columns in the input buffer.
+* \param [in] cam_buffer_width The input buffer width (the camera width must be a multiple of 8).
+* \param [in] cam_buffer_height The input buffer height.
+* \param [in] camera_param The array of camera_params.
+* \param [out] ValidPixelEntry The array of StitchValidPixelEntry: only the 8-pixel groups with a valid pixel.
+* \param [out] WarpRemapEntry The array of StitchWarpRemapEntry: source pixels in Q13.3 format.
+* The undistorted image of a camera has the dimensions of the camera image, so the tables can be applied with
+* stitchWarpNode to an output image of the camera width and num_buff_rows * num_buff_cols camera heights.
 * \see <tt>AMDOVX_KERNEL_STITCHING_LENS_DISTORTION_REMAP</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
-VX_API_ENTRY vx_node VX_API_CALL stitchLensDistortionNode(vx_graph graph, vx_matrix lens_param, vx_matrix warp_param, vx_matrix rig_parm, vx_remap table, vx_array warp_ROI);
+VX_API_ENTRY vx_node VX_API_CALL stitchLensDistortionRemapNode(vx_graph graph, vx_uint32 num_buff_rows, vx_uint32 num_buff_cols,
+	vx_uint32 cam_buffer_width, vx_uint32 cam_buffer_height, vx_array camera_param, vx_array ValidPixelEntry, vx_array WarpRemapEntry);
 
 /*! \brief [Graph] Creates a Warp node.
 * \param [in] graph The reference to the graph.
@@ -500,12 +540,13 @@ VX_API_ENTRY vx_node VX_API_CALL stitchInitializeStitchRemapNode(vx_graph graph,
 * \param [in] exp_data   Input Array of expdata.
 * \param [in] mask       Mask image.
 * \param [out] out_intensity     Output matrix for sum of overlapping pixels.
+* \param [out] out_block_stats   Optional output array of StitchExpCompBlockStats, one per exp_data entry (block gains mode).
 * \see <tt>AMDOVX_KERNEL_STITCHING_EXPOSURE_COMP_CALC_ERROR_FUNC</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph graph, vx_uint32 numCameras,
-	vx_image input, vx_array exp_data, vx_image mask, vx_matrix out_intensity);
+	vx_image input, vx_array exp_data, vx_image mask, vx_matrix out_intensity, vx_array out_block_stats);
 
 
 /*! \brief [Graph] Creates a ExposureCompSolveForGain node.
@@ -515,12 +556,17 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompCalcErrorFnNode(vx_graph grap
 * \param [in] in_intensity  Input matrix for sum of overlapping pixels.
 * \param [in] in_count      Input matrix for count of overlapping pixels.
 * \param [out] out_gains    Output array for gains.
+* \param [in] block_gain_width  Number of EXPCOMP_GAIN_BLOCK_WIDTH columns in the block gains grid (block gains mode).
+* \param [in] in_overlap_pixel  Optional array of StitchOverlapPixelEntry (block gains mode).
+* \param [in] in_block_stats    Optional array of StitchExpCompBlockStats (block gains mode).
+* \param [out] out_block_gains  Optional output array for smoothed gains per camera per block: [camera][block_y][block_x].
 * \see <tt>AMDOVX_KERNEL_STITCHING_EXPOSURE_COMP_SOLVE_FOR_GAIN</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph graph, vx_float32 alpha,
-	vx_float32 beta, vx_matrix in_intensity, vx_matrix in_count, vx_array out_gains);
+	vx_float32 beta, vx_matrix in_intensity, vx_matrix in_count, vx_array out_gains,
+	vx_uint32 block_gain_width, vx_array in_overlap_pixel, vx_array in_block_stats, vx_array out_block_gains);
 
 /*! \brief [Graph] Creates a ExposureCompApplyGain node.
 * \param [in] graph      The reference to the graph.
@@ -528,12 +574,13 @@ VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompSolveForGainNode(vx_graph gra
 * \param [in] in_gains   Array of valid regions of rectangles
 * \param [in] in_offsets Array of StitchExpCompCalcEntry
 * \param [out] output    Exposure adjusted image.
+* \param [in] in_block_gains Optional array of gains per camera per block, bilinearly interpolated instead of in_gains.
 * \see <tt>AMDOVX_KERNEL_STITCHING_EXPOSURE_COMP_SOLVE_FOR_GAIN</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchExposureCompApplyGainNode(vx_graph graph, vx_image input,
-	vx_array in_gains, vx_array in_offsets, vx_image output);
+	vx_array in_gains, vx_array in_offsets, vx_image output, vx_array in_block_gains);
 
 /*! \brief [Graph] Creates a stitchBlendMultiBandMerge node.
 * \param [in] graph         The reference to the graph.
@@ -603,12 +650,32 @@ VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandUpscaleGaussianAddNode(vx_graph
 * \param [in] input2 The src image2
 * \param [in] valid_arr The offsets/valid rect array (offsets will be useful for GPU kernel)
 * \param [out] output image.
+* \param [in] interior_input The src image (RGBX) copied to the interior tiles (optional)
+* \param [in] interior_array_offs The start_offset of the interior tiles to valid_arr in #of elements (0: no interior tiles)
 * \see <tt>AMDOVX_KERNEL_STITCHING_LAPLACIAN_RECONSTRUCT</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandLaplacianReconstructNode(vx_graph graph, vx_uint32 num_cameras, vx_uint32 blend_array_offs,
-	vx_image input1, vx_image input2, vx_array valid_arr, vx_image output);
+	vx_image input1, vx_image input2, vx_array valid_arr, vx_image output, vx_image interior_input, vx_uint32 interior_array_offs);
+
+/*! \brief [Graph] Creates a stitchMultiBandFused node: builds the gaussian and laplacian pyramids, blends and reconstructs
+* one block at a time, without the per-level images and nodes. Processed on the CPU.
+* \param [in] graph The reference to the graph.
+* \param [in] num_cameras The number of cameras
+* \param [in] blend_array_offs The start_offset of level 0 to valid_arr in #of elements
+* \param [in] num_bands The number of bands
+* \param [in] input The src image (RGBX) after exposure compensation
+* \param [in] weight_img The weight image (U8)
+* \param [in] valid_arr The offsets/valid rect array
+* \param [out] output The reconstructed image (RGBX).
+* \param [in] interior_array_offs The start_offset of the interior tiles to valid_arr in #of elements (0: no interior tiles)
+* \see <tt>AMDOVX_KERNEL_STITCHING_MULTIBAND_FUSED</tt>
+* \return <tt>\ref vx_node</tt>.
+* \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
+*/
+VX_API_ENTRY vx_node VX_API_CALL stitchMultiBandFusedNode(vx_graph graph, vx_uint32 num_cameras, vx_uint32 blend_array_offs, vx_uint32 num_bands,
+	vx_image input, vx_image weight_img, vx_array valid_arr, vx_image output, vx_uint32 interior_array_offs);
 
 /***********************************************************************************************************************************
 Seam Find
@@ -640,25 +707,28 @@ VX_API_ENTRY vx_node VX_API_CALL stitchWarpU8Node(vx_graph graph, vx_enum method
 * \param [in] seam_info The input array of seam info.
 * \param [out] seam_pref The array of seam preference.
 * \param [out] output The array of seam scene change.
+* \param [in] scene_duration The number of frames the seam stays locked after a scene change (0: default of 150).
+* \param [in] view_scene_change The scene change display: 0:OFF 1:dark 2:bright.
 * \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_K0</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSceneDetectNode(vx_graph graph, vx_scalar current_frame, vx_scalar scene_threshold,
-	vx_image input_image, vx_array seam_info, vx_array seam_pref, vx_array seam_scene_change);
+	vx_image input_image, vx_array seam_info, vx_array seam_pref, vx_array seam_scene_change, vx_uint32 scene_duration, vx_uint32 view_scene_change);
 
-/*! \brief [Graph] Creates a SeamFind Cost Generate node - K1 - GPU.
+/*! \brief [Graph] Creates a SeamFind Cost Generate node - K1 - GPU/CPU.
 * \param [in] graph The reference to the graph.
 * \param [in] executeFlag The input scalar to bypass the execution of kernel.
 * \param [in] input_weight_image The input U8 weight image from Warp.
 * \param [out] magnitude_image The output magnitude image.
 * \param [out] phase_image The output phase image.
+* \param [in] cost_tiles The input array of StitchSeamFindCostTile (optional): only the tiles covering the overlaps are computed.
 * \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_GENERATE</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostGenerateNode(vx_graph graph, vx_scalar executeFlag,
-	vx_image input_weight_image, vx_image magnitude_image, vx_image phase_image);
+	vx_image input_weight_image, vx_image magnitude_image, vx_image phase_image, vx_array cost_tiles);
 
 /*! \brief [Graph] Creates a SeamFind Accumulate node K2 - GPU.
 * \param [in] graph The reference to the graph.
@@ -690,29 +760,36 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindK2Node(vx_graph graph, vx_scalar
 * \param [in] valid_seam    The input array of valid_seam pixels.
 * \param [in] pref_seam     The input array of seam preference.
 * \param [in] info_seam     The input seam info array.
-* \param [out] output       The output seam_accum array.
+* \param [out] accum_seam   The output array of accumulated values (VX_TYPE_INT32).
+* \param [out] parent_seam  The output array of packed parent offsets (VX_TYPE_UINT8).
+* \param [in] corridor      The half width in pixels of the band around the previous seam searched by a seam refresh
+*                           (0: full search). A seam started by a scene change is always searched in full.
+* \param [in] coarse_scale  The downscale factor of the cost used to find a coarse seam, refined at full resolution in a band
+*                           of three blocks around it when there is no previous seam to search around (0: no coarse seam).
 * \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_K2</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindCostAccumulateNode(vx_graph graph, vx_scalar current_frame,
 	vx_uint32 output_width, vx_uint32 output_height, vx_image magnitude_img, vx_image phase_img,
-	vx_image mask_img, vx_array valid_seam, vx_array pref_seam, vx_array info_seam, vx_array accum_seam);
+	vx_image mask_img, vx_array valid_seam, vx_array pref_seam, vx_array info_seam, vx_array accum_seam, vx_array parent_seam,
+	vx_uint32 corridor, vx_uint32 coarse_scale);
 
 /*! \brief [Graph] Creates a SeamFind Accumulate node K3_A - GPU/CPU.
 * \param [in] graph The reference to the graph.
 * \param [in] current_frame The Current Frame.
 * \param [in] weight_image  The input Weight Image
 * \param [in] seam_info     The input seam info array.
-* \param [in] seam_accum    The input seam_accum array.
+* \param [in] seam_accum    The input array of accumulated values.
 * \param [in] seam_pref     The input array of seam preference
 * \param [out] output       The Path Array.
+* \param [in] seam_parent   The input array of packed parent offsets.
 * \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_K3_A</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindPathTraceNode(vx_graph graph, vx_scalar current_frame, vx_image weight_image, vx_array seam_info,
-	vx_array seam_accum, vx_array seam_pref, vx_array paths);
+	vx_array seam_accum, vx_array seam_pref, vx_array paths, vx_array seam_parent);
 
 /*! \brief [Graph] Creates a SeamFind Accumulate node K3_B - GPU.
 * \param [in] graph         The reference to the graph.
@@ -724,13 +801,25 @@ VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindPathTraceNode(vx_graph graph, vx_
 * \param [in] seam_path     The input array of seam path .
 * \param [in] seam_pref     The input array of seam preference.
 * \param [out] output       The weight image.
+* \param [in] view_scene_change The scene change display: 0:OFF 1:dark 2:bright (same as the scene detect node).
 * \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_K3_B</tt>
 * \return <tt>\ref vx_node</tt>.
 * \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
 */
 VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindSetWeightsNode(vx_graph graph, vx_scalar current_frame, vx_uint32 NumCam,
 	vx_uint32 output_width, vx_uint32 output_height, vx_array seam_weight, vx_array seam_path,
-	vx_array seam_pref, vx_image weight_image);
+	vx_array seam_pref, vx_image weight_image, vx_uint32 view_scene_change);
+
+/*! \brief [Graph] Creates a SeamFind Analyze node - CPU.
+* \param [in] graph         The reference to the graph.
+* \param [in] current_frame The input Current Frame.
+* \param [in] seam_pref     The input array of seam preference.
+* \param [out] flag         The output scalar: non-zero if a seam is due on the current frame.
+* \see <tt>AMDOVX_KERNEL_STITCHING_SEAMFIND_ANALYZE</tt>
+* \return <tt>\ref vx_node</tt>.
+* \retval vx_node A node reference. Any possible errors preventing a successful creation should be checked using <tt>\ref vxGetStatus</tt>
+*/
+VX_API_ENTRY vx_node VX_API_CALL stitchSeamFindAnalyzeNode(vx_graph graph, vx_scalar current_frame, vx_array seam_pref, vx_scalar flag);
 
 /*! \brief [Graph] Creates a SeamFind CPU Node.
 * \param [in] graph         The reference to the graph.
@@ -762,10 +851,10 @@ vx_status simple_blend(vx_uint32 BLEND_MODE, vx_uint32 BLEND_HORIZONTAL, vx_uint
 vx_status Seamfind_CopyWeights(vx_image weight_image, vx_image new_weight_image, vx_rectangle_t *Overlap_ROI, vx_int32 *Overlap_matrix, vx_uint32 width, vx_uint32 height, vx_uint32 NumCam);
 vx_status Seamfind_seamrange(vx_uint32 *seam_adjust, vx_uint32 x_dir);
 vx_uint32 Compute_StitchBlendArraySize(int width, int height, int num_camera, int num_bands, vx_uint32 offset[]);
-vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pOverlap_roi, vx_array blendOffs, int numCameras, int numBands, int width, int height);
+vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pOverlap_roi, vx_array blendOffs, int numCameras, int numBands, int width, int height, const vx_uint8 * cell_owner);
 vx_node stitchCreateNode(vx_graph graph, vx_enum kernelEnum, vx_reference params[], vx_uint32 num);
 vx_node stitchCreateNode(vx_graph graph, const char * kernelName, vx_reference params[], vx_uint32 num);
 vx_status seamfind_utility(vx_uint32 mode, vx_uint32 eqr_width, vx_uint32 num_cam, SeamFindSizeInfo *entry_var);
-vx_status seamfind_accurate_utility(vx_uint32 mode, vx_uint32 num_cam, vx_uint32 ip_width, vx_uint32 ip_height, vx_uint32 eqr_width, vx_matrix mat_rig_params, vx_array array_cam_params, SeamFindSizeInfo *entry_var);
+vx_status seamfind_accurate_utility(vx_uint32 mode, vx_uint32 num_cam, vx_uint32 num_buff_cols, vx_uint32 ip_width, vx_uint32 ip_height, vx_uint32 eqr_width, vx_matrix mat_rig_params, vx_array array_cam_params, SeamFindSizeInfo *entry_var);
 
 #endif //__VX_STITCHING_H__
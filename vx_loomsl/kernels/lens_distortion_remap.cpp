@@ -21,13 +21,209 @@ THE SOFTWARE.
 */
 
 #include "kernels.h"
+#include "projection.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
-#include <omp.h>
+#include <string.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+//! \brief Compute the remap entries of a row of the undistorted image of a camera: only the 8-pixel groups with a valid pixel are kept.
+static void lens_distortion_remap_row(const camera_params * par, const stitch_projection_camera * proj, vx_uint32 cam, vx_uint32 num_buff_cols,
+	vx_uint32 src_width, vx_uint32 src_height, vx_uint32 y, std::vector<StitchValidPixelEntry>& valid_entry, std::vector<StitchWarpRemapEntry>& remap_entry)
+{
+	float width2 = (float)src_width * 0.5f, height2 = (float)src_height * 0.5f;
+	float inv_f1 = (proj->f[1] > 0.0f) ? 1.0f / proj->f[1] : 0.0f;
+	float src_width_start = (float)((cam % num_buff_cols) * src_width), src_width_end = src_width_start + (float)src_width - 1.0f;
+	float dy = (float)y - height2;
+	for (vx_uint32 x0 = 0; x0 < src_width; x0 += 8) {
+		StitchWarpRemapEntry remap;
+		memset(&remap, 0xff, sizeof(remap));
+		vx_uint16 * coord = &remap.srcX0;
+		vx_uint32 count = 0;
+		for (vx_uint32 k = 0; k < 8; k++, coord += 2) {
+			float dx = (float)(x0 + k) - width2;
+			float rr = sqrtf(dx * dx + dy * dy);
+			float scale = stitchProjectionLensScale(proj, rr * inv_f1);
+			float xd = proj->cx + dx * scale, yd = proj->cy + dy * scale;
+			if (xd >= src_width_start && xd < src_width_end && yd >= 0 && yd < (float)src_height - 1.0f && (par->lens.r_crop <= 0.0f || rr * scale <= par->lens.r_crop)) {
+				// Q13.3 format
+				coord[0] = (vx_uint16)(xd * 8.0f);
+				coord[1] = (vx_uint16)(yd * 8.0f);
+				count++;
+			}
+		}
+		if (count > 0) {
+			StitchValidPixelEntry valid = { 0 };
+			valid.camId = cam;
+			valid.allValid = (count == 8) ? 1 : 0;
+			valid.dstX = x0 >> 3;
+			valid.dstY = y;
+			valid_entry.push_back(valid);
+			remap_entry.push_back(remap);
+		}
+	}
+}
+
+//! \brief The validator callback.
+static vx_status VX_CALLBACK lens_distortion_remap_validate(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_meta_format metas[])
+{
+	// check scalar types
+	vx_enum types[4] = { VX_TYPE_INVALID, VX_TYPE_INVALID, VX_TYPE_INVALID, VX_TYPE_INVALID };
+	for (int i = 0; i < 4; i++) {
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)parameters[i], VX_SCALAR_ATTRIBUTE_TYPE, &types[i], sizeof(vx_enum)));
+		if (types[i] != VX_TYPE_UINT32) {
+			vx_status status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: scalar type not valid\n");
+			return status;
+		}
+	}
+
+	// read scalar values: the undistorted image of a camera has the dimensions of the camera image
+	vx_uint32 num_buff_rows = 0, num_buff_cols = 0, cam_buffer_width = 0, cam_buffer_height = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_buff_rows));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &num_buff_cols));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[2], &cam_buffer_width));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[3], &cam_buffer_height));
+	if (num_buff_rows < 1 || num_buff_cols < 1 || cam_buffer_width < 1 || cam_buffer_height < 1) {
+		vx_status status = VX_ERROR_INVALID_VALUE;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: scalar value not valid\n");
+		return status;
+	}
+	vx_uint32 num_cam = num_buff_rows * num_buff_cols;
+	vx_uint32 src_width = cam_buffer_width / num_buff_cols, src_height = cam_buffer_height / num_buff_rows;
+	if (num_cam > 31 || (src_width & 7) || src_width > 16384 || src_height > 8192 || cam_buffer_width >= 8192 || cam_buffer_height >= 8192) {
+		vx_status status = VX_ERROR_INVALID_DIMENSION;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: camera buffer dimensions are not valid (%dx%d for %dx%d cameras)\n",
+			cam_buffer_width, cam_buffer_height, num_buff_cols, num_buff_rows);
+		return status;
+	}
+
+	// check camera config array dimensions
+	vx_size size = 0, num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[4], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[4], VX_ARRAY_ATTRIBUTE_CAPACITY, &num_items, sizeof(num_items)));
+	if (size != sizeof(camera_params) || (num_items != num_cam)) {
+		vx_status status = VX_ERROR_INVALID_TYPE;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: camera params array type/dimensions are not valid\n");
+		return status;
+	}
+
+	// valid pixel and warp remap arrays: at most one entry per 8 pixels of each camera
+	vx_size capacity = vx_size(src_width / 8) * src_height * num_cam;
+	vx_enum type = VX_TYPE_INVALID;
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[5], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[5], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+	ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[5], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+	ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[5], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+	if (size != sizeof(StitchValidPixelEntry)) {
+		vx_status status = VX_ERROR_INVALID_TYPE;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: valid pixel array type is not valid\n");
+		return status;
+	}
+	type = VX_TYPE_INVALID;
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[6], VX_ARRAY_ATTRIBUTE_ITEMSIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxQueryArray((vx_array)parameters[6], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+	ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[6], VX_ARRAY_ATTRIBUTE_ITEMTYPE, &type, sizeof(type)));
+	ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(metas[6], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+	if (size != sizeof(StitchWarpRemapEntry)) {
+		vx_status status = VX_ERROR_INVALID_TYPE;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: warp remap array type is not valid\n");
+		return status;
+	}
+
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel execution.
+static vx_status VX_CALLBACK lens_distortion_remap_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	// get num cameras and image dimensions
+	vx_uint32 num_buff_rows = 0, num_buff_cols = 0, cam_buffer_width = 0, cam_buffer_height = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_buff_rows));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &num_buff_cols));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[2], &cam_buffer_width));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[3], &cam_buffer_height));
+	vx_uint32 num_cam = num_buff_rows * num_buff_cols;
+	vx_uint32 src_width = cam_buffer_width / num_buff_cols, src_height = cam_buffer_height / num_buff_rows;
+
+	// get camera parameters
+	vx_array array_cam = (vx_array)parameters[4];
+	camera_params * cam_par = nullptr;
+	vx_size stride = sizeof(camera_params), num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(array_cam, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+	if (num_items != num_cam) {
+		vx_status status = VX_ERROR_INVALID_TYPE;
+		vxAddLogEntry((vx_reference)node, status, "ERROR: lens_distortion_remap: camera parameter dimensions are not valid\n");
+		return status;
+	}
+	ERROR_CHECK_STATUS(vxAccessArrayRange(array_cam, 0, num_items, &stride, (void **)&cam_par, VX_READ_ONLY));
+	// the lens model and optical center of each camera: the rig orientation is not used
+	rig_params rig_par = { 0 };
+	std::vector<stitch_projection_camera> proj(num_cam);
+	for (vx_uint32 cam = 0; cam < num_cam; cam++) {
+		if (stitchProjectionSetup(&proj[cam], &rig_par, &cam_par[cam], cam, num_buff_cols, src_width, src_height) != VX_SUCCESS) {
+			vxAddLogEntry((vx_reference)array_cam, VX_ERROR_INVALID_TYPE, "ERROR: lens_distortion_remap: lens_type = %d not supported [cam#%d]\n", cam_par[cam].lens.lens_type, cam);
+			ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam, 0, num_cam, cam_par));
+			return VX_ERROR_INVALID_TYPE;
+		}
+	}
+
+	// compute the remap entries of each row of each camera in parallel and append them in camera and row order
+	int num_rows = (int)(num_cam * src_height);
+	std::vector<std::vector<StitchValidPixelEntry>> valid_entry(num_rows);
+	std::vector<std::vector<StitchWarpRemapEntry>> remap_entry(num_rows);
+	std::atomic<int> next_row(0);
+	auto row_thread_func = [&]() {
+		for (int row = next_row++; row < num_rows; row = next_row++) {
+			vx_uint32 cam = (vx_uint32)row / src_height, y = (vx_uint32)row % src_height;
+			lens_distortion_remap_row(&cam_par[cam], &proj[cam], cam, num_buff_cols, src_width, src_height, y, valid_entry[row], remap_entry[row]);
+		}
+	};
+	int num_threads = std::max(1, std::min((int)std::thread::hardware_concurrency(), num_rows));
+	std::vector<std::thread> row_thread;
+	for (int i = 1; i < num_threads; i++)
+		row_thread.push_back(std::thread(row_thread_func));
+	row_thread_func();
+	for (size_t i = 0; i < row_thread.size(); i++)
+		row_thread[i].join();
+	ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam, 0, num_cam, cam_par));
+
+	vx_array arr_valid = (vx_array)parameters[5];
+	vx_array arr_remap = (vx_array)parameters[6];
+	ERROR_CHECK_STATUS(vxTruncateArray(arr_valid, 0));
+	ERROR_CHECK_STATUS(vxTruncateArray(arr_remap, 0));
+	for (int row = 0; row < num_rows; row++) {
+		vx_size count = valid_entry[row].size();
+		if (count > 0) {
+			ERROR_CHECK_STATUS(vxAddArrayItems(arr_valid, count, &valid_entry[row][0], sizeof(StitchValidPixelEntry)));
+			ERROR_CHECK_STATUS(vxAddArrayItems(arr_remap, count, &remap_entry[row][0], sizeof(StitchWarpRemapEntry)));
+		}
+	}
+
+	return VX_SUCCESS;
+}
 
 //! \brief The kernel publisher.
 vx_status lens_distortion_remap_publish(vx_context context)
 {
-	// nothing to do
+	// add kernel to the context with callbacks
+	vx_kernel kernel = vxAddUserKernel(context, "com.amd.loomsl.lens_distortion_remap", AMDOVX_KERNEL_STITCHING_LENS_DISTORTION_REMAP, lens_distortion_remap_kernel, 7, lens_distortion_remap_validate, nullptr, nullptr);
+	ERROR_CHECK_OBJECT(kernel);
+
+	// set kernel parameters
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED)); // num_buff_rows
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED)); // num_buff_cols
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED)); // cam_buffer_width
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED)); // cam_buffer_height
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));  // camera_params[]
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED)); // valid pixel entries
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED)); // warp remap entries
+
+	// finalize and release kernel object
+	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
+	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
+
 	return VX_SUCCESS;
 }
@@ -22,9 +22,15 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "thread_pool.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
+#include <vector>
+#include <emmintrin.h>
+#include <atomic>
+
+#define MERGE_WEIGHT_Q 14 // fixed-point precision of the CPU blend weights
 
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK merge_input_validator(vx_node node, vx_uint32 index)
@@ -220,7 +226,7 @@ static vx_status VX_CALLBACK merge_query_target_support(vx_graph graph, vx_node
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -444,19 +450,161 @@ static vx_status VX_CALLBACK merge_opencl_codegen(
 //! \brief The kernel initialize.
 static vx_status VX_CALLBACK merge_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_SUCCESS;
+	return stitch_thread_pool_initialize(node, parameters, num);
 }
 
 //! \brief The kernel deinitialize.
 static vx_status VX_CALLBACK merge_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_SUCCESS;
+	return stitch_thread_pool_deinitialize(node, parameters, num);
+}
+
+//! \brief Accumulate 8 RGBX pixels scaled by per-pixel Q14 weights into 32-bit accumulators.
+static inline void merge_accumulate_8(__m128i acc[8], const vx_uint8 * src, const vx_int32 wt[8])
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (int k = 0; k < 8; k += 4) {
+		__m128i px = _mm_loadu_si128((const __m128i *)(src + k * 4));
+		__m128i lo = _mm_unpacklo_epi8(px, zero), hi = _mm_unpackhi_epi8(px, zero);
+		acc[k + 0] = _mm_add_epi32(acc[k + 0], _mm_madd_epi16(_mm_unpacklo_epi16(lo, zero), _mm_set1_epi32(wt[k + 0])));
+		acc[k + 1] = _mm_add_epi32(acc[k + 1], _mm_madd_epi16(_mm_unpackhi_epi16(lo, zero), _mm_set1_epi32(wt[k + 1])));
+		acc[k + 2] = _mm_add_epi32(acc[k + 2], _mm_madd_epi16(_mm_unpacklo_epi16(hi, zero), _mm_set1_epi32(wt[k + 2])));
+		acc[k + 3] = _mm_add_epi32(acc[k + 3], _mm_madd_epi16(_mm_unpackhi_epi16(hi, zero), _mm_set1_epi32(wt[k + 3])));
+	}
 }
 
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK merge_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	vx_uint8 numBands = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &numBands));
+	if (numBands == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_array band_weights_array = (vx_array)parameters[1];
+	vx_image cam_id_image = (vx_image)parameters[2];
+	vx_image group1_image = (vx_image)parameters[3];
+	vx_image group2_image = (vx_image)parameters[4];
+	vx_image input_image = (vx_image)parameters[5];
+	vx_image weight_image = (vx_image)parameters[6];
+	vx_image output_image = (vx_image)parameters[7];
+
+	// get image configurations
+	vx_uint32 map_width = 0, map_height = 0, ip_width = 0, ip_height = 0, op_width = 0, op_height = 0;
+	vx_df_image output_format = VX_DF_IMAGE_VIRT;
+	ERROR_CHECK_STATUS(vxQueryImage(cam_id_image, VX_IMAGE_ATTRIBUTE_WIDTH, &map_width, sizeof(map_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(cam_id_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &map_height, sizeof(map_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_WIDTH, &ip_width, sizeof(ip_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &ip_height, sizeof(ip_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &op_width, sizeof(op_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &op_height, sizeof(op_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_FORMAT, &output_format, sizeof(output_format)));
+	vx_uint32 bandHeight = ip_height / numBands;
+
+	// convert band weights into Q14 lookup tables: a single camera uses the band weight only,
+	// overlapping cameras use (weight/255)*bandWeight
+	vx_float32 * bandWt = nullptr;
+	vx_size stride = sizeof(vx_float32);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(band_weights_array, 0, numBands, &stride, (void **)&bandWt, VX_READ_ONLY));
+	std::vector<vx_int32> single_wt(numBands), overlap_wt(numBands * 256);
+	const vx_float32 one = (vx_float32)(1 << MERGE_WEIGHT_Q);
+	for (vx_uint32 band = 0; band < numBands; band++) {
+		vx_float32 bw = *(vx_float32 *)((vx_uint8 *)bandWt + band * stride);
+		single_wt[band] = std::min(32767, std::max(0, (vx_int32)(bw * one + 0.5f)));
+		for (vx_uint32 v = 0; v < 256; v++)
+			overlap_wt[band * 256 + v] = std::min(32767, std::max(0, (vx_int32)(v * (1.0f / 255.0f) * bw * one + 0.5f)));
+	}
+	ERROR_CHECK_STATUS(vxCommitArrayRange(band_weights_array, 0, 0, bandWt));
+
+	// access images
+	vx_rectangle_t map_rect = { 0, 0, map_width, map_height };
+	vx_rectangle_t ip_rect = { 0, 0, ip_width, ip_height };
+	vx_rectangle_t op_rect = { 0, 0, op_width, op_height };
+	vx_imagepatch_addressing_t cam_id_addr, group1_addr, group2_addr, ip_addr, wt_addr, op_addr;
+	vx_uint8 * cam_id_buf = nullptr, *group1_buf = nullptr, *group2_buf = nullptr, *ip_buf = nullptr, *wt_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(cam_id_image, &map_rect, 0, &cam_id_addr, (void **)&cam_id_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(group1_image, &map_rect, 0, &group1_addr, (void **)&group1_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(group2_image, &map_rect, 0, &group2_addr, (void **)&group2_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &ip_rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(weight_image, &ip_rect, 0, &wt_addr, (void **)&wt_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &op_rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+	vx_int32 ip_stride = ip_addr.stride_y, wt_stride = wt_addr.stride_y, op_stride = op_addr.stride_y;
+	bool op_rgbx = (output_format == VX_DF_IMAGE_RGBX);
+
+	// each row of the camera id map is processed independently: one 8-pixel block per map entry
+	vx_uint32 rows = std::min(map_height, op_height), cols = std::min(map_width, op_width >> 3);
+	std::atomic<int> next_row(0);
+	std::function<void()> row_thread_func = [&]() {
+		for (int y = next_row++; y < (int)rows; y = next_row++) {
+			const vx_uint8 * cam_id_row = cam_id_buf + y * cam_id_addr.stride_y;
+			const vx_uint16 * group1_row = (const vx_uint16 *)(group1_buf + y * group1_addr.stride_y);
+			const vx_uint16 * group2_row = (const vx_uint16 *)(group2_buf + y * group2_addr.stride_y);
+			vx_uint8 * op_row = op_buf + y * op_stride;
+			for (vx_uint32 x = 0; x < cols; x++) {
+				vx_uint8 camIdSelect = cam_id_row[x];
+				if (camIdSelect == 31)
+					continue;
+				vx_uint32 cam_list[6], cam_count = 0;
+				if (camIdSelect < 31) {
+					cam_list[cam_count++] = camIdSelect;
+				}
+				else {
+					vx_uint32 groups = ((vx_uint32)group2_row[x] << 15) | group1_row[x];
+					vx_uint32 slots = (camIdSelect >= 128) ? (vx_uint32)std::min(6, camIdSelect - 126) : 2;
+					for (vx_uint32 i = 0; i < slots; i++) {
+						vx_uint32 camId = (groups >> (5 * i)) & 0x1f;
+						if (camId != 31) cam_list[cam_count++] = camId;
+					}
+				}
+				__m128i acc[8];
+				for (int k = 0; k < 8; k++) acc[k] = _mm_setzero_si128();
+				vx_int32 wt[8];
+				for (vx_uint32 band = 0; band < numBands; band++) {
+					for (vx_uint32 c = 0; c < cam_count; c++) {
+						vx_uint32 row = band * bandHeight + y + op_height * cam_list[c];
+						const vx_uint8 * src = ip_buf + row * ip_stride + (x << 5);
+						if (camIdSelect < 31) {
+							for (int k = 0; k < 8; k++) wt[k] = single_wt[band];
+						}
+						else {
+							const vx_uint8 * w = wt_buf + row * wt_stride + (x << 3);
+							const vx_int32 * lut = &overlap_wt[band * 256];
+							for (int k = 0; k < 8; k++) wt[k] = lut[w[k]];
+						}
+						merge_accumulate_8(acc, src, wt);
+					}
+				}
+				// round, saturate and store 8 output pixels
+				const __m128i round = _mm_set1_epi32(1 << (MERGE_WEIGHT_Q - 1));
+				for (int k = 0; k < 8; k += 4) {
+					__m128i p01 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(acc[k + 0], round), MERGE_WEIGHT_Q), _mm_srai_epi32(_mm_add_epi32(acc[k + 1], round), MERGE_WEIGHT_Q));
+					__m128i p23 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(acc[k + 2], round), MERGE_WEIGHT_Q), _mm_srai_epi32(_mm_add_epi32(acc[k + 3], round), MERGE_WEIGHT_Q));
+					__m128i pix = _mm_packus_epi16(p01, p23);
+					if (op_rgbx) {
+						pix = _mm_or_si128(pix, _mm_set1_epi32((int)0xff000000));
+						_mm_storeu_si128((__m128i *)(op_row + ((x << 3) + k) * 4), pix);
+					}
+					else {
+						vx_uint32 rgbx[4];
+						_mm_storeu_si128((__m128i *)rgbx, pix);
+						vx_uint8 * dst = op_row + ((x << 3) + k) * 3;
+						for (int i = 0; i < 4; i++, dst += 3) {
+							dst[0] = (vx_uint8)rgbx[i]; dst[1] = (vx_uint8)(rgbx[i] >> 8); dst[2] = (vx_uint8)(rgbx[i] >> 16);
+						}
+					}
+				}
+			}
+		}
+	};
+	stitch_thread_pool_run(node, (int)rows, row_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(cam_id_image, nullptr, 0, &cam_id_addr, cam_id_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(group1_image, nullptr, 0, &group1_addr, group1_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(group2_image, nullptr, 0, &group2_addr, group2_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, nullptr, 0, &wt_addr, wt_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &op_rect, 0, &op_addr, op_buf));
+
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel publisher.
@@ -22,6 +22,11 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "thread_pool.h"
+#include <string.h>
+#include <algorithm>
+#include <emmintrin.h>
+#include <atomic>
 //#include "blend.h"
 
 //! \brief The input validator callback.
@@ -145,7 +150,7 @@ static vx_status VX_CALLBACK multiband_blend_query_target_support(vx_graph graph
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -280,10 +285,93 @@ static vx_status VX_CALLBACK multiband_blend_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief Multiband blend of one tile on the host: the top pyramid level scaled by weight/255 and truncated to RGB4.
+static void multiband_blend_tile(const StitchBlendValidEntry& tile, vx_int32 width, vx_int32 height, bool ip_rgb4,
+	const vx_uint8 * ip_buf, vx_int32 ip_stride, const vx_uint8 * wt_buf, vx_int32 wt_stride, vx_uint8 * op_buf, vx_int32 op_stride)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x + 3) >> 2) << 2), width - x0);
+	vx_int32 ny = std::min((vx_int32)tile.end_y + 1, height - y0);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale_wt = _mm_set1_ps(0.00392157f);
+	for (vx_int32 y = 0; y < ny; y++) {
+		vx_int32 gy = tile.camId * height + y0 + y;
+		const vx_uint8 * ip = ip_buf + gy * ip_stride;
+		const vx_uint8 * wt = wt_buf + gy * wt_stride + x0;
+		vx_int16 * op = (vx_int16 *)(op_buf + gy * op_stride + x0 * 6);
+		for (vx_int32 x = 0; x < nx; x++) {
+			__m128i px;
+			if (ip_rgb4) {
+				const vx_int16 * p = (const vx_int16 *)(ip + (x0 + x) * 6);
+				px = _mm_setr_epi32(p[0], p[1], p[2], 0);
+			}
+			else {
+				px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)(ip + (x0 + x) * 4)), zero), zero);
+			}
+			__m128 f = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(px), _mm_set1_ps((vx_float32)wt[x])), scale_wt);
+			__m128i v = _mm_cvttps_epi32(f);
+			v = _mm_packs_epi32(v, v);
+			op[x * 3 + 0] = (vx_int16)_mm_extract_epi16(v, 0);
+			op[x * 3 + 1] = (vx_int16)_mm_extract_epi16(v, 1);
+			op[x * 3 + 2] = (vx_int16)_mm_extract_epi16(v, 2);
+		}
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK multiband_blend_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	vx_uint32 num_cameras = 0, arr_offs = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	if (num_cameras == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_image input_image = (vx_image)parameters[2];
+	vx_image weight_image = (vx_image)parameters[3];
+	vx_array arr = (vx_array)parameters[4];
+	vx_image output_image = (vx_image)parameters[5];
+
+	// get image configurations
+	vx_uint32 width = 0, height = 0;
+	vx_df_image input_format = VX_DF_IMAGE_VIRT;
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_FORMAT, &input_format, sizeof(input_format)));
+
+	// access tiles: the item just before the first tile of a level holds its number of tiles
+	vx_size num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+	if (arr_offs < 1 || arr_offs > num_items)
+		return VX_ERROR_INVALID_VALUE;
+	StitchBlendValidEntry * tiles = nullptr;
+	vx_size stride = sizeof(StitchBlendValidEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(arr, 0, num_items, &stride, (void **)&tiles, VX_READ_ONLY));
+	vx_uint32 num_tiles = std::min(*((vx_uint32 *)&tiles[arr_offs - 1]), (vx_uint32)(num_items - arr_offs));
+
+	// access images
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_imagepatch_addressing_t ip_addr, wt_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *wt_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(weight_image, &rect, 0, &wt_addr, (void **)&wt_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+	bool ip_rgb4 = (input_format == VX_DF_IMAGE_RGB4_AMD);
+
+	// each tile is processed independently
+	std::atomic<int> next_tile(0);
+	std::function<void()> tile_thread_func = [&]() {
+		for (int t = next_tile++; t < (int)num_tiles; t = next_tile++) {
+			multiband_blend_tile(tiles[arr_offs + t], width, height / num_cameras, ip_rgb4,
+				ip_buf, ip_addr.stride_y, wt_buf, wt_addr.stride_y, op_buf, op_addr.stride_y);
+		}
+	};
+	stitch_thread_pool_run(node, (int)num_tiles, tile_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, nullptr, 0, &wt_addr, wt_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &rect, 0, &op_addr, op_buf));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	return VX_SUCCESS;
 }
 
 //! \brief The OpenCL global work updater callback.
@@ -325,8 +413,8 @@ vx_status multiband_blend_publish(vx_context context)
 		6,
 		multiband_blend_input_validator,
 		multiband_blend_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = multiband_blend_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = multiband_blend_opencl_codegen;
@@ -347,6 +435,567 @@ vx_status multiband_blend_publish(vx_context context)
 	return VX_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Fused multiband blend: the gaussian and laplacian pyramids are built, blended and reconstructed one
+// level-0 block at a time, so that the intermediate levels only live in a per-thread scratch buffer.
+
+#define MULTIBAND_FUSED_BLOCK       128  // level-0 block size in pixels
+
+//! \brief An inclusive pixel rectangle of a pyramid level of a camera.
+struct multiband_fused_rect {
+	vx_int32 x0, y0, x1, y1;
+};
+
+//! \brief The pixels of a pyramid level: pixel (x,y) is at buf + (y - rect.y0) * stride + (x - rect.x0) * pixel size.
+struct multiband_fused_plane {
+	vx_uint8 * buf;
+	vx_int32 stride;
+	multiband_fused_rect rect;
+};
+
+//! \brief A pyramid level of a block.
+struct multiband_fused_level {
+	vx_int32 width, height;              // size of the level of a camera
+	multiband_fused_rect region;         // pixels to reconstruct
+	multiband_fused_plane gauss;         // gaussian pyramid (RGBX)
+	multiband_fused_plane weight;        // weight pyramid (U8)
+	multiband_fused_plane rec;           // blended and reconstructed laplacian (4 x S016), RGBX output for level 0
+};
+
+//! \brief The upsampler of a pyramid level: a ring of three horizontally filtered source rows.
+struct multiband_fused_upsampler {
+	const multiband_fused_plane * src;   // source level
+	bool src_rec;                        // source pixels are 4 x S016, otherwise RGBX
+	vx_int32 src_width, src_height;      // size of the source level
+	vx_int32 x0, x1;                     // output columns
+	vx_int32 next_m;                     // next source row to filter horizontally
+	std::vector<vx_int16> line, ring;
+	std::vector<vx_int32> sum;           // upsampled row scaled by 64, 4 lanes per pixel
+};
+
+//! \brief The per-thread scratch of the fused multiband blend.
+struct multiband_fused_scratch {
+	std::vector<multiband_fused_level> level;
+	std::vector<vx_uint8> mem;
+	std::vector<vx_uint16> half_scale;
+	multiband_fused_upsampler up_gauss, up_rec;
+};
+
+static inline vx_uint8 * multiband_fused_pixel(const multiband_fused_plane& p, vx_int32 x, vx_int32 y, vx_int32 pixel_size)
+{
+	return p.buf + (y - p.rect.y0) * p.stride + (x - p.rect.x0) * pixel_size;
+}
+
+static inline multiband_fused_rect multiband_fused_clip(vx_int32 x0, vx_int32 y0, vx_int32 x1, vx_int32 y1, vx_int32 width, vx_int32 height)
+{
+	multiband_fused_rect r = { std::max(x0, 0), std::max(y0, 0), std::min(x1, width - 1), std::min(y1, height - 1) };
+	return r;
+}
+
+//! \brief Half scale gaussian of src into dst.rect with the 5x5 binomial filter of half_scale_gaussian (ch: 1 or 4 bytes per pixel).
+// The input rows are split into even and odd pixels and filtered horizontally into a ring of five 16-bit rows.
+static void multiband_fused_half_scale(const multiband_fused_plane& src, vx_int32 src_width, vx_int32 src_height,
+	const multiband_fused_plane& dst, vx_int32 ch, std::vector<vx_uint16>& scratch)
+{
+	const multiband_fused_rect& r = dst.rect;
+	vx_int32 nx = r.x1 - r.x0 + 1, lanes = nx * ch, pitch = (lanes + 7) & ~7;
+	if (scratch.size() < (size_t)(7 * pitch + 32))
+		scratch.resize(7 * pitch + 32);
+	vx_uint16 * even = &scratch[0], *odd = even + pitch + 16, *ring = odd + pitch + 16;
+	vx_int32 next = 2 * r.y0 - 1;
+	const __m128i c127 = _mm_set1_epi16(127), c1 = _mm_set1_epi16(1);
+	for (vx_int32 y = r.y0; y <= r.y1; y++) {
+		// horizontal pass over input rows up to 2y+3: O[x-1] + 4E[x] + 6O[x] + 4E[x+1] + O[x+1]
+		for (; next <= 2 * y + 3; next++) {
+			vx_int32 sy = std::min(std::max(next, 0), src_height - 1);
+			for (vx_int32 k = 0; k <= nx; k++) {
+				const vx_uint8 * p = multiband_fused_pixel(src, std::min(2 * (r.x0 + k), src_width - 1), sy, ch);
+				for (vx_int32 c = 0; c < ch; c++)
+					even[k * ch + c] = p[c];
+			}
+			for (vx_int32 k = -1; k <= nx; k++) {
+				const vx_uint8 * p = multiband_fused_pixel(src, std::min(std::max(2 * (r.x0 + k) + 1, 0), src_width - 1), sy, ch);
+				for (vx_int32 c = 0; c < ch; c++)
+					odd[(k + 1) * ch + c] = p[c];
+			}
+			vx_uint16 * h = ring + ((next + 5) % 5) * pitch;
+			for (vx_int32 i = 0; i < lanes; i += 8) {
+				__m128i om = _mm_loadu_si128((const __m128i *)&odd[i]);
+				__m128i oc = _mm_loadu_si128((const __m128i *)&odd[i + ch]);
+				__m128i op = _mm_loadu_si128((const __m128i *)&odd[i + 2 * ch]);
+				__m128i e0 = _mm_loadu_si128((const __m128i *)&even[i]);
+				__m128i e1 = _mm_loadu_si128((const __m128i *)&even[i + ch]);
+				__m128i s = _mm_add_epi16(_mm_add_epi16(om, op), _mm_slli_epi16(_mm_add_epi16(e0, e1), 2));
+				s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(oc, 2), _mm_slli_epi16(oc, 1)));
+				_mm_storeu_si128((__m128i *)&h[i], s);
+			}
+		}
+		// vertical pass over input rows 2y-1 ... 2y+3 with round to nearest even like amd_pack
+		const vx_uint16 * h0 = ring + ((2 * y + 4) % 5) * pitch, *h1 = ring + ((2 * y + 5) % 5) * pitch;
+		const vx_uint16 * h2 = ring + ((2 * y + 6) % 5) * pitch, *h3 = ring + ((2 * y + 7) % 5) * pitch;
+		const vx_uint16 * h4 = ring + ((2 * y + 8) % 5) * pitch;
+		vx_uint8 * d = multiband_fused_pixel(dst, r.x0, y, ch);
+		for (vx_int32 i = 0; i < lanes; i += 8) {
+			__m128i r0 = _mm_loadu_si128((const __m128i *)&h0[i]);
+			__m128i r1 = _mm_loadu_si128((const __m128i *)&h1[i]);
+			__m128i r2 = _mm_loadu_si128((const __m128i *)&h2[i]);
+			__m128i r3 = _mm_loadu_si128((const __m128i *)&h3[i]);
+			__m128i r4 = _mm_loadu_si128((const __m128i *)&h4[i]);
+			__m128i s = _mm_add_epi16(_mm_add_epi16(r0, r4), _mm_slli_epi16(_mm_add_epi16(r1, r3), 2));
+			s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(r2, 2), _mm_slli_epi16(r2, 1)));
+			s = _mm_add_epi16(s, _mm_add_epi16(c127, _mm_and_si128(_mm_srli_epi16(s, 8), c1)));
+			s = _mm_srli_epi16(s, 8);
+			_mm_storel_epi64((__m128i *)&d[i], _mm_packus_epi16(s, s));
+		}
+	}
+}
+
+static void multiband_fused_upsample_start(multiband_fused_upsampler& up, const multiband_fused_plane& src, bool src_rec,
+	vx_int32 src_width, vx_int32 src_height, const multiband_fused_rect& out)
+{
+	vx_int32 nx = out.x1 - out.x0 + 1;
+	up.src = &src;
+	up.src_rec = src_rec;
+	up.src_width = src_width;
+	up.src_height = src_height;
+	up.x0 = out.x0;
+	up.x1 = out.x1;
+	up.next_m = (out.y0 >> 1) - 1;
+	up.line.resize(((out.x1 >> 1) - (out.x0 >> 1) + 3) * 4);
+	up.ring.resize(3 * nx * 4);
+	up.sum.resize(nx * 4);
+}
+
+//! \brief Upsample row y of the output level into up.sum: 1-6-1 at even and 4-4 at odd positions, horizontally
+// in 16-bit lanes like the OpenCL kernels and vertically in 32-bit lanes.
+static void multiband_fused_upsample_row(multiband_fused_upsampler& up, vx_int32 y)
+{
+	vx_int32 nx = up.x1 - up.x0 + 1, k0 = (up.x0 >> 1) - 1, m = y >> 1;
+	vx_int16 * line = &up.line[0];
+	for (; up.next_m <= m + 1; up.next_m++) {
+		vx_int32 sy = std::min(std::max(up.next_m, 0), up.src_height - 1);
+		for (vx_int32 k = 0; k < (vx_int32)up.line.size() / 4; k++) {
+			vx_int32 sx = std::min(std::max(k0 + k, 0), up.src_width - 1);
+			if (up.src_rec) {
+				_mm_storel_epi64((__m128i *)&line[k * 4], _mm_loadl_epi64((const __m128i *)multiband_fused_pixel(*up.src, sx, sy, 8)));
+			}
+			else {
+				const vx_uint8 * p = multiband_fused_pixel(*up.src, sx, sy, 4);
+				line[k * 4 + 0] = p[0]; line[k * 4 + 1] = p[1]; line[k * 4 + 2] = p[2]; line[k * 4 + 3] = 0;
+			}
+		}
+		vx_int16 * h = &up.ring[((up.next_m + 3) % 3) * nx * 4];
+		for (vx_int32 x = up.x0; x <= up.x1; x++) {
+			vx_int32 j = (x >> 1) - k0;
+			__m128i pc = _mm_loadl_epi64((const __m128i *)&line[j * 4]);
+			__m128i pr = _mm_loadl_epi64((const __m128i *)&line[(j + 1) * 4]);
+			__m128i v;
+			if (x & 1) {
+				v = _mm_slli_epi16(_mm_add_epi16(pc, pr), 2);
+			}
+			else {
+				__m128i pl = _mm_loadl_epi64((const __m128i *)&line[(j - 1) * 4]);
+				v = _mm_add_epi16(_mm_add_epi16(pl, pr), _mm_add_epi16(_mm_slli_epi16(pc, 2), _mm_slli_epi16(pc, 1)));
+			}
+			_mm_storel_epi64((__m128i *)&h[(x - up.x0) * 4], v);
+		}
+	}
+	const vx_int16 * ha = &up.ring[((m + 2) % 3) * nx * 4];
+	const vx_int16 * hb = &up.ring[((m + 3) % 3) * nx * 4];
+	const vx_int16 * hc = &up.ring[((m + 4) % 3) * nx * 4];
+	vx_int32 * sum = &up.sum[0];
+	for (vx_int32 i = 0; i < nx * 4; i += 4) {
+		__m128i b = _mm_loadl_epi64((const __m128i *)&hb[i]);
+		__m128i c = _mm_loadl_epi64((const __m128i *)&hc[i]);
+		b = _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16);
+		c = _mm_srai_epi32(_mm_unpacklo_epi16(c, c), 16);
+		__m128i s;
+		if (y & 1) {
+			s = _mm_slli_epi32(_mm_add_epi32(b, c), 2);
+		}
+		else {
+			__m128i a = _mm_loadl_epi64((const __m128i *)&ha[i]);
+			a = _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16);
+			s = _mm_add_epi32(_mm_add_epi32(a, c), _mm_add_epi32(_mm_slli_epi32(b, 2), _mm_slli_epi32(b, 1)));
+		}
+		_mm_storeu_si128((__m128i *)&sum[i], s);
+	}
+}
+
+//! \brief Blend the top level: gaussian scaled by weight/255 and truncated like multiband_blend.
+static void multiband_fused_blend_top(const multiband_fused_level& lv)
+{
+	const __m128i zero = _mm_setzero_si128(), rgb = _mm_setr_epi32(-1, -1, -1, 0);
+	const __m128 scale_wt = _mm_set1_ps(0.00392157f);
+	for (vx_int32 y = lv.region.y0; y <= lv.region.y1; y++) {
+		for (vx_int32 x = lv.region.x0; x <= lv.region.x1; x++) {
+			__m128i px = _mm_cvtsi32_si128(*(const int *)multiband_fused_pixel(lv.gauss, x, y, 4));
+			px = _mm_and_si128(_mm_unpacklo_epi16(_mm_unpacklo_epi8(px, zero), zero), rgb);
+			vx_float32 w = (vx_float32)*multiband_fused_pixel(lv.weight, x, y, 1);
+			__m128i v = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(px), _mm_set1_ps(w)), scale_wt));
+			_mm_storel_epi64((__m128i *)multiband_fused_pixel(lv.rec, x, y, 8), _mm_packs_epi32(v, v));
+		}
+	}
+}
+
+//! \brief Reconstruct a level: the laplacian of upscale_gaussian_subtract scaled by the weight, plus the
+// upsampled reconstruction of the next level like upscale_gaussian_add, or like laplacian_reconstruct into RGBX for level 0.
+static void multiband_fused_reconstruct(const multiband_fused_level& lv, bool level0,
+	multiband_fused_upsampler& up_gauss, multiband_fused_upsampler& up_rec)
+{
+	const __m128i zero = _mm_setzero_si128(), rgb = _mm_setr_epi32(-1, -1, -1, 0), c63 = _mm_set1_epi32(63);
+	const __m128i alpha = _mm_cvtsi32_si128((int)0xff000000);
+	const __m128 scale_up = _mm_set1_ps(0.015625f), scale_wt = _mm_set1_ps(0.00392157f);
+	for (vx_int32 y = lv.region.y0; y <= lv.region.y1; y++) {
+		multiband_fused_upsample_row(up_gauss, y);
+		multiband_fused_upsample_row(up_rec, y);
+		const vx_int32 * sg = &up_gauss.sum[0], *sr = &up_rec.sum[0];
+		for (vx_int32 x = lv.region.x0, i = 0; x <= lv.region.x1; x++, i += 4) {
+			__m128i px = _mm_cvtsi32_si128(*(const int *)multiband_fused_pixel(lv.gauss, x, y, 4));
+			px = _mm_and_si128(_mm_unpacklo_epi16(_mm_unpacklo_epi8(px, zero), zero), rgb);
+			vx_float32 w = (vx_float32)*multiband_fused_pixel(lv.weight, x, y, 1);
+			__m128 d = _mm_sub_ps(_mm_cvtepi32_ps(px), _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&sg[i])), scale_up));
+			d = _mm_mul_ps(_mm_mul_ps(d, _mm_set1_ps(w)), scale_wt);
+			__m128i lap = _mm_cvttps_epi32(d);
+			lap = _mm_packs_epi32(lap, lap);
+			__m128i s = _mm_loadu_si128((const __m128i *)&sr[i]);
+			if (level0) {
+				__m128 f = _mm_add_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lap, lap), 16)), _mm_mul_ps(_mm_cvtepi32_ps(s), scale_up));
+				__m128i v = _mm_cvtps_epi32(f);
+				v = _mm_packs_epi32(v, v);
+				v = _mm_or_si128(_mm_packus_epi16(v, v), alpha);
+				*(vx_uint32 *)multiband_fused_pixel(lv.rec, x, y, 4) = (vx_uint32)_mm_cvtsi128_si32(v);
+			}
+			else {
+				s = _mm_srai_epi32(_mm_add_epi32(s, _mm_and_si128(_mm_srai_epi32(s, 31), c63)), 6);
+				_mm_storel_epi64((__m128i *)multiband_fused_pixel(lv.rec, x, y, 8), _mm_add_epi16(lap, _mm_packs_epi32(s, s)));
+			}
+		}
+	}
+}
+
+//! \brief Blend the level-0 block of a camera starting at (bx,by): level 0 of scratch.level must refer to the camera images.
+static void multiband_fused_block(multiband_fused_scratch& scratch, vx_int32 num_bands, vx_int32 bx, vx_int32 by)
+{
+	std::vector<multiband_fused_level>& level = scratch.level;
+	// regions to reconstruct: each level needs the 3x3 neighborhood of the level below at half resolution
+	level[0].region = multiband_fused_clip(bx, by, bx + MULTIBAND_FUSED_BLOCK - 1, by + MULTIBAND_FUSED_BLOCK - 1, level[0].width, level[0].height);
+	for (vx_int32 l = 1; l < num_bands; l++) {
+		const multiband_fused_rect& p = level[l - 1].region;
+		level[l].region = multiband_fused_clip((p.x0 >> 1) - 1, (p.y0 >> 1) - 1, (p.x1 >> 1) + 1, (p.y1 >> 1) + 1, level[l].width, level[l].height);
+	}
+	// gaussian and weight regions: the region of the level plus the 5x5 support of the next gaussian level
+	level[num_bands - 1].gauss.rect = level[num_bands - 1].region;
+	for (vx_int32 l = num_bands - 2; l >= 1; l--) {
+		const multiband_fused_rect& g = level[l + 1].gauss.rect, & r = level[l].region;
+		multiband_fused_rect s = multiband_fused_clip(2 * g.x0 - 1, 2 * g.y0 - 1, 2 * g.x1 + 3, 2 * g.y1 + 3, level[l].width, level[l].height);
+		level[l].gauss.rect = multiband_fused_clip(std::min(s.x0, r.x0), std::min(s.y0, r.y0), std::max(s.x1, r.x1), std::max(s.y1, r.y1), level[l].width, level[l].height);
+	}
+	// carve the scratch planes of levels 1 and above
+	size_t size = 0;
+	for (vx_int32 l = 1; l < num_bands; l++) {
+		multiband_fused_level& lv = level[l];
+		vx_int32 gw = lv.gauss.rect.x1 - lv.gauss.rect.x0 + 1, gh = lv.gauss.rect.y1 - lv.gauss.rect.y0 + 1;
+		vx_int32 rw = lv.region.x1 - lv.region.x0 + 1, rh = lv.region.y1 - lv.region.y0 + 1;
+		lv.weight.rect = lv.gauss.rect;
+		lv.rec.rect = lv.region;
+		lv.gauss.stride = (gw * 4 + 15) & ~15;
+		lv.weight.stride = (gw + 15) & ~15;
+		lv.rec.stride = (rw * 8 + 15) & ~15;
+		size += (lv.gauss.stride + lv.weight.stride) * gh + lv.rec.stride * rh;
+	}
+	if (scratch.mem.size() < size)
+		scratch.mem.resize(size);
+	vx_uint8 * mem = &scratch.mem[0];
+	for (vx_int32 l = 1; l < num_bands; l++) {
+		multiband_fused_level& lv = level[l];
+		vx_int32 gh = lv.gauss.rect.y1 - lv.gauss.rect.y0 + 1, rh = lv.region.y1 - lv.region.y0 + 1;
+		lv.gauss.buf = mem; mem += lv.gauss.stride * gh;
+		lv.weight.buf = mem; mem += lv.weight.stride * gh;
+		lv.rec.buf = mem; mem += lv.rec.stride * rh;
+	}
+	// build the gaussian and weight pyramids
+	for (vx_int32 l = 1; l < num_bands; l++) {
+		multiband_fused_half_scale(level[l - 1].gauss, level[l - 1].width, level[l - 1].height, level[l].gauss, 4, scratch.half_scale);
+		multiband_fused_half_scale(level[l - 1].weight, level[l - 1].width, level[l - 1].height, level[l].weight, 1, scratch.half_scale);
+	}
+	// blend and reconstruct from the top level down
+	multiband_fused_blend_top(level[num_bands - 1]);
+	for (vx_int32 l = num_bands - 2; l >= 0; l--) {
+		const multiband_fused_level& next = level[l + 1];
+		multiband_fused_upsample_start(scratch.up_gauss, next.gauss, false, next.width, next.height, level[l].region);
+		multiband_fused_upsample_start(scratch.up_rec, next.rec, true, next.width, next.height, level[l].region);
+		multiband_fused_reconstruct(level[l], l == 0, scratch.up_gauss, scratch.up_rec);
+	}
+}
+
+//! \brief The input validator callback.
+static vx_status VX_CALLBACK multiband_fused_input_validator(vx_node node, vx_uint32 index)
+{
+	vx_status status = VX_ERROR_INVALID_PARAMETERS;
+	// get reference for parameter at specified index
+	vx_reference ref = avxGetNodeParamRef(node, index);
+	ERROR_CHECK_OBJECT(ref);
+	if (index == 0 || index == 1 || index == 2)
+	{ // scalar of VX_TYPE_UINT32
+		vx_enum itemtype = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
+		if (itemtype == VX_TYPE_UINT32) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: multiband_fused scalar #%d should be UINT32 type\n", index);
+		}
+		if (index == 2) {
+			vx_uint32 num_bands = 0;
+			ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)ref, &num_bands));
+			if (num_bands < 2) {
+				status = VX_ERROR_INVALID_VALUE;
+				vxAddLogEntry((vx_reference)node, status, "ERROR: multiband_fused number of bands should be 2 or more\n");
+			}
+		}
+		ERROR_CHECK_STATUS(vxReleaseScalar((vx_scalar *)&ref));
+	}
+	else if (index == 3 || index == 4)
+	{ // RGBX source image and U8 weight image
+		vx_df_image format = VX_DF_IMAGE_VIRT;
+		ERROR_CHECK_STATUS(vxQueryImage((vx_image)ref, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format)));
+		if (format == (index == 3 ? VX_DF_IMAGE_RGBX : VX_DF_IMAGE_U8)) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: multiband_fused %s image should be an image of %s type\n", index == 3 ? "input" : "weight", index == 3 ? "RGBX" : "U008");
+		}
+		ERROR_CHECK_STATUS(vxReleaseImage((vx_image *)&ref));
+	}
+	else if (index == 5)
+	{ // array object for offsets
+		vx_size itemsize = 0;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+		if (itemsize == sizeof(StitchBlendValidEntry)) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: multiband_fused array element (StitchBlendValidEntry) size should be 8 bytes\n");
+		}
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+	}
+	else if (index == 7)
+	{ // scalar of VX_TYPE_UINT32: offset of the interior tiles
+		vx_enum itemtype = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
+		if (itemtype == VX_TYPE_UINT32) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: multiband_fused scalar #%d should be UINT32 type\n", index);
+		}
+		ERROR_CHECK_STATUS(vxReleaseScalar((vx_scalar *)&ref));
+	}
+	return status;
+}
+
+//! \brief The output validator callback.
+static vx_status VX_CALLBACK multiband_fused_output_validator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+	vx_status status = VX_ERROR_INVALID_PARAMETERS;
+	if (index == 6)
+	{ // RGBX image of the same size as the input
+		vx_image image = (vx_image)avxGetNodeParamRef(node, 3);
+		ERROR_CHECK_OBJECT(image);
+		vx_uint32 width = 0, height = 0;
+		ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+		ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+		ERROR_CHECK_STATUS(vxReleaseImage(&image));
+		// set output image meta data
+		vx_df_image format = VX_DF_IMAGE_RGBX;
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format)));
+		status = VX_SUCCESS;
+	}
+	return status;
+}
+
+//! \brief The multiband_fused node local data: the worker threads and their scratch are kept across executions,
+//  so that the scratch buffers are only allocated by the first frames.
+struct multiband_fused_data {
+	stitch_thread_pool pool;                        // worker threads blending the blocks
+	std::vector<multiband_fused_scratch> scratch;   // scratch of each thread of the pool and of the calling thread
+};
+
+//! \brief The kernel initialize.
+static vx_status VX_CALLBACK multiband_fused_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	multiband_fused_data * data = new multiband_fused_data();
+	data->pool.start();
+	data->scratch.resize(data->pool.worker.size() + 1);
+	vx_size size = sizeof(multiband_fused_data);
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK multiband_fused_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(multiband_fused_data)))
+	{
+		multiband_fused_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) delete data;
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel execution.
+static vx_status VX_CALLBACK multiband_fused_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_uint32 num_cameras = 0, arr_offs = 0, num_bands = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[2], &num_bands));
+	if (num_cameras == 0 || num_bands < 2)
+		return VX_ERROR_INVALID_VALUE;
+	vx_image input_image = (vx_image)parameters[3];
+	vx_image weight_image = (vx_image)parameters[4];
+	vx_array arr = (vx_array)parameters[5];
+	vx_image output_image = (vx_image)parameters[6];
+	vx_uint32 interior_offs = 0;
+	if (num > 7 && parameters[7])
+		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[7], &interior_offs));
+
+	// get image configuration
+	vx_uint32 width = 0, height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	vx_int32 cam_height = (vx_int32)(height / num_cameras);
+
+	// pick the level-0 blocks that hold at least one valid tile of a camera
+	vx_size num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+	if (arr_offs < 1 || arr_offs > num_items)
+		return VX_ERROR_INVALID_VALUE;
+	StitchBlendValidEntry * tiles = nullptr;
+	vx_size stride = sizeof(StitchBlendValidEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(arr, 0, num_items, &stride, (void **)&tiles, VX_READ_ONLY));
+	vx_uint32 num_tiles = std::min(*((vx_uint32 *)&tiles[arr_offs - 1]), (vx_uint32)(num_items - arr_offs));
+	vx_int32 blocks_x = ((vx_int32)width + MULTIBAND_FUSED_BLOCK - 1) / MULTIBAND_FUSED_BLOCK;
+	vx_int32 blocks_y = (cam_height + MULTIBAND_FUSED_BLOCK - 1) / MULTIBAND_FUSED_BLOCK;
+	std::vector<vx_uint8> block_used(num_cameras * blocks_x * blocks_y, 0);
+	for (vx_uint32 t = 0; t < num_tiles; t++) {
+		const StitchBlendValidEntry& tile = tiles[arr_offs + t];
+		if (tile.camId >= num_cameras)
+			continue;
+		vx_int32 tx1 = std::min((vx_int32)(tile.dstX + tile.end_x), (vx_int32)width - 1) / MULTIBAND_FUSED_BLOCK;
+		vx_int32 ty1 = std::min((vx_int32)(tile.dstY + tile.end_y), cam_height - 1) / MULTIBAND_FUSED_BLOCK;
+		for (vx_int32 j = tile.dstY / MULTIBAND_FUSED_BLOCK; j <= ty1; j++)
+			for (vx_int32 i = tile.dstX / MULTIBAND_FUSED_BLOCK; i <= tx1; i++)
+				block_used[(tile.camId * blocks_y + j) * blocks_x + i] = 1;
+	}
+	// interior tiles are away from the overlaps: they are copied from the input
+	std::vector<StitchBlendValidEntry> interior;
+	if (interior_offs > 0 && interior_offs <= num_items) {
+		vx_uint32 num_interior = std::min(*((vx_uint32 *)&tiles[interior_offs - 1]), (vx_uint32)(num_items - interior_offs));
+		interior.assign(tiles + interior_offs, tiles + interior_offs + num_interior);
+	}
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	std::vector<vx_int32> blocks;
+	for (vx_int32 b = 0; b < (vx_int32)block_used.size(); b++) {
+		if (block_used[b])
+			blocks.push_back(b);
+	}
+
+	// access images
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_imagepatch_addressing_t ip_addr, wt_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *wt_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(weight_image, &rect, 0, &wt_addr, (void **)&wt_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+
+	// each block is blended independently with a scratch per thread, then the interior tiles are copied
+	multiband_fused_data * data = nullptr;
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(multiband_fused_data))) {
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	}
+	std::vector<multiband_fused_scratch> local_scratch(data ? 0 : 1);
+	std::vector<multiband_fused_scratch>& thread_scratch = data ? data->scratch : local_scratch;
+	std::atomic<int> next_block(0), next_interior(0), next_scratch(0);
+	std::function<void()> block_thread_func = [&]() {
+		multiband_fused_scratch& scratch = thread_scratch[next_scratch++];
+		scratch.level.resize(num_bands);
+		for (vx_uint32 l = 0; l < num_bands; l++) {
+			scratch.level[l].width = (vx_int32)width >> l;
+			scratch.level[l].height = cam_height >> l;
+		}
+		multiband_fused_rect cam_rect = { 0, 0, (vx_int32)width - 1, cam_height - 1 };
+		multiband_fused_level& lv0 = scratch.level[0];
+		lv0.gauss.rect = lv0.weight.rect = lv0.rec.rect = cam_rect;
+		lv0.gauss.stride = ip_addr.stride_y;
+		lv0.weight.stride = wt_addr.stride_y;
+		lv0.rec.stride = op_addr.stride_y;
+		for (int b = next_block++; b < (int)blocks.size(); b = next_block++) {
+			vx_int32 cam = blocks[b] / (blocks_x * blocks_y), bxy = blocks[b] % (blocks_x * blocks_y);
+			lv0.gauss.buf = ip_buf + cam * cam_height * ip_addr.stride_y;
+			lv0.weight.buf = wt_buf + cam * cam_height * wt_addr.stride_y;
+			lv0.rec.buf = op_buf + cam * cam_height * op_addr.stride_y;
+			multiband_fused_block(scratch, (vx_int32)num_bands, (bxy % blocks_x) * MULTIBAND_FUSED_BLOCK, (bxy / blocks_x) * MULTIBAND_FUSED_BLOCK);
+		}
+		for (int t = next_interior++; t < (int)interior.size(); t = next_interior++) {
+			const StitchBlendValidEntry& tile = interior[t];
+			vx_int32 x0 = tile.dstX, nx = std::min((vx_int32)tile.end_x + 1, (vx_int32)width - x0);
+			vx_int32 y0 = tile.camId * cam_height + tile.dstY, ny = std::min((vx_int32)tile.end_y + 1, cam_height - (vx_int32)tile.dstY);
+			for (vx_int32 y = y0; y < y0 + ny; y++)
+				memcpy(op_buf + y * op_addr.stride_y + x0 * 4, ip_buf + y * ip_addr.stride_y + x0 * 4, nx * 4);
+		}
+	};
+	if (data)
+		data->pool.run((int)(blocks.size() + interior.size()), block_thread_func);
+	else
+		block_thread_func();
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, nullptr, 0, &wt_addr, wt_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &rect, 0, &op_addr, op_buf));
+	return VX_SUCCESS;
+}
+
+//! \brief The multiband_fused kernel publisher.
+vx_status multiband_fused_publish(vx_context context)
+{
+	// add kernel to the context with callbacks
+	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.multiband_fused",
+		AMDOVX_KERNEL_STITCHING_MULTIBAND_FUSED,
+		multiband_fused_kernel,
+		8,
+		multiband_fused_input_validator,
+		multiband_fused_output_validator,
+		multiband_fused_initialize,
+		multiband_fused_deinitialize);
+	ERROR_CHECK_OBJECT(kernel);
+	// set kernel parameters
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+	// finalize and release kernel object
+	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
+	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
+	return VX_SUCCESS;
+}
+
+// offset[] holds num_bands + 1 entries: offset[num_bands] is the list of the interior tiles of level 0
 vx_uint32 Compute_StitchBlendArraySize(int width, int height, int num_camera, int num_bands, vx_uint32 offset[])
 {
 	vx_uint32 totalCount = 0;
@@ -355,13 +1004,49 @@ vx_uint32 Compute_StitchBlendArraySize(int width, int height, int num_camera, in
 		vx_uint32 count = 1 + (((width >> level) + 63) >> 6) * (((height >> level) + 15) >> 4) * num_camera;
 		totalCount += count;
 	}
+	offset[num_bands] = 1 + totalCount;
+	totalCount += 1 + ((width + 63) >> 6) * ((height + 15) >> 4) * num_camera;
 	return totalCount;
 }
 
+//! \brief Summed area table of the cells of the owner map that are equal to v0 or v1.
+static void multiband_cell_table(std::vector<vx_int32>& sat, const vx_uint8 * cells, int cells_x, int cells_y, vx_uint8 v0, vx_uint8 v1)
+{
+	int pitch = cells_x + 1;
+	sat.assign(pitch * (cells_y + 1), 0);
+	for (int cy = 0; cy < cells_y; cy++) {
+		vx_int32 row = 0;
+		for (int cx = 0; cx < cells_x; cx++) {
+			vx_uint8 v = cells[cy * cells_x + cx];
+			row += (v == v0 || v == v1) ? 1 : 0;
+			sat[(cy + 1) * pitch + cx + 1] = sat[cy * pitch + cx + 1] + row;
+		}
+	}
+}
+
+//! \brief Sum of a summed area table over the cells touching the pixels [x0,x1) x [y0,y1), clipped to the map: count is the number of cells.
+static vx_int32 multiband_cell_sum(const std::vector<vx_int32>& sat, int cells_x, int cells_y, int x0, int y0, int x1, int y1, vx_int32& count)
+{
+	int cx0 = std::max(x0, 0) / MULTIBAND_OWNER_CELL, cy0 = std::max(y0, 0) / MULTIBAND_OWNER_CELL;
+	int cx1 = std::min((std::max(x1, 0) + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL, cells_x);
+	int cy1 = std::min((std::max(y1, 0) + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL, cells_y);
+	count = 0;
+	if (cx0 >= cx1 || cy0 >= cy1)
+		return 0;
+	int pitch = cells_x + 1;
+	count = (cx1 - cx0) * (cy1 - cy0);
+	return sat[cy1 * pitch + cx1] - sat[cy0 * pitch + cx1] - sat[cy1 * pitch + cx0] + sat[cy0 * pitch + cx0];
+}
+
 // helper function for calculating offset tables for blend
-vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pValid_roi, vx_array blendOffs, int numCameras, int numBands, int width, int height)
+// With a cell_owner map (MULTIBAND_OWNER_CELL cells, camera id or MULTIBAND_OWNER_NONE/MIXED), the level-0 tiles of a camera
+// whose pyramid support only holds pixels of that camera are listed as interior tiles: the reconstructed pyramid of a single
+// camera is its source to within 1 LSB (the truncation of the upscale), so they skip the pyramid and copy the source.
+// The tiles of a camera that the merge never reads are dropped, and levels 1 and above only keep the tiles within the
+// support of the remaining level-0 tiles.
+vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pValid_roi, vx_array blendOffs, int numCameras, int numBands, int width, int height, const vx_uint8 * cell_owner)
 {
-	vx_uint32 *array_offset = new vx_uint32[numBands];
+	vx_uint32 *array_offset = new vx_uint32[numBands + 1];
 	vx_rectangle_t *pRoi_rect = new vx_rectangle_t[numCameras];
 	Compute_StitchBlendArraySize(width, height, numCameras, numBands, array_offset);
 	vx_size max_size;
@@ -395,11 +1080,21 @@ vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pValid_roi, vx_a
 		pRoi_rect[i] = { x1, y1, x2, y2 };
 	}
 
-	for (int level = 0; level < numBands; level++){
-		StitchBlendValidEntry *entry_start = &pBlendArr[array_offset[level] - 1];
-		StitchBlendValidEntry *entry = entry_start+1;
-		int num_entries = 0;
-		for (int i = 0; i < numCameras; i++){
+	// support radius of the pyramid at level 0 and of the levels above in level-0 pixels
+	int radius = 3 << numBands;
+	int cells_x = (width + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL, cells_y = (height + MULTIBAND_OWNER_CELL - 1) / MULTIBAND_OWNER_CELL;
+	std::vector<vx_int32> own_sat, used_sat, pyr_sat;
+	std::vector<vx_uint8> pyr_cells;
+	std::vector<StitchBlendValidEntry *> entry(numBands + 1);
+	for (int level = 0; level <= numBands; level++)
+		entry[level] = &pBlendArr[array_offset[level]];
+	for (int i = 0; i < numCameras; i++){
+		if (cell_owner) {
+			multiband_cell_table(own_sat, cell_owner, cells_x, cells_y, (vx_uint8)i, (vx_uint8)i);
+			multiband_cell_table(used_sat, cell_owner, cells_x, cells_y, (vx_uint8)i, MULTIBAND_OWNER_MIXED);
+			pyr_cells.assign(cells_x * cells_y, 0);
+		}
+		for (int level = 0; level < numBands; level++){
 			vx_rectangle_t *pRect = pRoi_rect + i;
 			x1 = pRect->start_x, x2 = pRect->end_x;
 			y1 = pRect->start_y, y2 = pRect->end_y;
@@ -407,22 +1102,46 @@ vx_status Compute_StitchMultiBandCalcValidEntry(vx_rectangle_t *pValid_roi, vx_a
 			x2 >>= level, y2 >>= level;
 			for (int y = y1; y < y2; y += 16){
 				for (int x = x1 & ~15; x < x2; x += 64){
-					entry->camId = i;
-					entry->dstX = x;
-					entry->dstY = y;
-					entry->end_x = ((x + 63) > x2) ? (x2 - x) : 63;
-					entry->end_y = ((y + 15) > y2) ? (y2 - y) : 15;
-					entry->start_x = (x < x1) ? (x1 - x) : 0;
-					entry->start_y = 0;
-					entry++;
+					StitchBlendValidEntry tile;
+					tile.camId = i;
+					tile.dstX = x;
+					tile.dstY = y;
+					tile.end_x = ((x + 63) > x2) ? (x2 - x) : 63;
+					tile.end_y = ((y + 15) > y2) ? (y2 - y) : 15;
+					tile.start_x = (x < x1) ? (x1 - x) : 0;
+					tile.start_y = 0;
+					if (cell_owner) {
+						vx_int32 count, tx0 = x << level, ty0 = y << level;
+						vx_int32 tx1 = (x + tile.end_x + 1) << level, ty1 = (y + tile.end_y + 1) << level;
+						if (level == 0) {
+							if (!multiband_cell_sum(used_sat, cells_x, cells_y, tx0, ty0, tx1, ty1, count))
+								continue;
+							vx_int32 own = multiband_cell_sum(own_sat, cells_x, cells_y, tx0 - radius, ty0 - radius, tx1 + radius, ty1 + radius, count);
+							if (own == count) {
+								*entry[numBands]++ = tile;
+								continue;
+							}
+							for (int cy = ty0 / MULTIBAND_OWNER_CELL; cy <= std::min(ty1 - 1, height - 1) / MULTIBAND_OWNER_CELL; cy++)
+								for (int cx = tx0 / MULTIBAND_OWNER_CELL; cx <= std::min(tx1 - 1, width - 1) / MULTIBAND_OWNER_CELL; cx++)
+									pyr_cells[cy * cells_x + cx] = 1;
+						}
+						else if (!multiband_cell_sum(pyr_sat, cells_x, cells_y, tx0 - 2 * radius, ty0 - 2 * radius, tx1 + 2 * radius, ty1 + 2 * radius, count))
+							continue;
+					}
+					*entry[level]++ = tile;
 				}
 			}
+			if (cell_owner && level == 0)
+				multiband_cell_table(pyr_sat, &pyr_cells[0], cells_x, cells_y, 1, 1);
 		}
-		*((vx_uint32 *)entry_start) = (vx_uint32)(entry - entry_start - 1);
+	}
+	for (int level = 0; level <= numBands; level++){
+		StitchBlendValidEntry *entry_start = &pBlendArr[array_offset[level] - 1];
+		*((vx_uint32 *)entry_start) = (vx_uint32)(entry[level] - entry_start - 1);
 	}
 	ERROR_CHECK_STATUS(vxCommitArrayRange(blendOffs, 0, max_size, pBlendArr));
-	delete array_offset;
-	delete pRoi_rect;
+	delete[] array_offset;
+	delete[] pRoi_rect;
 	return VX_SUCCESS;
 }
 
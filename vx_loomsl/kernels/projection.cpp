@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "projection.h"
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <emmintrin.h>
+
+//! \brief Function to Compute M.
+static void ComputeM(float * M, float th, float fi, float sy)
+{
+	float sth = sinf(th), cth = cosf(th);
+	float sfi = sinf(fi), cfi = cosf(fi);
+	float ssy = sinf(sy), csy = cosf(sy);
+	M[0] = sth*ssy*sfi + cth*csy; M[1] = ssy*cfi; M[2] = cth*ssy*sfi - sth*csy;
+	M[3] = sth*csy*sfi - cth*ssy; M[4] = csy*cfi; M[5] = cth*csy*sfi + sth*ssy;
+	M[6] = sth    *cfi;          M[7] = -sfi;     M[8] = cth    *cfi;
+}
+
+//! \brief Matix Multiplication Function.
+static void MatMul3x3(float * C, const float * A, const float * B)
+{
+	const float * At = A;
+	for (int i = 0; i < 3; i++, At += 3) {
+		const float * Bt = B;
+		for (int j = 0; j < 3; j++, Bt++, C++) {
+			*C = At[0] * Bt[0] + At[1] * Bt[3] + At[2] * Bt[6];
+		}
+	}
+}
+
+//! \brief Setup the projection of a camera.
+vx_status stitchProjectionSetup(stitch_projection_camera * proj, const rig_params * rig_par, const camera_params * cam_par, vx_uint32 cam,
+	vx_uint32 num_buff_cols, vx_uint32 src_width, vx_uint32 src_height)
+{
+	const camera_lens_params * lens = &cam_par->lens;
+	float deg2rad = (float)M_PI / 180.0f;
+	float Mr[9], Mc[9];
+	ComputeM(Mr, rig_par->yaw * deg2rad, rig_par->pitch * deg2rad, rig_par->roll * deg2rad);
+	ComputeM(Mc, cam_par->focal.yaw * deg2rad, cam_par->focal.pitch * deg2rad, cam_par->focal.roll * deg2rad);
+	MatMul3x3(proj->M, Mc, Mr);
+	if (rig_par->d > 0.0f) {
+		proj->T[0] = cam_par->focal.tx / rig_par->d;
+		proj->T[1] = cam_par->focal.ty / rig_par->d;
+		proj->T[2] = cam_par->focal.tz / rig_par->d;
+	}
+	else {
+		proj->T[0] = proj->T[1] = proj->T[2] = 0.0f;
+	}
+
+	if (lens->lens_type == ptgui_lens_rectilinear || lens->lens_type == adobe_lens_rectilinear) {
+		proj->fisheye = 0;
+		proj->f[0] = 1.0f / tanf(0.5f * lens->hfov * deg2rad);
+	}
+	else if (lens->lens_type == ptgui_lens_fisheye_ff || lens->lens_type == ptgui_lens_fisheye_circ || lens->lens_type == adobe_lens_fisheye_ff) {
+		proj->fisheye = 1;
+		proj->f[0] = 1.0f / (0.5f * lens->hfov * deg2rad);
+	}
+	else { // unsupported lens
+		return VX_ERROR_INVALID_TYPE;
+	}
+	proj->f[1] = 0.5f * lens->haw;
+	if (lens->lens_type == adobe_lens_rectilinear || lens->lens_type == adobe_lens_fisheye_ff) {
+		proj->even = 1;
+		proj->p[0] = 1.0f;
+		proj->p[1] = lens->k1;
+		proj->p[2] = lens->k2;
+		proj->p[3] = (lens->lens_type == adobe_lens_rectilinear) ? lens->k3 : 0.0f;
+	}
+	else {
+		proj->even = 0;
+		proj->p[0] = 1.0f - lens->k1 - lens->k2 - lens->k3;
+		proj->p[1] = lens->k3;
+		proj->p[2] = lens->k2;
+		proj->p[3] = lens->k1;
+	}
+
+	// optical center: the center of the camera in the buffer shifted by du0 & dv0
+	vx_uint32 src_width_start = (cam % num_buff_cols) * src_width;
+	if (num_buff_cols > 1) proj->cx = lens->du0 + (float)(src_width / 2 + src_width_start);
+	else proj->cx = lens->du0 + (float)src_width * 0.5f;
+	proj->cy = lens->dv0 + (float)src_height * 0.5f;
+
+	return VX_SUCCESS;
+}
+
+//! \brief Compute the column directions of an equirectangular image.
+void stitchProjectionColumns(stitch_projection_columns * columns, vx_uint32 width_eqr, vx_uint32 height_eqr)
+{
+	vx_uint32 padded_width = (width_eqr + STITCH_PROJECTION_BATCH - 1) & ~(STITCH_PROJECTION_BATCH - 1);
+	float pi_by_h = (float)M_PI / (float)height_eqr;
+	columns->width = width_eqr;
+	columns->height = height_eqr;
+	columns->sin_te.resize(padded_width);
+	columns->cos_te.resize(padded_width);
+	for (vx_uint32 x = 0; x < padded_width; x++) {
+		float te = (float)x * pi_by_h - (float)M_PI;
+		columns->sin_te[x] = sinf(te);
+		columns->cos_te[x] = cosf(te);
+	}
+}
+
+//! \brief atan(y/x) for 0 <= y and 0 < x, with a relative error of a few ulps (cephes atanf).
+static inline __m128 projection_atan2_ps(__m128 y, __m128 x)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 swap = _mm_cmpgt_ps(y, x);
+	// t >= 1e-10 keeps the polynomial out of the denormals, atan(t) = t at this scale
+	__m128 t = _mm_max_ps(_mm_div_ps(_mm_min_ps(x, y), _mm_max_ps(x, y)), _mm_set1_ps(1e-10f));
+	// reduce to |t| <= tan(pi/8) with atan(t) = pi/4 + atan((t - 1) / (t + 1))
+	__m128 big = _mm_cmpgt_ps(t, _mm_set1_ps(0.41421356237309504880f));
+	t = _mm_or_ps(_mm_andnot_ps(big, t), _mm_and_ps(big, _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one))));
+	__m128 base = _mm_and_ps(big, _mm_set1_ps((float)M_PI_4));
+	__m128 t2 = _mm_mul_ps(t, t);
+	__m128 p = _mm_set1_ps(8.05374449538e-2f);
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(-1.38776856032e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(1.99777106478e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(-3.33329491539e-1f));
+	__m128 a = _mm_add_ps(base, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, t2), t), t));
+	// atan(y/x) = pi/2 - atan(x/y) when y > x
+	return _mm_or_ps(_mm_andnot_ps(swap, a), _mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps((float)M_PI_2), a)));
+}
+
+//! \brief Project 4 pixels into a camera.
+// With the unit ray Y in the camera coordinates, rho = sqrt(Y0^2 + Y1^2) = sin(th) and Y2 = cos(th) for the incidence angle th,
+// so the direction of the distorted radius is (Y0,Y1)/rho and the rectilinear radius is f[0] * rho / Y2: only the fisheye
+// lenses need an arc tangent, and the distorted position is (Y0,Y1) scaled by the distorted to rho ratio.
+static inline void projection_pixels_ps(const stitch_projection_camera * proj, __m128 X1, __m128 sin_te, __m128 cos_te, __m128 cos_pe,
+	float * xd, float * yd, float * rr, float * z)
+{
+	const __m128 zero = _mm_setzero_ps();
+	__m128 X0 = _mm_sub_ps(_mm_mul_ps(sin_te, cos_pe), _mm_set1_ps(proj->T[0]));
+	__m128 X2 = _mm_sub_ps(_mm_mul_ps(cos_te, cos_pe), _mm_set1_ps(proj->T[2]));
+	__m128 inv_n = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(X0, X0), _mm_mul_ps(X1, X1)), _mm_mul_ps(X2, X2))));
+	const float * M = proj->M;
+	__m128 Y0 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(M[0]), X0), _mm_mul_ps(_mm_set1_ps(M[1]), X1)), _mm_mul_ps(_mm_set1_ps(M[2]), X2)), inv_n);
+	__m128 Y1 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(M[3]), X0), _mm_mul_ps(_mm_set1_ps(M[4]), X1)), _mm_mul_ps(_mm_set1_ps(M[5]), X2)), inv_n);
+	__m128 Y2 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(M[6]), X0), _mm_mul_ps(_mm_set1_ps(M[7]), X1)), _mm_mul_ps(_mm_set1_ps(M[8]), X2)), inv_n);
+	__m128 rho = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(Y0, Y0), _mm_mul_ps(Y1, Y1)));
+	// pixels behind the camera (Y2 <= 0) are projected as if Y2 was tiny, the caller drops them
+	__m128 cz = _mm_max_ps(Y2, _mm_set1_ps(1e-20f));
+	__m128 f0 = _mm_set1_ps(proj->f[0]);
+	__m128 r, ratio;
+	if (proj->fisheye) {
+		__m128 th = projection_atan2_ps(rho, cz);
+		r = _mm_mul_ps(th, f0);
+		__m128 small = _mm_cmplt_ps(rho, _mm_set1_ps(1e-6f));
+		ratio = _mm_mul_ps(f0, _mm_or_ps(_mm_andnot_ps(small, _mm_div_ps(th, _mm_or_ps(rho, _mm_and_ps(small, _mm_set1_ps(1.0f))))), _mm_and_ps(small, _mm_set1_ps(1.0f))));
+	}
+	else {
+		ratio = _mm_div_ps(f0, cz);
+		r = _mm_mul_ps(rho, ratio);
+	}
+	__m128 u = proj->even ? _mm_mul_ps(r, r) : r;
+	__m128 p = _mm_set1_ps(proj->p[3]);
+	p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(proj->p[2]));
+	p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(proj->p[1]));
+	p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(proj->p[0]));
+	__m128 s = _mm_mul_ps(_mm_mul_ps(ratio, p), _mm_set1_ps(proj->f[1]));
+	_mm_storeu_ps(xd, _mm_add_ps(_mm_set1_ps(proj->cx), _mm_mul_ps(Y0, s)));
+	_mm_storeu_ps(yd, _mm_add_ps(_mm_set1_ps(proj->cy), _mm_mul_ps(Y1, s)));
+	__m128 d = _mm_mul_ps(rho, s);
+	_mm_storeu_ps(rr, _mm_max_ps(d, _mm_sub_ps(zero, d)));
+	_mm_storeu_ps(z, Y2);
+}
+
+//! \brief Project STITCH_PROJECTION_BATCH pixels of a row of the equirectangular image into a camera.
+void stitchProjectPixels(const stitch_projection_camera * proj, float sin_pe, float cos_pe, const float * sin_te, const float * cos_te,
+	float * xd, float * yd, float * rr, float * z)
+{
+	__m128 X1 = _mm_set1_ps(sin_pe - proj->T[1]);
+	__m128 cpe = _mm_set1_ps(cos_pe);
+	for (int i = 0; i < STITCH_PROJECTION_BATCH; i += 4) {
+		projection_pixels_ps(proj, X1, _mm_loadu_ps(sin_te + i), _mm_loadu_ps(cos_te + i), cpe, xd + i, yd + i, rr + i, z + i);
+	}
+}
+
+//! \brief Project a row of the equirectangular image into a camera.
+void stitchProjectRow(const stitch_projection_camera * proj, const stitch_projection_columns * columns, vx_uint32 y,
+	float * xd, float * yd, float * rr, float * z)
+{
+	float pi_by_h = (float)M_PI / (float)columns->height;
+	float pe = (float)y * pi_by_h - (float)M_PI_2;
+	float sin_pe = sinf(pe), cos_pe = cosf(pe);
+	vx_size padded_width = columns->sin_te.size();
+	for (vx_size x = 0; x < padded_width; x += STITCH_PROJECTION_BATCH) {
+		stitchProjectPixels(proj, sin_pe, cos_pe, &columns->sin_te[x], &columns->cos_te[x], xd + x, yd + x, rr + x, z + x);
+	}
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef __STITCH_PROJECTION_H__
+#define __STITCH_PROJECTION_H__
+
+// header file for the projection of the equirectangular output onto the cameras of the rig, shared by all table builders
+#include "kernels.h"
+
+#define STITCH_PROJECTION_BATCH		8	// number of equirectangular pixels evaluated per stitchProjectPixels call
+
+//! \brief The projection of a camera of the rig.
+// The lens distortion of all the lens types is the polynomial p(u) = p[0] + u * (p[1] + u * (p[2] + u * p[3])) of the
+// normalized undistorted radius r, with u = r for the PTGui models and u = r^2 for the adobe models: the distorted radius is r * p(u).
+typedef struct {
+	float M[9];          // rotation from the equirectangular to the camera coordinates
+	float T[3];          // camera translation normalized by the rig distance
+	float f[2];          // f[0] normalizes the incidence angle (or its tangent) to r, f[1] scales the distorted radius to pixels
+	float p[4];          // lens distortion polynomial coefficients
+	float cx, cy;        // optical center in the camera buffer
+	vx_int32 fisheye;    // 1 if the radius is proportional to the incidence angle, 0 if it is proportional to its tangent
+	vx_int32 even;       // 1 if the polynomial is in r^2 (adobe), 0 if it is in r (PTGui)
+} stitch_projection_camera;
+
+//! \brief The per column directions of an equirectangular image, padded to a multiple of STITCH_PROJECTION_BATCH.
+typedef struct {
+	vx_uint32 width, height;
+	std::vector<float> sin_te, cos_te;
+} stitch_projection_columns;
+
+//! \brief Setup the projection of a camera: returns VX_ERROR_INVALID_TYPE if the lens type is not supported.
+vx_status stitchProjectionSetup(stitch_projection_camera * proj, const rig_params * rig_par, const camera_params * cam_par, vx_uint32 cam,
+	vx_uint32 num_buff_cols, vx_uint32 src_width, vx_uint32 src_height);
+
+//! \brief Compute the column directions of an equirectangular image.
+void stitchProjectionColumns(stitch_projection_columns * columns, vx_uint32 width_eqr, vx_uint32 height_eqr);
+
+//! \brief Project STITCH_PROJECTION_BATCH pixels of a row of the equirectangular image into a camera.
+// The outputs are the source position (xd,yd) in the camera buffer, the distorted radius rr in pixels and the
+// z coordinate of the ray in the camera: a pixel is only seen by the camera if z > 0, and a larger z is closer to the optical axis.
+void stitchProjectPixels(const stitch_projection_camera * proj, float sin_pe, float cos_pe, const float * sin_te, const float * cos_te,
+	float * xd, float * yd, float * rr, float * z);
+
+//! \brief Project a row of the equirectangular image into a camera: the outputs must hold columns->sin_te.size() items.
+void stitchProjectRow(const stitch_projection_camera * proj, const stitch_projection_columns * columns, vx_uint32 y,
+	float * xd, float * yd, float * rr, float * z);
+
+//! \brief The ratio of the distorted to the undistorted radius for a normalized undistorted radius r.
+static inline float stitchProjectionLensScale(const stitch_projection_camera * proj, float r)
+{
+	float u = proj->even ? r * r : r;
+	return proj->p[0] + u * (proj->p[1] + u * (proj->p[2] + u * proj->p[3]));
+}
+
+#endif //__STITCH_PROJECTION_H__
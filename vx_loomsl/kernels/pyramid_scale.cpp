@@ -22,9 +22,95 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "thread_pool.h"
 #include <CL/cl.h>
 #include <stdio.h>
+#include <string.h>
 #include <algorithm>
+#include <emmintrin.h>
+#include <atomic>
+
+//! \brief Clamp a pixel coordinate to [0, size-1]: the host kernels replicate the border pixels of a camera.
+static inline vx_int32 pyramid_clamp(vx_int32 v, vx_int32 size)
+{
+	return v < 0 ? 0 : (v >= size ? size - 1 : v);
+}
+
+//! \brief Access the blend offsets array: the item just before the first tile of a level holds its number of tiles.
+static vx_status pyramid_access_tiles(vx_array arr, vx_uint32 arr_offs, vx_size& num_items, StitchBlendValidEntry *& base, vx_uint32& num_tiles)
+{
+	num_items = 0; base = nullptr; num_tiles = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+	if (arr_offs < 1 || arr_offs > num_items)
+		return VX_ERROR_INVALID_VALUE;
+	vx_size stride = sizeof(StitchBlendValidEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(arr, 0, num_items, &stride, (void **)&base, VX_READ_ONLY));
+	num_tiles = std::min(*((vx_uint32 *)&base[arr_offs - 1]), (vx_uint32)(num_items - arr_offs));
+	return VX_SUCCESS;
+}
+
+//! \brief Upsample one tile of a half scale image with the filter of the OpenCL kernels, scaled by 64.
+// Output pixel 2k is 1-6-1 of source pixels k-1, k, k+1 and output pixel 2k+1 is 4-4 of source pixels k, k+1, both horizontally
+// and vertically. The horizontal pass runs on 16-bit lanes like the OpenCL kernels and the vertical pass on 32-bit lanes.
+// The result is up[y * 256 + x * 4 + c] for the nx x ny pixels of the tile, channel 3 is zero.
+static void pyramid_upsample_tile(vx_int32 x0, vx_int32 y0, vx_int32 nx, vx_int32 ny,
+	const vx_uint8 * src, vx_int32 src_stride, vx_int32 src_width, vx_int32 src_height, bool src_rgb4, vx_int32 * up)
+{
+	vx_int32 k0 = x0 >> 1, kn = ((x0 + nx - 1) >> 1) - k0 + 1;
+	vx_int32 m0 = y0 >> 1, mn = ((y0 + ny - 1) >> 1) - m0 + 1;
+	vx_int16 line[(32 + 2) * 4];
+	vx_int32 hbuf[(8 + 2) * 256];
+	for (vx_int32 r = 0; r < mn + 2; r++) {
+		// source pixels k0-1 ... k0+kn of row m0-1+r, 4 lanes per pixel
+		const vx_uint8 * row = src + pyramid_clamp(m0 - 1 + r, src_height) * src_stride;
+		for (vx_int32 k = 0; k < kn + 2; k++) {
+			vx_int32 sx = pyramid_clamp(k0 - 1 + k, src_width);
+			if (src_rgb4) {
+				const vx_int16 * p = (const vx_int16 *)(row + sx * 6);
+				line[k * 4 + 0] = p[0]; line[k * 4 + 1] = p[1]; line[k * 4 + 2] = p[2];
+			}
+			else {
+				const vx_uint8 * p = row + sx * 4;
+				line[k * 4 + 0] = p[0]; line[k * 4 + 1] = p[1]; line[k * 4 + 2] = p[2];
+			}
+			line[k * 4 + 3] = 0;
+		}
+		// horizontal pass: two output pixels per iteration
+		vx_int32 * h = hbuf + r * 256;
+		for (vx_int32 x = 0; x < nx; x += 2) {
+			vx_int32 k = ((x0 + x) >> 1) - k0 + 1;
+			__m128i pl = _mm_loadl_epi64((const __m128i *)&line[(k - 1) * 4]);
+			__m128i pc = _mm_loadl_epi64((const __m128i *)&line[k * 4]);
+			__m128i pr = _mm_loadl_epi64((const __m128i *)&line[(k + 1) * 4]);
+			__m128i ev = _mm_add_epi16(_mm_add_epi16(pl, pr), _mm_add_epi16(_mm_slli_epi16(pc, 2), _mm_slli_epi16(pc, 1)));
+			__m128i od = _mm_slli_epi16(_mm_add_epi16(pc, pr), 2);
+			__m128i v = _mm_unpacklo_epi64(ev, od);
+			_mm_storeu_si128((__m128i *)&h[x * 4], _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+			_mm_storeu_si128((__m128i *)&h[x * 4 + 4], _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+		}
+	}
+	// vertical pass
+	for (vx_int32 y = 0; y < ny; y++) {
+		const vx_int32 * hc = hbuf + (((y0 + y) >> 1) - m0 + 1) * 256;
+		vx_int32 * u = up + y * 256;
+		if ((y0 + y) & 1) {
+			for (vx_int32 i = 0; i < nx * 4; i += 4) {
+				__m128i b = _mm_loadu_si128((const __m128i *)&hc[i]);
+				__m128i c = _mm_loadu_si128((const __m128i *)&hc[i + 256]);
+				_mm_storeu_si128((__m128i *)&u[i], _mm_slli_epi32(_mm_add_epi32(b, c), 2));
+			}
+		}
+		else {
+			for (vx_int32 i = 0; i < nx * 4; i += 4) {
+				__m128i a = _mm_loadu_si128((const __m128i *)&hc[i - 256]);
+				__m128i b = _mm_loadu_si128((const __m128i *)&hc[i]);
+				__m128i c = _mm_loadu_si128((const __m128i *)&hc[i + 256]);
+				__m128i s = _mm_add_epi32(_mm_add_epi32(a, c), _mm_add_epi32(_mm_slli_epi32(b, 2), _mm_slli_epi32(b, 1)));
+				_mm_storeu_si128((__m128i *)&u[i], s);
+			}
+		}
+	}
+}
 
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK half_scale_gaussian_input_validator(vx_node node, vx_uint32 index)
@@ -142,7 +228,7 @@ static vx_status VX_CALLBACK half_scale_gaussian_query_target_support(vx_graph g
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -492,10 +578,117 @@ static vx_status VX_CALLBACK half_scale_gaussian_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief Half scale gaussian of one 64x16 output tile on the host: 5x5 binomial filter centered at input pixel (2x+1, 2y+1).
+// Each input row is split into even and odd pixels so the horizontal pass is O[x-1] + 4E[x] + 6O[x] + 4E[x+1] + O[x+1] on 16-bit lanes.
+static void half_scale_gaussian_tile(const StitchBlendValidEntry& tile, vx_int32 ch,
+	const vx_uint8 * ip_buf, vx_int32 ip_stride, vx_int32 ip_width, vx_int32 ip_height,
+	vx_uint8 * op_buf, vx_int32 op_stride, vx_int32 op_width, vx_int32 op_height)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x >> 2) + 1) << 2), op_width - x0);
+	vx_int32 ny = std::min((vx_int32)tile.end_y + 1, op_height - y0);
+	if (nx <= 0 || ny <= 0)
+		return;
+	const vx_uint8 * ip_cam = ip_buf + tile.camId * ip_height * ip_stride;
+	vx_uint8 * op_cam = op_buf + tile.camId * op_height * op_stride;
+	vx_int32 lanes = nx * ch;
+	vx_uint16 even[(64 + 1) * 4 + 8] = { 0 }, odd[(64 + 2) * 4 + 8] = { 0 };
+	vx_uint16 hbuf[(2 * 16 + 3) * 256];
+	vx_uint8 obuf[256 + 8];
+	// horizontal pass over input rows 2*y0-1 ... 2*(y0+ny)+1
+	for (vx_int32 r = 0; r < 2 * ny + 3; r++) {
+		const vx_uint8 * row = ip_cam + pyramid_clamp(2 * y0 - 1 + r, ip_height) * ip_stride;
+		for (vx_int32 k = 0; k <= nx; k++) {
+			const vx_uint8 * pe = row + pyramid_clamp(2 * (x0 + k), ip_width) * ch;
+			for (vx_int32 c = 0; c < ch; c++)
+				even[k * ch + c] = pe[c];
+		}
+		for (vx_int32 k = -1; k <= nx; k++) {
+			const vx_uint8 * po = row + pyramid_clamp(2 * (x0 + k) + 1, ip_width) * ch;
+			for (vx_int32 c = 0; c < ch; c++)
+				odd[(k + 1) * ch + c] = po[c];
+		}
+		vx_uint16 * h = hbuf + r * 256;
+		for (vx_int32 i = 0; i < lanes; i += 8) {
+			__m128i om = _mm_loadu_si128((const __m128i *)&odd[i]);
+			__m128i oc = _mm_loadu_si128((const __m128i *)&odd[i + ch]);
+			__m128i op = _mm_loadu_si128((const __m128i *)&odd[i + 2 * ch]);
+			__m128i e0 = _mm_loadu_si128((const __m128i *)&even[i]);
+			__m128i e1 = _mm_loadu_si128((const __m128i *)&even[i + ch]);
+			__m128i s = _mm_add_epi16(_mm_add_epi16(om, op), _mm_slli_epi16(_mm_add_epi16(e0, e1), 2));
+			s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(oc, 2), _mm_slli_epi16(oc, 1)));
+			_mm_storeu_si128((__m128i *)&h[i], s);
+		}
+	}
+	// vertical pass with round to nearest even like amd_pack: the sums fit in 16 bits (255 * 256)
+	const __m128i c127 = _mm_set1_epi16(127), c1 = _mm_set1_epi16(1);
+	for (vx_int32 y = 0; y < ny; y++) {
+		const vx_uint16 * h = hbuf + 2 * y * 256;
+		for (vx_int32 i = 0; i < lanes; i += 8) {
+			__m128i r0 = _mm_loadu_si128((const __m128i *)&h[i]);
+			__m128i r1 = _mm_loadu_si128((const __m128i *)&h[i + 256]);
+			__m128i r2 = _mm_loadu_si128((const __m128i *)&h[i + 512]);
+			__m128i r3 = _mm_loadu_si128((const __m128i *)&h[i + 768]);
+			__m128i r4 = _mm_loadu_si128((const __m128i *)&h[i + 1024]);
+			__m128i s = _mm_add_epi16(_mm_add_epi16(r0, r4), _mm_slli_epi16(_mm_add_epi16(r1, r3), 2));
+			s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(r2, 2), _mm_slli_epi16(r2, 1)));
+			s = _mm_add_epi16(s, _mm_add_epi16(c127, _mm_and_si128(_mm_srli_epi16(s, 8), c1)));
+			s = _mm_srli_epi16(s, 8);
+			_mm_storel_epi64((__m128i *)&obuf[i], _mm_packus_epi16(s, s));
+		}
+		memcpy(op_cam + (y0 + y) * op_stride + x0 * ch, obuf, lanes);
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK half_scale_gaussian_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_SUPPORTED;
+	vx_uint32 num_cameras = 0, arr_offs = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	if (num_cameras == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_array arr = (vx_array)parameters[2];
+	vx_image input_image = (vx_image)parameters[3];
+	vx_image output_image = (vx_image)parameters[4];
+
+	// get image configurations
+	vx_uint32 ip_width = 0, ip_height = 0, op_width = 0, op_height = 0;
+	vx_df_image format = VX_DF_IMAGE_VIRT;
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_WIDTH, &ip_width, sizeof(ip_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &ip_height, sizeof(ip_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &op_width, sizeof(op_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &op_height, sizeof(op_height)));
+	vx_int32 ch = (format == VX_DF_IMAGE_RGBX) ? 4 : 1;
+
+	// access tiles and images
+	vx_size num_items = 0;
+	vx_uint32 num_tiles = 0;
+	StitchBlendValidEntry * tiles = nullptr;
+	ERROR_CHECK_STATUS(pyramid_access_tiles(arr, arr_offs, num_items, tiles, num_tiles));
+	vx_rectangle_t ip_rect = { 0, 0, ip_width, ip_height };
+	vx_rectangle_t op_rect = { 0, 0, op_width, op_height };
+	vx_imagepatch_addressing_t ip_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &ip_rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &op_rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+
+	// each tile is processed independently with its own scratch rows
+	std::atomic<int> next_tile(0);
+	std::function<void()> tile_thread_func = [&]() {
+		for (int t = next_tile++; t < (int)num_tiles; t = next_tile++) {
+			half_scale_gaussian_tile(tiles[arr_offs + t], ch,
+				ip_buf, ip_addr.stride_y, ip_width, ip_height / num_cameras,
+				op_buf, op_addr.stride_y, op_width, op_height / num_cameras);
+		}
+	};
+	stitch_thread_pool_run(node, (int)num_tiles, tile_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &op_rect, 0, &op_addr, op_buf));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel publisher.
@@ -508,8 +701,8 @@ vx_status half_scale_gaussian_publish(vx_context context)
 		5,
 		half_scale_gaussian_input_validator,
 		half_scale_gaussian_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = half_scale_gaussian_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = half_scale_gaussian_opencl_codegen;
@@ -675,14 +868,100 @@ static vx_status VX_CALLBACK upscale_gaussian_subtract_query_target_support(vx_g
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
+//! \brief Upscale gaussian subtract of one tile on the host: ip - upsample(ip1), optionally scaled by weight/255, truncated to RGB4.
+static void upscale_gaussian_subtract_tile(const StitchBlendValidEntry& tile, vx_int32 width, vx_int32 height,
+	const vx_uint8 * ip_buf, vx_int32 ip_stride, const vx_uint8 * ip1_buf, vx_int32 ip1_stride, vx_int32 ip1_width,
+	const vx_uint8 * wt_buf, vx_int32 wt_stride, vx_uint8 * op_buf, vx_int32 op_stride)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x + 3) >> 2) << 2), width - x0);
+	vx_int32 ny = std::min((vx_int32)(((tile.end_y >> 1) + 1) << 1), height - y0);
+	if (nx <= 0 || ny <= 0)
+		return;
+	vx_int32 up[16 * 256];
+	pyramid_upsample_tile(x0, y0, nx, ny, ip1_buf + tile.camId * (height >> 1) * ip1_stride, ip1_stride, ip1_width, height >> 1, false, up);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale_up = _mm_set1_ps(0.015625f), scale_wt = _mm_set1_ps(0.00392157f);
+	for (vx_int32 y = 0; y < ny; y++) {
+		vx_int32 gy = tile.camId * height + y0 + y;
+		const vx_uint8 * ip = ip_buf + gy * ip_stride + x0 * 4;
+		const vx_uint8 * wt = wt_buf ? wt_buf + gy * wt_stride + x0 : nullptr;
+		vx_int16 * op = (vx_int16 *)(op_buf + gy * op_stride + x0 * 6);
+		const vx_int32 * u = up + y * 256;
+		for (vx_int32 x = 0; x < nx; x++) {
+			__m128i px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)&ip[x * 4]), zero), zero);
+			__m128 d = _mm_sub_ps(_mm_cvtepi32_ps(px), _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&u[x * 4])), scale_up));
+			if (wt)
+				d = _mm_mul_ps(_mm_mul_ps(d, _mm_set1_ps((vx_float32)wt[x])), scale_wt);
+			__m128i v = _mm_cvttps_epi32(d);
+			v = _mm_packs_epi32(v, v);
+			op[x * 3 + 0] = (vx_int16)_mm_extract_epi16(v, 0);
+			op[x * 3 + 1] = (vx_int16)_mm_extract_epi16(v, 1);
+			op[x * 3 + 2] = (vx_int16)_mm_extract_epi16(v, 2);
+		}
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK upscale_gaussian_subtract_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	vx_uint32 num_cameras = 0, arr_offs = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	if (num_cameras == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_image input_image = (vx_image)parameters[2];
+	vx_image input1_image = (vx_image)parameters[3];
+	vx_array arr = (vx_array)parameters[4];
+	vx_image weight_image = (vx_image)parameters[5];
+	vx_image output_image = (vx_image)parameters[6];
+
+	// get image configurations
+	vx_uint32 width = 0, height = 0, ip1_width = 0, ip1_height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_WIDTH, &ip1_width, sizeof(ip1_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &ip1_height, sizeof(ip1_height)));
+
+	// access tiles and images
+	vx_size num_items = 0;
+	vx_uint32 num_tiles = 0;
+	StitchBlendValidEntry * tiles = nullptr;
+	ERROR_CHECK_STATUS(pyramid_access_tiles(arr, arr_offs, num_items, tiles, num_tiles));
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_rectangle_t ip1_rect = { 0, 0, ip1_width, ip1_height };
+	vx_imagepatch_addressing_t ip_addr, ip1_addr, wt_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *ip1_buf = nullptr, *wt_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input1_image, &ip1_rect, 0, &ip1_addr, (void **)&ip1_buf, VX_READ_ONLY));
+	if (weight_image) {
+		ERROR_CHECK_STATUS(vxAccessImagePatch(weight_image, &rect, 0, &wt_addr, (void **)&wt_buf, VX_READ_ONLY));
+	}
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+
+	// each tile is processed independently with its own scratch rows
+	std::atomic<int> next_tile(0);
+	std::function<void()> tile_thread_func = [&]() {
+		for (int t = next_tile++; t < (int)num_tiles; t = next_tile++) {
+			upscale_gaussian_subtract_tile(tiles[arr_offs + t], width, height / num_cameras,
+				ip_buf, ip_addr.stride_y, ip1_buf, ip1_addr.stride_y, ip1_width,
+				wt_buf, wt_buf ? wt_addr.stride_y : 0, op_buf, op_addr.stride_y);
+		}
+	};
+	stitch_thread_pool_run(node, (int)num_tiles, tile_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input1_image, nullptr, 0, &ip1_addr, ip1_buf));
+	if (weight_image) {
+		ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, nullptr, 0, &wt_addr, wt_buf));
+	}
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &rect, 0, &op_addr, op_buf));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	return VX_SUCCESS;
 }
 
 //! \brief The OpenCL code generator callback.
@@ -981,8 +1260,8 @@ vx_status upscale_gaussian_subtract_publish(vx_context context)
 		7,
 		upscale_gaussian_subtract_input_validator,
 		upscale_gaussian_subtract_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = upscale_gaussian_subtract_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = upscale_gaussian_subtract_opencl_codegen;
@@ -1124,14 +1403,88 @@ static vx_status VX_CALLBACK upscale_gaussian_add_query_target_support(vx_graph
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
+//! \brief Upscale gaussian add of one tile on the host: ip + upsample(ip1) with the 16-bit wrap around of the OpenCL kernel.
+static void upscale_gaussian_add_tile(const StitchBlendValidEntry& tile, vx_int32 width, vx_int32 height,
+	const vx_uint8 * ip_buf, vx_int32 ip_stride, const vx_uint8 * ip1_buf, vx_int32 ip1_stride, vx_int32 ip1_width,
+	vx_uint8 * op_buf, vx_int32 op_stride)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x + 7) >> 3) << 3), width - x0);
+	vx_int32 ny = std::min((vx_int32)(((tile.end_y >> 1) + 1) << 1), height - y0);
+	if (nx <= 0 || ny <= 0)
+		return;
+	vx_int32 up[16 * 256];
+	pyramid_upsample_tile(x0, y0, nx, ny, ip1_buf + tile.camId * (height >> 1) * ip1_stride, ip1_stride, ip1_width, height >> 1, true, up);
+	const __m128i c63 = _mm_set1_epi32(63);
+	for (vx_int32 y = 0; y < ny; y++) {
+		vx_int32 gy = tile.camId * height + y0 + y;
+		const vx_int16 * ip = (const vx_int16 *)(ip_buf + gy * ip_stride + x0 * 6);
+		vx_int16 * op = (vx_int16 *)(op_buf + gy * op_stride + x0 * 6);
+		const vx_int32 * u = up + y * 256;
+		for (vx_int32 x = 0; x < nx; x++) {
+			// upsampled value divided by 64 with truncation towards zero
+			__m128i s = _mm_loadu_si128((const __m128i *)&u[x * 4]);
+			s = _mm_srai_epi32(_mm_add_epi32(s, _mm_and_si128(_mm_srai_epi32(s, 31), c63)), 6);
+			__m128i v = _mm_add_epi16(_mm_packs_epi32(s, s), _mm_setr_epi16(ip[x * 3 + 0], ip[x * 3 + 1], ip[x * 3 + 2], 0, 0, 0, 0, 0));
+			op[x * 3 + 0] = (vx_int16)_mm_extract_epi16(v, 0);
+			op[x * 3 + 1] = (vx_int16)_mm_extract_epi16(v, 1);
+			op[x * 3 + 2] = (vx_int16)_mm_extract_epi16(v, 2);
+		}
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK upscale_gaussian_add_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	vx_uint32 num_cameras = 0, arr_offs = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	if (num_cameras == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_image input_image = (vx_image)parameters[2];
+	vx_image input1_image = (vx_image)parameters[3];
+	vx_array arr = (vx_array)parameters[4];
+	vx_image output_image = (vx_image)parameters[5];
+
+	// get image configurations
+	vx_uint32 width = 0, height = 0, ip1_width = 0, ip1_height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_WIDTH, &ip1_width, sizeof(ip1_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &ip1_height, sizeof(ip1_height)));
+
+	// access tiles and images
+	vx_size num_items = 0;
+	vx_uint32 num_tiles = 0;
+	StitchBlendValidEntry * tiles = nullptr;
+	ERROR_CHECK_STATUS(pyramid_access_tiles(arr, arr_offs, num_items, tiles, num_tiles));
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_rectangle_t ip1_rect = { 0, 0, ip1_width, ip1_height };
+	vx_imagepatch_addressing_t ip_addr, ip1_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *ip1_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input1_image, &ip1_rect, 0, &ip1_addr, (void **)&ip1_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+
+	// each tile is processed independently with its own scratch rows
+	std::atomic<int> next_tile(0);
+	std::function<void()> tile_thread_func = [&]() {
+		for (int t = next_tile++; t < (int)num_tiles; t = next_tile++) {
+			upscale_gaussian_add_tile(tiles[arr_offs + t], width, height / num_cameras,
+				ip_buf, ip_addr.stride_y, ip1_buf, ip1_addr.stride_y, ip1_width, op_buf, op_addr.stride_y);
+		}
+	};
+	stitch_thread_pool_run(node, (int)num_tiles, tile_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input1_image, nullptr, 0, &ip1_addr, ip1_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &rect, 0, &op_addr, op_buf));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	return VX_SUCCESS;
 }
 
 //! \brief The OpenCL code generator callback.
@@ -1348,8 +1701,8 @@ vx_status upscale_gaussian_add_publish(vx_context context)
 		6,
 		upscale_gaussian_add_input_validator,
 		upscale_gaussian_add_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = upscale_gaussian_add_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = upscale_gaussian_add_opencl_codegen;
@@ -1449,6 +1802,31 @@ static vx_status VX_CALLBACK laplacian_reconstruct_input_validator(vx_node node,
 		}
 		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
 	}
+	else if (index == 6)
+	{ // image of format VX_DF_IMAGE_RGBX: source of the interior tiles
+		vx_df_image input_format = VX_DF_IMAGE_VIRT;
+		ERROR_CHECK_STATUS(vxQueryImage((vx_image)ref, VX_IMAGE_ATTRIBUTE_FORMAT, &input_format, sizeof(input_format)));
+		ERROR_CHECK_STATUS(vxReleaseImage((vx_image *)&ref));
+		if (input_format != VX_DF_IMAGE_RGBX) {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: laplacian_recon image %d should be an image of RGBX type\n", index);
+		}
+		else {
+			status = VX_SUCCESS;
+		}
+	}
+	else if (index == 7)
+	{ // scalar of VX_TYPE_UINT32
+		vx_enum itemtype = VX_TYPE_INVALID;
+		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
+		if (itemtype == VX_TYPE_UINT32) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_DIMENSION;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: laplacian_recon interior_offs should be UINT32 type\n");
+		}
+	}
 	return status;
 }
 
@@ -1491,14 +1869,119 @@ static vx_status VX_CALLBACK laplacian_reconstruct_query_target_support(vx_graph
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
+//! \brief Laplacian reconstruct of one tile on the host: ip + upsample(ip1) packed into RGBX with round to nearest even.
+static void laplacian_reconstruct_tile(const StitchBlendValidEntry& tile, vx_int32 width, vx_int32 height,
+	const vx_uint8 * ip_buf, vx_int32 ip_stride, const vx_uint8 * ip1_buf, vx_int32 ip1_stride, vx_int32 ip1_width,
+	vx_uint8 * op_buf, vx_int32 op_stride)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x + 7) >> 3) << 3), width - x0);
+	vx_int32 ny = std::min((vx_int32)(((tile.end_y >> 1) + 1) << 1), height - y0);
+	if (nx <= 0 || ny <= 0)
+		return;
+	vx_int32 up[16 * 256];
+	pyramid_upsample_tile(x0, y0, nx, ny, ip1_buf + tile.camId * (height >> 1) * ip1_stride, ip1_stride, ip1_width, height >> 1, true, up);
+	const __m128 scale_up = _mm_set1_ps(0.015625f);
+	const __m128i alpha = _mm_cvtsi32_si128((int)0xff000000);
+	for (vx_int32 y = 0; y < ny; y++) {
+		vx_int32 gy = tile.camId * height + y0 + y;
+		const vx_int16 * ip = (const vx_int16 *)(ip_buf + gy * ip_stride + x0 * 6);
+		vx_uint32 * op = (vx_uint32 *)(op_buf + gy * op_stride + x0 * 4);
+		const vx_int32 * u = up + y * 256;
+		for (vx_int32 x = 0; x < nx; x++) {
+			__m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&u[x * 4])), scale_up);
+			f = _mm_add_ps(f, _mm_cvtepi32_ps(_mm_setr_epi32(ip[x * 3 + 0], ip[x * 3 + 1], ip[x * 3 + 2], 0)));
+			__m128i v = _mm_cvtps_epi32(f);
+			v = _mm_packs_epi32(v, v);
+			v = _mm_or_si128(_mm_packus_epi16(v, v), alpha);
+			op[x] = (vx_uint32)_mm_cvtsi128_si32(v);
+		}
+	}
+}
+
+//! \brief Copy one interior tile on the host: the pyramid of a single camera would reconstruct its source to within 1 LSB
+//  (the truncation of the upscale), so the interior tiles get the source pixels exactly.
+static void laplacian_reconstruct_copy_tile(const StitchBlendValidEntry& tile, vx_int32 width, vx_int32 height,
+	const vx_uint8 * src_buf, vx_int32 src_stride, vx_uint8 * op_buf, vx_int32 op_stride)
+{
+	vx_int32 x0 = tile.dstX, y0 = tile.dstY;
+	vx_int32 nx = std::min((vx_int32)(((tile.end_x + 7) >> 3) << 3), width - x0);
+	vx_int32 ny = std::min((vx_int32)(((tile.end_y >> 1) + 1) << 1), height - y0);
+	for (vx_int32 y = 0; y < ny; y++) {
+		vx_int32 gy = tile.camId * height + y0 + y;
+		memcpy(op_buf + gy * op_stride + x0 * 4, src_buf + gy * src_stride + x0 * 4, nx * 4);
+	}
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK laplacian_reconstruct_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	vx_uint32 num_cameras = 0, arr_offs = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &num_cameras));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &arr_offs));
+	if (num_cameras == 0)
+		return VX_ERROR_INVALID_VALUE;
+	vx_image input_image = (vx_image)parameters[2];
+	vx_image input1_image = (vx_image)parameters[3];
+	vx_array arr = (vx_array)parameters[4];
+	vx_image output_image = (vx_image)parameters[5];
+	vx_image src_image = (num > 7 && parameters[6] && parameters[7]) ? (vx_image)parameters[6] : nullptr;
+	vx_uint32 interior_offs = 0;
+	if (src_image)
+		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[7], &interior_offs));
+
+	// get image configurations
+	vx_uint32 width = 0, height = 0, ip1_width = 0, ip1_height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_WIDTH, &ip1_width, sizeof(ip1_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input1_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &ip1_height, sizeof(ip1_height)));
+
+	// access tiles and images
+	vx_size num_items = 0;
+	vx_uint32 num_tiles = 0;
+	StitchBlendValidEntry * tiles = nullptr;
+	ERROR_CHECK_STATUS(pyramid_access_tiles(arr, arr_offs, num_items, tiles, num_tiles));
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_rectangle_t ip1_rect = { 0, 0, ip1_width, ip1_height };
+	vx_imagepatch_addressing_t ip_addr, ip1_addr, op_addr;
+	vx_uint8 * ip_buf = nullptr, *ip1_buf = nullptr, *op_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input1_image, &ip1_rect, 0, &ip1_addr, (void **)&ip1_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+	vx_uint32 num_interior = 0;
+	vx_imagepatch_addressing_t src_addr;
+	vx_uint8 * src_buf = nullptr;
+	if (src_image && interior_offs > 0 && interior_offs <= num_items) {
+		num_interior = std::min(*((vx_uint32 *)&tiles[interior_offs - 1]), (vx_uint32)(num_items - interior_offs));
+		ERROR_CHECK_STATUS(vxAccessImagePatch(src_image, &rect, 0, &src_addr, (void **)&src_buf, VX_READ_ONLY));
+	}
+
+	// each tile is processed independently with its own scratch rows, the interior tiles follow the pyramid tiles
+	std::atomic<int> next_tile(0);
+	std::function<void()> tile_thread_func = [&]() {
+		for (int t = next_tile++; t < (int)(num_tiles + num_interior); t = next_tile++) {
+			if (t < (int)num_tiles)
+				laplacian_reconstruct_tile(tiles[arr_offs + t], width, height / num_cameras,
+					ip_buf, ip_addr.stride_y, ip1_buf, ip1_addr.stride_y, ip1_width, op_buf, op_addr.stride_y);
+			else
+				laplacian_reconstruct_copy_tile(tiles[interior_offs + t - num_tiles], width, height / num_cameras,
+					src_buf, src_addr.stride_y, op_buf, op_addr.stride_y);
+		}
+	};
+	stitch_thread_pool_run(node, (int)(num_tiles + num_interior), tile_thread_func);
+
+	if (src_buf)
+		ERROR_CHECK_STATUS(vxCommitImagePatch(src_image, nullptr, 0, &src_addr, src_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input1_image, nullptr, 0, &ip1_addr, ip1_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &rect, 0, &op_addr, op_buf));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, 0, 0, tiles));
+	return VX_SUCCESS;
 }
 
 //! \brief The OpenCL code generator callback.
@@ -1535,6 +2018,12 @@ static vx_status VX_CALLBACK laplacian_reconstruct_opencl_codegen(
 	vx_array wg_offsets = (vx_array)avxGetNodeParamRef(node, 4);
 	ERROR_CHECK_STATUS(vxQueryArray(wg_offsets, VX_ARRAY_ATTRIBUTE_CAPACITY, &wg_num, sizeof(wg_num)));
 	ERROR_CHECK_STATUS(vxReleaseArray(&wg_offsets));
+	// interior tiles are copied from the source image by the work-groups after the pyramid tiles
+	vx_image interior_src = (vx_image)avxGetNodeParamRef(node, 6);		// optional source of the interior tiles
+	vx_scalar interior_offs = (vx_scalar)avxGetNodeParamRef(node, 7);	// optional offset of the interior tiles
+	bool interior = (interior_src && interior_offs) ? true : false;
+	if (interior_src) ERROR_CHECK_STATUS(vxReleaseImage(&interior_src));
+	if (interior_offs) ERROR_CHECK_STATUS(vxReleaseScalar(&interior_offs));
 	// set kernel configuration
 	strcpy(opencl_kernel_function_name, "laplacian_reconstruct");
 	opencl_work_dim = 2;
@@ -1543,6 +2032,26 @@ static vx_status VX_CALLBACK laplacian_reconstruct_opencl_codegen(
 	opencl_global_work[0] = wg_num*opencl_local_work[0];
 	opencl_global_work[1] = opencl_local_work[1]<<1;
 	height1 = (vx_uint32)(height / numCam);
+	char interior_code[2048];
+	sprintf(interior_code,
+		"	uint num_tiles = *(__global uint *)(pG_buf - 8);\n"
+		"	if (grp_id >= num_tiles) {\n"
+		"		__global uchar * pI_buf = pG_buf + (((int)interior_offs - (int)arr_offs) << 3);\n"
+		"		grp_id -= num_tiles;\n"
+		"		if (grp_id < *(__global uint *)(pI_buf - 8)) {\n"
+		"			uint2 offs = ((__global uint2 *)pI_buf)[grp_id];\n"
+		"			uint camera_id = offs.x & 0x1f; uint gx = (lx<<3) + ((offs.x >> 5) & 0x3FFF); uint gy = ly*2 + (offs.x >> 19) + camera_id*%d;\n"
+		"			if ((lx*8 < (offs.y & 0xFF)) & (ly*2 <= (offs.y >> 8))) {\n"
+		"				ip2_buf += ip2_offset + mad24(gy, ip2_stride, gx*4);\n"
+		"				op_buf += op_offset + mad24(gy, op_stride, gx*4);\n"
+		"				*(__global uint4 *)(op_buf) = *(__global uint4 *)(ip2_buf); *(__global uint4 *)(op_buf + 16) = *(__global uint4 *)(ip2_buf + 16);\n"
+		"				op_buf += op_stride; ip2_buf += ip2_stride;\n"
+		"				*(__global uint4 *)(op_buf) = *(__global uint4 *)(ip2_buf); *(__global uint4 *)(op_buf + 16) = *(__global uint4 *)(ip2_buf + 16);\n"
+		"			}\n"
+		"		}\n"
+		"		return;\n"
+		"	}\n"
+		, height1);
 	char item[8192];
 	sprintf(item,
 		"#pragma OPENCL EXTENSION cl_amd_media_ops : enable\n"
@@ -1552,10 +2061,11 @@ static vx_status VX_CALLBACK laplacian_reconstruct_opencl_codegen(
 		" 	uint ip_width, uint ip_height, __global uchar * ip_buf, uint ip_stride, uint ip_offset,\n"
 		" 	uint ip1_width, uint ip1_height, __global uchar * ip1_buf, uint ip1_stride, uint ip1_offset,\n"
 		"	__global uchar * pG_buf, uint pG_offs, uint pG_num,\n"
-		"   uint op_width, uint op_height, __global uchar * op_buf, uint op_stride, uint op_offset)\n"
+		"   uint op_width, uint op_height, __global uchar * op_buf, uint op_stride, uint op_offset%s)\n"
 		"{\n"
 		"	int grp_id = get_global_id(0)>>3, lx = get_local_id(0), ly = get_global_id(1);\n"
 		"	pG_buf += (pG_offs + (arr_offs<<3));\n"
+		"%s"
 		"	if (grp_id < pG_num) {\n"
 		"		int size_x = get_local_size(0) - 1; \n"
 		"		uint2 offs = ((__global uint2 *)pG_buf)[grp_id];\n"
@@ -1567,7 +2077,9 @@ static vx_status VX_CALLBACK laplacian_reconstruct_opencl_codegen(
 		"		ip_buf += (camera_id * ip_stride*%d);\n"
 		"		ip1_buf += (camera_id * ip1_stride*%d);\n"
 		"		op_buf += (camera_id * op_stride*%d);\n"
-		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name, height1, height1 >> 1, height1);
+		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name,
+		interior ? ",\n	uint ip2_width, uint ip2_height, __global uchar * ip2_buf, uint ip2_stride, uint ip2_offset, uint interior_offs" : "",
+		interior ? interior_code : "", height1, height1 >> 1, height1);
 	opencl_kernel_code = item;
 
 	opencl_kernel_code +=
@@ -1702,6 +2214,18 @@ static vx_status VX_CALLBACK laplacian_reconstruct_opencl_global_work_update(
 	ERROR_CHECK_STATUS(vxAccessArrayRange(arr, arr_offset - 1, arr_offset, &stride_blend_arr, (void **)&pBlendArr, VX_READ_ONLY));
 	arr_numitems = *((vx_uint32 *)pBlendArr);
 	ERROR_CHECK_STATUS(vxCommitArrayRange(arr, arr_offset - 1, arr_offset, pBlendArr));
+	// the interior tiles follow the pyramid tiles
+	vx_image interior_src = (vx_image)avxGetNodeParamRef(node, 6);
+	if (interior_src) ERROR_CHECK_STATUS(vxReleaseImage(&interior_src));
+	scalar = interior_src ? (vx_scalar)avxGetNodeParamRef(node, 7) : nullptr;
+	if (scalar) {
+		vx_uint32 interior_offset = 0;
+		ERROR_CHECK_STATUS(vxReadScalarValue(scalar, &interior_offset));
+		ERROR_CHECK_STATUS(vxReleaseScalar(&scalar));
+		ERROR_CHECK_STATUS(vxAccessArrayRange(arr, interior_offset - 1, interior_offset, &stride_blend_arr, (void **)&pBlendArr, VX_READ_ONLY));
+		arr_numitems += *((vx_uint32 *)pBlendArr);
+		ERROR_CHECK_STATUS(vxCommitArrayRange(arr, interior_offset - 1, interior_offset, pBlendArr));
+	}
 	ERROR_CHECK_STATUS(vxReleaseArray(&arr));
 	opencl_global_work[0] = arr_numitems*opencl_local_work[0];
 	opencl_global_work[1] = opencl_local_work[1]<<1;
@@ -1715,11 +2239,11 @@ vx_status laplacian_reconstruct_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.laplacian_reconstruct",
 		AMDOVX_KERNEL_STITCHING_LAPLACIAN_RECONSTRUCT,
 		laplacian_reconstruct_kernel,
-		6,
+		8,
 		laplacian_reconstruct_input_validator,
 		laplacian_reconstruct_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 
 	amd_kernel_opencl_global_work_update_callback_f opencl_global_work_update_callback_f = laplacian_reconstruct_opencl_global_work_update;
@@ -1735,6 +2259,8 @@ vx_status laplacian_reconstruct_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
 	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
@@ -22,12 +22,20 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "projection.h"
+#include "thread_pool.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <emmintrin.h>
 
 //developer settings
 #define GET_TIMING 0
@@ -672,6 +680,23 @@ vx_status seamfind_model_publish(vx_context context)
 /***********************************************************************************************************************************
 Seam Find Kernel - 0 --- Set Seam Preference -- CPU/GPU
 ************************************************************************************************************************************/
+//! \brief The scene detection settings of a node: optional scalars 6 (scene duration) and 7 (view scene change).
+static void seamfind_scene_detect_settings(vx_node node, vx_int32& scene_duration, vx_int32& view_scene_change)
+{
+	scene_duration = 150; view_scene_change = 0;
+	vx_uint32 value = 0;
+	vx_scalar scalar = (vx_scalar)avxGetNodeParamRef(node, 6);
+	if (scalar) {
+		if (vxReadScalarValue(scalar, &value) == VX_SUCCESS && value > 0) scene_duration = (vx_int32)value;
+		vxReleaseScalar(&scalar);
+	}
+	scalar = (vx_scalar)avxGetNodeParamRef(node, 7);
+	if (scalar) {
+		if (vxReadScalarValue(scalar, &value) == VX_SUCCESS) view_scene_change = (vx_int32)value;
+		vxReleaseScalar(&scalar);
+	}
+}
+
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK seamfind_scene_detect_input_validator(vx_node node, vx_uint32 index)
 {
@@ -680,8 +705,8 @@ static vx_status VX_CALLBACK seamfind_scene_detect_input_validator(vx_node node,
 	vx_reference ref = avxGetNodeParamRef(node, index);
 	ERROR_CHECK_OBJECT(ref);
 	// validate each parameter
-	if (index == 0 || index == 1)
-	{//->Current Frame/NumCamera
+	if (index == 0 || index == 1 || index == 6 || index == 7)
+	{//->Current Frame/Threshold/Scene Duration/View Scene Change
 		vx_enum type = 0;	vx_uint32 value = 0;
 		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &type, sizeof(type)));
 		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)ref, &value));
@@ -832,10 +857,15 @@ static vx_status VX_CALLBACK seamfind_scene_detect_opencl_codegen(
 	ERROR_CHECK_STATUS(vxReleaseArray(&arr));
 
 	char textBuffer[256];
-	int VIEW_SCENE_CHANGE = 0, SCENE_DURATION = 300, DETECT_ALG = 0;
-	if (StitchGetEnvironmentVariable("VIEW_SCENE_CHANGE", textBuffer, sizeof(textBuffer))) { VIEW_SCENE_CHANGE = atoi(textBuffer); }
-	if (StitchGetEnvironmentVariable("SCENE_DURATION", textBuffer, sizeof(textBuffer))) { SCENE_DURATION = atoi(textBuffer); }
+	int VIEW_SCENE_CHANGE = 0, SCENE_DURATION = 150, DETECT_ALG = 0;
+	seamfind_scene_detect_settings(node, SCENE_DURATION, VIEW_SCENE_CHANGE);
 	if (StitchGetEnvironmentVariable("DETECT_ALG", textBuffer, sizeof(textBuffer))) { DETECT_ALG = atoi(textBuffer); }
+	vx_scalar scene_settings = (vx_scalar)avxGetNodeParamRef(node, 6);
+	bool has_scene_duration = scene_settings ? true : false;
+	if (scene_settings) ERROR_CHECK_STATUS(vxReleaseScalar(&scene_settings));
+	scene_settings = (vx_scalar)avxGetNodeParamRef(node, 7);
+	bool has_view_scene_change = scene_settings ? true : false;
+	if (scene_settings) ERROR_CHECK_STATUS(vxReleaseScalar(&scene_settings));
 
 	// set kernel configuration
 	vx_uint32 work_items = (vx_uint32)arr_capacity;
@@ -860,8 +890,9 @@ static vx_status VX_CALLBACK seamfind_scene_detect_opencl_codegen(
 		"						uint ip_cost_width, uint ip_cost_height, __global uchar * ip_cost_buf, uint ip_cost_stride, uint ip_cost_offset,\n"
 		"						__global char * seam_info_buf, uint seam_info_buf_offset, uint seam_info_num_items,\n"
 		"						__global char * seam_pref_buf, uint seam_pref_buf_offset, uint seam_pref_num_items,\n"
-		"						__global char * seam_scene_buf, uint seam_scene_buf_offset, uint seam_scene_num_items)\n"
-		, opencl_local_work[0], opencl_kernel_function_name);
+		"						__global char * seam_scene_buf, uint seam_scene_buf_offset, uint seam_scene_num_items%s%s)\n"
+		, opencl_local_work[0], opencl_kernel_function_name,
+		has_scene_duration ? ", uint scene_duration" : "", has_view_scene_change ? ", uint view_scene_change" : "");
 	opencl_kernel_code = item;
 	opencl_kernel_code +=
 		"{\n"
@@ -990,9 +1021,9 @@ static vx_status VX_CALLBACK seamfind_scene_detect_opencl_codegen(
 		"\n"
 		"				if(SAD > threshold_scene_vert && pref.s7 == 0 && current_frame != 0 )\n"
 		"				{\n"
-		"					pref.s2 = current_frame;\n"
-		"					pref.s6 = 150;\n"
-		"\n";
+		"					pref.s2 = current_frame;\n";
+	sprintf(item, "					pref.s6 = %d;\n\n", SCENE_DURATION);
+	opencl_kernel_code += item;
 	if (!VIEW_SCENE_CHANGE)
 	{
 		opencl_kernel_code +=
@@ -1071,9 +1102,9 @@ static vx_status VX_CALLBACK seamfind_scene_detect_opencl_codegen(
 		"\n"
 		"				if(SAD > threshold_scene_hort && pref.s7 == 0 && current_frame != 0 )\n"
 		"				{\n"
-		"					pref.s2 = current_frame;\n"
-		"					pref.s6 = 150;\n"
-		"\n";
+		"					pref.s2 = current_frame;\n";
+	sprintf(item, "					pref.s6 = %d;\n\n", SCENE_DURATION);
+	opencl_kernel_code += item;
 	if (!VIEW_SCENE_CHANGE)
 	{
 		opencl_kernel_code +=
@@ -1105,9 +1136,92 @@ static vx_status VX_CALLBACK seamfind_scene_detect_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief The seamfind_scene_detect node local data: the settings are resolved once at graph verify.
+struct seamfind_scene_detect_data {
+	vx_int32 scene_duration;		// number of frames the seam stays locked after a scene change
+	vx_int32 view_scene_change;		// 0:OFF 1:mark scene changes dark 2:mark scene changes bright
+	vx_int32 seam_threshold;		// SAD threshold of a scene change when the live threshold is 0 (SEAM_THRESHOLD env override)
+};
+
+//! \brief The kernel initialize.
+static vx_status VX_CALLBACK seamfind_scene_detect_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	seamfind_scene_detect_data * data = new seamfind_scene_detect_data;
+	seamfind_scene_detect_settings(node, data->scene_duration, data->view_scene_change);
+	data->seam_threshold = 1500;
+	char textBuffer[256];
+	if (StitchGetEnvironmentVariable("SEAM_THRESHOLD", textBuffer, sizeof(textBuffer))) { data->seam_threshold = atoi(textBuffer); }
+	vx_size size = sizeof(seamfind_scene_detect_data);
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK seamfind_scene_detect_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(seamfind_scene_detect_data)))
+	{
+		seamfind_scene_detect_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) delete data;
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief The luma signature of an overlap: 8 probe rows/columns along the seam, 3 probes of MAX_SEAM_BYTES pixels across it.
+// A probe pixel is kept only where both cameras are valid, otherwise it is zero.
+static void seamfind_scene_signature(const vx_uint8 * input_ptr, vx_uint32 width_eqr, vx_uint32 offset_1, vx_uint32 offset_2,
+	const StitchSeamFindInformation& info, bool vertical, StitchSeamFindSceneEntry& signature)
+{
+	int y_dir = info.end_y - info.start_y;
+	int x_dir = info.end_x - info.start_x;
+	const __m128i zero = _mm_setzero_si128();
+	for (int f = 0; f < 8; f++)
+	{
+		for (int g = 0; g < 3; g++)
+		{
+			int x_start, y_start;
+			if (vertical) {
+				y_start = info.start_y + ((y_dir / 8) * f);
+				x_start = info.start_x + (((x_dir / 2) + ((x_dir / 10)*(g - 1))) - 4);
+			}
+			else {
+				x_start = info.start_x + ((x_dir / 8) * f);
+				y_start = info.start_y + (((y_dir / 2) + ((y_dir / 10)*(g - 1))) - 4);
+			}
+			__m128i p1 = _mm_loadl_epi64((const __m128i *)&input_ptr[((y_start + offset_1)*width_eqr) + x_start]);
+			__m128i p2 = _mm_loadl_epi64((const __m128i *)&input_ptr[((y_start + offset_2)*width_eqr) + x_start]);
+			__m128i invalid = _mm_or_si128(_mm_cmpeq_epi8(p1, zero), _mm_cmpeq_epi8(p2, zero));
+			_mm_storel_epi64((__m128i *)signature.segment[(f * 3) + g], _mm_andnot_si128(invalid, p1));
+		}
+	}
+}
+
+//! \brief SAD between the previous and the current signature of an overlap: the previous signature is replaced by the current one.
+static vx_int32 seamfind_scene_sad(StitchSeamFindSceneEntry& previous, const StitchSeamFindSceneEntry& current)
+{
+	__m128i sum = _mm_setzero_si128();
+	for (size_t k = 0; k < sizeof(StitchSeamFindSceneEntry); k += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(&previous.segment[0][0] + k));
+		__m128i b = _mm_loadu_si128((const __m128i *)(&current.segment[0][0] + k));
+		sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
+		_mm_storeu_si128((__m128i *)(&previous.segment[0][0] + k), b);
+	}
+	return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+}
+
 //! \brief The kernel execution on the CPU.
 static vx_status VX_CALLBACK seamfind_scene_detect_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
+	seamfind_scene_detect_data * data = nullptr;
+	vx_size size = 0;
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	if (!data || size != sizeof(seamfind_scene_detect_data)) return VX_FAILURE;
+
 	//Number Of Cameras - Variable 0 & 1
 	vx_uint32 current_frame = 0, width_eqr = 0, height_eqr = 0, Threshold_scalar = 0;
 	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &current_frame));
@@ -1145,20 +1259,10 @@ static vx_status VX_CALLBACK seamfind_scene_detect_kernel(vx_node node, const vx
 	stride = sizeof(StitchSeamFindSceneEntry);
 	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_previous_scene, 0, arr_numitems, &stride, (void **)&Seam_Previous_scene, VX_READ_AND_WRITE));
 
-	//Local SeamScene Data
-	std::vector<StitchSeamFindSceneEntry> current_seam_scene;
-	current_seam_scene.resize(arr_numitems);
-
-	//Get ENV Variables to override/set pref
-	char textBuffer[256];
-	int SEAM_THRESHOLD = 1500, VIEW_SCENE_CHANGE = 0, SCENE_DURATION = 150, SEAM_FREQUENCY = 300;
-	if (StitchGetEnvironmentVariable("SEAM_THRESHOLD", textBuffer, sizeof(textBuffer))) { SEAM_THRESHOLD = atoi(textBuffer); }
-	if (StitchGetEnvironmentVariable("VIEW_SCENE_CHANGE", textBuffer, sizeof(textBuffer))) { VIEW_SCENE_CHANGE = atoi(textBuffer); }
-	if (StitchGetEnvironmentVariable("SCENE_DURATION", textBuffer, sizeof(textBuffer))) { SCENE_DURATION = atoi(textBuffer); }
-	if (StitchGetEnvironmentVariable("SEAM_FREQUENCY", textBuffer, sizeof(textBuffer))){ SEAM_FREQUENCY = atoi(textBuffer); }
-
 	//Live Updated Threshold value
+	int SEAM_THRESHOLD = data->seam_threshold;
 	if (Threshold_scalar){ SEAM_THRESHOLD = (int)((Threshold_scalar * (192 * 255)) * 0.01); }
+	int VIEW_SCENE_CHANGE = data->view_scene_change;
 
 	//Loop over all the overlap camera once
 	for (vx_uint32 i = 0; i < arr_numitems; i++)
@@ -1167,147 +1271,40 @@ static vx_status VX_CALLBACK seamfind_scene_detect_kernel(vx_node node, const vx
 		vx_uint32 offset_2 = SeamFindInfo_ptr[i].cam_id_2 * height_eqr;
 		int y_dir = SeamFindInfo_ptr[i].end_y - SeamFindInfo_ptr[i].start_y;
 		int x_dir = SeamFindInfo_ptr[i].end_x - SeamFindInfo_ptr[i].start_x;
-		/***********************************************************************************************************************************
-		Vertical SeamCut
-		************************************************************************************************************************************/
-		if (y_dir >= x_dir)
-		{
-#if	ENABLE_VERTICAL_SEAM
-			//count down previous scene change
-			if (Seam_Pref[i].scene_flag != 0)
-			{
-				Seam_Pref[i].seam_lock--;
-				if (Seam_Pref[i].seam_lock == 0)
-				{
-					Seam_Pref[i].scene_flag = 0;
-					if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
-						Seam_Pref[i].start_frame = current_frame;
-				}
-			}
-
-			//Find current frame segement values
-			for (int f = 0; f < 8; f++)
-			{
-				int y_start = SeamFindInfo_ptr[i].start_y + ((y_dir / 8) * f);
-				for (int g = 0; g < 3; g++)
-				{
-					int x_start = SeamFindInfo_ptr[i].start_x + (((x_dir / 2) + ((x_dir / 10)*(g - 1))) - 4);
-					for (int k = 0; k < MAX_SEAM_BYTES; k++)
-					{
-						int cost_id_1 = ((y_start + offset_1)*width_eqr) + (x_start + k);
-						int cost_id_2 = ((y_start + offset_2)*width_eqr) + (x_start + k);
-						if (input_ptr[cost_id_1] && input_ptr[cost_id_2])
-						{
-#if 1
-							current_seam_scene[i].segment[(f * 3) + g][k] = abs(input_ptr[cost_id_1]); //Check cost from one image
-#else
-							current_seam_scene[i].segment[(f * 3) + g][k] = abs((input_ptr[cost_id_1] + input_ptr[cost_id_2]) / 2);//Check cost from two images
+		// Vertical SeamCut if y_dir >= x_dir, else Horizontal SeamCut. Special Case SeamCut: TBD
+		bool vertical = (y_dir >= x_dir);
+#if !ENABLE_VERTICAL_SEAM
+		if (vertical) continue;
 #endif
-						}
-					}
-				}
-			}
-			//First Frame reference value stored
-			if (current_frame == 0)
-			{
-				for (int f = 0; f < MAX_SEGMENTS; f++)
-				for (int k = 0; k < MAX_SEAM_BYTES; k++)
-					Seam_Previous_scene[i].segment[f][k] = current_seam_scene[i].segment[f][k];
-			}
-			//Else calculate SAD and store the values
-			else
-			{
-				int SAD = 0;
-				for (int f = 0; f < MAX_SEGMENTS; f++)
-				for (int k = 0; k < MAX_SEAM_BYTES; k++)
-				{
-					SAD += abs(Seam_Previous_scene[i].segment[f][k] - current_seam_scene[i].segment[f][k]);
-					Seam_Previous_scene[i].segment[f][k] = current_seam_scene[i].segment[f][k];
-				}
-				//if scene change detected, set seam to be found in the current frame
-				if (SAD > SEAM_THRESHOLD && Seam_Pref[i].scene_flag == 0)
-				{
-					Seam_Pref[i].start_frame = current_frame;
-					Seam_Pref[i].scene_flag = 1;
-					Seam_Pref[i].seam_lock = SCENE_DURATION;
-					if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
-						Seam_Pref[i].scene_flag = (VIEW_SCENE_CHANGE + 1);
-				}
-			}
+#if !ENABLE_HORIZONTAL_SEAM
+		if (!vertical) continue;
 #endif
-		}
-		/***********************************************************************************************************************************
-		Horizontal SeamCut
-		************************************************************************************************************************************/
-		else if (x_dir > y_dir)
+		//count down previous scene change
+		if (Seam_Pref[i].scene_flag != 0)
 		{
-#if ENABLE_HORIZONTAL_SEAM
-			//count down previous scene change
-			if (Seam_Pref[i].scene_flag != 0)
-			{
-				Seam_Pref[i].seam_lock--;
-				if (Seam_Pref[i].seam_lock == 0)
-				{
-					Seam_Pref[i].scene_flag = 0;
-					if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
-						Seam_Pref[i].start_frame = current_frame;
-				}
-			}
-
-			//Find current frame segement value
-			for (int f = 0; f < 8; f++)
-			{
-				int x_start = SeamFindInfo_ptr[i].start_x + ((x_dir / 8) * f);
-				for (int g = 0; g < 3; g++)
-				{
-					int y_start = SeamFindInfo_ptr[i].start_y + (((y_dir / 2) + ((y_dir / 10)*(g - 1))) - 4);
-					for (int k = 0; k < MAX_SEAM_BYTES; k++)
-					{
-						int cost_id_1 = ((y_start + offset_1)*width_eqr) + (x_start + k);
-						int cost_id_2 = ((y_start + offset_2)*width_eqr) + (x_start + k);
-						if (input_ptr[cost_id_1] && input_ptr[cost_id_2])
-						{
-#if 1
-							current_seam_scene[i].segment[(f * 3) + g][k] = abs(input_ptr[cost_id_1]);//Check cost from one image
-#else
-							current_seam_scene[i].segment[(f * 3) + g][k] = abs((input_ptr[cost_id_1] + input_ptr[cost_id_2]) / 2);//Check cost from two images
-#endif
-						}
-					}
-				}
-			}
-			//First Frame reference value stored
-			if (current_frame == 0)
-			{
-				for (int f = 0; f < MAX_SEGMENTS; f++)
-				for (int k = 0; k < MAX_SEAM_BYTES; k++)
-					Seam_Previous_scene[i].segment[f][k] = current_seam_scene[i].segment[f][k];
-			}
-			//Else calculate SAD and store the values
-			else
+			Seam_Pref[i].seam_lock--;
+			if (Seam_Pref[i].seam_lock == 0)
 			{
-				int SAD = 0;
-				for (int f = 0; f < MAX_SEGMENTS; f++)
-				for (int k = 0; k < MAX_SEAM_BYTES; k++)
-				{
-					SAD += abs(Seam_Previous_scene[i].segment[f][k] - current_seam_scene[i].segment[f][k]);
-					Seam_Previous_scene[i].segment[f][k] = current_seam_scene[i].segment[f][k];
-				}
-				//if scene change detected, set seam to be found in the current frame
-				if (SAD > SEAM_THRESHOLD && Seam_Pref[i].scene_flag == 0)
-				{
+				Seam_Pref[i].scene_flag = 0;
+				if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
 					Seam_Pref[i].start_frame = current_frame;
-					Seam_Pref[i].scene_flag = 1;
-					Seam_Pref[i].seam_lock = SCENE_DURATION;
-					if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
-						Seam_Pref[i].scene_flag = (VIEW_SCENE_CHANGE + 1);
-				}
 			}
-#endif
 		}
-		/***********************************************************************************************************************************
-		Special Case SeamCut: TBD
-		************************************************************************************************************************************/
+
+		//Find current frame segement values and the SAD with the previous frame: the first frame only stores the reference
+		StitchSeamFindSceneEntry current_seam_scene;
+		seamfind_scene_signature(input_ptr, width_eqr, offset_1, offset_2, SeamFindInfo_ptr[i], vertical, current_seam_scene);
+		int SAD = seamfind_scene_sad(Seam_Previous_scene[i], current_seam_scene);
+
+		//if scene change detected, set seam to be found in the current frame
+		if (current_frame != 0 && SAD > SEAM_THRESHOLD && Seam_Pref[i].scene_flag == 0)
+		{
+			Seam_Pref[i].start_frame = current_frame;
+			Seam_Pref[i].scene_flag = 1;
+			Seam_Pref[i].seam_lock = data->scene_duration;
+			if (VIEW_SCENE_CHANGE == 1 || VIEW_SCENE_CHANGE == 2)
+				Seam_Pref[i].scene_flag = (VIEW_SCENE_CHANGE + 1);
+		}
 	}
 
 	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, &input_rect, 0, &input_addr, input_image_ptr));
@@ -1315,9 +1312,6 @@ static vx_status VX_CALLBACK seamfind_scene_detect_kernel(vx_node node, const vx
 	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_Pref, 0, arr_numitems, Seam_Pref));
 	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_previous_scene, 0, arr_numitems, Seam_Previous_scene));
 
-	//Clear Memory
-	current_seam_scene.clear();
-
 	return VX_SUCCESS;
 }
 
@@ -1328,11 +1322,11 @@ vx_status seamfind_scene_detect_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_scene_detect",
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_SCENE_DETECT,
 		seamfind_scene_detect_kernel,
-		6,
+		8,
 		seamfind_scene_detect_input_validator,
 		seamfind_scene_detect_output_validator,
-		nullptr,
-		nullptr);
+		seamfind_scene_detect_initialize,
+		seamfind_scene_detect_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = seamfind_scene_detect_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = seamfind_scene_detect_opencl_codegen;
@@ -1348,6 +1342,8 @@ vx_status seamfind_scene_detect_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
 
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
@@ -1403,6 +1399,19 @@ static vx_status VX_CALLBACK seamfind_cost_generate_input_validator(vx_node node
 			status = VX_SUCCESS;
 		ERROR_CHECK_STATUS(vxReleaseImage((vx_image *)&ref));
 	}
+	else if (index == 4)
+	{ // array object of cost tiles
+		vx_size itemsize = 0;
+		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+		if (itemsize == sizeof(StitchSeamFindCostTile)) {
+			status = VX_SUCCESS;
+		}
+		else {
+			status = VX_ERROR_INVALID_TYPE;
+			vxAddLogEntry((vx_reference)node, status, "ERROR: SeamFind cost tile array element (StitchSeamFindCostTile) size should be 8 bytes\n");
+		}
+		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
+	}
 	
 	return status;
 }
@@ -1447,7 +1456,14 @@ static vx_status VX_CALLBACK seamfind_cost_generate_query_target_support(vx_grap
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	char textBuffer[256];
+	int SEAM_FIND_TARGET = 0;
+	if (StitchGetEnvironmentVariable("SEAM_FIND_TARGET", textBuffer, sizeof(textBuffer))) { SEAM_FIND_TARGET = atoi(textBuffer); }
+
+	if (!SEAM_FIND_TARGET)
+		supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
+	else
+		supported_target_affinity = AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -1461,6 +1477,15 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_global_work_update(
 	const vx_size opencl_local_work[]              // [input] local_work[] for clEnqueueNDRangeKernel()
 	)
 {
+	// one workgroup per cost tile (Variable 4), when present
+	vx_array arr = (vx_array)avxGetNodeParamRef(node, 4);
+	if (arr) {
+		vx_size arr_numitems = 0;
+		ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &arr_numitems, sizeof(arr_numitems)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&arr));
+		opencl_global_work[0] = std::max(arr_numitems, (vx_size)1) * opencl_local_work[0];
+		opencl_global_work[1] = opencl_local_work[1];
+	}
 	return VX_SUCCESS;
 }
 
@@ -1487,15 +1512,30 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_codegen(
 	ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
 	ERROR_CHECK_STATUS(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
 	ERROR_CHECK_STATUS(vxReleaseImage(&image));
+	// the cost tiles covering the overlaps (optional): one 128x16 tile per workgroup, otherwise the whole image
+	vx_array arr_tile = (vx_array)avxGetNodeParamRef(node, 4);
+	bool bCostTile = false;
+	vx_size tile_capacity = 0;
+	if (arr_tile) {
+		bCostTile = true;
+		ERROR_CHECK_STATUS(vxQueryArray(arr_tile, VX_ARRAY_ATTRIBUTE_CAPACITY, &tile_capacity, sizeof(tile_capacity)));
+		ERROR_CHECK_STATUS(vxReleaseArray(&arr_tile));
+	}
 
 	// set kernel configuration
 	vx_uint32 work_items[2] = { (width + 7) / 8, height };
 	strcpy(opencl_kernel_function_name, "seamfind_cost_generate");
 	opencl_work_dim = 2;
-	opencl_local_work[0] = 16;
-	opencl_local_work[1] = 16;
-	opencl_global_work[0] = (work_items[0] + opencl_local_work[0] - 1) & ~(opencl_local_work[0] - 1);
-	opencl_global_work[1] = (work_items[1] + opencl_local_work[1] - 1) & ~(opencl_local_work[1] - 1);
+	opencl_local_work[0] = SEAMFIND_COST_TILE_WIDTH / 8;
+	opencl_local_work[1] = SEAMFIND_COST_TILE_HEIGHT;
+	if (bCostTile) {
+		opencl_global_work[0] = std::max(tile_capacity, (vx_size)1) * opencl_local_work[0];
+		opencl_global_work[1] = opencl_local_work[1];
+	}
+	else {
+		opencl_global_work[0] = (work_items[0] + opencl_local_work[0] - 1) & ~(opencl_local_work[0] - 1);
+		opencl_global_work[1] = (work_items[1] + opencl_local_work[1] - 1) & ~(opencl_local_work[1] - 1);
+	}
 
 	// Setting variables required by the interface
 	opencl_local_buffer_usage_mask = 0;
@@ -1514,16 +1554,37 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_codegen(
 		"void %s(uint flag,\n"				// opencl_kernel_function_name
 		"		 uint ip_image_width, uint ip_image_height, __global uchar * ip_image_buf, uint ip_image_stride, uint ip_image_offset,\n"
 		"		 uint op_mag_width, uint op_mag_height, __global uchar * op_mag_buf, uint op_mag_stride, uint op_mag_offset,\n"
-		"		 uint op_phase_width, uint op_phase_height, __global uchar * op_phase_buf, uint op_phase_stride, uint op_phase_offset)\n"
-		"{\n"
-		"  if (flag) {\n"
-		"    uint x = get_global_id(0) * 8;\n"
-		"    uint y = get_global_id(1);\n"
+		"		 uint op_phase_width, uint op_phase_height, __global uchar * op_phase_buf, uint op_phase_stride, uint op_phase_offset"
+		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name);
+	opencl_kernel_code = item;
+	if (bCostTile) {
+		opencl_kernel_code +=
+			",\n"
+			"		 __global uchar * tile_buf, uint tile_buf_offset, uint tile_num_items)\n"
+			"{\n"
+			"  uint tile = get_group_id(0);\n"
+			"  if (flag && (tile < tile_num_items)) {\n"
+			"    uint2 tile_xy = vload2(tile, (__global uint *)(tile_buf + tile_buf_offset));\n"
+			"    uint x = tile_xy.s0 + get_local_id(0) * 8;\n"
+			"    uint y = tile_xy.s1 + get_local_id(1);\n";
+	}
+	else {
+		opencl_kernel_code +=
+			")\n"
+			"{\n"
+			"  if (flag) {\n"
+			"    uint x = get_global_id(0) * 8;\n"
+			"    uint y = get_global_id(1);\n";
+	}
+	sprintf(item,
 		"    int lx = get_local_id(0);\n"
 		"    int ly = get_local_id(1);\n"
 		"    bool valid = (x < %d) && (y < %d);\n"	// width, height
-		, opencl_local_work[0], opencl_local_work[1], opencl_kernel_function_name, width, height);
-	opencl_kernel_code = item;
+		"    // the one pixel border of the image is set to 0 as on the CPU\n"
+		"    int8 xi = (int8)(x) + (int8)(0, 1, 2, 3, 4, 5, 6, 7);\n"
+		"    int8 border = (xi == (int8)(0)) | (xi >= (int8)(%d)) | (int8)((y == 0 || y >= %d) ? -1 : 0);\n"	// width - 1, height - 1
+		, width, height, width - 1, height - 1);
+	opencl_kernel_code += item;
 	opencl_kernel_code +=
 		"    ip_image_buf += ip_image_offset;\n"
 		"    op_mag_buf += (op_mag_offset + y * op_mag_stride + x);\n"
@@ -1565,9 +1626,9 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_codegen(
 		"    // Filter row 1\n"
 		"    pix = vload4(0, lbufptr + (lstride >> 2));\n"
 		"    tempf = (float8)(amd_unpack3(pix.s0), amd_unpack0(pix.s1), amd_unpack1(pix.s1), amd_unpack2(pix.s1), amd_unpack3(pix.s1), amd_unpack0(pix.s2), amd_unpack1(pix.s2), amd_unpack2(pix.s2));\n"
-		"    Gx = (tempf, (float8)(-2.0f), Gx);\n"
+		"    Gx = mad(tempf, (float8)(-2.0f), Gx);\n"
 		"    tempf = (float8)(amd_unpack1(pix.s1), amd_unpack2(pix.s1), amd_unpack3(pix.s1), amd_unpack0(pix.s2), amd_unpack1(pix.s2), amd_unpack2(pix.s2), amd_unpack3(pix.s2), amd_unpack0(pix.s3));\n"
-		"    Gx = (tempf, (float8)(2.0f), Gx);\n"
+		"    Gx = mad(tempf, (float8)(2.0f), Gx);\n"
 		"    // Filter row 2\n"
 		"    pix = vload4(0, lbufptr + (lstride >> 1));\n"
 		"    tempf = (float8)(amd_unpack3(pix.s0), amd_unpack0(pix.s1), amd_unpack1(pix.s1), amd_unpack2(pix.s1), amd_unpack3(pix.s1), amd_unpack0(pix.s2), amd_unpack1(pix.s2), amd_unpack2(pix.s2));\n"
@@ -1581,10 +1642,12 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_codegen(
 		"    int8 quad = select(select((int8)0, (int8)3, signbit(Gy)), select((int8)1, (int8)2, signbit(Gy)), signbit(Gx));\n"
 		"    Gx = fabs(Gx); Gy = fabs(Gy);\n"
 		"    tempf = Gx + Gy;\n"
+		"    tempf = select(tempf, (float8)0, border);\n"
 		"    mag.s0 = amd_pack(tempf.s0123); mag.s1 = amd_pack(tempf.s4567);\n"
 		"    tempf = select(select((float8)2, (float8)1, Gy < T2*Gx), (float8)0, Gy < T1*Gx);\n"
 		"    tempf += (2*(convert_float8)(quad));\n"
 		"    tempf = select(tempf, (float8)0, tempf > (float8)(7.0f));\n"
+		"    tempf = select(tempf, (float8)0, border);\n"
 		"    ph.s0 = amd_pack(tempf.s0123); ph.s1 = amd_pack(tempf.s4567);\n"
 		"    if (valid) {\n"
 		"      *(__global uint2 *) op_mag_buf = mag;\n"
@@ -1596,10 +1659,144 @@ static vx_status VX_CALLBACK seamfind_cost_generate_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief The phase thresholds of seamfind_cost_generate: tan(22.5) and tan(67.5) degrees.
+static const float seamfind_phase_t1 = 0.4142135623730950488016887242097f;
+static const float seamfind_phase_t2 = 2.4142135623730950488016887242097f;
+
+//! \brief Compute the Sobel magnitude and quantized phase of one pixel: the one pixel border of the image is set to 0
+// on both targets, since the 3x3 window is not inside the image there.
+static inline void seamfind_cost_pixel(const vx_uint8 * src, vx_int32 stride, vx_int32 width, vx_int32 height, vx_int32 x, vx_int32 y, vx_uint8 * mag, vx_uint8 * phase)
+{
+	if (x <= 0 || y <= 0 || x >= width - 1 || y >= height - 1) {
+		*mag = 0; *phase = 0;
+		return;
+	}
+	const vx_uint8 * r0 = src + (y - 1) * stride, * r1 = r0 + stride, * r2 = r1 + stride;
+	vx_int32 xl = x - 1, xr = x + 1;
+	vx_int32 gx = (r0[xr] - r0[xl]) + 2 * (r1[xr] - r1[xl]) + (r2[xr] - r2[xl]);
+	vx_int32 gy = (r2[xl] + 2 * r2[x] + r2[xr]) - (r0[xl] + 2 * r0[x] + r0[xr]);
+	vx_int32 quad = (gx < 0) ? ((gy < 0) ? 2 : 1) : ((gy < 0) ? 3 : 0);
+	gx = abs(gx); gy = abs(gy);
+	float fx = (float)gx, fy = (float)gy;
+	vx_int32 bin = ((fy < seamfind_phase_t1 * fx) ? 0 : ((fy < seamfind_phase_t2 * fx) ? 1 : 2)) + 2 * quad;
+	*mag = (vx_uint8)std::min(gx + gy, 255);
+	*phase = (vx_uint8)((bin > 7) ? 0 : bin);
+}
+
+//! \brief Compute the Sobel magnitude and quantized phase of the pixels [x0, x1) of a row in a single pass.
+// The gradients of 8 pixels are computed as 16-bit SSE2 vectors and only the phase thresholds use floats,
+// so the result is identical to the OpenCL kernel, borders included, without any intermediate image.
+static void seamfind_cost_row(const vx_uint8 * src, vx_int32 stride, vx_int32 width, vx_int32 height, vx_int32 y, vx_int32 x0, vx_int32 x1,
+	vx_uint8 * mag, vx_uint8 * phase)
+{
+	vx_int32 x = x0;
+	if (y > 0 && y < height - 1) {
+		const vx_uint8 * r0 = src + (y - 1) * stride, * r1 = r0 + stride, * r2 = r1 + stride;
+		const __m128i zero = _mm_setzero_si128(), two = _mm_set1_epi16(2), four = _mm_set1_epi16(4), six = _mm_set1_epi16(6), seven = _mm_set1_epi16(7);
+		const __m128 t1 = _mm_set1_ps(seamfind_phase_t1), t2 = _mm_set1_ps(seamfind_phase_t2);
+		for (; x < 1 && x < x1; x++)
+			seamfind_cost_pixel(src, stride, width, height, x, y, &mag[x], &phase[x]);
+		for (; x + 8 <= x1 && x + 9 <= width; x += 8) {
+			__m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r0[x - 1]), zero);
+			__m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r0[x]), zero);
+			__m128i c0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r0[x + 1]), zero);
+			__m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r1[x - 1]), zero);
+			__m128i c1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r1[x + 1]), zero);
+			__m128i a2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r2[x - 1]), zero);
+			__m128i b2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r2[x]), zero);
+			__m128i c2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&r2[x + 1]), zero);
+			__m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(c0, a0), _mm_sub_epi16(c2, a2)), _mm_slli_epi16(_mm_sub_epi16(c1, a1), 1));
+			__m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(a2, c2), _mm_slli_epi16(b2, 1)), _mm_add_epi16(_mm_add_epi16(a0, c0), _mm_slli_epi16(b0, 1)));
+			__m128i gxneg = _mm_cmplt_epi16(gx, zero), gyneg = _mm_cmplt_epi16(gy, zero);
+			gx = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+			gy = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+			_mm_storel_epi64((__m128i *)&mag[x], _mm_packus_epi16(_mm_add_epi16(gx, gy), zero));
+			// phase bin within the quadrant: 2 + (gy < t1*gx ? -1 : 0) + (gy < t2*gx ? -1 : 0)
+			__m128 fxl = _mm_cvtepi32_ps(_mm_unpacklo_epi16(gx, zero)), fxh = _mm_cvtepi32_ps(_mm_unpackhi_epi16(gx, zero));
+			__m128 fyl = _mm_cvtepi32_ps(_mm_unpacklo_epi16(gy, zero)), fyh = _mm_cvtepi32_ps(_mm_unpackhi_epi16(gy, zero));
+			__m128i lt1 = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(fyl, _mm_mul_ps(t1, fxl))), _mm_castps_si128(_mm_cmplt_ps(fyh, _mm_mul_ps(t1, fxh))));
+			__m128i lt2 = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(fyl, _mm_mul_ps(t2, fxl))), _mm_castps_si128(_mm_cmplt_ps(fyh, _mm_mul_ps(t2, fxh))));
+			__m128i bin = _mm_add_epi16(two, _mm_add_epi16(lt1, lt2));
+			// quadrant offset: 2*quad is 2 for (-,+), 4 for (-,-), and 6 for (+,-)
+			__m128i quad2 = _mm_sub_epi16(_mm_add_epi16(_mm_and_si128(gxneg, two), _mm_and_si128(gyneg, six)), _mm_and_si128(_mm_and_si128(gxneg, gyneg), four));
+			bin = _mm_add_epi16(bin, quad2);
+			bin = _mm_andnot_si128(_mm_cmpgt_epi16(bin, seven), bin);
+			_mm_storel_epi64((__m128i *)&phase[x], _mm_packus_epi16(bin, zero));
+		}
+	}
+	for (; x < x1; x++)
+		seamfind_cost_pixel(src, stride, width, height, x, y, &mag[x], &phase[x]);
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK seamfind_cost_generate_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_SUPPORTED;
+	vx_uint32 flag = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &flag));
+	if (!flag)
+		return VX_SUCCESS;
+
+	// Input luma, output magnitude and phase images - Variable 1, 2, 3
+	vx_image image[3] = { (vx_image)parameters[1], (vx_image)parameters[2], (vx_image)parameters[3] };
+	vx_rectangle_t rect[3]; vx_imagepatch_addressing_t addr[3]; void * image_ptr[3] = { nullptr, nullptr, nullptr };
+	vx_uint32 width = 0, height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(image[0], VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS(vxQueryImage(image[0], VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	for (int k = 0; k < 3; k++) {
+		rect[k].start_x = rect[k].start_y = 0; rect[k].end_x = width; rect[k].end_y = height;
+		ERROR_CHECK_STATUS(vxAccessImagePatch(image[k], &rect[k], 0, &addr[k], &image_ptr[k], k == 0 ? VX_READ_ONLY : VX_WRITE_ONLY));
+	}
+	const vx_uint8 * src = (const vx_uint8 *)image_ptr[0];
+	vx_uint8 * mag = (vx_uint8 *)image_ptr[1], * phase = (vx_uint8 *)image_ptr[2];
+	vx_int32 src_stride = addr[0].stride_y, mag_stride = addr[1].stride_y, phase_stride = addr[2].stride_y;
+
+	// the tiles to compute: the cost tiles covering the overlaps (Variable 4), or the whole image
+	std::vector<StitchSeamFindCostTile> tile;
+	vx_array arr_tile = (num > 4) ? (vx_array)parameters[4] : nullptr;
+	if (arr_tile) {
+		vx_size num_tiles = 0;
+		ERROR_CHECK_STATUS(vxQueryArray(arr_tile, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_tiles, sizeof(num_tiles)));
+		if (num_tiles > 0) {
+			vx_uint8 * tile_ptr = nullptr; vx_size stride_tile = sizeof(StitchSeamFindCostTile);
+			ERROR_CHECK_STATUS(vxAccessArrayRange(arr_tile, 0, num_tiles, &stride_tile, (void **)&tile_ptr, VX_READ_ONLY));
+			tile.resize(num_tiles);
+			for (vx_size i = 0; i < num_tiles; i++)
+				tile[i] = *(StitchSeamFindCostTile *)(tile_ptr + i * stride_tile);
+			ERROR_CHECK_STATUS(vxCommitArrayRange(arr_tile, 0, num_tiles, tile_ptr));
+		}
+	}
+	else {
+		for (vx_uint32 y = 0; y < height; y += SEAMFIND_COST_TILE_HEIGHT) {
+			for (vx_uint32 x = 0; x < width; x += SEAMFIND_COST_TILE_WIDTH) {
+				StitchSeamFindCostTile t = { x, y };
+				tile.push_back(t);
+			}
+		}
+	}
+
+	// tiles are processed on separate threads
+	if (tile.size() > 0)
+	{
+		vx_int32 num_tiles = (vx_int32)tile.size();
+		std::atomic<int> next_tile(0);
+		std::function<void()> tile_thread_func = [&]() {
+			for (int t = next_tile++; t < num_tiles; t = next_tile++) {
+				if (tile[t].x >= width || tile[t].y >= height)
+					continue;
+				vx_int32 x0 = (vx_int32)tile[t].x, x1 = (vx_int32)std::min(tile[t].x + SEAMFIND_COST_TILE_WIDTH, width);
+				vx_int32 y1 = (vx_int32)std::min(tile[t].y + SEAMFIND_COST_TILE_HEIGHT, height);
+				for (vx_int32 y = (vx_int32)tile[t].y; y < y1; y++)
+					seamfind_cost_row(src, src_stride, (vx_int32)width, (vx_int32)height, y, x0, x1, mag + y * mag_stride, phase + y * phase_stride);
+			}
+		};
+		stitch_thread_pool_run(node, num_tiles, tile_thread_func);
+	}
+
+	for (int k = 0; k < 3; k++) {
+		ERROR_CHECK_STATUS(vxCommitImagePatch(image[k], &rect[k], 0, &addr[k], image_ptr[k]));
+	}
+
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel publisher.
@@ -1609,11 +1806,11 @@ vx_status seamfind_cost_generate_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_cost_generate",
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_GENERATE,
 		seamfind_cost_generate_kernel,
-		4,
+		5,
 		seamfind_cost_generate_input_validator,
 		seamfind_cost_generate_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = seamfind_cost_generate_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = seamfind_cost_generate_opencl_codegen;
@@ -1627,6 +1824,7 @@ vx_status seamfind_cost_generate_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_OPTIONAL));
 
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
@@ -1638,6 +1836,24 @@ vx_status seamfind_cost_generate_publish(vx_context context)
 /***********************************************************************************************************************************
 Seam Find Kernel: Cost Accumulate with edgeness - Vertical & Horizontal Seam - K2
 ************************************************************************************************************************************/
+//! \brief The seam search settings of a node: optional scalars 11 (half width in pixels of the band around the previous seam,
+// 0: full search) and 12 (downscale factor of the coarse seam, 0 or 1: no coarse seam).
+static void seamfind_cost_accumulate_settings(vx_node node, vx_int32& corridor, vx_int32& coarse_scale)
+{
+	corridor = 0; coarse_scale = 0;
+	vx_uint32 value = 0;
+	vx_scalar scalar = (vx_scalar)avxGetNodeParamRef(node, 11);
+	if (scalar) {
+		if (vxReadScalarValue(scalar, &value) == VX_SUCCESS) corridor = (vx_int32)value;
+		vxReleaseScalar(&scalar);
+	}
+	scalar = (vx_scalar)avxGetNodeParamRef(node, 12);
+	if (scalar) {
+		if (vxReadScalarValue(scalar, &value) == VX_SUCCESS && value > 1) coarse_scale = (vx_int32)value;
+		vxReleaseScalar(&scalar);
+	}
+}
+
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK seamfind_cost_accumulate_input_validator(vx_node node, vx_uint32 index)
 {
@@ -1646,7 +1862,7 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_input_validator(vx_node no
 	vx_reference ref = avxGetNodeParamRef(node, index);
 	ERROR_CHECK_OBJECT(ref);
 	// validate each parameter
-	if (index == 0 || index == 1 || index == 2)
+	if (index == 0 || index == 1 || index == 2 || index == 11 || index == 12)
 	{ // object of SCALAR type
 		vx_enum itemtype = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
@@ -1774,19 +1990,20 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_output_validator(vx_node n
 {
 	vx_status status = VX_ERROR_INVALID_PARAMETERS;
 	vx_reference ref = avxGetNodeParamRef(node, index);
-	if (index == 9)
-	{ // array object of StitchSeamFindAccumEntry type
+	if (index == 9 || index == 10)
+	{ // array object of accumulated values (vx_int32) and packed parents (vx_uint8)
 		vx_size itemsize = 0; vx_size arr_capacity = 0;
 		vx_enum itemtype;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_CAPACITY, &arr_capacity, sizeof(arr_capacity)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
 
-		if (itemsize == sizeof(StitchSeamFindAccumEntry))
+		if (itemsize == (index == 9 ? sizeof(vx_int32) : sizeof(vx_uint8)))
 			status = VX_SUCCESS;
 		else {
 			status = VX_ERROR_INVALID_DIMENSION;
-			vxAddLogEntry((vx_reference)node, status, "ERROR: SeamFind array element (StitchSeamFindAccumEntry) size should be 12 bytes\n");
+			vxAddLogEntry((vx_reference)node, status, index == 9 ? "ERROR: SeamFind accumulate value array element size should be 4 bytes\n"
+				: "ERROR: SeamFind accumulate parent array element size should be 1 byte\n");
 		}
 		// set output image meta data
 		ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &itemtype, sizeof(itemtype)));
@@ -1802,7 +2019,17 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_query_target_support(vx_gr
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	char textBuffer[256];
+	int SEAM_FIND_TARGET = 0;
+	if (StitchGetEnvironmentVariable("SEAM_FIND_TARGET", textBuffer, sizeof(textBuffer))) { SEAM_FIND_TARGET = atoi(textBuffer); }
+
+	// the band searches around the previous seam and around the coarse seam are only available on the CPU
+	vx_int32 corridor = 0, coarse_scale = 0;
+	seamfind_cost_accumulate_settings(node, corridor, coarse_scale);
+	if (!SEAM_FIND_TARGET && !corridor && !coarse_scale)
+		supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
+	else
+		supported_target_affinity = AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -1874,6 +2101,12 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"#pragma OPENCL EXTENSION cl_amd_media_ops : enable\n"
 		"#pragma OPENCL EXTENSION cl_amd_media_ops2 : enable\n"
 		"\n"
+		"#define PARENT_LEFT      0\n"
+		"#define PARENT_MIDDLE    1\n"
+		"#define PARENT_RIGHT     2\n"
+		"#define PARENT_NONE      %d\n"										// SEAMFIND_PARENT_NONE
+		"#define PARENT_PROPAGATE %d\n"										// SEAMFIND_PARENT_PROPAGATE
+		"\n"
 		"__kernel __attribute__((reqd_work_group_size(%d, 1, 1)))\n"					// opencl_local_work[0]
 		"\n"
 		"void %s(uint current_frame,uint equi_width, uint equi_height,\n"				// opencl_kernel_function_name
@@ -1883,8 +2116,9 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"						__global char * valid_pix_buf, uint valid_pix_buf_offset, uint valid_pix_num_items,\n"
 		"						__global char * seam_pref_buf, uint seam_pref_buf_offset, uint seam_pref_num_items,\n"
 		"						__global char * seam_info_buf, uint seam_info_buf_offset, uint seam_info_num_items,\n"
-		"						__global char * seam_buf, uint seam_buf_offset, uint seam_num_items)\n"
-		, opencl_local_work[0], opencl_kernel_function_name);
+		"						__global char * seam_buf, uint seam_buf_offset, uint seam_num_items,\n"
+		"						__global uchar * seam_parent_buf, uint seam_parent_buf_offset, uint seam_parent_num_items)\n"
+		, SEAMFIND_PARENT_NONE, SEAMFIND_PARENT_PROPAGATE, opencl_local_work[0], opencl_kernel_function_name);
 	opencl_kernel_code = item;
 	opencl_kernel_code +=
 		"{\n"
@@ -1898,12 +2132,14 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"	seam_pref_buf =  seam_pref_buf + seam_pref_buf_offset;\n"
 		"	seam_info_buf =  seam_info_buf + seam_info_buf_offset;\n"
 		"	seam_buf =  seam_buf + seam_buf_offset;\n"
+		"	seam_parent_buf =  seam_parent_buf + seam_parent_buf_offset;\n"
 		"\n"
 		"	ip_cost_buf =  ip_cost_buf + ip_cost_offset;\n"
 		"	ip_phase_buf =  ip_phase_buf + ip_phase_offset;\n"
 		"	ip_mask_buf =  ip_mask_buf + ip_mask_offset;\n"
 		"\n"
-		"	int4 accum;\n"
+		"	int accum_value;\n"
+		"	uchar accum_parent;\n"
 		"	short8 dim, pref, info;\n"
 		"	dim = vload8(0, (__global short *)valid_pix_buf);\n"
 		"	pref = vload8(0, (__global short *)&seam_pref_buf[dim.s7 * 16]);\n"
@@ -1963,11 +2199,10 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"				/* Parent at the start of the seam set to control value */\n"
 		"				if (i == 0)\n"
 		"				{\n"
-		"					accum.s0 = -1;\n"
-		"					accum.s1 = Pixel;\n"
-		"					accum.s2 = 0;\n"
+		"					accum_value = Pixel;\n"
+		"					accum_parent = PARENT_NONE;\n"
 		"					if (Pixel != 0x7F00FFFF)\n"
-		"						accum.s2 = 1;\n"
+		"						accum_parent |= PARENT_PROPAGATE;\n"
 		"				}\n"
 		"				else\n"
 		"				{\n"
@@ -1980,13 +2215,14 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"					{\n"
 		"\n"
 		"						uint ID_left = overlap_offset + ((dim.s1 - info.s4 + i - 1) * dim.s3) + (dim.s0 - info.s2 - 1);\n"
-		"						int4 left_accum = vload4(0, (__global int *)&seam_buf[ID_left * 12]);\n"
+		"						int left_accum = *(__global int *)&seam_buf[ID_left * 4];\n"
+		"						uchar left_parent = seam_parent_buf[ID_left];\n"
 		"						mask_1 = *(__global char *)&ip_mask_buf[((((dim.s1 + i) -1 ) + input_offset) * equi_width) + (dim.s0 - 1)];\n"
 		"						mask_2 = *(__global char *)&ip_mask_buf[(((dim.s5 + i) -1 ) * equi_width) + (dim.s4 - 1)];\n"
 		"						if(mask_1 && mask_2)\n"
 		"						{\n"
-		"							left = left_accum.s1;\n"
-		"							left_prop = left_accum.s2;\n"
+		"							left = left_accum;\n"
+		"							left_prop = left_parent & PARENT_PROPAGATE;\n"
 		"						}\n"
 		"\n"
 		"					}\n"
@@ -1995,25 +2231,27 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"					{\n"
 		"\n"
 		"						uint ID_right = overlap_offset + ((dim.s1 - info.s4 + i - 1) * dim.s3) + (dim.s0 - info.s2 + 1);\n"
-		"						int4 right_accum = vload4(0, (__global int *)&seam_buf[ID_right * 12]);\n"
+		"						int right_accum = *(__global int *)&seam_buf[ID_right * 4];\n"
+		"						uchar right_parent = seam_parent_buf[ID_right];\n"
 		"						mask_1 = *(__global char *)&ip_mask_buf[((((dim.s1 + i) -1 ) + input_offset) * equi_width) + (dim.s0 + 1)];\n"
 		"						mask_2 = *(__global char *)&ip_mask_buf[(((dim.s5 + i) -1 ) * equi_width) + (dim.s4 + 1)];\n"
 		"						if(mask_1 && mask_2)\n"
 		"						{\n"
-		"							right = right_accum.s1;\n"
-		"							right_prop = right_accum.s2;\n"
+		"							right = right_accum;\n"
+		"							right_prop = right_parent & PARENT_PROPAGATE;\n"
 		"						}\n"
 		"\n"
 		"					}\n"
 		"\n"
 		"					uint ID_middle = overlap_offset + ((dim.s1 - info.s4 + i - 1) * dim.s3) + (dim.s0 - info.s2);\n"
-		"					int4 middle_accum = vload4(0, (__global int *)&seam_buf[ID_middle * 12]);\n"
+		"					int middle_accum = *(__global int *)&seam_buf[ID_middle * 4];\n"
+		"					uchar middle_parent = seam_parent_buf[ID_middle];\n"
 		"					mask_1 = *(__global char *)&ip_mask_buf[((((dim.s1 + i) -1 ) + input_offset) * equi_width) + (dim.s0)];\n"
 		"					mask_2 = *(__global char *)&ip_mask_buf[(((dim.s5 + i) -1 ) * equi_width) + (dim.s4)];\n"
 		"					if(mask_1 && mask_2)\n"
 		"					{\n"
-		"						middle = middle_accum.s1;\n"
-		"						middle_prop = middle_accum.s2;\n"
+		"						middle = middle_accum;\n"
+		"						middle_prop = middle_parent & PARENT_PROPAGATE;\n"
 		"					}\n"
 		"\n"
 		"\n"
@@ -2067,43 +2305,37 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"						if ((right < valid_child) && right_prop)\n"
 		"						{\n"
 		"							valid_child = right;\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | ((dim.s0 + 1) & 0x0000FFFF) ;\n"
-		"							accum.s1 = (right + Pixel) + (2*BONUS);\n"
-		"							accum.s2 = 1;\n"
+		"							accum_value = (right + Pixel) + (2*BONUS);\n"
+		"							accum_parent = PARENT_RIGHT | PARENT_PROPAGATE;\n"
 		"						}\n"
 		"						if ((left < valid_child) && left_prop)\n"
 		"						{\n"
 		"							valid_child = left;\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | ((dim.s0 - 1) & 0x0000FFFF) ;\n"
-		"							accum.s1 = (left + Pixel)  + (2*BONUS);\n"
-		"							accum.s2 = 1;\n"
+		"							accum_value = (left + Pixel)  + (2*BONUS);\n"
+		"							accum_parent = PARENT_LEFT | PARENT_PROPAGATE;\n"
 		"						}\n"
 		"						if ((middle < valid_child) && middle_prop)\n"
 		"						{\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | (dim.s0 & 0x0000FFFF) ;\n"
-		"							accum.s1 = (middle + Pixel) - (2*BONUS);\n"
-		"							accum.s2 = 1;\n"
+		"							accum_value = (middle + Pixel) - (2*BONUS);\n"
+		"							accum_parent = PARENT_MIDDLE | PARENT_PROPAGATE;\n"
 		"						}\n"
 		"					}\n"
 		"					else\n"
 		"					{\n"
 		"						if (right < middle && right < left)\n"
 		"						{\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | ((dim.s0 + 1) & 0x0000FFFF) ;\n"
-		"							accum.s1 = (right + Pixel) + (2*BONUS);\n"
-		"							accum.s2 = 0;\n"
+		"							accum_value = (right + Pixel) + (2*BONUS);\n"
+		"							accum_parent = PARENT_RIGHT;\n"
 		"						}\n"
 		"						else if (left < right && left < middle)\n"
 		"						{\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | ((dim.s0 - 1) & 0x0000FFFF) ;\n"
-		"							accum.s1 = (left + Pixel)  + (2*BONUS);\n"
-		"							accum.s2 = 0;\n"
+		"							accum_value = (left + Pixel)  + (2*BONUS);\n"
+		"							accum_parent = PARENT_LEFT;\n"
 		"						}\n"
 		"						else\n"
 		"						{\n"
-		"							accum.s0 = ((((dim.s1 + i) - 1) << 16 ) & 0xFFFF0000) | (dim.s0 & 0x0000FFFF) ;\n"
-		"							accum.s1 = (middle + Pixel) - (2*BONUS);\n"
-		"							accum.s2 = 0;\n"
+		"							accum_value = (middle + Pixel) - (2*BONUS);\n"
+		"							accum_parent = PARENT_MIDDLE;\n"
 		"						}\n"
 		"					}\n"
 		"\n";
@@ -2111,8 +2343,8 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"				}\n"
 		"\n"
 		//"				barrier(CLK_GLOBAL_MEM_FENCE);\n"
-		"				*(__global int2 *) &seam_buf[output_ID * 12] = accum.s01;\n"
-		"				*(__global int *) &seam_buf[output_ID * 12 + 8] = accum.s2;\n"
+		"				*(__global int *) &seam_buf[output_ID * 4] = accum_value;\n"
+		"				seam_parent_buf[output_ID] = accum_parent;\n"
 		"				barrier(CLK_GLOBAL_MEM_FENCE);\n"
 		"\n"
 		"			}\n"
@@ -2155,11 +2387,10 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 			"			//Parent at the start of the seam set to control value\n"
 			"			if (i == 0)\n"
 			"			{\n"
-			"				accum.s0 = -1;\n"
-			"				accum.s1 = Pixel;\n"
-			"				accum.s2 = 0;\n"
+			"				accum_value = Pixel;\n"
+			"				accum_parent = PARENT_NONE;\n"
 			"				if (Pixel != 0x7F00FFFF)\n"
-			"					accum.s2 = 1;\n"
+			"					accum_parent |= PARENT_PROPAGATE;\n"
 			"			}\n"
 			"			else\n"
 			"			{\n"
@@ -2172,13 +2403,14 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 			"				{\n"
 			"\n"
 			"					uint ID_left = overlap_offset + ((dim.s0 - info.s2 + i - 1) * dim.s2) + (dim.s1 - info.s4 - 1) ;\n"
-			"					int4 left_accum = vload4(0, (__global int *)&seam_buf[ID_left * 12]);\n"
+			"					int left_accum = *(__global int *)&seam_buf[ID_left * 4];\n"
+			"					uchar left_parent = seam_parent_buf[ID_left];\n"
 			"					mask_1 = *(__global char *)&ip_mask_buf[(((dim.s1 - 1) + input_offset) * equi_width) + ((dim.s0 + i) - 1)];\n"
 			"					mask_2 = *(__global char *)&ip_mask_buf[((dim.s5 - 1) * equi_width) + ((dim.s4 + i) - 1)];\n"
 			"					if (mask_1 && mask_2)\n"
 			"					{\n"
-			"						left = left_accum.s1;\n"
-			"						left_prop = left_accum.s2;\n"
+			"						left = left_accum;\n"
+			"						left_prop = left_parent & PARENT_PROPAGATE;\n"
 			"					}\n"
 			"\n"
 			"				}\n"
@@ -2187,26 +2419,28 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 			"				{\n"
 			"\n"
 			"					uint ID_right = overlap_offset + ((dim.s0 - info.s2 + i - 1) * dim.s2) + (dim.s1 - info.s4 + 1) ;\n"
-			"					int4 right_accum = vload4(0, (__global int *)&seam_buf[ID_right * 12]);\n"
+			"					int right_accum = *(__global int *)&seam_buf[ID_right * 4];\n"
+			"					uchar right_parent = seam_parent_buf[ID_right];\n"
 			"					mask_1 = *(__global char *)&ip_mask_buf[(((dim.s1 + 1) + input_offset) * equi_width) + ((dim.s0 + i) - 1)];\n"
 			"					mask_2 = *(__global char *)&ip_mask_buf[((dim.s5 + 1) * equi_width) + ((dim.s4 + i) - 1)];\n"
 			"					if (mask_1 && mask_2)\n"
 			"					{\n"
-			"						right = right_accum.s1;\n"
-			"						right_prop = right_accum.s2;\n"
+			"						right = right_accum;\n"
+			"						right_prop = right_parent & PARENT_PROPAGATE;\n"
 			"					}\n"
 			"\n"
 			"				}\n"
 			"\n"
 			"\n"
 			"					uint ID_middle = overlap_offset + ((dim.s0 - info.s2 + i - 1) * dim.s2) + (dim.s1 - info.s4);\n"
-			"					int4 middle_accum = vload4(0, (__global int *)&seam_buf[ID_middle * 12]);\n"
+			"					int middle_accum = *(__global int *)&seam_buf[ID_middle * 4];\n"
+			"					uchar middle_parent = seam_parent_buf[ID_middle];\n"
 			"					mask_1 = *(__global char *)&ip_mask_buf[((dim.s1 + input_offset) * equi_width) + ((dim.s0 + i) - 1)];\n"
 			"					mask_2 = *(__global char *)&ip_mask_buf[(dim.s5 * equi_width) + ((dim.s4 + i) - 1)];\n"
 			"					if (mask_1 && mask_2)\n"
 			"					{\n"
-			"						middle = middle_accum.s1;\n"
-			"						middle_prop = middle_accum.s2;\n"
+			"						middle = middle_accum;\n"
+			"						middle_prop = middle_parent & PARENT_PROPAGATE;\n"
 			"					}\n"
 			"\n"
 			"				//Adding Bonus to the path next to an Edge\n"
@@ -2257,51 +2491,45 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 		"					if ((right < valid_child) && right_prop)\n"
 		"					{\n"
 		"						valid_child = right;\n"
-		"						accum.s0 = (((dim.s1 + 1) << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (right + Pixel) + (2 * BONUS);\n"
-		"						accum.s2 = 1;\n"
+		"						accum_value = (right + Pixel) + (2 * BONUS);\n"
+		"						accum_parent = PARENT_RIGHT | PARENT_PROPAGATE;\n"
 		"					}\n"
 		"					if ((left < valid_child) && left_prop)\n"
 		"					{\n"
 		"						valid_child = left;\n"
-		"						accum.s0 = (((dim.s1 - 1) << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (left + Pixel) + (2 * BONUS);\n"
-		"						accum.s2 = 1;\n"
+		"						accum_value = (left + Pixel) + (2 * BONUS);\n"
+		"						accum_parent = PARENT_LEFT | PARENT_PROPAGATE;\n"
 		"					}\n"
 		"					if ((middle < valid_child) && middle_prop)\n"
 		"					{\n"
-		"						accum.s0 = ((dim.s1 << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (middle + Pixel) - (2 * BONUS);\n"
-		"						accum.s2 = 1;\n"
+		"						accum_value = (middle + Pixel) - (2 * BONUS);\n"
+		"						accum_parent = PARENT_MIDDLE | PARENT_PROPAGATE;\n"
 		"					}\n"
 		"				}\n"
 		"				else\n"
 		"				{\n"
 		"					if (right < middle && right < left)\n"
 		"					{\n"
-		"						accum.s0 = (((dim.s1 + 1) << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (right + Pixel) + (2 * BONUS);\n"
-		"						accum.s2 = 0;\n"
+		"						accum_value = (right + Pixel) + (2 * BONUS);\n"
+		"						accum_parent = PARENT_RIGHT;\n"
 		"					}\n"
 		"					else if (left < right && left < middle)\n"
 		"					{\n"
-		"						accum.s0 = (((dim.s1 - 1) << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (left + Pixel) + (2 * BONUS);\n"
-		"						accum.s2 = 0;\n"
+		"						accum_value = (left + Pixel) + (2 * BONUS);\n"
+		"						accum_parent = PARENT_LEFT;\n"
 		"					}\n"
 		"					else\n"
 		"					{\n"
-		"						accum.s0 = ((dim.s1 << 16) & 0xFFFF0000) | (((dim.s0 + i) - 1) & 0x0000FFFF);\n"
-		"						accum.s1 = (middle + Pixel) - (2 * BONUS);\n"
-		"						accum.s2 = 0;\n"
+		"						accum_value = (middle + Pixel) - (2 * BONUS);\n"
+		"						accum_parent = PARENT_MIDDLE;\n"
 		"					}\n"
 		"				}\n"
 		"\n"
 		"			}\n"
 		"\n"
 		//"				barrier(CLK_GLOBAL_MEM_FENCE);\n"
-		"				*(__global int2 *) &seam_buf[output_ID * 12] = accum.s01;\n"
-		"				*(__global int *) &seam_buf[output_ID * 12 + 8] = accum.s2;\n"
+		"				*(__global int *) &seam_buf[output_ID * 4] = accum_value;\n"
+		"				seam_parent_buf[output_ID] = accum_parent;\n"
 		"				barrier(CLK_GLOBAL_MEM_FENCE);\n"
 		"\n"
 		"			}\n"
@@ -2316,61 +2544,482 @@ static vx_status VX_CALLBACK seamfind_cost_accumulate_opencl_codegen(
 	return VX_SUCCESS;
 }
 
-//! \brief The kernel execution.
-static vx_status VX_CALLBACK seamfind_cost_accumulate_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
+//! \brief The edge bonus of the seamfind_cost_accumulate GPU kernel (cost and phase are read as signed char there as well).
+static inline vx_int32 seamfind_accumulate_bonus(vx_int32 mag, vx_int32 phase, bool vertical, int seam_quality)
 {
-	return VX_ERROR_NOT_SUPPORTED;
+	vx_int32 bonus = 0;
+	if (seam_quality == 1) {
+		if (vertical) {
+			if (mag > 75 && (phase == 0 || phase == 4)) bonus = 100 + ((mag > 200) ? 50 : 0);
+		}
+		else {
+			if (mag > 50 && (phase == 2 || phase == 6)) bonus = 100 + ((mag > 200) ? 50 : 0);
+		}
+	}
+	else if (seam_quality == 2) {
+		if (vertical) {
+			if (mag > 50 && ((phase >= 0 && phase <= 32) || (phase >= 97 && phase <= 160) || (phase >= 225 && phase <= 255))) bonus = 100 + ((mag > 225) ? 50 : 0);
+		}
+		else {
+			if (mag > 50 && ((phase >= 32 && phase <= 97) || (phase >= 160 && phase <= 225))) bonus = 100 + ((mag > 200) ? 50 : 0);
+		}
+	}
+	return bonus;
 }
 
-//! \brief The kernel publisher.
-vx_status seamfind_cost_accumulate_publish(vx_context context)
-{
-	// add kernel to the context with callbacks
-	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_cost_accumulate",
-		AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_ACCUMULATE,
-		seamfind_cost_accumulate_kernel,
-		10,
-		seamfind_cost_accumulate_input_validator,
-		seamfind_cost_accumulate_output_validator,
-		nullptr,
-		nullptr);
-	ERROR_CHECK_OBJECT(kernel);
-	amd_kernel_query_target_support_f query_target_support_f = seamfind_cost_accumulate_query_target_support;
-	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = seamfind_cost_accumulate_opencl_codegen;
-	amd_kernel_opencl_global_work_update_callback_f opencl_global_work_update_callback_f = seamfind_cost_accumulate_opencl_global_work_update;
-	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_QUERY_TARGET_SUPPORT, &query_target_support_f, sizeof(query_target_support_f)));
-	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_OPENCL_CODEGEN_CALLBACK, &opencl_codegen_callback_f, sizeof(opencl_codegen_callback_f)));
-	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_OPENCL_GLOBAL_WORK_UPDATE_CALLBACK, &opencl_global_work_update_callback_f, sizeof(opencl_global_work_update_callback_f)));
-
-	// set kernel parameters
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 8, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
-	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 9, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+//! \brief The accumulate layout of an overlap: the previous seam can only be traced back when the layout is unchanged.
+struct seamfind_accumulate_layout {
+	vx_int32 out_base;		// accumulate index of the first lane of the first step (-1: no previous seam)
+	vx_int32 lane_width;	// accumulate entries per step
+	vx_int32 lanes;			// number of lanes
+	vx_int32 steps;			// last step of the seam
+};
 
-	// finalize and release kernel object
-	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
-	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
+//! \brief Clamp the band of lanes of each step to one lane beyond the band of the previous step, so every lane in a band
+// has a parent in the band of the previous step.
+static void seamfind_accumulate_band_clamp(std::vector<vx_int32>& band, vx_int32 lanes)
+{
+	vx_int32 steps = (vx_int32)band.size() / 2 - 1;
+	for (vx_int32 i = 1; i <= steps; i++) {
+		vx_int32 lo = std::max(band[2 * i], band[2 * i - 2] - 1), hi = std::min(band[2 * i + 1], band[2 * i - 1] + 1);
+		if (lo > hi) {
+			lo = std::max(band[2 * i - 2] - 1, 0);
+			hi = std::min(band[2 * i - 1] + 1, lanes - 1);
+		}
+		band[2 * i] = lo;
+		band[2 * i + 1] = hi;
+	}
+}
 
-	return VX_SUCCESS;
+//! \brief Trace the previous seam of an overlap back from its accumulate entries, as seamfind_path_trace does, and set
+// the band of lanes searched at each step to +/- corridor lanes around it. The steps the previous seam doesn't reach are
+// searched in full.
+static void seamfind_accumulate_band(const vx_int32 * accum_value, const vx_uint8 * accum_parent, const seamfind_accumulate_layout& layout,
+	vx_int32 corridor, std::vector<vx_int32>& band)
+{
+	vx_int32 lanes = layout.lanes, steps = layout.steps;
+	band.resize(2 * (steps + 1));
+	for (vx_int32 i = 0; i <= steps; i++) {
+		band[2 * i] = 0;
+		band[2 * i + 1] = lanes - 1;
+	}
+	// the previous seam starts at the least cost lane of the last step
+	const vx_int32 * last = accum_value + layout.out_base + steps * layout.lane_width;
+	vx_int32 lane = -1, min_cost = 0x7FFFFFFF;
+	for (vx_int32 c = lanes - 1; c >= 0; c--) {
+		if (min_cost > last[c]) {
+			min_cost = last[c];
+			lane = c;
+		}
+	}
+	for (vx_int32 i = steps; i >= 0 && lane >= 0 && lane < lanes; i--) {
+		band[2 * i] = std::max(lane - corridor, 0);
+		band[2 * i + 1] = std::min(lane + corridor, lanes - 1);
+		vx_int32 parent = accum_parent[layout.out_base + i * layout.lane_width + lane] & SEAMFIND_PARENT_LANE_MASK;
+		if (parent == SEAMFIND_PARENT_NONE) break;
+		lane += parent - 1;
+	}
+	seamfind_accumulate_band_clamp(band, lanes);
 }
 
-/***********************************************************************************************************************************
+//! \brief Find the seam of an overlap on its cost downscaled by scale along both directions and set the band of lanes searched
+// at each step to the block of the coarse seam and one block on each side. The cost of a block is the mean cost of its valid
+// pixels and a block without valid pixels is never on the coarse seam. Returns false when there is no coarse seam.
+static bool seamfind_accumulate_coarse_band(const vx_int8 * cost_ptr, const vx_uint8 * mask_ptr, vx_int32 base1, vx_int32 base2,
+	vx_int32 lane_step, vx_int32 sweep_step, bool vertical, int cost_select, vx_int32 lanes, vx_int32 steps, vx_int32 scale,
+	std::vector<vx_int32>& band)
+{
+	const vx_int32 max_value = 0x7FFFFFFF;
+	vx_int32 coarse_lanes = (lanes + scale - 1) / scale, coarse_steps = (steps + scale) / scale;
+	if (coarse_lanes < 3) return false;
+	std::vector<vx_int32> accum(coarse_lanes * coarse_steps), sum(coarse_lanes), count(coarse_lanes);
+	std::vector<vx_int8> parent(coarse_lanes * coarse_steps, 0);
+	for (vx_int32 s = 0; s < coarse_steps; s++) {
+		// block mean of the valid pixel costs
+		std::fill(sum.begin(), sum.end(), 0);
+		std::fill(count.begin(), count.end(), 0);
+		for (vx_int32 i = s * scale; i < std::min(s * scale + scale, steps + 1); i++) {
+			for (vx_int32 c = 0; c < lanes; c++) {
+				vx_int32 id1 = base1 + c * lane_step + i * sweep_step;
+				vx_int32 id2 = base2 + c * lane_step + i * sweep_step;
+				if (mask_ptr[id1] && mask_ptr[id2]) {
+					vx_int32 cost = cost_ptr[id1];
+					if (vertical && cost_select) cost = (cost_ptr[id1] + cost_ptr[id2]) / 2;
+					sum[c / scale] += cost;
+					count[c / scale]++;
+				}
+			}
+		}
+		// cheapest of the three parents: a block without a valid parent starts a new seam
+		vx_int32 * row = &accum[s * coarse_lanes], * prev = row - coarse_lanes;
+		for (vx_int32 c = 0; c < coarse_lanes; c++) {
+			if (!count[c]) {
+				row[c] = max_value;
+				continue;
+			}
+			vx_int32 cost = sum[c] / count[c], best = max_value;
+			if (s > 0) {
+				best = prev[c];
+				if (c > 0 && prev[c - 1] < best) { best = prev[c - 1]; parent[s * coarse_lanes + c] = -1; }
+				if (c < coarse_lanes - 1 && prev[c + 1] < best) { best = prev[c + 1]; parent[s * coarse_lanes + c] = 1; }
+			}
+			row[c] = (best == max_value) ? cost : best + cost;
+		}
+	}
 
-Seam Find Kernel: 3 A - Path Tracing - Vertical & Horizontal Seam -- GPU/CPU
+	// trace the coarse seam back from its least cost block and upsample it to a band of three blocks
+	const vx_int32 * last = &accum[(coarse_steps - 1) * coarse_lanes];
+	vx_int32 lane = -1, min_cost = max_value;
+	for (vx_int32 c = coarse_lanes - 1; c >= 0; c--) {
+		if (min_cost > last[c]) {
+			min_cost = last[c];
+			lane = c;
+		}
+	}
+	if (lane < 0) return false;
+	band.resize(2 * (steps + 1));
+	for (vx_int32 s = coarse_steps - 1; s >= 0; s--) {
+		for (vx_int32 i = s * scale; i < std::min(s * scale + scale, steps + 1); i++) {
+			band[2 * i] = std::max((lane - 1) * scale, 0);
+			band[2 * i + 1] = std::min((lane + 2) * scale - 1, lanes - 1);
+		}
+		lane = std::min(std::max(lane + parent[s * coarse_lanes + lane], 0), coarse_lanes - 1);
+	}
+	seamfind_accumulate_band_clamp(band, lanes);
+	return true;
+}
 
-************************************************************************************************************************************/
-//! \brief The input validator callback.
-static vx_status VX_CALLBACK seamfind_path_trace_input_validator(vx_node node, vx_uint32 index)
+//! \brief Accumulate the seam cost of one overlap on the CPU.
+// The lanes of the overlap (columns of a vertical seam, rows of a horizontal seam) are processed as SSE2 vectors
+// while sweeping along the seam, so each step picks the cheapest of the three parents of 4 lanes with packed compares.
+// Parents outside the overlap are never selected.
+// With a corridor, only the band of lanes around the previous seam is accumulated when the previous layout is unchanged,
+// otherwise with a coarse scale only the band of lanes around the seam of the downscaled cost is accumulated:
+// the lanes of the last step outside the band are marked invalid so the path trace never starts from a stale entry.
+// The layout of this seam is kept in previous for the next refresh.
+static void seamfind_accumulate_overlap(const StitchSeamFindValidEntry * entry, vx_uint32 lanes, const StitchSeamFindInformation * info,
+	const vx_int8 * cost_ptr, const vx_int8 * phase_ptr, const vx_uint8 * mask_ptr, vx_uint32 stride, vx_uint32 equi_height,
+	int cost_select, int seam_quality, vx_int32 * accum_value, vx_uint8 * accum_parent, vx_size accum_num,
+	vx_int32 corridor, vx_int32 coarse_scale, seamfind_accumulate_layout * previous)
 {
-	vx_status status = VX_ERROR_INVALID_PARAMETERS;
-	// get reference for parameter at specified index
+	const vx_int32 invalid_pixel = 0x7F00FFFF, max_value = 0x7FFFFFFF;
+	bool vertical = entry->height >= entry->width;
+	vx_int32 steps = vertical ? entry->height : entry->width;
+	vx_int32 lane_width = vertical ? entry->width : entry->height;
+	vx_int32 lane0 = vertical ? entry->dstX : entry->dstY, lane_start = vertical ? info->start_x : info->start_y;
+	vx_int32 sweep0 = vertical ? entry->dstY : entry->dstX, sweep_start = vertical ? info->start_y : info->start_x;
+	vx_int32 lane_step = vertical ? 1 : (vx_int32)stride, sweep_step = vertical ? (vx_int32)stride : 1;
+	vx_int32 base1 = (entry->dstY + entry->CAMERA_ID_1 * (vx_int32)equi_height) * (vx_int32)stride + entry->dstX;
+	vx_int32 base2 = entry->OverLapY * (vx_int32)stride + entry->OverLapX;
+	if (previous) previous->out_base = -1;
+	if (steps < 0 || lane_width < 0 || (lane0 - lane_start) < 0 || (sweep0 - sweep_start) < 0) return;
+	if ((vx_size)info->offset + (vx_size)(sweep0 - sweep_start + steps) * lane_width + (lane0 - lane_start + lanes) > accum_num) return;
+
+	// band of lanes accumulated at each step: all the lanes without a previous seam with the same layout or a coarse seam
+	seamfind_accumulate_layout layout = { info->offset + (sweep0 - sweep_start) * lane_width + (lane0 - lane_start), lane_width, (vx_int32)lanes, steps };
+	std::vector<vx_int32> band;
+	if (corridor > 0 && previous && previous->out_base == layout.out_base && previous->lane_width == layout.lane_width &&
+		previous->lanes == layout.lanes && previous->steps == layout.steps)
+		seamfind_accumulate_band(accum_value, accum_parent, layout, corridor, band);
+	else if (coarse_scale > 1 && !seamfind_accumulate_coarse_band(cost_ptr, mask_ptr, base1, base2, lane_step, sweep_step, vertical, cost_select,
+		(vx_int32)lanes, steps, coarse_scale, band))
+		band.clear();
+
+	// per lane buffers: padded to a multiple of 4 lanes, the parent rows have a sentinel lane on each side
+	vx_uint32 lanes4 = (lanes + 3) & ~3;
+	std::vector<vx_int32> buf((lanes4 + 8) * 2 + lanes4 * 5);
+	vx_int32 * parent_value = &buf[0] + 3, * parent_prop = parent_value + lanes4 + 8;
+	vx_int32 * pixel = parent_prop + lanes4 + 5, * valid = pixel + lanes4, * bonus2 = valid + lanes4, * dir = bonus2 + lanes4, * prop = dir + lanes4;
+	for (vx_int32 c = -1; c < (vx_int32)lanes4 + 2; c++) { parent_value[c] = max_value; parent_prop[c] = 0; }
+	for (vx_uint32 c = lanes; c < lanes4; c++) { pixel[c] = invalid_pixel; valid[c] = 0; bonus2[c] = 0; }
+
+	const __m128i vmax = _mm_set1_epi32(max_value), vzero = _mm_setzero_si128(), vone = _mm_set1_epi32(1);
+	for (vx_int32 i = 0; i <= steps; i++)
+	{
+		vx_int32 lo = band.empty() ? 0 : band[2 * i], hi = band.empty() ? (vx_int32)lanes - 1 : band[2 * i + 1];
+		// pixel cost, validity, and edge bonus of the lanes in this step
+		for (vx_int32 c = lo; c <= hi; c++) {
+			vx_int32 id1 = base1 + c * lane_step + i * sweep_step;
+			vx_int32 id2 = base2 + c * lane_step + i * sweep_step;
+			bool is_valid = mask_ptr[id1] && mask_ptr[id2];
+			vx_int32 cost = cost_ptr[id1];
+			if (vertical && cost_select) cost = (cost_ptr[id1] + cost_ptr[id2]) / 2;
+			pixel[c] = is_valid ? cost : invalid_pixel;
+			valid[c] = is_valid ? -1 : 0;
+			vx_int32 bonus = 0;
+			if (seam_quality && i > 0) {
+				vx_int32 lane = lane0 + c;
+				if (vertical ? (lane > 0) : (lane > 0 && lane < (vx_int32)equi_height)) {
+					bonus = seamfind_accumulate_bonus(cost_ptr[id1 + lane_step], phase_ptr[id1 + lane_step], vertical, seam_quality)
+						+ seamfind_accumulate_bonus(cost_ptr[id1 - lane_step], phase_ptr[id1 - lane_step], vertical, seam_quality);
+				}
+			}
+			bonus2[c] = 2 * bonus;
+		}
+		vx_int32 out_row = layout.out_base + i * lane_width;
+		if (i == 0) {
+			// start of the seam: no parent
+			for (vx_int32 c = lo; c <= hi; c++) {
+				prop[c] = (pixel[c] != invalid_pixel) ? 1 : 0;
+				accum_value[out_row + c] = pixel[c];
+				accum_parent[out_row + c] = (vx_uint8)(SEAMFIND_PARENT_NONE | (prop[c] ? SEAMFIND_PARENT_PROPAGATE : 0));
+			}
+		}
+		else {
+			for (vx_int32 c = lo & ~3; c <= hi; c += 4) {
+				__m128i L = _mm_loadu_si128((const __m128i *)&parent_value[c - 1]);
+				__m128i M = _mm_loadu_si128((const __m128i *)&parent_value[c]);
+				__m128i R = _mm_loadu_si128((const __m128i *)&parent_value[c + 1]);
+				__m128i LP = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)&parent_prop[c - 1]), vzero);
+				__m128i MP = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)&parent_prop[c]), vzero);
+				__m128i RP = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)&parent_prop[c + 1]), vzero);
+				__m128i V = _mm_loadu_si128((const __m128i *)&valid[c]);
+				// propagating paths: first of right, left, middle with the strictly smallest value
+				__m128i A = _mm_andnot_si128(_mm_and_si128(_mm_and_si128(LP, MP), RP), V);
+				__m128i rr = _mm_or_si128(_mm_andnot_si128(RP, R), _mm_and_si128(RP, vmax));
+				__m128i ll = _mm_or_si128(_mm_andnot_si128(LP, L), _mm_and_si128(LP, vmax));
+				__m128i mm = _mm_or_si128(_mm_andnot_si128(MP, M), _mm_and_si128(MP, vmax));
+				__m128i aR = _mm_cmplt_epi32(rr, vmax);
+				__m128i vc = _mm_or_si128(_mm_and_si128(aR, rr), _mm_andnot_si128(aR, vmax));
+				__m128i aL = _mm_cmplt_epi32(ll, vc);
+				vc = _mm_or_si128(_mm_and_si128(aL, ll), _mm_andnot_si128(aL, vc));
+				__m128i aM = _mm_cmplt_epi32(mm, vc);
+				aL = _mm_andnot_si128(aM, aL);
+				aR = _mm_andnot_si128(_mm_or_si128(aM, aL), aR);
+				// otherwise: right or left only when strictly smaller than both others
+				__m128i bR = _mm_and_si128(_mm_cmplt_epi32(R, M), _mm_cmplt_epi32(R, L));
+				__m128i bL = _mm_and_si128(_mm_cmplt_epi32(L, R), _mm_cmplt_epi32(L, M));
+				__m128i dR = _mm_or_si128(_mm_and_si128(A, aR), _mm_andnot_si128(A, bR));
+				__m128i dL = _mm_or_si128(_mm_and_si128(A, aL), _mm_andnot_si128(A, bL));
+				__m128i dM = _mm_andnot_si128(_mm_or_si128(dR, dL), _mm_set1_epi32(-1));
+				__m128i parent = _mm_or_si128(_mm_or_si128(_mm_and_si128(dR, R), _mm_and_si128(dL, L)), _mm_and_si128(dM, M));
+				// the bonus favours the straight path
+				__m128i b2 = _mm_loadu_si128((const __m128i *)&bonus2[c]);
+				b2 = _mm_sub_epi32(_mm_xor_si128(b2, dM), dM);
+				__m128i value = _mm_add_epi32(_mm_add_epi32(parent, _mm_loadu_si128((const __m128i *)&pixel[c])), b2);
+				_mm_storeu_si128((__m128i *)&pixel[c], value);
+				_mm_storeu_si128((__m128i *)&prop[c], _mm_and_si128(A, vone));
+				_mm_storeu_si128((__m128i *)&dir[c], _mm_sub_epi32(dL, dR));
+			}
+			for (vx_int32 c = lo; c <= hi; c++) {
+				accum_value[out_row + c] = pixel[c];
+				accum_parent[out_row + c] = (vx_uint8)((dir[c] + 1) | (prop[c] ? SEAMFIND_PARENT_PROPAGATE : 0));
+			}
+		}
+		if (i == steps && !band.empty()) {
+			// the path trace starts from the least cost lane of the last step: lanes outside the band are invalid
+			for (vx_int32 c = 0; c < lo; c++) {
+				accum_value[out_row + c] = invalid_pixel;
+				accum_parent[out_row + c] = SEAMFIND_PARENT_NONE;
+			}
+			for (vx_int32 c = hi + 1; c < (vx_int32)lanes; c++) {
+				accum_value[out_row + c] = invalid_pixel;
+				accum_parent[out_row + c] = SEAMFIND_PARENT_NONE;
+			}
+		}
+		// parents of the next step: invalid pixels and lanes outside the band are never selected as parent
+		if (i > 0 && !band.empty()) {
+			for (vx_int32 c = band[2 * i - 2]; c <= band[2 * i - 1]; c++) {
+				parent_value[c] = max_value;
+				parent_prop[c] = 0;
+			}
+		}
+		for (vx_int32 c = lo; c <= hi; c++) {
+			parent_value[c] = valid[c] ? pixel[c] : max_value;
+			parent_prop[c] = valid[c] ? prop[c] : 0;
+		}
+	}
+	if (previous) *previous = layout;
+}
+
+//! \brief The local data of seamfind_cost_accumulate: the settings are resolved once at graph verify and the worker
+//  threads are kept across executions.
+struct seamfind_cost_accumulate_data {
+	vx_int32 corridor;										// half width in lanes of the band around the previous seam (0: full search)
+	vx_int32 coarse_scale;									// downscale factor of the coarse seam (0: no coarse seam)
+	std::vector<seamfind_accumulate_layout> previous;		// layout of the previous seam of each overlap
+	stitch_thread_pool pool;								// worker threads accumulating the overlaps
+};
+
+//! \brief The kernel execution.
+static vx_status VX_CALLBACK seamfind_cost_accumulate_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_uint32 current_frame = 0, equi_width = 0, equi_height = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &current_frame));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &equi_width));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[2], &equi_height));
+
+	// get developer configurations
+	int COST_SELECT = 0, SEAM_QUALITY = 1;
+	char textBuffer[256];
+	if (StitchGetEnvironmentVariable("COST_SELECT", textBuffer, sizeof(textBuffer)))	{ COST_SELECT = atoi(textBuffer); }
+	if (StitchGetEnvironmentVariable("SEAM_QUALITY", textBuffer, sizeof(textBuffer)))	{ SEAM_QUALITY = atoi(textBuffer); }
+
+	// Cost, Phase, and Mask images - Variable 3, 4, 5
+	vx_image image[3] = { (vx_image)parameters[3], (vx_image)parameters[4], (vx_image)parameters[5] };
+	vx_rectangle_t rect[3]; vx_imagepatch_addressing_t addr[3]; void * image_ptr[3] = { nullptr, nullptr, nullptr };
+	for (int k = 0; k < 3; k++) {
+		vx_uint32 width = 0, height = 0;
+		ERROR_CHECK_STATUS(vxQueryImage(image[k], VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+		ERROR_CHECK_STATUS(vxQueryImage(image[k], VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+		rect[k].start_x = rect[k].start_y = 0; rect[k].end_x = width; rect[k].end_y = height;
+		ERROR_CHECK_STATUS(vxAccessImagePatch(image[k], &rect[k], 0, &addr[k], &image_ptr[k], VX_READ_ONLY));
+	}
+	vx_uint32 stride = (vx_uint32)addr[0].stride_y;	// cost, phase, and mask images have the same dimensions
+
+	// Valid, Pref, Info, Accum value and Accum parent arrays - Variable 6, 7, 8, 9, 10
+	vx_array arr[5] = { (vx_array)parameters[6], (vx_array)parameters[7], (vx_array)parameters[8], (vx_array)parameters[9], (vx_array)parameters[10] };
+	vx_size arr_num[5] = { 0, 0, 0, 0, 0 };
+	vx_size arr_stride[5] = { sizeof(StitchSeamFindValidEntry), sizeof(StitchSeamFindPreference), sizeof(StitchSeamFindInformation), sizeof(vx_int32), sizeof(vx_uint8) };
+	void * arr_ptr[5] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+	for (int k = 0; k < 5; k++) {
+		ERROR_CHECK_STATUS(vxQueryArray(arr[k], VX_ARRAY_ATTRIBUTE_NUMITEMS, &arr_num[k], sizeof(arr_num[k])));
+		if (arr_num[k] > 0)
+			ERROR_CHECK_STATUS(vxAccessArrayRange(arr[k], 0, arr_num[k], &arr_stride[k], &arr_ptr[k], k < 3 ? VX_READ_ONLY : VX_READ_AND_WRITE));
+	}
+	const StitchSeamFindValidEntry * valid_entry = (const StitchSeamFindValidEntry *)arr_ptr[0];
+	const StitchSeamFindPreference * pref = (const StitchSeamFindPreference *)arr_ptr[1];
+	const StitchSeamFindInformation * info = (const StitchSeamFindInformation *)arr_ptr[2];
+	vx_int32 * accum_value = (vx_int32 *)arr_ptr[3];
+	vx_uint8 * accum_parent = (vx_uint8 *)arr_ptr[4];
+	vx_size accum_num = std::min(arr_num[3], arr_num[4]);
+
+	// corridor search around the previous seam of each overlap
+	seamfind_cost_accumulate_data * data = nullptr;
+	vx_size data_size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &data_size, sizeof(data_size)) && (data_size == sizeof(seamfind_cost_accumulate_data)))
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	if (data && data->corridor > 0 && data->previous.size() != arr_num[1]) {
+		seamfind_accumulate_layout none = { -1, 0, 0, 0 };
+		data->previous.assign(arr_num[1], none);
+	}
+
+	// valid entries of an overlap are consecutive: each overlap scheduled for this frame is one task
+	std::vector<std::pair<vx_uint32, vx_uint32>> overlap;
+	for (vx_uint32 k = 0, count = 0; k < arr_num[0]; k += count) {
+		vx_int16 id = valid_entry[k].ID;
+		for (count = 1; k + count < arr_num[0] && valid_entry[k + count].ID == id; count++)
+			;
+		if (id < 0 || (vx_size)id >= arr_num[1] || (vx_size)id >= arr_num[2] || !accum_value || !accum_parent)
+			continue;
+		if (pref[id].priority != -1 && (((vx_uint32)pref[id].start_frame == current_frame) || ((current_frame + 1) % (pref[id].frequency + pref[id].seam_type_num) == 0)))
+			overlap.push_back(std::make_pair(k, count));
+	}
+
+	// independent overlaps are accumulated on separate threads
+	if (overlap.size() > 0)
+	{
+		std::atomic<int> next_overlap(0);
+		int num_overlaps = (int)overlap.size();
+		std::function<void()> overlap_thread_func = [&]() {
+			for (int i = next_overlap++; i < num_overlaps; i = next_overlap++) {
+				const StitchSeamFindValidEntry * entry = &valid_entry[overlap[i].first];
+				// a seam started on this frame (first seam or scene change) is searched in full
+				vx_int32 corridor = 0, coarse_scale = data ? data->coarse_scale : 0;
+				seamfind_accumulate_layout * previous = nullptr;
+				if (data && data->corridor > 0) {
+					corridor = ((vx_uint32)pref[entry->ID].start_frame == current_frame) ? 0 : data->corridor;
+					previous = &data->previous[entry->ID];
+				}
+				seamfind_accumulate_overlap(entry, overlap[i].second, &info[entry->ID],
+					(const vx_int8 *)image_ptr[0], (const vx_int8 *)image_ptr[1], (const vx_uint8 *)image_ptr[2], stride, equi_height,
+					COST_SELECT, SEAM_QUALITY, accum_value, accum_parent, accum_num, corridor, coarse_scale, previous);
+			}
+		};
+		if (data)
+			data->pool.run(num_overlaps, overlap_thread_func);
+		else
+			overlap_thread_func();
+	}
+
+	for (int k = 0; k < 5; k++) {
+		if (arr_ptr[k])
+			ERROR_CHECK_STATUS(vxCommitArrayRange(arr[k], 0, arr_num[k], arr_ptr[k]));
+	}
+	for (int k = 0; k < 3; k++) {
+		ERROR_CHECK_STATUS(vxCommitImagePatch(image[k], &rect[k], 0, &addr[k], image_ptr[k]));
+	}
+
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel initialize.
+static vx_status VX_CALLBACK seamfind_cost_accumulate_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	seamfind_cost_accumulate_data * data = new seamfind_cost_accumulate_data();
+	seamfind_cost_accumulate_settings(node, data->corridor, data->coarse_scale);
+	data->pool.start();
+	vx_size size = sizeof(seamfind_cost_accumulate_data);
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK seamfind_cost_accumulate_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(seamfind_cost_accumulate_data)))
+	{
+		seamfind_cost_accumulate_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) delete data;
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel publisher.
+vx_status seamfind_cost_accumulate_publish(vx_context context)
+{
+	// add kernel to the context with callbacks
+	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_cost_accumulate",
+		AMDOVX_KERNEL_STITCHING_SEAMFIND_COST_ACCUMULATE,
+		seamfind_cost_accumulate_kernel,
+		13,
+		seamfind_cost_accumulate_input_validator,
+		seamfind_cost_accumulate_output_validator,
+		seamfind_cost_accumulate_initialize,
+		seamfind_cost_accumulate_deinitialize);
+	ERROR_CHECK_OBJECT(kernel);
+	amd_kernel_query_target_support_f query_target_support_f = seamfind_cost_accumulate_query_target_support;
+	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = seamfind_cost_accumulate_opencl_codegen;
+	amd_kernel_opencl_global_work_update_callback_f opencl_global_work_update_callback_f = seamfind_cost_accumulate_opencl_global_work_update;
+	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_QUERY_TARGET_SUPPORT, &query_target_support_f, sizeof(query_target_support_f)));
+	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_OPENCL_CODEGEN_CALLBACK, &opencl_codegen_callback_f, sizeof(opencl_codegen_callback_f)));
+	ERROR_CHECK_STATUS(vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_AMD_OPENCL_GLOBAL_WORK_UPDATE_CALLBACK, &opencl_global_work_update_callback_f, sizeof(opencl_global_work_update_callback_f)));
+
+	// set kernel parameters
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 0, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 1, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 2, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 8, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 9, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 10, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 11, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 12, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
+
+	// finalize and release kernel object
+	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
+	ERROR_CHECK_STATUS(vxReleaseKernel(&kernel));
+
+	return VX_SUCCESS;
+}
+
+/***********************************************************************************************************************************
+
+Seam Find Kernel: 3 A - Path Tracing - Vertical & Horizontal Seam -- GPU/CPU
+
+************************************************************************************************************************************/
+//! \brief The input validator callback.
+static vx_status VX_CALLBACK seamfind_path_trace_input_validator(vx_node node, vx_uint32 index)
+{
+	vx_status status = VX_ERROR_INVALID_PARAMETERS;
+	// get reference for parameter at specified index
 	vx_reference ref = avxGetNodeParamRef(node, index);
 	ERROR_CHECK_OBJECT(ref);
 	// validate each parameter
@@ -2423,16 +3072,17 @@ static vx_status VX_CALLBACK seamfind_path_trace_input_validator(vx_node node, v
 		}
 		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
 	}
-	else if (index == 3)
-	{ // array object of StitchSeamFindAccumEntry type
+	else if (index == 3 || index == 6)
+	{ // array object of accumulated values (vx_int32) and packed parents (vx_uint8)
 		vx_size itemsize = 0;
 		ERROR_CHECK_STATUS(vxQueryArray((vx_array)ref, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
-		if (itemsize == sizeof(StitchSeamFindAccumEntry)) {
+		if (itemsize == (index == 3 ? sizeof(vx_int32) : sizeof(vx_uint8))) {
 			status = VX_SUCCESS;
 		}
 		else {
 			status = VX_ERROR_INVALID_DIMENSION;
-			vxAddLogEntry((vx_reference)node, status, "ERROR: SeamFind array element (StitchSeamFindAccumEntry) size should be 12 bytes\n");
+			vxAddLogEntry((vx_reference)node, status, index == 3 ? "ERROR: SeamFind accumulate value array element size should be 4 bytes\n"
+				: "ERROR: SeamFind accumulate parent array element size should be 1 byte\n");
 		}
 		ERROR_CHECK_STATUS(vxReleaseArray((vx_array *)&ref));
 	}
@@ -2559,6 +3209,10 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"#pragma OPENCL EXTENSION cl_amd_media_ops : enable\n"
 		"#pragma OPENCL EXTENSION cl_amd_media_ops2 : enable\n"
 		"\n"
+		"#define PARENT_LANE_MASK %d\n"										// SEAMFIND_PARENT_LANE_MASK
+		"#define PARENT_NONE      %d\n"										// SEAMFIND_PARENT_NONE
+		"#define PARENT_PROPAGATE %d\n"										// SEAMFIND_PARENT_PROPAGATE
+		"\n"
 		"__kernel __attribute__((reqd_work_group_size(%d, 1, 1)))\n" // opencl_local_work[0]
 		"\n"
 		"void %s(uint current_frame,\n"								 // opencl_kernel_function_name
@@ -2566,8 +3220,9 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"						__global char * seam_info_buf, uint seam_info_buf_offset, uint seam_info_num_items,\n"
 		"						__global char * seam_accum_buf, uint seam_accum_buf_offset, uint seam_accum_num_items,\n"
 		"						__global char * seam_pref_buf, uint seam_pref_buf_offset, uint seam_pref_num_items,\n"
-		"						__global char * seam_path_buf, uint seam_path_buf_offset, uint seam_path_num_items)\n"
-		, opencl_local_work[0], opencl_kernel_function_name);
+		"						__global char * seam_path_buf, uint seam_path_buf_offset, uint seam_path_num_items,\n"
+		"						__global uchar * seam_parent_buf, uint seam_parent_buf_offset, uint seam_parent_num_items)\n"
+		, SEAMFIND_PARENT_LANE_MASK, SEAMFIND_PARENT_NONE, SEAMFIND_PARENT_PROPAGATE, opencl_local_work[0], opencl_kernel_function_name);
 	opencl_kernel_code = item;
 	opencl_kernel_code +=
 		"{\n"
@@ -2581,6 +3236,7 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"		seam_accum_buf  =  seam_accum_buf + seam_accum_buf_offset;\n"
 		"		seam_pref_buf	=  seam_pref_buf + seam_pref_buf_offset;\n"
 		"		seam_path_buf	=  seam_path_buf + seam_path_buf_offset;\n"
+		"		seam_parent_buf	=  seam_parent_buf + seam_parent_buf_offset;\n"
 		"\n"
 		"		ip_weight_buf =  ip_weight_buf + ip_weight_offset;\n"
 		"		uint equi_height = (ip_weight_width >> 1);\n"
@@ -2595,7 +3251,8 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"\n"
 		"		int min_x = -1, min_y = -1;\n"
 		"		int min_cost = 0X7FFFFFFF;\n"
-		"		int4 accum;\n"
+		"		int accum;\n"
+		"		uchar parent;\n"
 		"\n"
 		"		if (pref.s5 != -1 && ( (pref.s2 == current_frame) || ((current_frame + 1) % (pref.s3 + pref.s1) == 0)))\n"
 		"		{\n"
@@ -2610,13 +3267,15 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"				for (int xe = (int)info.s3; xe >= (int)info.s2; xe--)\n"
 		"				{\n"
 		"					uint pixel_id = overlap_offset + ((ye - info.s4) * x_dir) + (xe - info.s2);\n"
-		"					accum = vload4(0, (__global int *)&seam_accum_buf[pixel_id * 12]); \n"
+		"					accum = *(__global int *)&seam_accum_buf[pixel_id * 4];\n"
+		"					parent = seam_parent_buf[pixel_id];\n"
 		"\n"
-		"					if ((min_cost > accum.s1) && accum.s2)\n"
+		"					if ((min_cost > accum) && (parent & PARENT_PROPAGATE))\n"
 		"					{\n"
-		"						p_x = (short)(accum.s0 & 0x0000FFFF);\n"
-		"						p_y = (short)((accum.s0 & 0xFFFF0000) >> 16);\n"
-		"						min_cost =  accum.s1;\n"
+		"						parent &= PARENT_LANE_MASK;\n"
+		"						p_x = (parent == PARENT_NONE) ? -1 : (short)(xe + parent - 1);\n"
+		"						p_y = (parent == PARENT_NONE) ? -1 : (short)(ye - 1);\n"
+		"						min_cost =  accum;\n"
 		"						min_x =  xe;\n"
 		"					}\n"
 		"\n"
@@ -2642,9 +3301,9 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"					min_x = p_x;\n"
 		"\n"
 		"					min_path_start = overlap_offset + ((min_y - info.s4) * x_dir) + (min_x - info.s2);\n"
-		"					accum = vload4(0, (__global int *)&seam_accum_buf[min_path_start * 12]); \n"
-		"					p_x = (accum.s0 & 0x0000FFFF);\n"
-		"					p_y = ((accum.s0 & 0xFFFF0000) >> 16);\n"
+		"					parent = seam_parent_buf[min_path_start] & PARENT_LANE_MASK;\n"
+		"					p_x = (parent == PARENT_NONE) ? -1 : (short)(min_x + parent - 1);\n"
+		"					p_y = (parent == PARENT_NONE) ? -1 : (short)(min_y - 1);\n"
 		"\n"
 		"				}\n"
 		"\n"
@@ -2664,13 +3323,15 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"				for (int ye = (int)info.s5; ye >= (int)info.s4; ye--)\n"
 		"				{\n"
 		"					uint pixel_id = overlap_offset + ((xe - info.s2) * y_dir) + (ye - info.s4);\n"
-		"					accum = vload4(0, (__global int *)&seam_accum_buf[pixel_id * 12]); \n"
+		"					accum = *(__global int *)&seam_accum_buf[pixel_id * 4];\n"
+		"					parent = seam_parent_buf[pixel_id];\n"
 		"\n"
-		"					if (min_cost > accum.s1 && accum.s2)\n"
+		"					if (min_cost > accum && (parent & PARENT_PROPAGATE))\n"
 		"					{\n"
-		"						p_x = (accum.s0 & 0x0000FFFF);\n"
-		"						p_y = ((accum.s0 & 0xFFFF0000) >> 16);\n"
-		"						min_cost =  accum.s1;\n"
+		"						parent &= PARENT_LANE_MASK;\n"
+		"						p_x = (parent == PARENT_NONE) ? -1 : (short)(xe - 1);\n"
+		"						p_y = (parent == PARENT_NONE) ? -1 : (short)(ye + parent - 1);\n"
+		"						min_cost =  accum;\n"
 		"						min_y =  ye;\n"
 		"					}\n"
 		"\n"
@@ -2695,9 +3356,9 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 		"					min_y = p_y;\n"
 		"\n"
 		"					min_path_start = overlap_offset + ((min_x - info.s2) * y_dir) + (min_y - info.s4);\n"
-		"					accum = vload4(0, (__global int *)&seam_accum_buf[min_path_start * 12]); \n"
-		"					p_x = (accum.s0 & 0x0000FFFF);\n"
-		"					p_y = ((accum.s0 & 0xFFFF0000) >> 16);\n"
+		"					parent = seam_parent_buf[min_path_start] & PARENT_LANE_MASK;\n"
+		"					p_x = (parent == PARENT_NONE) ? -1 : (short)(min_x - 1);\n"
+		"					p_y = (parent == PARENT_NONE) ? -1 : (short)(min_y + parent - 1);\n"
 		"\n"
 		"				}\n"
 		"\n"
@@ -2712,6 +3373,29 @@ static vx_status VX_CALLBACK seamfind_path_trace_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief The parent position of a Seam Find accumulate entry at (x, y): (-1, -1) at the start of a seam.
+static inline void seamfind_parent_position(vx_uint8 parent, bool vertical, vx_int32 x, vx_int32 y, vx_int32& parent_x, vx_int32& parent_y)
+{
+	vx_int32 lane = parent & SEAMFIND_PARENT_LANE_MASK;
+	if (lane == SEAMFIND_PARENT_NONE) {
+		parent_x = parent_y = -1;
+	}
+	else if (vertical) {
+		parent_x = x + lane - 1;
+		parent_y = y - 1;
+	}
+	else {
+		parent_x = x - 1;
+		parent_y = y + lane - 1;
+	}
+}
+
+//! \brief The local data of seamfind_path_trace: the path buffer and the worker threads are kept across executions.
+struct seamfind_path_trace_data {
+	std::vector<StitchSeamFindPathEntry> path;          // path entries of all the overlaps (width_eqr per overlap)
+	stitch_thread_pool pool;                          // worker threads tracing the overlaps
+};
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK seamfind_path_trace_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
@@ -2744,10 +3428,18 @@ static vx_status VX_CALLBACK seamfind_path_trace_kernel(vx_node node, const vx_r
 	vx_array Array_SeamFind_ACCUM = (vx_array)parameters[3];
 	vx_size SeamFind_ACCUM_max = 0;
 	ERROR_CHECK_STATUS(vxQueryArray(Array_SeamFind_ACCUM, VX_ARRAY_ATTRIBUTE_NUMITEMS, &SeamFind_ACCUM_max, sizeof(SeamFind_ACCUM_max)));
-	StitchSeamFindAccumEntry *SeamFind_Accum = nullptr;
-	vx_size stride_accum = sizeof(StitchSeamFindAccumEntry);
+	vx_int32 *SeamFind_Accum = nullptr;
+	vx_size stride_accum = sizeof(vx_int32);
 	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_SeamFind_ACCUM, 0, SeamFind_ACCUM_max, &stride_accum, (void **)&SeamFind_Accum, VX_READ_ONLY));
 
+	//Seam Find Accum Parent Array - Variable 6
+	vx_array Array_SeamFind_Parent = (vx_array)parameters[6];
+	vx_size SeamFind_Parent_max = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(Array_SeamFind_Parent, VX_ARRAY_ATTRIBUTE_NUMITEMS, &SeamFind_Parent_max, sizeof(SeamFind_Parent_max)));
+	vx_uint8 *SeamFind_Parent = nullptr;
+	vx_size stride_parent = sizeof(vx_uint8);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_SeamFind_Parent, 0, SeamFind_Parent_max, &stride_parent, (void **)&SeamFind_Parent, VX_READ_ONLY));
+
 	//Seam Find Accum Array - Variable 4
 	vx_array Array_SeamFind_Pref = (vx_array)parameters[4];
 	vx_size SeamFind_Pref_max = 0;
@@ -2756,15 +3448,22 @@ static vx_status VX_CALLBACK seamfind_path_trace_kernel(vx_node node, const vx_r
 	vx_size stride_pref = sizeof(StitchSeamFindPreference);
 	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_SeamFind_Pref, 0, SeamFind_Pref_max, &stride_pref, (void **)&SeamFind_Pref, VX_READ_ONLY));
 
-	std::vector<StitchSeamFindPathEntry> SeamFind_Path;
+	//Seam Find Path buffer kept across executions - Variable 5
+	seamfind_path_trace_data local_data, *data = &local_data;
+	vx_size data_size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &data_size, sizeof(data_size)) && (data_size == sizeof(seamfind_path_trace_data)))
+	{
+		seamfind_path_trace_data * node_data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &node_data, sizeof(node_data)));
+		if (node_data) data = node_data;
+	}
 	vx_size  path_array_size = (vx_size)(width_eqr * arr_numitems);
-	SeamFind_Path.resize(path_array_size);
-
-	//Horizontal Overlap Counter
-	vx_uint32 horizontal_overlap = 1;
+	if (data->path.size() != path_array_size)
+		data->path.assign(path_array_size, StitchSeamFindPathEntry());
+	std::vector<StitchSeamFindPathEntry>& SeamFind_Path = data->path;
 
-	//Loop over all the overlaps
-	for (vx_uint32 i = 0; i < arr_numitems; i++)
+	//Trace the seam of an overlap: each overlap only writes its own range of the path buffer
+	auto trace_overlap = [&](vx_uint32 i)
 	{
 		vx_uint32 offset_1 = SeamFindInfo_ptr[i].cam_id_1 * height_eqr;
 		vx_uint32 offset_2 = SeamFindInfo_ptr[i].cam_id_2 * height_eqr;
@@ -2774,142 +3473,187 @@ static vx_status VX_CALLBACK seamfind_path_trace_kernel(vx_node node, const vx_r
 		vx_int32 min_cost = 0X7FFFFFFF;
 		vx_int32 min_x = -1, min_y = -1;
 
-		if (SeamFind_Pref[i].priority != -1 && ((SeamFind_Pref[i].start_frame == current_frame) || ((current_frame + 1) % (SeamFind_Pref[i].frequency + SeamFind_Pref[i].seam_type_num) == 0)))
+		/***********************************************************************************************************************************
+		Vertical SeamCut
+		************************************************************************************************************************************/
+		if (y_dir >= x_dir)
 		{
-			/***********************************************************************************************************************************
-			Vertical SeamCut
-			************************************************************************************************************************************/
-			if (y_dir >= x_dir)
-			{
 #if ENABLE_VERTICAL_SEAM
 
 #if GET_TIMING
-				int64_t start_path_t = stitchGetClockCounter();
+			int64_t start_path_t = stitchGetClockCounter();
 #endif
-				//Select the least cost pixel for the start of the seam
-				vx_uint32 ye = SeamFindInfo_ptr[i].end_y;
-				min_y = ye;
+			//Select the least cost pixel for the start of the seam
+			vx_uint32 ye = SeamFindInfo_ptr[i].end_y;
+			min_y = ye;
 
-				for (vx_int32 xe = (vx_int32)SeamFindInfo_ptr[i].end_x; xe >= (vx_int32)SeamFindInfo_ptr[i].start_x; xe--)
+			for (vx_int32 xe = (vx_int32)SeamFindInfo_ptr[i].end_x; xe >= (vx_int32)SeamFindInfo_ptr[i].start_x; xe--)
+			{
+				vx_uint32 pixel_id = SeamFindInfo_ptr[i].offset + ((ye - SeamFindInfo_ptr[i].start_y) * x_dir) + (xe - SeamFindInfo_ptr[i].start_x);
+				if ((min_cost > SeamFind_Accum[pixel_id]))
 				{
-					vx_uint32 pixel_id = SeamFindInfo_ptr[i].offset + ((ye - SeamFindInfo_ptr[i].start_y) * x_dir) + (xe - SeamFindInfo_ptr[i].start_x);
-					if ((min_cost > SeamFind_Accum[pixel_id].value))
-					{
-						min_cost = SeamFind_Accum[pixel_id].value;
-						min_x = xe;
-					}
+					min_cost = SeamFind_Accum[pixel_id];
+					min_x = xe;
 				}
+			}
 #if GET_TIMING
-				int64_t end_path_t = stitchGetClockCounter();
-				int64_t freq = stitchGetClockFrequency();
-				float factor = 1000.0f / (float)freq; // to convert clock counter to ms
-				float Path_find_time = (float)((end_path_t - start_path_t) * factor);
-				int64_t start_path_traverse = stitchGetClockCounter();
+			int64_t end_path_t = stitchGetClockCounter();
+			int64_t freq = stitchGetClockFrequency();
+			float factor = 1000.0f / (float)freq; // to convert clock counter to ms
+			float Path_find_time = (float)((end_path_t - start_path_t) * factor);
+			int64_t start_path_traverse = stitchGetClockCounter();
 #endif
-				//Selected Min Path 
-				vx_uint32 min_path_start = SeamFindInfo_ptr[i].offset + ((min_y - SeamFindInfo_ptr[i].start_y) * x_dir) + (min_x - SeamFindInfo_ptr[i].start_x);
-				vx_uint32 path_offset = (i * width_eqr);
-
-				//Selected Weight at End-X for Image i 
-				int i_val = 0;
-				vx_uint32 weight_pixel_check = ((SeamFindInfo_ptr[i].end_y + offset_1) * width_eqr) + SeamFindInfo_ptr[i].end_x;
-				if (weight_ptr[weight_pixel_check] == 255) i_val = 255;
-
-				//Traverse the path to obtain the seam			
-				while ((SeamFind_Accum[min_path_start].parent_x != -1 || SeamFind_Accum[min_path_start].parent_y != -1) && (SeamFind_Accum[min_path_start].parent_x != 0 && SeamFind_Accum[min_path_start].parent_y != 0))
-				{
-					vx_uint32 path_id = min_y + path_offset;
-					SeamFind_Path[path_id].min_pixel = min_x;
-					SeamFind_Path[path_id].weight_value_i = i_val;
-
-					min_y--;
-					min_x = SeamFind_Accum[min_path_start].parent_x;
-					min_path_start = SeamFindInfo_ptr[i].offset +((SeamFind_Accum[min_path_start].parent_y - SeamFindInfo_ptr[i].start_y) * x_dir) + (SeamFind_Accum[min_path_start].parent_x - SeamFindInfo_ptr[i].start_x);
-				}
+			//Selected Min Path 
+			vx_uint32 min_path_start = SeamFindInfo_ptr[i].offset + ((min_y - SeamFindInfo_ptr[i].start_y) * x_dir) + (min_x - SeamFindInfo_ptr[i].start_x);
+			vx_uint32 path_offset = (i * width_eqr);
+			std::fill(SeamFind_Path.begin() + path_offset + SeamFindInfo_ptr[i].start_y, SeamFind_Path.begin() + path_offset + SeamFindInfo_ptr[i].end_y + 1, StitchSeamFindPathEntry());
+
+			//Selected Weight at End-X for Image i 
+			int i_val = 0;
+			vx_uint32 weight_pixel_check = ((SeamFindInfo_ptr[i].end_y + offset_1) * width_eqr) + SeamFindInfo_ptr[i].end_x;
+			if (weight_ptr[weight_pixel_check] == 255) i_val = 255;
+
+			//Traverse the path to obtain the seam			
+			vx_int32 parent_x, parent_y;
+			seamfind_parent_position(SeamFind_Parent[min_path_start], true, min_x, min_y, parent_x, parent_y);
+			while ((parent_x != -1 || parent_y != -1) && (parent_x != 0 && parent_y != 0))
+			{
+				vx_uint32 path_id = min_y + path_offset;
+				SeamFind_Path[path_id].min_pixel = min_x;
+				SeamFind_Path[path_id].weight_value_i = i_val;
+
+				min_y--;
+				min_x = parent_x;
+				min_path_start = SeamFindInfo_ptr[i].offset +((parent_y - SeamFindInfo_ptr[i].start_y) * x_dir) + (parent_x - SeamFindInfo_ptr[i].start_x);
+				seamfind_parent_position(SeamFind_Parent[min_path_start], true, min_x, min_y, parent_x, parent_y);
+			}
 #if GET_TIMING
-				int64_t end_path_traverse = stitchGetClockCounter();
-				float Path_travese_time = (float)((end_path_traverse - start_path_traverse) * factor);
-				printf("Overlap::%d,%d:::Best Path Find Time-->%f (ms) Path Traverse Time--> %f (ms) \n", i, j, Path_find_time, Path_travese_time);
+			int64_t end_path_traverse = stitchGetClockCounter();
+			float Path_travese_time = (float)((end_path_traverse - start_path_traverse) * factor);
+			printf("Overlap::%d,%d:::Best Path Find Time-->%f (ms) Path Traverse Time--> %f (ms) \n", i, j, Path_find_time, Path_travese_time);
 #endif
 
 #endif
-			}
-			/***********************************************************************************************************************************
-			Horizontal SeamCut
-			************************************************************************************************************************************/
-			else if (x_dir > y_dir)
-			{
+		}
+		/***********************************************************************************************************************************
+		Horizontal SeamCut
+		************************************************************************************************************************************/
+		else if (x_dir > y_dir)
+		{
 #if ENABLE_HORIZONTAL_SEAM
 
 #if GET_TIMING
-				int64_t start_path_t = stitchGetClockCounter();
+			int64_t start_path_t = stitchGetClockCounter();
 #endif
-				//Select the least cost pixel for the start of the seam
-				vx_uint32 xe = SeamFindInfo_ptr[i].end_x;
-				min_x = xe;
+			//Select the least cost pixel for the start of the seam
+			vx_uint32 xe = SeamFindInfo_ptr[i].end_x;
+			min_x = xe;
 
-				for (vx_int32 ye = (vx_int32)SeamFindInfo_ptr[i].end_y; ye >= (vx_int32)SeamFindInfo_ptr[i].start_y; ye--)
+			for (vx_int32 ye = (vx_int32)SeamFindInfo_ptr[i].end_y; ye >= (vx_int32)SeamFindInfo_ptr[i].start_y; ye--)
+			{
+				vx_uint32 pixel_id = SeamFindInfo_ptr[i].offset + ((xe - SeamFindInfo_ptr[i].start_x) * y_dir) + (ye - SeamFindInfo_ptr[i].start_y);
+				if ((min_cost > SeamFind_Accum[pixel_id]))
 				{
-					vx_uint32 pixel_id = SeamFindInfo_ptr[i].offset + ((xe - SeamFindInfo_ptr[i].start_x) * y_dir) + (ye - SeamFindInfo_ptr[i].start_y);
-					if ((min_cost > SeamFind_Accum[pixel_id].value))
-					{
-						min_cost = SeamFind_Accum[pixel_id].value;
-						min_y = ye;
-					}
+					min_cost = SeamFind_Accum[pixel_id];
+					min_y = ye;
 				}
+			}
 #if GET_TIMING
-				int64_t end_path_t = stitchGetClockCounter();
-				int64_t freq = stitchGetClockFrequency();
-				float factor = 1000.0f / (float)freq; // to convert clock counter to ms
-				float Path_find_time = (float)((end_path_t - start_path_t) * factor);
-				int64_t start_path_traverse = stitchGetClockCounter();
+			int64_t end_path_t = stitchGetClockCounter();
+			int64_t freq = stitchGetClockFrequency();
+			float factor = 1000.0f / (float)freq; // to convert clock counter to ms
+			float Path_find_time = (float)((end_path_t - start_path_t) * factor);
+			int64_t start_path_traverse = stitchGetClockCounter();
 #endif
-				//Selected Min Path 
-				vx_uint32 min_path_start = SeamFindInfo_ptr[i].offset + ((min_x - SeamFindInfo_ptr[i].start_x) * y_dir) + (min_y - SeamFindInfo_ptr[i].start_y);
-				vx_uint32 path_offset = (i * width_eqr);
-
-				//Selected Weight at End-X for Image i 
-				int i_val = 0;
-				vx_uint32 weight_pixel_check = ((min_y + offset_1) * width_eqr) + SeamFindInfo_ptr[i].end_x;
-				if (weight_ptr[weight_pixel_check] == 255) i_val = 255;
-
-				//Traverse the path to obtain the seam			
-				while ((SeamFind_Accum[min_path_start].parent_x != -1 || SeamFind_Accum[min_path_start].parent_y != -1) && (SeamFind_Accum[min_path_start].parent_x != 0 && SeamFind_Accum[min_path_start].parent_y != 0))
-				{
-					vx_uint32 path_id = min_x + path_offset;
-					SeamFind_Path[path_id].min_pixel = min_y;
-					SeamFind_Path[path_id].weight_value_i = i_val;
+			//Selected Min Path 
+			vx_uint32 min_path_start = SeamFindInfo_ptr[i].offset + ((min_x - SeamFindInfo_ptr[i].start_x) * y_dir) + (min_y - SeamFindInfo_ptr[i].start_y);
+			vx_uint32 path_offset = (i * width_eqr);
+			std::fill(SeamFind_Path.begin() + path_offset + SeamFindInfo_ptr[i].start_x, SeamFind_Path.begin() + path_offset + SeamFindInfo_ptr[i].end_x + 1, StitchSeamFindPathEntry());
+
+			//Selected Weight at End-X for Image i 
+			int i_val = 0;
+			vx_uint32 weight_pixel_check = ((min_y + offset_1) * width_eqr) + SeamFindInfo_ptr[i].end_x;
+			if (weight_ptr[weight_pixel_check] == 255) i_val = 255;
+
+			//Traverse the path to obtain the seam			
+			vx_int32 parent_x, parent_y;
+			seamfind_parent_position(SeamFind_Parent[min_path_start], false, min_x, min_y, parent_x, parent_y);
+			while ((parent_x != -1 || parent_y != -1) && (parent_x != 0 && parent_y != 0))
+			{
+				vx_uint32 path_id = min_x + path_offset;
+				SeamFind_Path[path_id].min_pixel = min_y;
+				SeamFind_Path[path_id].weight_value_i = i_val;
 
-					min_x--;
-					min_y = SeamFind_Accum[min_path_start].parent_y;
+				min_x--;
+				min_y = parent_y;
 
-					min_path_start = SeamFindInfo_ptr[i].offset + ((min_x - SeamFindInfo_ptr[i].start_x) * y_dir) + (min_y - SeamFindInfo_ptr[i].start_y);
-				}
+				min_path_start = SeamFindInfo_ptr[i].offset + ((min_x - SeamFindInfo_ptr[i].start_x) * y_dir) + (min_y - SeamFindInfo_ptr[i].start_y);
+				seamfind_parent_position(SeamFind_Parent[min_path_start], false, min_x, min_y, parent_x, parent_y);
+			}
 
 #if GET_TIMING
-				int64_t end_path_traverse = stitchGetClockCounter();
-				float Path_travese_time = (float)((end_path_traverse - start_path_traverse) * factor);
-				printf("Overlap::%d,%d:::Best Path Find Time-->%f (ms) Path Traverse Time--> %f (ms) \n", i, j, Path_find_time, Path_travese_time);
+			int64_t end_path_traverse = stitchGetClockCounter();
+			float Path_travese_time = (float)((end_path_traverse - start_path_traverse) * factor);
+			printf("Overlap::%d,%d:::Best Path Find Time-->%f (ms) Path Traverse Time--> %f (ms) \n", i, j, Path_find_time, Path_travese_time);
 #endif
-				horizontal_overlap++;
 #endif
-			}
 		}
+	};
+
+	//Trace the overlaps with a seam due on the current frame on separate threads
+	std::vector<vx_uint32> due_overlap;
+	for (vx_uint32 i = 0; i < arr_numitems; i++)
+	{
+		if (SeamFind_Pref[i].priority != -1 && ((SeamFind_Pref[i].start_frame == current_frame) || ((current_frame + 1) % (SeamFind_Pref[i].frequency + SeamFind_Pref[i].seam_type_num) == 0)))
+			due_overlap.push_back(i);
 	}
+	int num_due = (int)due_overlap.size();
+	std::atomic<int> next_overlap(0);
+	std::function<void()> overlap_thread_func = [&]() {
+		for (int k = next_overlap++; k < num_due; k = next_overlap++)
+			trace_overlap(due_overlap[k]);
+	};
+	data->pool.run(num_due, overlap_thread_func);
+
 	vx_array accum_seamFindPathEntry = (vx_array)parameters[5];
 	vx_size seamcut_path_size = width_eqr * arr_numitems;
-	StitchSeamFindPathEntry *StitchSeamCutPath_ptr = &SeamFind_Path[0];
 	ERROR_CHECK_STATUS(vxTruncateArray(accum_seamFindPathEntry, 0));
-	ERROR_CHECK_STATUS(vxAddArrayItems(accum_seamFindPathEntry, seamcut_path_size, StitchSeamCutPath_ptr, sizeof(StitchSeamFindPathEntry)));
+	if (seamcut_path_size > 0)
+	{
+		StitchSeamFindPathEntry *StitchSeamCutPath_ptr = &SeamFind_Path[0];
+		ERROR_CHECK_STATUS(vxAddArrayItems(accum_seamFindPathEntry, seamcut_path_size, StitchSeamCutPath_ptr, sizeof(StitchSeamFindPathEntry)));
+	}
 
 	ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, &weight_rect, 0, &weight_addr, weight_image_ptr));
 	ERROR_CHECK_STATUS(vxCommitArrayRange(SeamFindInfo, 0, arr_numitems, SeamFindInfo_ptr));
 	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_SeamFind_ACCUM, 0, SeamFind_ACCUM_max, SeamFind_Accum));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_SeamFind_Parent, 0, SeamFind_Parent_max, SeamFind_Parent));
 	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_SeamFind_Pref, 0, SeamFind_Pref_max, SeamFind_Pref));
 
-	//Release Memory
-	SeamFind_Path.clear();
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel initialize.
+static vx_status VX_CALLBACK seamfind_path_trace_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = sizeof(seamfind_path_trace_data);
+	seamfind_path_trace_data * data = new seamfind_path_trace_data();
+	data->pool.start();
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	return VX_SUCCESS;
+}
 
+//! \brief The kernel deinitialize.
+static vx_status VX_CALLBACK seamfind_path_trace_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(seamfind_path_trace_data)))
+	{
+		seamfind_path_trace_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) delete data;
+	}
 	return VX_SUCCESS;
 }
 
@@ -2920,11 +3664,11 @@ vx_status seamfind_path_trace_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_path_trace",
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_PATH_TRACE,
 		seamfind_path_trace_kernel,
-		6,
+		7,
 		seamfind_path_trace_input_validator,
 		seamfind_path_trace_output_validator,
-		nullptr,
-		nullptr);
+		seamfind_path_trace_initialize,
+		seamfind_path_trace_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = seamfind_path_trace_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = seamfind_path_trace_opencl_codegen;
@@ -2940,6 +3684,7 @@ vx_status seamfind_path_trace_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 3, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 4, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
@@ -2960,7 +3705,7 @@ static vx_status VX_CALLBACK seamfind_set_weights_input_validator(vx_node node,
 	vx_reference ref = avxGetNodeParamRef(node, index);
 	ERROR_CHECK_OBJECT(ref);
 	// validate each parameter
-	if (index == 0 || index == 1 || index == 2 || index == 3)
+	if (index == 0 || index == 1 || index == 2 || index == 3 || index == 8)
 	{ // object of SCALAR type
 		vx_enum itemtype = VX_TYPE_INVALID;
 		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
@@ -3051,21 +3796,230 @@ static vx_status VX_CALLBACK seamfind_set_weights_output_validator(vx_node node,
 	return status;
 }
 
+//! \brief The view scene change setting of a seamfind_set_weights node: optional scalar 8, same value as seamfind_scene_detect.
+static vx_int32 seamfind_set_weights_view_scene_change(vx_node node)
+{
+	vx_int32 view_scene_change = 0;
+	vx_scalar scalar = (vx_scalar)avxGetNodeParamRef(node, 8);
+	if (scalar) {
+		vx_uint32 value = 0;
+		if (vxReadScalarValue(scalar, &value) == VX_SUCCESS) view_scene_change = (vx_int32)value;
+		vxReleaseScalar(&scalar);
+	}
+	return view_scene_change;
+}
+
+//! \brief The local data of seamfind_set_weights: the weight entries grouped per seam line and the path last painted on each line.
+// A seam line is one path entry (a row of a vertical overlap or a column of a horizontal overlap): only the pixels of a
+// line between its previous and its new seam position change camera, so the rest of the line is left untouched.
+struct seamfind_set_weights_data {
+	vx_size num_entries;                                // number of weight entries the line grouping was built from
+	std::vector<vx_uint32> line_start;                  // first entry of each line in line_entry (one more item than the path entries)
+	std::vector<vx_uint32> line_entry;                  // weight entry ids sorted by line and by position along the line
+	std::vector<vx_int16> line_pos;                     // position along the line of each item in line_entry
+	std::vector<StitchSeamFindPathEntry> painted_path;  // path entry each line was last painted with
+	std::vector<vx_uint8> painted;                      // line has been painted at least once
+	int DRAW_SEAM, VIEW_SCENE_CHANGE;
+};
+
+//! \brief Group the weight entries per seam line, sorted by position along the line.
+static void seamfind_set_weights_group_lines(seamfind_set_weights_data * data, const StitchSeamFindWeightEntry * weight_entry, vx_size num_entries, vx_size num_lines, vx_uint32 width_eqr)
+{
+	data->num_entries = num_entries;
+	data->line_start.assign(num_lines + 1, 0);
+	data->line_entry.assign(num_entries, 0);
+	data->line_pos.assign(num_entries, 0);
+	data->painted_path.assign(num_lines, StitchSeamFindPathEntry());
+	data->painted.assign(num_lines, 0);
+
+	// count the entries of each line and skip the ones without a path entry
+	auto line_of = [&](const StitchSeamFindWeightEntry& e) -> vx_size {
+		return (vx_size)e.overlap_id * width_eqr + (e.overlap_type == 0 ? e.y : e.x);
+	};
+	vx_size num_valid = 0;
+	for (vx_size i = 0; i < num_entries; i++) {
+		if (weight_entry[i].overlap_type > 1 || weight_entry[i].overlap_id < 0) continue;
+		vx_size line = line_of(weight_entry[i]);
+		if (line < num_lines) { data->line_start[line + 1]++; num_valid++; }
+	}
+	for (vx_size line = 0; line < num_lines; line++)
+		data->line_start[line + 1] += data->line_start[line];
+	std::vector<vx_uint32> fill(data->line_start.begin(), data->line_start.end() - 1);
+	for (vx_size i = 0; i < num_entries; i++) {
+		if (weight_entry[i].overlap_type > 1 || weight_entry[i].overlap_id < 0) continue;
+		vx_size line = line_of(weight_entry[i]);
+		if (line < num_lines) data->line_entry[fill[line]++] = (vx_uint32)i;
+	}
+	data->line_entry.resize(num_valid);
+	data->line_pos.resize(num_valid);
+
+	// sort each line by position so that a seam move maps to a contiguous range of entries
+	for (vx_size line = 0; line < num_lines; line++) {
+		auto first = data->line_entry.begin() + data->line_start[line], last = data->line_entry.begin() + data->line_start[line + 1];
+		if (last - first > 1) {
+			std::sort(first, last, [&](vx_uint32 a, vx_uint32 b) {
+				const StitchSeamFindWeightEntry& ea = weight_entry[a], & eb = weight_entry[b];
+				return (ea.overlap_type == 0 ? ea.x : ea.y) < (eb.overlap_type == 0 ? eb.x : eb.y);
+			});
+		}
+		for (vx_uint32 k = data->line_start[line]; k < data->line_start[line + 1]; k++) {
+			const StitchSeamFindWeightEntry& e = weight_entry[data->line_entry[k]];
+			data->line_pos[k] = (e.overlap_type == 0) ? e.x : e.y;
+		}
+	}
+}
+
 //! \brief The kernel initialize.
 static vx_status VX_CALLBACK seamfind_set_weights_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
+	vx_size size = sizeof(seamfind_set_weights_data);
+	seamfind_set_weights_data * data = new seamfind_set_weights_data();
+	data->num_entries = 0;
+	data->DRAW_SEAM = 0; data->VIEW_SCENE_CHANGE = 0;
+	char textBuffer[256];
+	if (StitchGetEnvironmentVariable("DRAW_SEAM", textBuffer, sizeof(textBuffer)))	{ data->DRAW_SEAM = atoi(textBuffer); }
+	data->VIEW_SCENE_CHANGE = seamfind_set_weights_view_scene_change(node);
+#if SHOW_ALL_SEAMS
+	data->DRAW_SEAM = 1;
+#endif
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
 	return VX_SUCCESS;
 }
 //! \brief The kernel deinitialize.
 static vx_status VX_CALLBACK seamfind_set_weights_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(seamfind_set_weights_data)))
+	{
+		seamfind_set_weights_data * data = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+		if (data) delete data;
+	}
 	return VX_SUCCESS;
 }
 
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK seamfind_set_weights_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_IMPLEMENTED;
+	seamfind_set_weights_data * data = nullptr;
+	vx_size data_size = 0;
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &data_size, sizeof(data_size)));
+	if (data_size != sizeof(seamfind_set_weights_data))
+		return VX_ERROR_INVALID_NODE;
+	ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data)));
+	ERROR_CHECK_OBJECT(data);
+
+	//Scalars - Variable 0, 1, 2 & 3
+	vx_uint32 current_frame = 0, NumCam = 0, width_eqr = 0, height_eqr = 0;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &current_frame));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &NumCam));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[2], &width_eqr));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[3], &height_eqr));
+
+	//Weight Entry Array - Variable 4
+	vx_array Array_Weight = (vx_array)parameters[4];
+	vx_size weight_num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(Array_Weight, VX_ARRAY_ATTRIBUTE_NUMITEMS, &weight_num_items, sizeof(weight_num_items)));
+
+	//Path Array - Variable 5
+	vx_array Array_Path = (vx_array)parameters[5];
+	vx_size path_num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(Array_Path, VX_ARRAY_ATTRIBUTE_NUMITEMS, &path_num_items, sizeof(path_num_items)));
+
+	//Seam Find Pref Array - Variable 6
+	vx_array Array_Pref = (vx_array)parameters[6];
+	vx_size pref_num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(Array_Pref, VX_ARRAY_ATTRIBUTE_NUMITEMS, &pref_num_items, sizeof(pref_num_items)));
+
+	if (weight_num_items == 0 || path_num_items == 0 || pref_num_items == 0)
+		return VX_SUCCESS;
+
+	StitchSeamFindWeightEntry *weight_entry = nullptr;
+	vx_size stride_weight = sizeof(StitchSeamFindWeightEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_Weight, 0, weight_num_items, &stride_weight, (void **)&weight_entry, VX_READ_ONLY));
+	StitchSeamFindPathEntry *path = nullptr;
+	vx_size stride_path = sizeof(StitchSeamFindPathEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_Path, 0, path_num_items, &stride_path, (void **)&path, VX_READ_ONLY));
+	StitchSeamFindPreference *pref = nullptr;
+	vx_size stride_pref = sizeof(StitchSeamFindPreference);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_Pref, 0, pref_num_items, &stride_pref, (void **)&pref, VX_READ_ONLY));
+
+	//Weight Image - Variable 7
+	vx_image weight_image = (vx_image)parameters[7];
+	void *weight_image_ptr = nullptr; vx_rectangle_t weight_rect; vx_imagepatch_addressing_t weight_addr;
+	weight_rect.start_x = weight_rect.start_y = 0; weight_rect.end_x = width_eqr; weight_rect.end_y = height_eqr * NumCam;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(weight_image, &weight_rect, 0, &weight_addr, &weight_image_ptr, VX_READ_AND_WRITE));
+	vx_uint8 *weight_ptr = (vx_uint8 *)weight_image_ptr;
+	vx_uint32 weight_stride = (vx_uint32)weight_addr.stride_y;
+
+	// the weight entries are fixed by the stitch configuration: group them once per line
+	if (data->num_entries != weight_num_items || data->painted.size() != path_num_items)
+		seamfind_set_weights_group_lines(data, weight_entry, weight_num_items, path_num_items, width_eqr);
+
+	//Paint a weight entry from the side of the seam it is on (same values as the OpenCL kernel)
+	auto paint_entry = [&](const StitchSeamFindWeightEntry& e, const StitchSeamFindPathEntry& p, const StitchSeamFindPreference& pr)
+	{
+		vx_uint8 * ID1 = weight_ptr + (e.y + e.cam_id_1 * height_eqr) * weight_stride + e.x;
+		vx_uint8 * ID2 = weight_ptr + (e.y + e.cam_id_2 * height_eqr) * weight_stride + e.x;
+		vx_int16 pos = (e.overlap_type == 0) ? e.x : e.y;
+#if !SHOW_ALL_SEAMS
+		bool start_side = (pos >= p.min_pixel);
+		bool i_start = (p.weight_value_i == 255);
+		*ID1 = (start_side == i_start) ? 255 : 0;
+		*ID2 = (start_side == i_start) ? 0 : 255;
+		if (data->VIEW_SCENE_CHANGE) {
+			if (pr.scene_flag == 2) { *ID1 = 50; *ID2 = 50; }
+			else if (pr.scene_flag == 3) { *ID1 = 255; *ID2 = 255; }
+		}
+		for (vx_uint32 cam = 0; cam < NumCam; cam++)
+			if (cam != (vx_uint32)e.cam_id_1 && cam != (vx_uint32)e.cam_id_2)
+				weight_ptr[(e.y + cam * height_eqr) * weight_stride + e.x] = 0;
+#endif
+		if (data->DRAW_SEAM == 1 && pos == p.min_pixel) { *ID1 = 0; *ID2 = 0; }
+		else if (data->DRAW_SEAM == 2 && pos == p.min_pixel) { *ID1 = 255; *ID2 = 255; }
+	};
+
+	//Repaint only the entries whose camera assignment changed since the last seam of their line
+	for (vx_size line = 0; line < path_num_items; line++)
+	{
+		vx_uint32 first = data->line_start[line], last = data->line_start[line + 1];
+		if (first == last) continue;
+		const StitchSeamFindWeightEntry& e0 = weight_entry[data->line_entry[first]];
+		if ((vx_size)e0.overlap_id >= pref_num_items) continue;
+#if !ENABLE_VERTICAL_SEAM
+		if (e0.overlap_type == 0) continue;
+#endif
+#if !ENABLE_HORIZONTAL_SEAM
+		if (e0.overlap_type == 1) continue;
+#endif
+		const StitchSeamFindPreference& pr = pref[e0.overlap_id];
+		if (!(pr.priority != -1 && (((vx_uint32)pr.start_frame == current_frame) || ((current_frame + 1) % (pr.frequency + pr.seam_type_num) == 0))))
+			continue;
+
+		const StitchSeamFindPathEntry& p = path[line];
+		StitchSeamFindPathEntry& old = data->painted_path[line];
+		if (data->painted[line] && !data->VIEW_SCENE_CHANGE && old.weight_value_i == p.weight_value_i)
+		{
+			if (old.min_pixel == p.min_pixel) continue;
+			// only the entries between the previous and the new seam position (both included for DRAW_SEAM) change
+			vx_int16 lo = std::min(old.min_pixel, p.min_pixel), hi = std::max(old.min_pixel, p.min_pixel);
+			const vx_int16 * pos = data->line_pos.data();
+			first = (vx_uint32)(std::lower_bound(pos + first, pos + last, lo) - pos);
+			last = (vx_uint32)(std::upper_bound(pos + first, pos + last, hi) - pos);
+		}
+		for (vx_uint32 k = first; k < last; k++)
+			paint_entry(weight_entry[data->line_entry[k]], p, pr);
+		old = p;
+		data->painted[line] = 1;
+	}
+
+	ERROR_CHECK_STATUS(vxCommitImagePatch(weight_image, &weight_rect, 0, &weight_addr, weight_image_ptr));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_Pref, 0, pref_num_items, pref));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_Path, 0, path_num_items, path));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(Array_Weight, 0, weight_num_items, weight_entry));
+
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel target support callback.
@@ -3074,7 +4028,14 @@ static vx_status VX_CALLBACK seamfind_set_weights_query_target_support(vx_graph
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	char textBuffer[256];
+	int SEAM_FIND_TARGET = 0;
+	if (StitchGetEnvironmentVariable("SEAM_FIND_TARGET", textBuffer, sizeof(textBuffer))) { SEAM_FIND_TARGET = atoi(textBuffer); }
+
+	if (!SEAM_FIND_TARGET)
+		supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
+	else
+		supported_target_affinity = AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -3123,10 +4084,12 @@ static vx_status VX_CALLBACK seamfind_set_weights_opencl_codegen(
 	ERROR_CHECK_STATUS(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &arr_capacity, sizeof(arr_capacity)));
 	ERROR_CHECK_STATUS(vxReleaseArray(&arr));
 
-	int DRAW_SEAM = 0, VIEW_SCENE_CHANGE = 0;
+	int DRAW_SEAM = 0, VIEW_SCENE_CHANGE = seamfind_set_weights_view_scene_change(node);
 	char textBuffer[256];
 	if (StitchGetEnvironmentVariable("DRAW_SEAM", textBuffer, sizeof(textBuffer)))	{ DRAW_SEAM = atoi(textBuffer); }
-	if (StitchGetEnvironmentVariable("VIEW_SCENE_CHANGE", textBuffer, sizeof(textBuffer)))	{ VIEW_SCENE_CHANGE = atoi(textBuffer); }
+	vx_scalar view_scene_change = (vx_scalar)avxGetNodeParamRef(node, 8);
+	bool has_view_scene_change = view_scene_change ? true : false;
+	if (view_scene_change) ERROR_CHECK_STATUS(vxReleaseScalar(&view_scene_change));
 
 #if SHOW_ALL_SEAMS
 	DRAW_SEAM = 1;
@@ -3159,8 +4122,8 @@ static vx_status VX_CALLBACK seamfind_set_weights_opencl_codegen(
 		"        __global char * valid_pix_buf, uint valid_pix_buf_offset, uint valid_pix_num_items,\n"
 		"        __global char * path_buf, uint path_buf_offset, uint path_num_items,\n"
 		"		 __global char * seam_pref_buf, uint seam_pref_buf_offset, uint seam_pref_num_items,\n"
-		"        uint weight_width, uint weight_height, __global uchar * weight_buf, uint weight_stride, uint weight_offset)\n"
-		, opencl_local_work[0], opencl_kernel_function_name);
+		"        uint weight_width, uint weight_height, __global uchar * weight_buf, uint weight_stride, uint weight_offset%s)\n"
+		, opencl_local_work[0], opencl_kernel_function_name, has_view_scene_change ? ", uint view_scene_change" : "");
 	opencl_kernel_code = item;
 	opencl_kernel_code +=
 		"{\n"
@@ -3439,7 +4402,7 @@ vx_status seamfind_set_weights_publish(vx_context context)
 	vx_kernel kernel = vxAddKernel(context, "com.amd.loomsl.seamfind_set_weights",
 		AMDOVX_KERNEL_STITCHING_SEAMFIND_SET_WEIGHTS,
 		seamfind_set_weights_kernel,
-		8,
+		9,
 		seamfind_set_weights_input_validator,
 		seamfind_set_weights_output_validator,
 		seamfind_set_weights_initialize,
@@ -3462,6 +4425,7 @@ vx_status seamfind_set_weights_publish(vx_context context)
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 5, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 6, VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED));
 	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 7, VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED));
+	ERROR_CHECK_STATUS(vxAddParameterToKernel(kernel, 8, VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL));
 
 	// finalize and release kernel object
 	ERROR_CHECK_STATUS(vxFinalizeKernel(kernel));
@@ -3525,6 +4489,7 @@ static vx_status VX_CALLBACK seamfind_analyze_output_validator(vx_node node, vx_
 		ERROR_CHECK_STATUS(vxQueryScalar((vx_scalar)ref, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
 
 		if (itemtype == VX_TYPE_UINT32) {
+			ERROR_CHECK_STATUS(vxSetMetaFormatAttribute(meta, VX_SCALAR_ATTRIBUTE_TYPE, &itemtype, sizeof(itemtype)));
 			status = VX_SUCCESS;
 		}
 		else {
@@ -3547,18 +4512,23 @@ static vx_status VX_CALLBACK seamfind_analyze_kernel(vx_node node, const vx_refe
 	vx_array Array_SeamFind_Pref = (vx_array)parameters[1];
 	vx_size SeamFind_Pref_max = 0;
 	ERROR_CHECK_STATUS(vxQueryArray(Array_SeamFind_Pref, VX_ARRAY_ATTRIBUTE_NUMITEMS, &SeamFind_Pref_max, sizeof(SeamFind_Pref_max)));
-	StitchSeamFindPreference *SeamFind_Pref = nullptr;
-	vx_size stride_pref = sizeof(StitchSeamFindPreference);
-	ERROR_CHECK_STATUS(vxAccessArrayRange(Array_SeamFind_Pref, 0, SeamFind_Pref_max, &stride_pref, (void **)&SeamFind_Pref, VX_READ_ONLY));
-
 	vx_uint32 flag = 0;
-
-	for (int i = 0; i < SeamFind_Pref_max; i++)
+	if (SeamFind_Pref_max > 0)
 	{
-		if (SeamFind_Pref[i].start_frame == current_frame) flag++;
-		else if ((current_frame + 1) % (SeamFind_Pref[i].frequency + SeamFind_Pref[i].seam_type_num) == 0) flag++;
+		StitchSeamFindPreference *SeamFind_Pref = nullptr;
+		vx_size stride_pref = sizeof(StitchSeamFindPreference);
+		ERROR_CHECK_STATUS(vxAccessArrayRange(Array_SeamFind_Pref, 0, SeamFind_Pref_max, &stride_pref, (void **)&SeamFind_Pref, VX_READ_ONLY));
 
-		if (flag) break;
+		// same condition as the accumulate, path trace, and set weights kernels
+		for (vx_size i = 0; i < SeamFind_Pref_max; i++)
+		{
+			if (SeamFind_Pref[i].priority == -1) continue;
+			if (SeamFind_Pref[i].start_frame == current_frame) flag++;
+			else if ((current_frame + 1) % (SeamFind_Pref[i].frequency + SeamFind_Pref[i].seam_type_num) == 0) flag++;
+
+			if (flag) break;
+		}
+		ERROR_CHECK_STATUS(vxCommitArrayRange(Array_SeamFind_Pref, 0, SeamFind_Pref_max, SeamFind_Pref));
 	}
 
 	vx_scalar Scalar_flag = (vx_scalar)parameters[2];
@@ -3593,339 +4563,146 @@ vx_status seamfind_analyze_publish(vx_context context)
 	return VX_SUCCESS;
 }
 
-//! \brief The local data to calculate the overlapping images.
-#define MAX_CAM_OVERLAP 6
-struct stitch_init_data {
-	vx_uint8 Num_camera = 0;
-	vx_uint8 Camera_ID[MAX_CAM_OVERLAP];
-	float Z_value[MAX_CAM_OVERLAP];
-};
-//! \brief Function to Compute M.
-static void ComputeM(float * M, float th, float fi, float sy)
-{
-	float sth = sinf(th), cth = cosf(th);
-	float sfi = sinf(fi), cfi = cosf(fi);
-	float ssy = sinf(sy), csy = cosf(sy);
-	M[0] = sth*ssy*sfi + cth*csy; M[1] = ssy*cfi; M[2] = cth*ssy*sfi - sth*csy;
-	M[3] = sth*csy*sfi - cth*ssy; M[4] = csy*cfi; M[5] = cth*csy*sfi + sth*ssy;
-	M[6] = sth    *cfi;          M[7] = -sfi;     M[8] = cth    *cfi;
-}
-//! \brief Matix Multiplication Function.
-static void MatMul3x3(float * C, const float * A, const float * B)
-{
-	const float * At = A;
-	for (int i = 0; i < 3; i++, At += 3) {
-		const float * Bt = B;
-		for (int j = 0; j < 3; j++, Bt++, C++) {
-			*C = At[0] * Bt[0] + At[1] * Bt[3] + At[2] * Bt[6];
-		}
-	}
-}
-//! \brief Matix Multiplication Function.
-static void MatMul3x1(float * Y, const float * M, const float * X)
-{
-	Y[0] = M[0] * X[0] + M[1] * X[1] + M[2] * X[2];
-	Y[1] = M[3] * X[0] + M[4] * X[1] + M[5] * X[2];
-	Y[2] = M[6] * X[0] + M[7] * X[1] + M[8] * X[2];
-}
-
 //! \brief SeamFind Utility Function to set sizes.
-vx_status seamfind_accurate_utility(vx_uint32 mode, vx_uint32 num_cam, vx_uint32 ip_width, vx_uint32 ip_height, vx_uint32 eqr_width, vx_matrix mat_rig_params, vx_array array_cam_params, SeamFindSizeInfo *entry_var)
+// mode 0 & 1 are the conservative and liberal allocations of seamfind_utility. mode 2 computes the sizes from the
+// overlap rectangles of the rig: the camera footprints are generated with the same projection and valid region test
+// as initialize_stitch_config, and the rectangles are used before they are reduced by the overlap_rectangle attribute,
+// so the sizes are an upper bound of the entries generated by initialize_stitch_config for the same parameters.
+vx_status seamfind_accurate_utility(vx_uint32 mode, vx_uint32 num_cam, vx_uint32 num_buff_cols, vx_uint32 ip_width, vx_uint32 ip_height, vx_uint32 eqr_width, vx_matrix mat_rig_params, vx_array array_cam_params, SeamFindSizeInfo *entry_var)
 {
-	if (eqr_width <= 0 || num_cam <= 0) return VX_FAILURE;
+	if (eqr_width <= 0 || num_cam <= 0 || num_buff_cols <= 0) return VX_FAILURE;
+	if (mode != 2) return seamfind_utility(mode, eqr_width, num_cam, entry_var);
 
 	vx_uint32 eqr_height = (eqr_width >> 1);
-	//Conservative Allocation of memory
-	if (mode == 0)
-	{
-		entry_var->accum_entry = (vx_uint32)(eqr_width * eqr_height * num_cam * 0.5);
-		entry_var->valid_entry = (vx_uint32)(eqr_width * eqr_height * 0.1);
-		entry_var->weight_entry = (vx_uint32)(eqr_width * eqr_height * num_cam * 0.25);
-		entry_var->pref_entry = (vx_uint32)(num_cam * num_cam * 0.5);
-		entry_var->info_entry = (vx_uint32)(num_cam * num_cam * 0.5);
-		entry_var->path_entry = (vx_uint32)(eqr_width * num_cam * num_cam * 0.5);
-	}
-	//Liberal Allocation of memory
-	else if (mode == 1)
+	rig_params rig_par;
+	ERROR_CHECK_STATUS(vxReadMatrix(mat_rig_params, &rig_par));
+	std::vector<camera_params> cam_par(num_cam);
+	camera_params *cam_par_ptr = nullptr;
+	vx_size stride_cam = sizeof(camera_params);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(array_cam_params, 0, num_cam, &stride_cam, (void **)&cam_par_ptr, VX_READ_ONLY));
+	for (vx_uint32 cam = 0; cam < num_cam; cam++)
+		cam_par[cam] = *(camera_params *)((vx_uint8 *)cam_par_ptr + cam * stride_cam);
+	ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam_params, 0, num_cam, cam_par_ptr));
+
+	// setup the projection of each camera
+	std::vector<stitch_projection_camera> proj(num_cam);
+	for (vx_uint32 cam = 0; cam < num_cam; cam++)
 	{
-		entry_var->valid_entry = (vx_uint32)(eqr_width * eqr_height);
-		entry_var->weight_entry = (vx_uint32)(eqr_width * eqr_height * num_cam);
-		entry_var->accum_entry = (vx_uint32)(eqr_width * eqr_height * num_cam);
-		entry_var->pref_entry = (vx_uint32)(num_cam * num_cam);
-		entry_var->info_entry = (vx_uint32)(num_cam * num_cam);
-		entry_var->path_entry = (vx_uint32)(eqr_width * num_cam * num_cam);
-	}
-	else
-	{
-		rig_params rig_par;
-		ERROR_CHECK_STATUS(vxReadMatrix(mat_rig_params, &rig_par));
-		camera_params *cam_par = nullptr;
-		vx_size stride_cam = sizeof(camera_params);
-		ERROR_CHECK_STATUS(vxAccessArrayRange(array_cam_params, 0, num_cam, &stride_cam, (void **)&cam_par, VX_READ_ONLY));
-
-		//Internal Data Variables - Overlap Calculate Data & Valid Region Rectangles
-		std::vector<stitch_init_data> stitch_component;
-		stitch_component.resize(eqr_width*eqr_height);
-		std::vector<vx_rectangle_t> Rectangle;
-		Rectangle.resize(num_cam);
-
-		//Calculate Simple MASK image 
-		vx_image mask_image = vxCreateImage(vxGetContext((vx_reference)array_cam_params), eqr_width, eqr_height*num_cam, VX_DF_IMAGE_U8);
-		void *mask_image_ptr = NULL; vx_rectangle_t mask_rect; vx_imagepatch_addressing_t mask_addr;
-		vx_int32 width = 0, height = 0;	vx_uint32 plane = 0;
-		ERROR_CHECK_STATUS(vxQueryImage(mask_image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
-		ERROR_CHECK_STATUS(vxQueryImage(mask_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
-		mask_rect.start_x = mask_rect.start_y = 0; mask_rect.end_x = width; mask_rect.end_y = height;
-		ERROR_CHECK_STATUS(vxAccessImagePatch(mask_image, &mask_rect, plane, &mask_addr, &mask_image_ptr, VX_READ_AND_WRITE));
-		vx_uint8 *MASK_ptr = (vx_uint8*)mask_image_ptr;
-
-		//Calculate ROI FOR EACH OVERLAP - Used in Seam Find - Optional Output
-		std::vector<vx_rectangle_t> VX_Overlap_ROI;
-		vx_uint32 max_roi = num_cam*num_cam;
-		VX_Overlap_ROI.resize(max_roi);
-		for (vx_uint32 i = 0; i < max_roi; i++)	{
-			VX_Overlap_ROI[i].start_x = eqr_width; VX_Overlap_ROI[i].end_x = 0;
-			VX_Overlap_ROI[i].start_y = eqr_height; VX_Overlap_ROI[i].end_y = 0;
+		if (stitchProjectionSetup(&proj[cam], &rig_par, &cam_par[cam], cam, num_buff_cols, ip_width, ip_height) != VX_SUCCESS) { // unsupported lens
+			vxAddLogEntry((vx_reference)array_cam_params, VX_ERROR_INVALID_TYPE, "ERROR: SEAM_FIND_UTILITY: lens_type = %d not supported [cam#%d]\n", cam_par[cam].lens.lens_type, cam);
+			return VX_ERROR_INVALID_TYPE;
 		}
-		/***********************************************************************************************************************************
-		Generate Warp tables for each Camera using warp and lens parameters
-		************************************************************************************************************************************/
-		// pre-compute M & T of each camera
-		float * Mcam = new float[num_cam * 9];
-		float * Tcam = new float[num_cam * 3];
-		float * fcam = new float[num_cam * 2];
-		float Mr[9];
-		float deg2rad = (float)M_PI / 180.0f;
-		ComputeM(Mr, rig_par.yaw * deg2rad, rig_par.pitch * deg2rad, rig_par.roll * deg2rad);
-
-		for (int cam = 0; cam <(int) num_cam; cam++)
-		{
-			float Mc[9];
-			ComputeM(Mc, cam_par[cam].focal.yaw * deg2rad, cam_par[cam].focal.pitch * deg2rad, cam_par[cam].focal.roll * deg2rad);
-			MatMul3x3(&Mcam[cam * 9], Mc, Mr);
-			if (rig_par.d > 0.0f) {
-				Tcam[cam * 3 + 0] = cam_par[cam].focal.tx / rig_par.d;
-				Tcam[cam * 3 + 1] = cam_par[cam].focal.ty / rig_par.d;
-				Tcam[cam * 3 + 2] = cam_par[cam].focal.tz / rig_par.d;
-			}
-			else {
-				Tcam[cam * 3 + 0] = Tcam[cam * 3 + 1] = Tcam[cam * 3 + 2] = 0.0f;
-			}
-			if (cam_par[cam].lens.lens_type == 0) { // ptgui rectilinear
-				fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-				fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-			}
-			else if (cam_par[cam].lens.lens_type == 1 || cam_par[cam].lens.lens_type == 2) { // ptgui fisheye
-				fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-				fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-				if (cam_par[cam].lens.lens_type == 2 && cam_par[cam].lens.r_crop <= 0.0f)
-					vxAddLogEntry((vx_reference)array_cam_params, VX_ERROR_INVALID_TYPE, "WARNING: SEAM_FIND_UTILITY: Camera:%d -- Circular Fisheye Lens without r_crop=%0.2f is not fully supported.\n", cam, cam_par[cam].lens.r_crop);
-			}
-			else if (cam_par[cam].lens.lens_type == 3) { // adobe rectilinear
-				fcam[cam * 2 + 0] = 1.0f / tanf(0.5f * cam_par[cam].lens.hfov * deg2rad);
-				fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-			}
-			else if (cam_par[cam].lens.lens_type == 4) { // adobe fisheye
-				fcam[cam * 2 + 0] = 1.0f / (0.5f * cam_par[cam].lens.hfov * deg2rad);
-				fcam[cam * 2 + 1] = 0.5f * cam_par[cam].lens.haw;
-			}
-			else{ // unsupported lens
-				vxAddLogEntry((vx_reference)array_cam_params, VX_ERROR_INVALID_TYPE, "ERROR: SEAM_FIND_UTILITY: lens_type = %d not supported [cam#%d]\n", cam_par[cam].lens.lens_type, cam);
-				return VX_ERROR_INVALID_TYPE;
-			}
-		}
-		// compute warp pixel map
-		float pi_by_h = (float)M_PI / (float)eqr_height;
-		float width2 = (float)eqr_width * 0.5f, height2 = (float)eqr_height * 0.5f;
-		const float * T = Tcam, *M = Mcam, *f = fcam;
-		int  array_var_counter = 0; // optimized warp variable
-
-		for (int cam = 0; cam < (int)num_cam; cam++, T += 3, M += 9, f += 2)
-		{
-			vx_uint32 yw_offset = cam * eqr_height;
-
-			for (int y = 0; y < (int)eqr_height; y++)
-			{
-				float pe = (float)y * pi_by_h - (float)M_PI_2;
-				float sin_pe = sinf(pe);
-				float cos_pe = cosf(pe);
-				for (int x = 0; x < (int)eqr_width; x++)
-				{
-					float xd, yd;
-
-					float te = (float)x * pi_by_h - (float)M_PI;
-					float sin_te = sinf(te);
-					float cos_te = cosf(te);
-					float X[3] = { sin_te*cos_pe, sin_pe, cos_te*cos_pe };
-
-					const camera_params * par = &cam_par[cam];
-					float Xt[3] = { X[0] - T[0], X[1] - T[1], X[2] - T[2] };
-					float nfactor = sqrtf(Xt[0] * Xt[0] + Xt[1] * Xt[1] + Xt[2] * Xt[2]);
-					Xt[0] /= nfactor;
-					Xt[1] /= nfactor;
-					Xt[2] /= nfactor;
-					float Y[3];
-					MatMul3x1(Y, M, Xt);
-
-					if (Y[2] > 0.0f)
-					{
-						float ph = atan2f(Y[1], Y[0]);
-						float th = asinf(sqrtf(Y[0] * Y[0] + Y[1] * Y[1]));
-						float rd = 0.0f;
-						if (par->lens.lens_type == 0)
-						{ // ptgui rectilinear
-							float a = par->lens.k1;
-							float b = par->lens.k2;
-							float c = par->lens.k3;
-							float d = 1.0f - a - b - c;
-							float r = tanf(th) * f[0];
-							rd = r * (d + r * (c + r * (b + r * a)));
-						}
-						else if (par->lens.lens_type == 1 || par->lens.lens_type == 2)
-						{ // ptgui fisheye circ
-							float a = par->lens.k1;
-							float b = par->lens.k2;
-							float c = par->lens.k3;
-							float d = 1.0f - a - b - c;
-							float r = th * f[0];
-							rd = r * (d + r * (c + r * (b + r * a)));
-						}
-						else if (par->lens.lens_type == 3)
-						{ // adobe rectilinear
-							float r = tanf(th) * f[0], r2 = r * r;
-							rd = r * (1 + r2 * (par->lens.k1 + r2 * (par->lens.k2 + r2 * par->lens.k3)));
-						}
-						else if (par->lens.lens_type == 4)
-						{ // adobe fisheye
-							float r = th * f[0], r2 = r * r;
-							rd = r * (1 + r2 * (par->lens.k1 + r2 * par->lens.k2));
-						}
-						xd = f[1] * rd * cosf(ph);
-						yd = f[1] * rd * sinf(ph);
-						float rr = sqrtf(xd*xd + yd*yd);
-
-						xd = width2 + par->lens.du0 + xd;
-						yd = height2 + par->lens.dv0 + yd;
-
-						if (xd >= 0 && xd < ip_width && yd >= 0 && yd < ip_height && (par->lens.r_crop <= 0.0f || rr <= par->lens.r_crop))
-						{
-							int ID = (y * eqr_width) + x;
-							
-							if (stitch_component[ID].Num_camera >= 5 && 0){
-								vxAddLogEntry((vx_reference)mask_image, VX_ERROR_INVALID_VALUE, "ERROR: SEAM_FIND_UTILITY: check camera parameters, camera overlaps greater than 5 not supported in this release\n");
-								return VX_ERROR_INVALID_VALUE;
-							}
+	}
 
-							stitch_component[ID].Camera_ID[stitch_component[ID].Num_camera] = cam;
-							stitch_component[ID].Num_camera++;
-							// set mask image
-							int MASK_ID = ((y + yw_offset)*eqr_width) + x;
-							MASK_ptr[MASK_ID] = 255;
-						}
-					}
-				}
-			}					
+	// camera footprints in the equirectangular output, one row at a time: the cameras covering a pixel are a bitmask
+	// of the row, and each thread keeps the overlap rectangle and the number of overlapping pixels of each camera pair
+	stitch_projection_columns columns;
+	stitchProjectionColumns(&columns, eqr_width, eqr_height);
+	int src_width = (int)ip_width, height = (int)ip_height;
+	vx_uint32 max_roi = num_cam * num_cam, mask_words = (num_cam + 31) / 32;
+	struct overlap_state {
+		std::vector<vx_rectangle_t> roi;    // overlap rectangle of each camera pair
+		std::vector<vx_uint32> count;       // number of pixels covered by both cameras of each pair
+	};
+	stitch_thread_pool pool;
+	pool.start();
+	std::vector<overlap_state> state(pool.worker.size() + 1);
+	std::atomic<int> next_row(0), next_state(0);
+	int num_rows = (int)eqr_height;
+	std::function<void()> row_thread_func = [&]() {
+		overlap_state& st = state[next_state++];
+		st.roi.resize(max_roi);
+		for (vx_uint32 i = 0; i < max_roi; i++) {
+			st.roi[i].start_x = eqr_width; st.roi[i].end_x = 0;
+			st.roi[i].start_y = eqr_height; st.roi[i].end_y = 0;
 		}
-
-		for (vx_uint32 ye = 0; ye < eqr_height; ye++)
-		for (vx_uint32 xe = 0; xe < eqr_width; xe++)
-		{
-			int ID = (ye*eqr_width) + xe;
-			vx_uint8 cam_id = -1;
-
-			if (stitch_component[ID].Num_camera > 1)
-			{
-				float Z = -1;
-
-				for (int i = 0; i < stitch_component[ID].Num_camera; i++)
+		st.count.assign(max_roi, 0);
+		vx_size padded_width = columns.sin_te.size();
+		std::vector<float> row(padded_width * 4);
+		std::vector<vx_uint32> row_mask(eqr_width * mask_words);
+		std::vector<vx_uint32> cam_list(num_cam);
+		float * row_xd = &row[0], * row_yd = row_xd + padded_width, * row_rr = row_yd + padded_width, * row_z = row_rr + padded_width;
+		for (int y = next_row++; y < num_rows; y = next_row++) {
+			std::fill(row_mask.begin(), row_mask.end(), 0);
+			for (vx_uint32 cam = 0; cam < num_cam; cam++) {
+				const camera_params * par = &cam_par[cam];
+				int src_width_start = ((cam % num_buff_cols) * src_width);
+				int src_width_end = (((cam % num_buff_cols) + 1) * src_width) - 1;
+				stitchProjectRow(&proj[cam], &columns, y, row_xd, row_yd, row_rr, row_z);
+				vx_uint32 word = cam >> 5, bit = 1u << (cam & 31);
+				for (int x = 0; x < (int)eqr_width; x++)
 				{
-					for (int j = i + 1; j < stitch_component[ID].Num_camera; j++)
-					{
-						// Calculate ROI ARRAY Variables 
-						int cam1 = stitch_component[ID].Camera_ID[i];
-						int cam2 = stitch_component[ID].Camera_ID[j];
-						if ((cam1 >= (int)(num_cam)) || (cam2 >= (int)(num_cam))){
-							vxAddLogEntry((vx_reference)mask_image, VX_ERROR_INVALID_VALUE, "ERROR: SEAM_FIND_UTILITY: check camera parameters, out of bound memory access\n");
-							return VX_ERROR_INVALID_VALUE;
-						}
-
-						int ROI_ID1 = (cam1 * num_cam) + cam2;
-						int ROI_ID2 = (cam2 * num_cam) + cam1;
-						if (xe < VX_Overlap_ROI[ROI_ID1].start_x){ VX_Overlap_ROI[ROI_ID1].start_x = xe; VX_Overlap_ROI[ROI_ID2].start_x = xe; }
-						if (xe > VX_Overlap_ROI[ROI_ID1].end_x){ VX_Overlap_ROI[ROI_ID1].end_x = xe; VX_Overlap_ROI[ROI_ID2].end_x = xe; }
-						if (ye < VX_Overlap_ROI[ROI_ID1].start_y){ VX_Overlap_ROI[ROI_ID1].start_y = ye; VX_Overlap_ROI[ROI_ID2].start_y = ye; }
-						if (ye > VX_Overlap_ROI[ROI_ID1].end_y){ VX_Overlap_ROI[ROI_ID1].end_y = ye; VX_Overlap_ROI[ROI_ID2].end_y = ye; }
-					}				
+					float xd = row_xd[x], yd = row_yd[x];
+					if (row_z[x] > 0.0f && xd >= src_width_start && xd < src_width_end && yd >= 0 && yd < height - 1 && (par->lens.r_crop <= 0.0f || row_rr[x] <= par->lens.r_crop))
+						row_mask[x * mask_words + word] |= bit;
 				}
 			}
-		}
-		
-		vx_uint32 accumulation_entry_offset = 0, seamfind_valid_entry_count = 0, seamfind_weight_entry_count = 0, overlap_number = 0;
-
-		for (vx_uint32 i = 0; i < num_cam; i++)
-		for (vx_uint32 j = i + 1; j < num_cam; j++)
-		{
-			vx_uint32 ID = (i * num_cam) + j;
-			if (VX_Overlap_ROI[ID].start_x != eqr_width && VX_Overlap_ROI[ID].end_x != 0)
+			for (vx_uint32 xe = 0; xe < eqr_width; xe++)
 			{
-				vx_int16 y_dir = VX_Overlap_ROI[ID].end_y - VX_Overlap_ROI[ID].start_y;
-				vx_int16 x_dir = VX_Overlap_ROI[ID].end_x - VX_Overlap_ROI[ID].start_x;
-				vx_uint32 offset_1 = i * eqr_height;
-				vx_uint32 offset_2 = j * eqr_height;
-
-				if (y_dir >= x_dir)// vertical seam
-				{
-					for (vx_uint32 xe = VX_Overlap_ROI[ID].start_x; xe <= VX_Overlap_ROI[ID].end_x; xe++)
-						seamfind_valid_entry_count++;
-
-					//SeamFind Set Weight Work Items
-					for (vx_uint32 ye = VX_Overlap_ROI[ID].start_y; ye <= VX_Overlap_ROI[ID].end_y; ye++)
-					for (vx_uint32 xe = VX_Overlap_ROI[ID].start_x; xe <= VX_Overlap_ROI[ID].end_x; xe++)
-					{
-						vx_uint32 pixel_id_1 = ((ye + offset_1) * eqr_width) + xe;
-						vx_uint32 pixel_id_2 = ((ye + offset_2) * eqr_width) + xe;
-						if (MASK_ptr[pixel_id_1] && MASK_ptr[pixel_id_2])
-							seamfind_weight_entry_count++;
-
+				vx_uint32 count = 0;
+				for (vx_uint32 w = 0; w < mask_words; w++) {
+					for (vx_uint32 m = row_mask[xe * mask_words + w], cam = w * 32; m; m >>= 1, cam++) {
+						if (m & 1) cam_list[count++] = cam;
 					}
-
-					accumulation_entry_offset += ((x_dir + 1) * (y_dir + 1));
 				}
-				else if (x_dir > y_dir && !(cam_par[i].lens.lens_type == 2 && cam_par[j].lens.lens_type == 2)) // horizontal seams for non-circular fisheye lens
+				for (vx_uint32 i = 0; i < count; i++)
+				for (vx_uint32 j = i + 1; j < count; j++)
 				{
-					for (vx_uint32 ye = VX_Overlap_ROI[ID].start_y; ye <= VX_Overlap_ROI[ID].end_y; ye++)
-						seamfind_valid_entry_count++;
-
-					//SeamFind Set Weight Work Items
-					for (vx_uint32 ye = VX_Overlap_ROI[ID].start_y; ye <= VX_Overlap_ROI[ID].end_y; ye++)
-					for (vx_uint32 xe = VX_Overlap_ROI[ID].start_x; xe <= VX_Overlap_ROI[ID].end_x; xe++)
-					{
-						vx_uint32 pixel_id_1 = ((ye + offset_1) * eqr_width) + xe;
-						vx_uint32 pixel_id_2 = ((ye + offset_2) * eqr_width) + xe;
-						if (MASK_ptr[pixel_id_1] && MASK_ptr[pixel_id_2])
-							seamfind_weight_entry_count++;		
-					}
-
-					accumulation_entry_offset += ((x_dir + 1) * (y_dir + 1));
+					vx_uint32 pair = (cam_list[i] * num_cam) + cam_list[j];
+					vx_rectangle_t * roi = &st.roi[pair];
+					if (xe < roi->start_x) roi->start_x = xe;
+					if (xe > roi->end_x) roi->end_x = xe;
+					if ((vx_uint32)y < roi->start_y) roi->start_y = y;
+					if ((vx_uint32)y > roi->end_y) roi->end_y = y;
+					st.count[pair]++;
 				}
-				//Number of Overlaps
-				overlap_number++;
 			}
 		}
+	};
+	pool.run(num_rows, row_thread_func);
+
+	// overlap rectangle and number of overlapping pixels of each camera pair
+	std::vector<vx_rectangle_t> VX_Overlap_ROI(max_roi);
+	std::vector<vx_uint32> overlap_count(max_roi, 0);
+	for (vx_uint32 i = 0; i < max_roi; i++) {
+		VX_Overlap_ROI[i].start_x = eqr_width; VX_Overlap_ROI[i].end_x = 0;
+		VX_Overlap_ROI[i].start_y = eqr_height; VX_Overlap_ROI[i].end_y = 0;
+	}
+	for (size_t t = 0; t < state.size(); t++) {
+		if (state[t].roi.empty()) continue;		// thread didn't join the job
+		for (vx_uint32 i = 0; i < max_roi; i++) {
+			const vx_rectangle_t * r = &state[t].roi[i];
+			vx_rectangle_t * roi = &VX_Overlap_ROI[i];
+			roi->start_x = std::min(roi->start_x, r->start_x); roi->end_x = std::max(roi->end_x, r->end_x);
+			roi->start_y = std::min(roi->start_y, r->start_y); roi->end_y = std::max(roi->end_y, r->end_y);
+			overlap_count[i] += state[t].count[i];
+		}
+	}
 
-		entry_var->accum_entry = accumulation_entry_offset;
-		entry_var->valid_entry = seamfind_valid_entry_count;
-		entry_var->weight_entry = seamfind_weight_entry_count;
-		entry_var->pref_entry = overlap_number;
-		entry_var->info_entry = overlap_number;
-		entry_var->path_entry = (vx_uint32)(eqr_width * overlap_number);
-
-		delete[] Mcam;
-		delete[] Tcam;
-		delete[] fcam;
-		ERROR_CHECK_STATUS(vxCommitArrayRange(array_cam_params, 0, num_cam, cam_par));
-		ERROR_CHECK_STATUS(vxCommitImagePatch(mask_image, &mask_rect, 0, &mask_addr, mask_image_ptr));
+	// entries of each overlap: the number of valid entries uses the smaller dimension of the rectangle
+	// since the seam direction is decided on the reduced rectangle
+	vx_uint32 accumulation_entry_offset = 0, seamfind_valid_entry_count = 0, seamfind_weight_entry_count = 0, overlap_number = 0;
+	for (vx_uint32 i = 0; i < num_cam; i++)
+	for (vx_uint32 j = i + 1; j < num_cam; j++)
+	{
+		const vx_rectangle_t * roi = &VX_Overlap_ROI[(i * num_cam) + j];
+		if (roi->start_x > roi->end_x || roi->start_y > roi->end_y)
+			continue;
+		vx_uint32 y_dir = roi->end_y - roi->start_y;
+		vx_uint32 x_dir = roi->end_x - roi->start_x;
+		seamfind_valid_entry_count += std::min(x_dir, y_dir) + 1;
+		accumulation_entry_offset += (x_dir + 1) * (y_dir + 1);
+		seamfind_weight_entry_count += overlap_count[(i * num_cam) + j];
+		overlap_number++;
 	}
 
+	// arrays are never created with zero capacity
+	entry_var->accum_entry = std::max(accumulation_entry_offset, 1u);
+	entry_var->valid_entry = std::max(seamfind_valid_entry_count, 1u);
+	entry_var->weight_entry = std::max(seamfind_weight_entry_count, 1u);
+	entry_var->pref_entry = std::max(overlap_number, 1u);
+	entry_var->info_entry = std::max(overlap_number, 1u);
+	entry_var->path_entry = eqr_width * std::max(overlap_number, 1u);
+
 	return VX_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,142 @@
+/*
+Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef __STITCH_THREAD_POOL_H__
+#define __STITCH_THREAD_POOL_H__
+
+// header file for the persistent worker threads shared by the CPU kernels
+#include "kernels.h"
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//! \brief The worker threads of a CPU node: started with the node local data in the kernel initialize and
+//  joined in the kernel deinitialize, so that the kernel execution doesn't spawn threads on every frame.
+struct stitch_thread_pool {
+	std::vector<std::thread> worker;                // worker threads
+	std::mutex mutex;                               // protects all the fields below
+	std::condition_variable cond;                   // signaled when a job is posted and on exit
+	std::condition_variable done;                   // signaled when the last worker of a job is done
+	const std::function<void()> * job;              // job being run
+	vx_uint64 job_id;                               // incremented for every job posted
+	int job_slots;                                  // number of workers that can still join the job
+	int job_active;                                 // number of workers running the job
+	bool exit;                                      // true to terminate the workers
+
+	stitch_thread_pool() : job(nullptr), job_id(0), job_slots(0), job_active(0), exit(false) {}
+	~stitch_thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			exit = true;
+		}
+		cond.notify_all();
+		for (size_t i = 0; i < worker.size(); i++)
+			worker[i].join();
+	}
+	//! \brief Start a worker per hardware thread besides the calling thread.
+	void start() {
+		int num_workers = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+		for (int i = 0; i < num_workers; i++)
+			worker.push_back(std::thread(&stitch_thread_pool::worker_func, this));
+	}
+	//! \brief Run func on the calling thread and on up to num_tasks-1 workers: returns when all of them are done.
+	//  func picks its tasks from a shared counter, so the workers that join late find no task left.
+	void run(int num_tasks, const std::function<void()>& func) {
+		int num_helpers = std::min((int)worker.size(), num_tasks - 1);
+		if (num_helpers > 0) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &func;
+				job_id++;
+				job_slots = job_active = num_helpers;
+			}
+			cond.notify_all();
+		}
+		func();
+		if (num_helpers > 0) {
+			std::unique_lock<std::mutex> lock(mutex);
+			done.wait(lock, [this] { return job_active == 0; });
+			job = nullptr;
+		}
+	}
+	void worker_func() {
+		vx_uint64 last_job_id = 0;
+		for (;;) {
+			const std::function<void()> * func = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cond.wait(lock, [&] { return exit || (job_id != last_job_id && job_slots > 0); });
+				if (exit)
+					return;
+				last_job_id = job_id;
+				job_slots--;
+				func = job;
+			}
+			(*func)();
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--job_active == 0)
+				done.notify_one();
+		}
+	}
+};
+
+//! \brief The kernel initialize of the CPU nodes whose local data is just a stitch_thread_pool.
+inline vx_status VX_CALLBACK stitch_thread_pool_initialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	stitch_thread_pool * pool = new stitch_thread_pool();
+	pool->start();
+	vx_size size = sizeof(stitch_thread_pool);
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)));
+	ERROR_CHECK_STATUS(vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &pool, sizeof(pool)));
+	return VX_SUCCESS;
+}
+
+//! \brief The kernel deinitialize of the CPU nodes whose local data is just a stitch_thread_pool.
+inline vx_status VX_CALLBACK stitch_thread_pool_deinitialize(vx_node node, const vx_reference * parameters, vx_uint32 num)
+{
+	vx_size size = 0;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(stitch_thread_pool)))
+	{
+		stitch_thread_pool * pool = nullptr;
+		ERROR_CHECK_STATUS(vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &pool, sizeof(pool)));
+		if (pool) delete pool;
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief Run func on the stitch_thread_pool of the node local data, or only on the calling thread if the node has none.
+inline void stitch_thread_pool_run(vx_node node, int num_tasks, const std::function<void()>& func)
+{
+	vx_size size = 0;
+	stitch_thread_pool * pool = nullptr;
+	if (!vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size)) && (size == sizeof(stitch_thread_pool)))
+		vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &pool, sizeof(pool));
+	if (pool)
+		pool->run(num_tasks, func);
+	else
+		func();
+}
+
+#endif //__STITCH_THREAD_POOL_H__
@@ -22,11 +22,16 @@ THE SOFTWARE.
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "kernels.h"
+#include "thread_pool.h"
 #include <CL/cl.h>
 #include <stdio.h>
 #include <algorithm>
+#include <math.h>
+#include <emmintrin.h>
+#include <atomic>
 
 #define WRITE_LUMA_AS_A 1
+#define WARP_CPU_ENTRIES_PER_STRIPE 1024
 
 //! \brief The input validator callback.
 static vx_status VX_CALLBACK warp_input_validator(vx_node node, vx_uint32 index)
@@ -188,7 +193,7 @@ static vx_status VX_CALLBACK warp_query_target_support(vx_graph graph, vx_node n
 	vx_uint32& supported_target_affinity // [output] must be set to AGO_TARGET_AFFINITY_CPU or AGO_TARGET_AFFINITY_GPU or (AGO_TARGET_AFFINITY_CPU | AGO_TARGET_AFFINITY_GPU)
 	)
 {
-	supported_target_affinity = AGO_TARGET_AFFINITY_GPU;
+	supported_target_affinity = AGO_TARGET_AFFINITY_GPU | AGO_TARGET_AFFINITY_CPU;
 	return VX_SUCCESS;
 }
 
@@ -724,10 +729,157 @@ static vx_status VX_CALLBACK warp_opencl_codegen(
 	return VX_SUCCESS;
 }
 
+//! \brief Bilinear interpolation of one RGBX pixel from its 2x2 neighborhood with Q3 fractions.
+//  Returns R,G,B,X in 16-bit lanes 0..3 scaled by 64 (i.e., without the final rounding shift).
+static inline __m128i warp_bilinear_q6(vx_uint32 p00, vx_uint32 p01, vx_uint32 p10, vx_uint32 p11, vx_uint32 fx, vx_uint32 fy)
+{
+	const __m128i zero = _mm_setzero_si128();
+	short w00 = (short)((8 - fx) * (8 - fy)), w01 = (short)(fx * (8 - fy));
+	short w10 = (short)((8 - fx) * fy), w11 = (short)(fx * fy);
+	__m128i px = _mm_setr_epi32((int)p00, (int)p01, (int)p10, (int)p11);
+	__m128i top = _mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_setr_epi16(w00, w00, w00, w00, w01, w01, w01, w01));
+	__m128i bot = _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_setr_epi16(w10, w10, w10, w10, w11, w11, w11, w11));
+	__m128i sum = _mm_add_epi16(top, bot);
+	return _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+}
+
+//! \brief Round and saturate a float value to U8 (same as amd_pack on GPU).
+static inline vx_uint8 warp_pack_u8(float v)
+{
+	return (vx_uint8)std::min(255.0f, std::max(0.0f, v + 0.5f));
+}
+
 //! \brief The kernel execution.
 static vx_status VX_CALLBACK warp_kernel(vx_node node, const vx_reference * parameters, vx_uint32 num)
 {
-	return VX_ERROR_NOT_SUPPORTED;
+	vx_enum grayscale_compute_method = STITCH_GRAY_SCALE_COMPUTE_METHOD_AVG;
+	vx_uint32 num_cameras = 0, num_camera_columns = 1;
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[0], &grayscale_compute_method));
+	ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[1], &num_cameras));
+	if (parameters[7]) {
+		ERROR_CHECK_STATUS(vxReadScalarValue((vx_scalar)parameters[7], &num_camera_columns));
+	}
+	vx_array valid_pix_array = (vx_array)parameters[2];
+	vx_array warp_remap_array = (vx_array)parameters[3];
+	vx_image input_image = (vx_image)parameters[4];
+	vx_image output_image = (vx_image)parameters[5];
+	vx_image output_u8_image = (vx_image)parameters[6];
+	vx_size num_items = 0;
+	ERROR_CHECK_STATUS(vxQueryArray(valid_pix_array, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items)));
+	if (num_items == 0)
+		return VX_SUCCESS;
+
+	// get image configurations
+	vx_df_image input_format = VX_DF_IMAGE_VIRT, output_format = VX_DF_IMAGE_VIRT;
+	vx_uint32 input_width = 0, input_height = 0, output_width = 0, output_height = 0;
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_FORMAT, &input_format, sizeof(input_format)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_WIDTH, &input_width, sizeof(input_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(input_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &input_height, sizeof(input_height)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_FORMAT, &output_format, sizeof(output_format)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_WIDTH, &output_width, sizeof(output_width)));
+	ERROR_CHECK_STATUS(vxQueryImage(output_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &output_height, sizeof(output_height)));
+	vx_uint32 ip_image_height_offs = input_height / num_cameras;
+	vx_uint32 op_image_height_offs = output_height / num_cameras;
+
+	// access arrays and images
+	StitchValidPixelEntry * valid_pix_entry = nullptr;
+	StitchWarpRemapEntry * warp_remap_entry = nullptr;
+	vx_size valid_pix_stride = sizeof(StitchValidPixelEntry), warp_remap_stride = sizeof(StitchWarpRemapEntry);
+	ERROR_CHECK_STATUS(vxAccessArrayRange(valid_pix_array, 0, num_items, &valid_pix_stride, (void **)&valid_pix_entry, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessArrayRange(warp_remap_array, 0, num_items, &warp_remap_stride, (void **)&warp_remap_entry, VX_READ_ONLY));
+	vx_rectangle_t ip_rect = { 0, 0, input_width, input_height };
+	vx_rectangle_t op_rect = { 0, 0, output_width, output_height };
+	vx_imagepatch_addressing_t ip_addr, op_addr, op_u8_addr;
+	vx_uint8 * ip_buf = nullptr, *op_buf = nullptr, *op_u8_buf = nullptr;
+	ERROR_CHECK_STATUS(vxAccessImagePatch(input_image, &ip_rect, 0, &ip_addr, (void **)&ip_buf, VX_READ_ONLY));
+	ERROR_CHECK_STATUS(vxAccessImagePatch(output_image, &op_rect, 0, &op_addr, (void **)&op_buf, VX_WRITE_ONLY));
+	if (output_u8_image) {
+		ERROR_CHECK_STATUS(vxAccessImagePatch(output_u8_image, &op_rect, 0, &op_u8_addr, (void **)&op_u8_buf, VX_WRITE_ONLY));
+	}
+	vx_int32 ip_stride = ip_addr.stride_y, op_stride = op_addr.stride_y, op_u8_stride = op_u8_buf ? op_u8_addr.stride_y : 0;
+	bool ip_rgbx = (input_format == VX_DF_IMAGE_RGBX), op_rgbx = (output_format == VX_DF_IMAGE_RGBX);
+
+	// process stripes of entries in parallel: each entry covers 8 consecutive output pixels
+	int num_stripes = (int)((num_items + WARP_CPU_ENTRIES_PER_STRIPE - 1) / WARP_CPU_ENTRIES_PER_STRIPE);
+	std::atomic<int> next_stripe(0);
+	std::function<void()> stripe_thread_func = [&]() {
+		for (int stripe = next_stripe++; stripe < num_stripes; stripe = next_stripe++) {
+			vx_size start = (vx_size)stripe * WARP_CPU_ENTRIES_PER_STRIPE;
+			vx_size end = std::min(start + WARP_CPU_ENTRIES_PER_STRIPE, num_items);
+			for (vx_size i = start; i < end; i++) {
+				const StitchValidPixelEntry * valid = (const StitchValidPixelEntry *)((const vx_uint8 *)valid_pix_entry + i * valid_pix_stride);
+				const StitchWarpRemapEntry * map = (const StitchWarpRemapEntry *)((const vx_uint8 *)warp_remap_entry + i * warp_remap_stride);
+				vx_uint32 camera_id = valid->camId, op_x = valid->dstX << 3, op_y = valid->dstY;
+				vx_uint32 ip_row_start = (camera_id / num_camera_columns) * ip_image_height_offs;
+				const vx_uint8 * ip_cam = ip_buf + ip_row_start * ip_stride;
+				vx_uint32 op_row = camera_id * op_image_height_offs + op_y;
+				vx_uint8 * op_pix = op_buf + op_row * op_stride + op_x * (op_rgbx ? 4 : 3);
+				vx_uint8 * op_u8_pix = op_u8_buf ? op_u8_buf + op_row * op_u8_stride + op_x : nullptr;
+				const vx_uint16 * coord = &map->srcX0;
+				for (vx_uint32 k = 0; k < 8; k++, coord += 2) {
+					vx_uint32 sx = coord[0], sy = coord[1];
+					if (sx == 0xffff && sy == 0xffff) {
+						if (op_rgbx) { op_pix[0] = 0; op_pix[1] = 0; op_pix[2] = 0; op_pix[3] = 128; op_pix += 4; }
+						else { op_pix[0] = 0; op_pix[1] = 0; op_pix[2] = 0; op_pix += 3; }
+						if (op_u8_pix) *op_u8_pix++ = 0;
+						continue;
+					}
+					// fetch 2x2 neighborhood clamped to the camera image
+					vx_uint32 x0 = sx >> 3, y0 = sy >> 3;
+					vx_uint32 x1 = (x0 + 1 < input_width) ? x0 + 1 : x0;
+					vx_uint32 y1 = (ip_row_start + y0 + 1 < input_height) ? y0 + 1 : y0;
+					const vx_uint8 * r0 = ip_cam + y0 * ip_stride, *r1 = ip_cam + y1 * ip_stride;
+					vx_uint32 p00, p01, p10, p11;
+					if (ip_rgbx) {
+						p00 = *(const vx_uint32 *)(r0 + x0 * 4); p01 = *(const vx_uint32 *)(r0 + x1 * 4);
+						p10 = *(const vx_uint32 *)(r1 + x0 * 4); p11 = *(const vx_uint32 *)(r1 + x1 * 4);
+					}
+					else {
+						const vx_uint8 * q;
+						q = r0 + x0 * 3; p00 = q[0] | (q[1] << 8) | (q[2] << 16);
+						q = r0 + x1 * 3; p01 = q[0] | (q[1] << 8) | (q[2] << 16);
+						q = r1 + x0 * 3; p10 = q[0] | (q[1] << 8) | (q[2] << 16);
+						q = r1 + x1 * 3; p11 = q[0] | (q[1] << 8) | (q[2] << 16);
+					}
+					__m128i sum = warp_bilinear_q6(p00, p01, p10, p11, sx & 7, sy & 7);
+					vx_uint32 pix = (vx_uint32)_mm_cvtsi128_si32(_mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(32)), 6), sum));
+					float r = _mm_extract_epi16(sum, 0) * (1.0f / 64.0f);
+					float g = _mm_extract_epi16(sum, 1) * (1.0f / 64.0f);
+					float b = _mm_extract_epi16(sum, 2) * (1.0f / 64.0f);
+					if (op_rgbx) {
+						if (!ip_rgbx) {
+							// alpha holds the grayscale value for RGB input
+							float a = (grayscale_compute_method == STITCH_GRAY_SCALE_COMPUTE_METHOD_AVG) ?
+								(r + g + b) * 0.3333333333f : sqrtf((r * r + g * g + b * b) * 0.3333333333f);
+							pix = (pix & 0x00ffffff) | ((vx_uint32)warp_pack_u8(a) << 24);
+						}
+						*(vx_uint32 *)op_pix = pix; op_pix += 4;
+					}
+					else {
+						op_pix[0] = (vx_uint8)pix; op_pix[1] = (vx_uint8)(pix >> 8); op_pix[2] = (vx_uint8)(pix >> 16); op_pix += 3;
+					}
+					if (op_u8_pix) {
+#if WRITE_LUMA_AS_A
+						*op_u8_pix++ = warp_pack_u8(r * 0.2126f + g * 0.7152f + b * 0.0722f);
+#else
+						*op_u8_pix++ = (vx_uint8)(pix >> 24);
+#endif
+					}
+				}
+			}
+		}
+	};
+	stitch_thread_pool_run(node, num_stripes, stripe_thread_func);
+
+	ERROR_CHECK_STATUS(vxCommitArrayRange(valid_pix_array, 0, 0, valid_pix_entry));
+	ERROR_CHECK_STATUS(vxCommitArrayRange(warp_remap_array, 0, 0, warp_remap_entry));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(input_image, nullptr, 0, &ip_addr, ip_buf));
+	ERROR_CHECK_STATUS(vxCommitImagePatch(output_image, &op_rect, 0, &op_addr, op_buf));
+	if (op_u8_buf) {
+		ERROR_CHECK_STATUS(vxCommitImagePatch(output_u8_image, &op_rect, 0, &op_u8_addr, op_u8_buf));
+	}
+
+	return VX_SUCCESS;
 }
 
 //! \brief The kernel publisher.
@@ -740,8 +892,8 @@ vx_status warp_publish(vx_context context)
 		8,
 		warp_input_validator,
 		warp_output_validator,
-		nullptr,
-		nullptr);
+		stitch_thread_pool_initialize,
+		stitch_thread_pool_deinitialize);
 	ERROR_CHECK_OBJECT(kernel);
 	amd_kernel_query_target_support_f query_target_support_f = warp_query_target_support;
 	amd_kernel_opencl_codegen_callback_f opencl_codegen_callback_f = warp_opencl_codegen;
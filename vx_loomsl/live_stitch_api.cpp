@@ -24,6 +24,10 @@ THE SOFTWARE.
 #include <vx_ext_amd.h>
 #include <sstream>
 #include <stdarg.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 // Version
 #define LS_VERSION             "0.9"
@@ -61,6 +65,34 @@ struct ls_loomio_info {
 	char kernelArguments[LOOMIO_MAX_LENGTH_KERNEL_ARGUMENTS];
 };
 
+//////////////////////////////////////////////////////////////////////
+//! \brief The number of completed frames whose status is kept for lsWaitForFrame
+#define LS_FRAME_STATUS_HISTORY              64
+
+//////////////////////////////////////////////////////////////////////
+//! \brief The frame scheduled with lsScheduleFrameAsync
+struct ls_frame_request {
+	vx_uint32 token;                            // frame token returned to the application
+	cl_mem input_buffer, output_buffer;         // frame buffers (nullptr: keep current buffers)
+	stitch_frame_callback_f callback;           // completion callback (optional)
+	void * user_data;                           // user data passed to the callback
+	vx_status status;                           // status of the frame processing
+};
+
+//! \brief The scheduler thread for lsScheduleFrameAsync
+struct ls_frame_scheduler {
+	std::thread thread;                         // thread processing the frames in order
+	std::mutex graph_mutex;                     // held while a frame is processed and while an image handle is swapped
+	std::mutex mutex;                           // protects all the fields below
+	std::condition_variable cond;               // signaled when a frame is scheduled/completed and on exit
+	std::deque<ls_frame_request> queue;         // frames in flight (front is being processed)
+	vx_uint32 max_frames_in_flight;             // maximum number of frames in the queue
+	vx_uint32 next_token;                       // token of the next frame scheduled
+	vx_uint32 completed_count;                  // number of frames completed
+	vx_status status[LS_FRAME_STATUS_HISTORY];  // status of the last completed frames, indexed by token % LS_FRAME_STATUS_HISTORY
+	bool exit;                                  // true to terminate the thread
+};
+
 //////////////////////////////////////////////////////////////////////
 //! \brief The stitch handle
 struct ls_context_t {
@@ -110,6 +142,8 @@ struct ls_context_t {
 	vx_context context;                         // OpenVX context
 	vx_graph graphStitch, graphInitializeStitch;   // separate graphs for frame-level stitching and Initialize Stitch Config
 	vx_graph graphOverlay;                      // graph for overlay computation
+	vx_graph graphSeamFind;                     // graph for seam find: processed only on the frames where a seam is due
+	vx_graph graphStitchInput;                  // graph for input conversion and warp of the next frame while graphStitch merges a frame (nullptr: all in graphStitch)
 	// configuration OpenVX objects
 	vx_matrix rig_par_mat, cam_par_mat;         // rig and camera parameters
 	vx_array cam_par_array;						// camera parameters
@@ -122,30 +156,39 @@ struct ls_context_t {
 	vx_node InputColorConvertNode, SimpleStitchRemapNode, OutputColorConvertNode;
 	//Stitch Mode 2
 	vx_array ValidPixelEntry, WarpRemapEntry, OverlapPixelEntry, valid_array, gain_array;
+	vx_array block_stats_array, block_gain_array;	// exposure comp block gains (EXPO_COMP == 2)
 	vx_matrix InitializeStitchConfig_matrix, overlap_matrix, A_matrix;
 	vx_image RGBY1, RGBY2, weight_image, cam_id_image, group1_image, group2_image;
+	vx_delay RGBY1_delay, u8_image_delay;       // with graphStitchInput: slot 0 written by the warp, slot -1 read by graphStitch
 	vx_node InitializeStitchConfigNode, WarpNode, ExpcompComputeGainNode, ExpcompSolveGainNode, ExpcompApplyGainNode, MergeNode;
 	vx_float32 alpha, beta;                     // needed for expcomp
 	vx_int32 * A_matrix_initial_value;          // needed for expcomp
 	//Stitch SEAMFIND DATA OBJECTS
-	vx_array overlap_rect_array, seamfind_valid_array, seamfind_weight_array, seamfind_accum_array, seamfind_pref_array, seamfind_info_array, seamfind_path_array, seamfind_scene_array;
+	vx_array overlap_rect_array, seamfind_valid_array, seamfind_weight_array, seamfind_accum_array, seamfind_parent_array, seamfind_pref_array, seamfind_info_array, seamfind_path_array, seamfind_scene_array;
+	vx_array seamfind_cost_tile_array;
 	vx_image mask_image, u8_image, sobelx_image, sobely_image, s16_image, sobel_magnitude_image, sobel_phase_image, new_weight_image;
 	vx_node SobelNode, MagnitudeNode, PhaseNode, ConvertDepthNode, SeamfindStep1Node, SeamfindStep2Node, SeamfindStep3Node, SeamfindStep4Node, SeamfindStep5Node;
-	vx_scalar input_shift, current_frame, scene_threshold, flag;
+	vx_node SeamfindAnalyzeNode;
+	vx_scalar input_shift, current_frame, scene_threshold, flag, seamfind_flag;
 	vx_int32  current_frame_value;
 	vx_uint32 scene_threshold_value, SEAM_FIND_TARGET;
 	//Stitch Multiband DATA objects
 	vx_int32 num_bands;
+	vx_uint32 blend_interior_offset;				// offset of the interior tiles in blend_offsets (0: all tiles go through the pyramid)
 	vx_array band_weights_array, blend_offsets;
 	vx_image blend_mask_image;
 	StitchMultibandData *pStitchMultiband;
+	vx_node MultibandFusedNode;
 	// LoomIO support
 	vx_uint32 loomioAuxDataLength;
 	vx_scalar cameraMediaConfig, overlayMediaConfig, outputMediaConfig, viewingMediaConfig;
 	vx_array loomioCameraAuxData, loomioOverlayAuxData, loomioOutputAuxData, loomioViewingAuxData;
+	vx_delay loomioCameraAuxDelay;              // with graphStitchInput: slot 0 written by the camera, slot -1 read by graphStitch
 	vx_node nodeLoomIoCamera, nodeLoomIoOverlay, nodeLoomIoOutput, nodeLoomIoViewing;
 	ls_loomio_info loomio_camera, loomio_output, loomio_overlay, loomio_viewing;
 	FILE * loomioAuxDumpFile;
+	// asynchronous frame scheduling
+	ls_frame_scheduler * frameScheduler;
 	// attributes
 	vx_float32 live_stitch_attr[LIVE_STITCH_ATTR_MAX_COUNT];
 };
@@ -212,6 +255,8 @@ static void ResetLiveStitchGlobalAttributes()
 		g_live_stitch_attr[LIVE_STITCH_ATTR_INPUT_SCALE_FACTOR] = 1.0f;                  // no input scaling
 		g_live_stitch_attr[LIVE_STITCH_ATTR_OUTPUT_SCALE_FACTOR] = 1.0f;                 // no output scaling
 		g_live_stitch_attr[LIVE_STITCH_ATTR_ENABLE_REINITIALIZE] = 0.0f;                 // lsReinitialize disabled
+		g_live_stitch_attr[LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT] = 2.0f;                // two frames in flight with lsScheduleFrameAsync
+		g_live_stitch_attr[LIVE_STITCH_ATTR_SEAM_SCENE_DURATION] = 150.0f;               // seam locked for 150 frames after a scene change
 		// LoomIO specific attributes
 		g_live_stitch_attr[LIVE_STITCH_ATTR_IO_AUX_DATA_CAPACITY] = (float)LOOMIO_DEFAULT_AUX_DATA_CAPACITY;
 	}
@@ -243,6 +288,25 @@ static vx_status IsValidContextAndNotInitialized(ls_context stitch)
 	return VX_SUCCESS;
 }
 
+//! \brief Function to check whether frames scheduled with lsScheduleFrameAsync are in flight.
+static bool IsFrameAsyncPending(ls_context stitch)
+{
+	if (!stitch->frameScheduler) return false;
+	std::lock_guard<std::mutex> lock(stitch->frameScheduler->mutex);
+	return !stitch->frameScheduler->queue.empty();
+}
+
+//! \brief Function to swap the buffer of an image: waits for the frame being processed by lsScheduleFrameAsync, if any.
+static vx_status SwapImageHandle(ls_context stitch, vx_image image, cl_mem buffer)
+{
+	void * ptr[] = { buffer };
+	if (stitch->frameScheduler) {
+		std::lock_guard<std::mutex> lock(stitch->frameScheduler->graph_mutex);
+		return vxSwapImageHandle(image, ptr, nullptr, 1);
+	}
+	return vxSwapImageHandle(image, ptr, nullptr, 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // Stitch API implementation
 
@@ -621,6 +685,287 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetViewingModule(ls_context stitch
 	return VX_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////
+//! \brief The initialize stitch cache file format.
+#define INITIALIZE_STITCH_CACHE_MAGIC      0x4c4d4943   // "CIML"
+#define INITIALIZE_STITCH_CACHE_VERSION    4
+typedef struct {
+	vx_uint32 magic;                            // should be INITIALIZE_STITCH_CACHE_MAGIC
+	vx_uint32 version;                          // should be INITIALIZE_STITCH_CACHE_VERSION
+	vx_uint64 key;                              // hash of the configuration used to generate the tables
+	vx_uint32 num_objects;                      // number of objects following the header
+	vx_uint32 reserved;
+} InitializeStitchCacheHeader;
+typedef struct {
+	vx_enum   type;                             // VX_TYPE_ARRAY, VX_TYPE_MATRIX, or VX_TYPE_IMAGE
+	vx_uint32 size;                             // item size (array), element size (matrix), or bytes per row (image)
+	vx_uint64 count;                            // number of items (array), elements (matrix), or rows (image)
+} InitializeStitchCacheObject;
+
+//! \brief Function to compute 64-bit FNV-1a hash.
+static vx_uint64 InitializeStitchCacheHash(vx_uint64 hash, const void * data, size_t size)
+{
+	const vx_uint8 * ptr = (const vx_uint8 *)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= ptr[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+//! \brief Function to get the output objects of graphInitializeStitch that are cached.
+//  Note that RGBY1 is not cached since it is only initialized to a constant.
+static std::vector<vx_reference> InitializeStitchCacheObjects(ls_context stitch)
+{
+	vx_reference ref[] = {
+		(vx_reference)stitch->ValidPixelEntry, (vx_reference)stitch->WarpRemapEntry, (vx_reference)stitch->OverlapPixelEntry,
+		(vx_reference)stitch->overlap_matrix, (vx_reference)stitch->weight_image,
+		(vx_reference)stitch->cam_id_image, (vx_reference)stitch->group1_image, (vx_reference)stitch->group2_image,
+		(vx_reference)stitch->valid_array, (vx_reference)stitch->mask_image, (vx_reference)stitch->overlap_rect_array,
+		(vx_reference)stitch->seamfind_valid_array, (vx_reference)stitch->seamfind_accum_array, (vx_reference)stitch->seamfind_weight_array,
+		(vx_reference)stitch->seamfind_pref_array, (vx_reference)stitch->seamfind_info_array, (vx_reference)stitch->blend_offsets,
+		(vx_reference)stitch->seamfind_parent_array, (vx_reference)stitch->seamfind_cost_tile_array,
+	};
+	std::vector<vx_reference> objects;
+	for (size_t i = 0; i < sizeof(ref) / sizeof(ref[0]); i++) {
+		if (ref[i]) objects.push_back(ref[i]);
+	}
+	return objects;
+}
+
+//! \brief Function to compute the cache key from all the inputs of graphInitializeStitch.
+static vx_uint64 InitializeStitchCacheKey(ls_context stitch, const InitializeStitchAttributes * attr)
+{
+	vx_uint64 key = 0xcbf29ce484222325ull;
+	vx_uint32 config[] = {
+		INITIALIZE_STITCH_CACHE_VERSION, stitch->num_cameras, stitch->num_camera_rows, stitch->num_camera_columns,
+		stitch->camera_rgb_buffer_width, stitch->camera_rgb_buffer_height, stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height,
+		(vx_uint32)sizeof(StitchValidPixelEntry), (vx_uint32)sizeof(StitchWarpRemapEntry), (vx_uint32)sizeof(StitchSeamFindValidEntry),
+		(vx_uint32)sizeof(StitchSeamFindWeightEntry), (vx_uint32)(sizeof(vx_int32) + sizeof(vx_uint8)), (vx_uint32)sizeof(StitchBlendValidEntry),
+		(vx_uint32)sizeof(StitchSeamFindCostTile),
+	};
+	key = InitializeStitchCacheHash(key, config, sizeof(config));
+	key = InitializeStitchCacheHash(key, &stitch->rig_par, sizeof(rig_params));
+	key = InitializeStitchCacheHash(key, stitch->camera_par, stitch->num_cameras * sizeof(camera_params));
+	key = InitializeStitchCacheHash(key, attr, sizeof(InitializeStitchAttributes));
+	// the set of objects depends on the EXPO_COMP, SEAM_FIND, and MULTIBAND_BLEND flags
+	vx_reference ref[] = {
+		(vx_reference)stitch->OverlapPixelEntry, (vx_reference)stitch->overlap_matrix, (vx_reference)stitch->valid_array,
+		(vx_reference)stitch->mask_image, (vx_reference)stitch->overlap_rect_array, (vx_reference)stitch->seamfind_valid_array,
+		(vx_reference)stitch->blend_offsets,
+	};
+	vx_uint32 present = 0;
+	for (size_t i = 0; i < sizeof(ref) / sizeof(ref[0]); i++) {
+		if (ref[i]) present |= (1 << i);
+	}
+	key = InitializeStitchCacheHash(key, &present, sizeof(present));
+	return key;
+}
+
+//! \brief Function to read the outputs of graphInitializeStitch from an open cache file. Returns VX_FAILURE on cache miss.
+static vx_status ReadInitializeStitchCache(ls_context stitch, FILE * fp, vx_uint64 key)
+{
+	std::vector<vx_reference> objects = InitializeStitchCacheObjects(stitch);
+	InitializeStitchCacheHeader header = { 0 };
+	vx_status status = VX_SUCCESS;
+	if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != INITIALIZE_STITCH_CACHE_MAGIC ||
+		header.version != INITIALIZE_STITCH_CACHE_VERSION || header.key != key || header.num_objects != (vx_uint32)objects.size())
+	{
+		status = VX_FAILURE;
+	}
+	std::vector<vx_uint8> buf;
+	for (size_t i = 0; status == VX_SUCCESS && i < objects.size(); i++) {
+		InitializeStitchCacheObject object = { 0 };
+		vx_enum type = VX_TYPE_INVALID;
+		if (fread(&object, sizeof(object), 1, fp) != 1 ||
+			vxQueryReference(objects[i], VX_REF_ATTRIBUTE_TYPE, &type, sizeof(type)) != VX_SUCCESS || type != object.type)
+		{
+			status = VX_FAILURE;
+			break;
+		}
+		if (type == VX_TYPE_ARRAY) {
+			vx_array arr = (vx_array)objects[i];
+			vx_size itemsize = 0, capacity = 0;
+			ERROR_CHECK_STATUS_(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+			ERROR_CHECK_STATUS_(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity)));
+			buf.resize((size_t)(object.count * object.size));
+			if (itemsize != object.size || object.count > capacity || (buf.size() > 0 && fread(&buf[0], buf.size(), 1, fp) != 1)) {
+				status = VX_FAILURE;
+				break;
+			}
+			ERROR_CHECK_STATUS_(vxTruncateArray(arr, 0));
+			if (object.count > 0) {
+				ERROR_CHECK_STATUS_(vxAddArrayItems(arr, (vx_size)object.count, &buf[0], itemsize));
+			}
+		}
+		else if (type == VX_TYPE_MATRIX) {
+			vx_matrix mat = (vx_matrix)objects[i];
+			vx_size size = 0;
+			ERROR_CHECK_STATUS_(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_SIZE, &size, sizeof(size)));
+			buf.resize((size_t)(object.count * object.size));
+			if (buf.size() != size || fread(&buf[0], buf.size(), 1, fp) != 1) {
+				status = VX_FAILURE;
+				break;
+			}
+			ERROR_CHECK_STATUS_(vxWriteMatrix(mat, &buf[0]));
+		}
+		else if (type == VX_TYPE_IMAGE) {
+			vx_image img = (vx_image)objects[i];
+			vx_uint32 width = 0, height = 0;
+			ERROR_CHECK_STATUS_(vxQueryImage(img, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+			ERROR_CHECK_STATUS_(vxQueryImage(img, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+			vx_rectangle_t rect = { 0, 0, width, height };
+			vx_imagepatch_addressing_t addr = { 0 };
+			vx_uint8 * ptr = nullptr;
+			ERROR_CHECK_STATUS_(vxAccessImagePatch(img, &rect, 0, &addr, (void **)&ptr, VX_WRITE_ONLY));
+			if (object.count != height || object.size != width * addr.stride_x) {
+				status = VX_FAILURE;
+			}
+			for (vx_uint32 y = 0; status == VX_SUCCESS && y < height; y++) {
+				if (fread(ptr + y * addr.stride_y, object.size, 1, fp) != 1)
+					status = VX_FAILURE;
+			}
+			ERROR_CHECK_STATUS_(vxCommitImagePatch(img, &rect, 0, &addr, ptr));
+		}
+		else {
+			status = VX_FAILURE;
+		}
+	}
+	return status;
+}
+
+//! \brief Function to initialize a warp output image to (0,0,0,128) same as initialize_stitch_config.
+static vx_status ResetWarpImage(vx_image image)
+{
+	vx_uint32 width = 0, height = 0;
+	ERROR_CHECK_STATUS_(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+	ERROR_CHECK_STATUS_(vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+	vx_rectangle_t rect = { 0, 0, width, height };
+	vx_imagepatch_addressing_t addr = { 0 };
+	vx_uint8 * ptr = nullptr;
+	ERROR_CHECK_STATUS_(vxAccessImagePatch(image, &rect, 0, &addr, (void **)&ptr, VX_WRITE_ONLY));
+	for (vx_uint32 y = 0; y < height; y++) {
+		vx_uint32 * row = (vx_uint32 *)(ptr + y * addr.stride_y);
+		for (vx_uint32 x = 0; x < width; x++)
+			row[x] = 0x80000000;
+	}
+	ERROR_CHECK_STATUS_(vxCommitImagePatch(image, &rect, 0, &addr, ptr));
+	return VX_SUCCESS;
+}
+
+//! \brief Function to load the outputs of graphInitializeStitch from a cache file. Returns VX_FAILURE on cache miss.
+static vx_status LoadInitializeStitchCache(ls_context stitch, const char * fileName, vx_uint64 key)
+{
+	FILE * fp = fopen(fileName, "rb");
+	if (!fp) return VX_FAILURE;
+	vx_status status = ReadInitializeStitchCache(stitch, fp, key);
+	fclose(fp);
+	if (status == VX_SUCCESS && stitch->RGBY1) {
+		ERROR_CHECK_STATUS_(ResetWarpImage(stitch->RGBY1));
+	}
+	return status;
+}
+
+//! \brief Function to copy the warp output initialized by graphInitializeStitch from CPU to GPU: graphStitch expects
+//  the data initialized on GPU since the warp writes only the valid pixels. With graphStitchInput, the slot of
+//  the warp output delay that graphInitializeStitch doesn't write is initialized the same way.
+static vx_status UploadWarpImages(ls_context stitch)
+{
+	if (stitch->RGBY1_delay) {
+		vx_image image = (vx_image)vxGetReferenceFromDelay(stitch->RGBY1_delay, -1);
+		ERROR_CHECK_STATUS_(ResetWarpImage(image));
+		ERROR_CHECK_STATUS_(vxDirective((vx_reference)image, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
+		ERROR_CHECK_STATUS_(vxDirective(vxGetReferenceFromDelay(stitch->RGBY1_delay, 0), VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
+	}
+	else if (stitch->RGBY1) {
+		ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->RGBY1, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief Function to write the outputs of graphInitializeStitch into an open cache file. Returns VX_FAILURE on write error.
+static vx_status WriteInitializeStitchCache(ls_context stitch, FILE * fp, vx_uint64 key)
+{
+	std::vector<vx_reference> objects = InitializeStitchCacheObjects(stitch);
+	InitializeStitchCacheHeader header = { INITIALIZE_STITCH_CACHE_MAGIC, INITIALIZE_STITCH_CACHE_VERSION, key, (vx_uint32)objects.size(), 0 };
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	for (size_t i = 0; ok && i < objects.size(); i++) {
+		InitializeStitchCacheObject object = { VX_TYPE_INVALID, 0, 0 };
+		ERROR_CHECK_STATUS_(vxQueryReference(objects[i], VX_REF_ATTRIBUTE_TYPE, &object.type, sizeof(object.type)));
+		if (object.type == VX_TYPE_ARRAY) {
+			vx_array arr = (vx_array)objects[i];
+			vx_size itemsize = 0, numitems = 0;
+			ERROR_CHECK_STATUS_(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_ITEMSIZE, &itemsize, sizeof(itemsize)));
+			ERROR_CHECK_STATUS_(vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_NUMITEMS, &numitems, sizeof(numitems)));
+			object.size = (vx_uint32)itemsize;
+			object.count = numitems;
+			ok = fwrite(&object, sizeof(object), 1, fp) == 1;
+			if (ok && numitems > 0) {
+				vx_size stride = itemsize;
+				vx_uint8 * ptr = nullptr;
+				ERROR_CHECK_STATUS_(vxAccessArrayRange(arr, 0, numitems, &stride, (void **)&ptr, VX_READ_ONLY));
+				for (vx_size k = 0; ok && k < numitems; k++)
+					ok = fwrite(ptr + k * stride, itemsize, 1, fp) == 1;
+				ERROR_CHECK_STATUS_(vxCommitArrayRange(arr, 0, 0, ptr));
+			}
+		}
+		else if (object.type == VX_TYPE_MATRIX) {
+			vx_matrix mat = (vx_matrix)objects[i];
+			vx_size size = 0;
+			ERROR_CHECK_STATUS_(vxQueryMatrix(mat, VX_MATRIX_ATTRIBUTE_SIZE, &size, sizeof(size)));
+			std::vector<vx_uint8> buf(size);
+			ERROR_CHECK_STATUS_(vxReadMatrix(mat, &buf[0]));
+			object.size = 1;
+			object.count = size;
+			ok = fwrite(&object, sizeof(object), 1, fp) == 1 && fwrite(&buf[0], size, 1, fp) == 1;
+		}
+		else if (object.type == VX_TYPE_IMAGE) {
+			vx_image img = (vx_image)objects[i];
+			vx_uint32 width = 0, height = 0;
+			ERROR_CHECK_STATUS_(vxQueryImage(img, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width)));
+			ERROR_CHECK_STATUS_(vxQueryImage(img, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height)));
+			vx_rectangle_t rect = { 0, 0, width, height };
+			vx_imagepatch_addressing_t addr = { 0 };
+			vx_uint8 * ptr = nullptr;
+			ERROR_CHECK_STATUS_(vxAccessImagePatch(img, &rect, 0, &addr, (void **)&ptr, VX_READ_ONLY));
+			object.size = width * addr.stride_x;
+			object.count = height;
+			ok = fwrite(&object, sizeof(object), 1, fp) == 1;
+			for (vx_uint32 y = 0; ok && y < height; y++)
+				ok = fwrite(ptr + y * addr.stride_y, object.size, 1, fp) == 1;
+			ERROR_CHECK_STATUS_(vxCommitImagePatch(img, nullptr, 0, &addr, ptr));
+		}
+		else {
+			ok = false;
+		}
+	}
+	return ok ? VX_SUCCESS : VX_FAILURE;
+}
+
+//! \brief Function to save the outputs of graphInitializeStitch into a cache file.
+static vx_status SaveInitializeStitchCache(ls_context stitch, const char * fileName, vx_uint64 key)
+{
+	// write into a temporary file and rename so that a partially written file is never picked up
+	std::string tempFileName = std::string(fileName) + ".tmp";
+	FILE * fp = fopen(tempFileName.c_str(), "wb");
+	if (!fp) {
+		ls_printf("WARNING: lsInitialize: unable to create: %s\n", tempFileName.c_str());
+		return VX_FAILURE;
+	}
+	bool ok = WriteInitializeStitchCache(stitch, fp, key) == VX_SUCCESS;
+	fclose(fp);
+	if (ok) {
+		remove(fileName);
+		ok = rename(tempFileName.c_str(), fileName) == 0;
+	}
+	if (!ok) {
+		remove(tempFileName.c_str());
+		ls_printf("WARNING: lsInitialize: unable to write: %s\n", fileName);
+		return VX_FAILURE;
+	}
+	return VX_SUCCESS;
+}
+
 //! \brief initialize the stitch context.
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 {
@@ -656,6 +1001,15 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 	if (stitch->live_stitch_attr[LIVE_STITCH_ATTR_PROFILER] == 2.0f) {
 		ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->graphStitch, VX_DIRECTIVE_AMD_ENABLE_PROFILE_CAPTURE));
 	}
+	// with frames in flight, the input conversion and warp of a frame run in graphStitchInput while
+	// graphStitch merges the previous frame: the warp outputs are passed between them with delays
+	if (stitch->stitching_mode == stitching_mode_normal && stitch->live_stitch_attr[LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT] >= 2.0f) {
+		ERROR_CHECK_OBJECT_(stitch->graphStitchInput = vxCreateGraph(stitch->context));
+		if (stitch->live_stitch_attr[LIVE_STITCH_ATTR_PROFILER] == 2.0f) {
+			ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->graphStitchInput, VX_DIRECTIVE_AMD_ENABLE_PROFILE_CAPTURE));
+		}
+	}
+	vx_graph graphInput = stitch->graphStitchInput ? stitch->graphStitchInput : stitch->graphStitch;
 
 	// create and initialize rig and camera param objects
 	ERROR_CHECK_OBJECT_(stitch->rig_par_mat = vxCreateMatrix(stitch->context, VX_TYPE_FLOAT32, sizeof(rig_params) / sizeof(vx_float32), 1));
@@ -681,14 +1035,19 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		}
 		// instantiate specified node into the graph
 		ERROR_CHECK_OBJECT_(stitch->cameraMediaConfig = vxCreateScalar(stitch->context, VX_TYPE_STRING_AMD, stitch->loomio_camera.kernelArguments));
-		ERROR_CHECK_OBJECT_(stitch->Img_input = vxCreateVirtualImage(stitch->graphStitch, stitch->camera_buffer_width, stitch->camera_buffer_height, stitch->camera_buffer_format));
+		ERROR_CHECK_OBJECT_(stitch->Img_input = vxCreateVirtualImage(graphInput, stitch->camera_buffer_width, stitch->camera_buffer_height, stitch->camera_buffer_format));
 		ERROR_CHECK_OBJECT_(stitch->loomioCameraAuxData = vxCreateArray(stitch->context, VX_TYPE_UINT8, stitch->loomioAuxDataLength));
+		if (stitch->graphStitchInput) {
+			ERROR_CHECK_OBJECT_(stitch->loomioCameraAuxDelay = vxCreateDelay(stitch->context, (vx_reference)stitch->loomioCameraAuxData, 2));
+			ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->loomioCameraAuxData));
+			stitch->loomioCameraAuxData = (vx_array)vxGetReferenceFromDelay(stitch->loomioCameraAuxDelay, 0);
+		}
 		vx_reference params[] = {
 			(vx_reference)stitch->cameraMediaConfig,
 			(vx_reference)stitch->Img_input,
 			(vx_reference)stitch->loomioCameraAuxData,
 		};
-		ERROR_CHECK_OBJECT_(stitch->nodeLoomIoCamera = stitchCreateNode(stitch->graphStitch, stitch->loomio_camera.kernelName, params, dimof(params)));
+		ERROR_CHECK_OBJECT_(stitch->nodeLoomIoCamera = stitchCreateNode(graphInput, stitch->loomio_camera.kernelName, params, dimof(params)));
 	}
 	else {
 		// need image created from OpenCL handle
@@ -701,6 +1060,8 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		if(addr_in.stride_y == 0) addr_in.stride_y = addr_in.stride_x * addr_in.dim_x;
 		ERROR_CHECK_OBJECT_(stitch->Img_input = vxCreateImageFromHandle(stitch->context, stitch->camera_buffer_format, &addr_in, ptr, VX_MEMORY_TYPE_OPENCL));
 	}
+	// the camera auxiliary data of the frame merged by graphStitch
+	vx_array cameraAuxData = stitch->loomioCameraAuxDelay ? (vx_array)vxGetReferenceFromDelay(stitch->loomioCameraAuxDelay, -1) : stitch->loomioCameraAuxData;
 	if (strlen(stitch->loomio_output.kernelName) > 0) {
 		// load OpenVX module (if specified)
 		if (strlen(stitch->loomio_output.module) > 0) {
@@ -722,7 +1083,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		vx_reference params[] = {
 			(vx_reference)stitch->outputMediaConfig,
 			(vx_reference)stitch->Img_output,
-			(vx_reference)stitch->loomioCameraAuxData,
+			(vx_reference)cameraAuxData,
 			(vx_reference)stitch->loomioOutputAuxData,
 		};
 		ERROR_CHECK_OBJECT_(stitch->nodeLoomIoOutput = stitchCreateNode(stitch->graphStitch, stitch->loomio_output.kernelName, params, dimof(params)));
@@ -740,7 +1101,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 	}
 	// create temporary images when extra color conversion is needed
 	if (stitch->camera_buffer_format != VX_DF_IMAGE_RGB) {
-		ERROR_CHECK_OBJECT_(stitch->Img_input_rgb = vxCreateVirtualImage(stitch->graphStitch, stitch->camera_rgb_buffer_width, stitch->camera_rgb_buffer_height, VX_DF_IMAGE_RGB));
+		ERROR_CHECK_OBJECT_(stitch->Img_input_rgb = vxCreateVirtualImage(graphInput, stitch->camera_rgb_buffer_width, stitch->camera_rgb_buffer_height, VX_DF_IMAGE_RGB));
 	}
 	if (stitch->output_buffer_format != VX_DF_IMAGE_RGB) {
 		vx_uint32 output_img_width = (vx_uint32)(stitch->output_rgb_scale_factor * stitch->output_buffer_width);
@@ -806,7 +1167,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 	vx_image rgb_input = stitch->Img_input;
 	if (stitch->camera_buffer_format != VX_DF_IMAGE_RGB) {
 		// needs input color conversion
-		stitch->InputColorConvertNode = stitchColorConvertNode(stitch->graphStitch, rgb_input, stitch->Img_input_rgb);
+		stitch->InputColorConvertNode = stitchColorConvertNode(graphInput, rgb_input, stitch->Img_input_rgb);
 		ERROR_CHECK_OBJECT_(stitch->InputColorConvertNode);
 		rgb_input = stitch->Img_input_rgb;
 	}
@@ -843,7 +1204,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		vx_reference params[] = {
 			(vx_reference)stitch->viewingMediaConfig,
 			(vx_reference)rgb_output,
-			(vx_reference)stitch->loomioCameraAuxData,
+			(vx_reference)cameraAuxData,
 			(vx_reference)stitch->loomioViewingAuxData,
 		};
 		ERROR_CHECK_OBJECT_(stitch->nodeLoomIoViewing = stitchCreateNode(stitch->graphStitch, stitch->loomio_viewing.kernelName, params, dimof(params)));
@@ -900,7 +1261,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		if (stitch->num_cameras <= 1){ stitch->EXPO_COMP = 0; stitch->SEAM_FIND = 0; stitch->MULTIBAND_BLEND = 0; };
 
 		//Setting Initialize Stitch Config preference from global attributes
-		InitializeStitchAttributes attr;
+		InitializeStitchAttributes attr = { 0 };
 		attr.overlap_rectangle = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_CT_OVERLAP_RECT];
 		attr.seam_find = (vx_float32)stitch->SEAM_FIND;
 		attr.seam_vertical_priority = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_CT_SEAM_VERT_PRIORITY];
@@ -910,6 +1271,8 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		attr.seam_stagger = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_CT_SEAM_STAGGER];
 		attr.multi_band = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_MULTIBAND];
 		attr.num_bands = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_MULTIBAND_NUMBANDS];
+		attr.multi_band_interior = stitch->MULTIBAND_BLEND ? (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_MULTIBAND_INTERIOR] : 0.0f;
+		attr.reinitialize = (vx_float32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_ENABLE_REINITIALIZE];
 		int CTAttr_size = (sizeof(InitializeStitchAttributes) / sizeof(vx_float32));
 		ERROR_CHECK_OBJECT_(stitch->InitializeStitchConfig_matrix = vxCreateMatrix(stitch->context, VX_TYPE_FLOAT32, CTAttr_size, 1));
 		ERROR_CHECK_STATUS_(vxWriteMatrix(stitch->InitializeStitchConfig_matrix, &attr));
@@ -926,6 +1289,11 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		ERROR_CHECK_OBJECT_(stitch->ValidPixelEntry = vxCreateArray(stitch->context, StitchValidPixelEntryType, ((stitch->output_rgb_buffer_width * stitch->output_rgb_buffer_height * stitch->num_cameras) / 8)));
 		ERROR_CHECK_OBJECT_(stitch->WarpRemapEntry = vxCreateArray(stitch->context, StitchWarpRemapEntryType, ((stitch->output_rgb_buffer_width * stitch->output_rgb_buffer_height * stitch->num_cameras) / 8)));
 		ERROR_CHECK_OBJECT_(stitch->RGBY1 = vxCreateImage(stitch->context, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_RGBX));
+		if (stitch->graphStitchInput) {
+			ERROR_CHECK_OBJECT_(stitch->RGBY1_delay = vxCreateDelay(stitch->context, (vx_reference)stitch->RGBY1, 2));
+			ERROR_CHECK_STATUS_(vxReleaseImage(&stitch->RGBY1));
+			stitch->RGBY1 = (vx_image)vxGetReferenceFromDelay(stitch->RGBY1_delay, 0);
+		}
 		// create data objects needed by exposure comp kernel
 		if (stitch->EXPO_COMP) {
 			vx_enum StitchOverlapPixelEntryType, StitchExpCompCalcEntryType;
@@ -946,29 +1314,44 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 			//SeamFind Images
 			ERROR_CHECK_OBJECT_(stitch->mask_image = vxCreateImage(stitch->context, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
 			ERROR_CHECK_OBJECT_(stitch->overlap_rect_array = vxCreateArray(stitch->context, VX_TYPE_RECTANGLE, (stitch->num_cameras * stitch->num_cameras)));
-			ERROR_CHECK_OBJECT_(stitch->u8_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
+			ERROR_CHECK_OBJECT_(stitch->u8_image = vxCreateImage(stitch->context, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
+			if (stitch->graphStitchInput) {
+				ERROR_CHECK_OBJECT_(stitch->u8_image_delay = vxCreateDelay(stitch->context, (vx_reference)stitch->u8_image, 2));
+				ERROR_CHECK_STATUS_(vxReleaseImage(&stitch->u8_image));
+				stitch->u8_image = (vx_image)vxGetReferenceFromDelay(stitch->u8_image_delay, 0);
+			}
 			//SeamFind Array Types
 			vx_enum StitchSeamFindValidEntryType, StitchSeamFindWeightEntryType;
-			vx_enum StitchSeamFindAccumEntryType, StitchSeamFindPreferenceType;
+			vx_enum StitchSeamFindPreferenceType;
 			vx_enum StitchSeamFindInformationType, StitchSeamFindPathEntryType;
 			ERROR_CHECK_TYPE_(StitchSeamFindValidEntryType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindValidEntry)));
 			ERROR_CHECK_TYPE_(StitchSeamFindWeightEntryType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindWeightEntry)));
-			ERROR_CHECK_TYPE_(StitchSeamFindAccumEntryType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindAccumEntry)));
 			ERROR_CHECK_TYPE_(StitchSeamFindPreferenceType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindPreference)));
 			ERROR_CHECK_TYPE_(StitchSeamFindInformationType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindInformation)));
 			ERROR_CHECK_TYPE_(StitchSeamFindPathEntryType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindPathEntry)));
+			vx_enum StitchSeamFindCostTileType;
+			ERROR_CHECK_TYPE_(StitchSeamFindCostTileType = vxRegisterUserStruct(stitch->context, sizeof(StitchSeamFindCostTile)));
 
-			//get seamfind variable sizes from the utility functiion
-			SeamFindSizeInfo size_var;	vx_uint32 mode = 0;
-			ERROR_CHECK_STATUS_(seamfind_utility(mode, stitch->output_rgb_buffer_width, stitch->num_cameras, &size_var));
+			//get seamfind variable sizes from the camera overlaps: lsReinitialize can grow the overlaps,
+			//so the conservative sizes are used when it is enabled
+			SeamFindSizeInfo size_var;
+			vx_uint32 mode = (stitch->live_stitch_attr[LIVE_STITCH_ATTR_ENABLE_REINITIALIZE] == 0.0f) ? 2 : 0;
+			ERROR_CHECK_STATUS_(seamfind_accurate_utility(mode, stitch->num_cameras, stitch->num_camera_columns,
+				stitch->camera_rgb_buffer_width / stitch->num_camera_columns, stitch->camera_rgb_buffer_height / stitch->num_camera_rows,
+				stitch->output_rgb_buffer_width, stitch->rig_par_mat, stitch->cam_par_array, &size_var));
 
 			//SeamFind Arrays
 			ERROR_CHECK_OBJECT_(stitch->seamfind_valid_array = vxCreateArray(stitch->context, StitchSeamFindValidEntryType, size_var.valid_entry));
 			ERROR_CHECK_OBJECT_(stitch->seamfind_weight_array = vxCreateArray(stitch->context, StitchSeamFindWeightEntryType, size_var.weight_entry));
-			ERROR_CHECK_OBJECT_(stitch->seamfind_accum_array = vxCreateArray(stitch->context, StitchSeamFindAccumEntryType, size_var.accum_entry));
+			ERROR_CHECK_OBJECT_(stitch->seamfind_accum_array = vxCreateArray(stitch->context, VX_TYPE_INT32, size_var.accum_entry));
+			ERROR_CHECK_OBJECT_(stitch->seamfind_parent_array = vxCreateArray(stitch->context, VX_TYPE_UINT8, size_var.accum_entry));
 			ERROR_CHECK_OBJECT_(stitch->seamfind_pref_array = vxCreateArray(stitch->context, StitchSeamFindPreferenceType, size_var.pref_entry));
 			ERROR_CHECK_OBJECT_(stitch->seamfind_info_array = vxCreateArray(stitch->context, StitchSeamFindInformationType, size_var.info_entry));
 			ERROR_CHECK_OBJECT_(stitch->seamfind_path_array = vxCreateArray(stitch->context, StitchSeamFindPathEntryType, size_var.path_entry));
+			//SeamFind cost tiles: at most all the tiles of the stacked camera images
+			vx_size cost_tile_count = ((stitch->output_rgb_buffer_width + SEAMFIND_COST_TILE_WIDTH - 1) / SEAMFIND_COST_TILE_WIDTH) *
+				((stitch->output_rgb_buffer_height * stitch->num_cameras + SEAMFIND_COST_TILE_HEIGHT - 1) / SEAMFIND_COST_TILE_HEIGHT);
+			ERROR_CHECK_OBJECT_(stitch->seamfind_cost_tile_array = vxCreateArray(stitch->context, StitchSeamFindCostTileType, cost_tile_count));
 		}
 		else if (stitch->MULTIBAND_BLEND) {
 			ERROR_CHECK_OBJECT_(stitch->mask_image = vxCreateImage(stitch->context, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
@@ -979,12 +1362,13 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 		if (stitch->MULTIBAND_BLEND && stitch->num_bands > 0) {
 			ERROR_CHECK_ALLOC_(stitch->pStitchMultiband = new StitchMultibandData[stitch->num_bands]);
 			memset(stitch->pStitchMultiband, 0, sizeof(StitchMultibandData)*stitch->num_bands);
-			vx_uint32 * array_offset = new vx_uint32[stitch->num_bands];
+			vx_uint32 * array_offset = new vx_uint32[stitch->num_bands + 1];
 			ERROR_CHECK_ALLOC_(array_offset);
 			vx_uint32 totalCount = Compute_StitchBlendArraySize(stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height, stitch->num_cameras, stitch->num_bands, array_offset);
 			for (int level = 0; level < stitch->num_bands; level++) {
 				stitch->pStitchMultiband[level].valid_array_offset = array_offset[level];
 			}
+			stitch->blend_interior_offset = attr.multi_band_interior ? array_offset[stitch->num_bands] : 0;
 			delete[] array_offset;
 			ERROR_CHECK_OBJECT_(stitch->blend_offsets = vxCreateArray(stitch->context, StitchBlendValidType, totalCount));
 		}
@@ -998,25 +1382,38 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 			stitch->weight_image, stitch->cam_id_image, stitch->group1_image, stitch->group2_image, stitch->valid_array,
 			stitch->mask_image, stitch->overlap_rect_array, 
 			stitch->seamfind_valid_array, stitch->seamfind_accum_array, stitch->seamfind_weight_array, stitch->seamfind_pref_array, stitch->seamfind_info_array,
-			stitch->blend_offsets);
+			stitch->blend_offsets, stitch->seamfind_parent_array, stitch->seamfind_cost_tile_array);
 		ERROR_CHECK_OBJECT_(node);
 		ERROR_CHECK_STATUS_(vxReleaseNode(&node));
 		ERROR_CHECK_STATUS_(vxVerifyGraph(stitch->graphInitializeStitch));
-		ERROR_CHECK_STATUS_(vxProcessGraph(stitch->graphInitializeStitch));
+		// use the tables cached by an earlier run with identical configuration, if the
+		// LOOM_INITIALIZE_CACHE environment variable specifies the cache folder
+		char cacheFolder[1024] = { 0 }, cacheFileName[1100] = { 0 };
+		vx_uint64 cacheKey = InitializeStitchCacheKey(stitch, &attr);
+		if (StitchGetEnvironmentVariable("LOOM_INITIALIZE_CACHE", cacheFolder, sizeof(cacheFolder))) {
+			sprintf(cacheFileName, "%s/loom_initialize_%016llx.bin", cacheFolder, (unsigned long long)cacheKey);
+		}
+		if (!cacheFileName[0] || LoadInitializeStitchCache(stitch, cacheFileName, cacheKey) != VX_SUCCESS) {
+			ERROR_CHECK_STATUS_(vxProcessGraph(stitch->graphInitializeStitch));
+			if (cacheFileName[0]) SaveInitializeStitchCache(stitch, cacheFileName, cacheKey);
+		}
 		
 		////////////////////////////////////////////////////////////////////////
 		// create and verify graphStitch using low-level kernels
 		////////////////////////////////////////////////////////////////////////
 		// warping
 		if (!stitch->SEAM_FIND) {
-			ERROR_CHECK_OBJECT_(stitch->WarpNode = stitchWarpNode(stitch->graphStitch, 1, stitch->num_cameras, stitch->ValidPixelEntry, stitch->WarpRemapEntry, rgb_input, stitch->RGBY1, stitch->num_camera_columns));
+			ERROR_CHECK_OBJECT_(stitch->WarpNode = stitchWarpNode(graphInput, 1, stitch->num_cameras, stitch->ValidPixelEntry, stitch->WarpRemapEntry, rgb_input, stitch->RGBY1, stitch->num_camera_columns));
 		}
 		else {
-			ERROR_CHECK_OBJECT_(stitch->WarpNode = stitchWarpU8Node(stitch->graphStitch, 1, stitch->num_cameras, stitch->ValidPixelEntry, stitch->WarpRemapEntry, rgb_input, stitch->RGBY1, stitch->u8_image, stitch->num_camera_columns));
+			ERROR_CHECK_OBJECT_(stitch->WarpNode = stitchWarpU8Node(graphInput, 1, stitch->num_cameras, stitch->ValidPixelEntry, stitch->WarpRemapEntry, rgb_input, stitch->RGBY1, stitch->u8_image, stitch->num_camera_columns));
 		}
+		// the warp outputs of the frame merged by graphStitch
+		vx_image rgby_warped = stitch->RGBY1_delay ? (vx_image)vxGetReferenceFromDelay(stitch->RGBY1_delay, -1) : stitch->RGBY1;
+		vx_image u8_warped = stitch->u8_image_delay ? (vx_image)vxGetReferenceFromDelay(stitch->u8_image_delay, -1) : stitch->u8_image;
 
 		// exposure comp
-		vx_image merge_input = stitch->RGBY1;
+		vx_image merge_input = rgby_warped;
 		if (stitch->EXPO_COMP) {
 			// data objects specific to exposure comp
 			ERROR_CHECK_OBJECT_(stitch->A_matrix = vxCreateMatrix(stitch->context, VX_TYPE_INT32, stitch->num_cameras, stitch->num_cameras));
@@ -1026,27 +1423,49 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 			stitch->alpha = 0.01f;
 			stitch->beta = 100.0f;
 			ERROR_CHECK_OBJECT_(stitch->gain_array = vxCreateArray(stitch->context, VX_TYPE_FLOAT32, stitch->num_cameras));
+			vx_uint32 block_gain_width = (stitch->output_rgb_buffer_width + EXPCOMP_GAIN_BLOCK_WIDTH - 1) / EXPCOMP_GAIN_BLOCK_WIDTH;
+			if (stitch->EXPO_COMP == 2) {
+				// block gains: per overlap entry statistics and a gain grid of EXPCOMP_GAIN_BLOCK_WIDTH x EXPCOMP_GAIN_BLOCK_HEIGHT blocks per camera
+				vx_uint32 block_gain_height = (stitch->output_rgb_buffer_height + EXPCOMP_GAIN_BLOCK_HEIGHT - 1) / EXPCOMP_GAIN_BLOCK_HEIGHT;
+				vx_size num_entries = 0;
+				ERROR_CHECK_STATUS_(vxQueryArray(stitch->OverlapPixelEntry, VX_ARRAY_ATTRIBUTE_CAPACITY, &num_entries, sizeof(num_entries)));
+				vx_enum StitchExpCompBlockStatsType;
+				ERROR_CHECK_TYPE_(StitchExpCompBlockStatsType = vxRegisterUserStruct(stitch->context, sizeof(StitchExpCompBlockStats)));
+				ERROR_CHECK_OBJECT_(stitch->block_stats_array = vxCreateArray(stitch->context, StitchExpCompBlockStatsType, num_entries));
+				ERROR_CHECK_OBJECT_(stitch->block_gain_array = vxCreateArray(stitch->context, VX_TYPE_FLOAT32, stitch->num_cameras * block_gain_width * block_gain_height));
+				// the stats are written by the GPU: make all items valid so that the solver can access them
+				std::vector<StitchExpCompBlockStats> stats(num_entries);
+				memset(&stats[0], 0, num_entries * sizeof(StitchExpCompBlockStats));
+				ERROR_CHECK_STATUS_(vxAddArrayItems(stitch->block_stats_array, num_entries, &stats[0], sizeof(StitchExpCompBlockStats)));
+			}
 			// graph
 			if (stitch->MULTIBAND_BLEND) {
-				ERROR_CHECK_OBJECT_(stitch->ExpcompComputeGainNode = stitchExposureCompCalcErrorFnNode(stitch->graphStitch, stitch->num_cameras, stitch->RGBY1, stitch->OverlapPixelEntry, stitch->mask_image, stitch->A_matrix));
+				ERROR_CHECK_OBJECT_(stitch->ExpcompComputeGainNode = stitchExposureCompCalcErrorFnNode(stitch->graphStitch, stitch->num_cameras, rgby_warped, stitch->OverlapPixelEntry, stitch->mask_image, stitch->A_matrix, stitch->block_stats_array));
 			}
 			else {
-				ERROR_CHECK_OBJECT_(stitch->ExpcompComputeGainNode = stitchExposureCompCalcErrorFnNode(stitch->graphStitch, stitch->num_cameras, stitch->RGBY1, stitch->OverlapPixelEntry, NULL, stitch->A_matrix));
+				ERROR_CHECK_OBJECT_(stitch->ExpcompComputeGainNode = stitchExposureCompCalcErrorFnNode(stitch->graphStitch, stitch->num_cameras, rgby_warped, stitch->OverlapPixelEntry, NULL, stitch->A_matrix, stitch->block_stats_array));
 			}
-			ERROR_CHECK_OBJECT_(stitch->ExpcompSolveGainNode = stitchExposureCompSolveForGainNode(stitch->graphStitch, stitch->alpha, stitch->beta, stitch->A_matrix, stitch->overlap_matrix, stitch->gain_array));
-			ERROR_CHECK_OBJECT_(stitch->ExpcompApplyGainNode = stitchExposureCompApplyGainNode(stitch->graphStitch, stitch->RGBY1, stitch->gain_array, stitch->valid_array, stitch->RGBY2));
+			ERROR_CHECK_OBJECT_(stitch->ExpcompSolveGainNode = stitchExposureCompSolveForGainNode(stitch->graphStitch, stitch->alpha, stitch->beta, stitch->A_matrix, stitch->overlap_matrix, stitch->gain_array,
+				block_gain_width, stitch->OverlapPixelEntry, stitch->block_stats_array, stitch->block_gain_array));
+			ERROR_CHECK_OBJECT_(stitch->ExpcompApplyGainNode = stitchExposureCompApplyGainNode(stitch->graphStitch, rgby_warped, stitch->gain_array, stitch->valid_array, stitch->RGBY2, stitch->block_gain_array));
 			// update merge input
 			merge_input = stitch->RGBY2;
 		}
 		if (stitch->SEAM_FIND) {
+			//SeamFind Graph: the cost, accumulate, path trace, and set weights nodes are processed only on the frames
+			//where a seam is due, as reported by the analyze node at the end of graphStitch
+			ERROR_CHECK_OBJECT_(stitch->graphSeamFind = vxCreateGraph(stitch->context));
+			if (stitch->live_stitch_attr[LIVE_STITCH_ATTR_PROFILER] == 2.0f) {
+				ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->graphSeamFind, VX_DIRECTIVE_AMD_ENABLE_PROFILE_CAPTURE));
+			}
 			//SeamFind Images
 			if (!stitch->SEAM_COST_SELECT){
-				ERROR_CHECK_OBJECT_(stitch->sobelx_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
-				ERROR_CHECK_OBJECT_(stitch->sobely_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
-				ERROR_CHECK_OBJECT_(stitch->s16_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
+				ERROR_CHECK_OBJECT_(stitch->sobelx_image = vxCreateVirtualImage(stitch->graphSeamFind, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
+				ERROR_CHECK_OBJECT_(stitch->sobely_image = vxCreateVirtualImage(stitch->graphSeamFind, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
+				ERROR_CHECK_OBJECT_(stitch->s16_image = vxCreateVirtualImage(stitch->graphSeamFind, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_S16));
 			}
-			ERROR_CHECK_OBJECT_(stitch->sobel_magnitude_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
-			ERROR_CHECK_OBJECT_(stitch->sobel_phase_image = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
+			ERROR_CHECK_OBJECT_(stitch->sobel_magnitude_image = vxCreateVirtualImage(stitch->graphSeamFind, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
+			ERROR_CHECK_OBJECT_(stitch->sobel_phase_image = vxCreateVirtualImage(stitch->graphSeamFind, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
 			ERROR_CHECK_OBJECT_(stitch->new_weight_image = vxCreateImage(stitch->context, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_U8));
 			//Smart Cut Weight Image
 			void *weight_image_ptr = nullptr; vx_rectangle_t weight_rect; vx_imagepatch_addressing_t weight_addr;
@@ -1093,39 +1512,56 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 				ERROR_CHECK_STATUS_(vxAddArrayItems(stitch->seamfind_scene_array, ((stitch->num_cameras * stitch->num_cameras) / 2), ARRAY_SeamFind_ptr, sizeof(StitchSeamFindSceneEntry)));
 				//SeamFind Step 1: Seam Refresh 
 				stitch->SeamfindStep1Node = stitchSeamFindSceneDetectNode(stitch->graphStitch, stitch->current_frame, stitch->scene_threshold,
-					stitch->u8_image, stitch->seamfind_info_array, stitch->seamfind_pref_array, stitch->seamfind_scene_array);
+					u8_warped, stitch->seamfind_info_array, stitch->seamfind_pref_array, stitch->seamfind_scene_array,
+					(vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_SEAM_SCENE_DURATION], (vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_SEAM_VIEW_SCENE_CHANGE]);
 				ERROR_CHECK_OBJECT_(stitch->SeamfindStep1Node);
 			}
 			//SeamFind Step 2 - Cost Generation: 0:OpenVX Sobel 1:Optimized Sobel
 			if (!stitch->SEAM_COST_SELECT){
-				ERROR_CHECK_OBJECT_(stitch->SobelNode = vxSobel3x3Node(stitch->graphStitch, stitch->u8_image, stitch->sobelx_image, stitch->sobely_image));
-				ERROR_CHECK_OBJECT_(stitch->MagnitudeNode = vxMagnitudeNode(stitch->graphStitch, stitch->sobelx_image, stitch->sobely_image, stitch->s16_image));
-				ERROR_CHECK_OBJECT_(stitch->PhaseNode = vxPhaseNode(stitch->graphStitch, stitch->sobelx_image, stitch->sobely_image, stitch->sobel_phase_image));
-				ERROR_CHECK_OBJECT_(stitch->ConvertDepthNode = vxConvertDepthNode(stitch->graphStitch, stitch->s16_image, stitch->sobel_magnitude_image, VX_CONVERT_POLICY_SATURATE, stitch->input_shift));
+				ERROR_CHECK_OBJECT_(stitch->SobelNode = vxSobel3x3Node(stitch->graphSeamFind, u8_warped, stitch->sobelx_image, stitch->sobely_image));
+				ERROR_CHECK_OBJECT_(stitch->MagnitudeNode = vxMagnitudeNode(stitch->graphSeamFind, stitch->sobelx_image, stitch->sobely_image, stitch->s16_image));
+				ERROR_CHECK_OBJECT_(stitch->PhaseNode = vxPhaseNode(stitch->graphSeamFind, stitch->sobelx_image, stitch->sobely_image, stitch->sobel_phase_image));
+				ERROR_CHECK_OBJECT_(stitch->ConvertDepthNode = vxConvertDepthNode(stitch->graphSeamFind, stitch->s16_image, stitch->sobel_magnitude_image, VX_CONVERT_POLICY_SATURATE, stitch->input_shift));
 			}
 			else{
 				vx_uint32 exe_flag = 1;
 				ERROR_CHECK_OBJECT_(stitch->flag = vxCreateScalar(stitch->context, VX_TYPE_UINT32, &exe_flag));
-				ERROR_CHECK_OBJECT_(stitch->SeamfindStep2Node = stitchSeamFindCostGenerateNode(stitch->graphStitch, stitch->flag, stitch->u8_image, stitch->sobel_magnitude_image, stitch->sobel_phase_image));
+				ERROR_CHECK_OBJECT_(stitch->SeamfindStep2Node = stitchSeamFindCostGenerateNode(stitch->graphSeamFind, stitch->flag, u8_warped, stitch->sobel_magnitude_image, stitch->sobel_phase_image,
+					stitch->seamfind_cost_tile_array));
 			}
 			//SeamFind Step 3 - Cost Accumulate
-			stitch->SeamfindStep3Node = stitchSeamFindCostAccumulateNode(stitch->graphStitch, stitch->current_frame, stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height,
+			stitch->SeamfindStep3Node = stitchSeamFindCostAccumulateNode(stitch->graphSeamFind, stitch->current_frame, stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height,
 				stitch->sobel_magnitude_image, stitch->sobel_phase_image, stitch->mask_image, stitch->seamfind_valid_array, stitch->seamfind_pref_array,
-				stitch->seamfind_info_array, stitch->seamfind_accum_array);
+				stitch->seamfind_info_array, stitch->seamfind_accum_array, stitch->seamfind_parent_array,
+				(vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_SEAM_CORRIDOR], (vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_SEAM_COARSE_SCALE]);
 			ERROR_CHECK_OBJECT_(stitch->SeamfindStep3Node);
 			//SeamFind Step 4 - Path Trace
-			stitch->SeamfindStep4Node = stitchSeamFindPathTraceNode(stitch->graphStitch, stitch->current_frame, stitch->weight_image, stitch->seamfind_info_array, 
-				stitch->seamfind_accum_array, stitch->seamfind_pref_array, stitch->seamfind_path_array);
+			stitch->SeamfindStep4Node = stitchSeamFindPathTraceNode(stitch->graphSeamFind, stitch->current_frame, stitch->weight_image, stitch->seamfind_info_array, 
+				stitch->seamfind_accum_array, stitch->seamfind_pref_array, stitch->seamfind_path_array, stitch->seamfind_parent_array);
 			ERROR_CHECK_OBJECT_(stitch->SeamfindStep4Node);
 			//SeamFind Step 5 - Set Weights
-			stitch->SeamfindStep5Node = stitchSeamFindSetWeightsNode(stitch->graphStitch, stitch->current_frame, stitch->num_cameras, stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height,
-				stitch->seamfind_weight_array, stitch->seamfind_path_array, stitch->seamfind_pref_array, stitch->new_weight_image);
+			stitch->SeamfindStep5Node = stitchSeamFindSetWeightsNode(stitch->graphSeamFind, stitch->current_frame, stitch->num_cameras, stitch->output_rgb_buffer_width, stitch->output_rgb_buffer_height,
+				stitch->seamfind_weight_array, stitch->seamfind_path_array, stitch->seamfind_pref_array, stitch->new_weight_image,
+				(vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_SEAM_VIEW_SCENE_CHANGE]);
 			ERROR_CHECK_OBJECT_(stitch->SeamfindStep5Node);
+			//SeamFind Analyze - flags the frames where a seam is due (after the seam refresh of the frame)
+			vx_uint32 seamfind_flag_value = 0;
+			ERROR_CHECK_OBJECT_(stitch->seamfind_flag = vxCreateScalar(stitch->context, VX_TYPE_UINT32, &seamfind_flag_value));
+			ERROR_CHECK_OBJECT_(stitch->SeamfindAnalyzeNode = stitchSeamFindAnalyzeNode(stitch->graphStitch, stitch->current_frame, stitch->seamfind_pref_array, stitch->seamfind_flag));
 		}
 		// create data objects and nodes for multiband blending
-		if (stitch->MULTIBAND_BLEND){
+		if (stitch->MULTIBAND_BLEND == 2){
+			// fused pyramid build, blend and reconstruct: the intermediate levels stay inside the node
+			ERROR_CHECK_OBJECT_(stitch->pStitchMultiband[0].DstPyrImgLaplacianRec = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_RGBX));
+			ERROR_CHECK_OBJECT_(stitch->MultibandFusedNode = stitchMultiBandFusedNode(stitch->graphStitch, stitch->num_cameras, stitch->pStitchMultiband[0].valid_array_offset, stitch->num_bands,
+				stitch->EXPO_COMP ? stitch->RGBY2 : rgby_warped, stitch->SEAM_FIND ? stitch->new_weight_image : stitch->weight_image, stitch->blend_offsets, stitch->pStitchMultiband[0].DstPyrImgLaplacianRec,
+				stitch->blend_interior_offset));
+			// update merge input
+			merge_input = stitch->pStitchMultiband[0].DstPyrImgLaplacianRec;
+		}
+		else if (stitch->MULTIBAND_BLEND){
 			stitch->pStitchMultiband[0].WeightPyrImgGaussian = stitch->SEAM_FIND ? stitch->new_weight_image : stitch->weight_image;	// for level0: weight image is mask image after seem find
-			stitch->pStitchMultiband[0].DstPyrImgGaussian = stitch->EXPO_COMP ? stitch->RGBY2 : stitch->RGBY1;			// for level0: dst image is image after exposure_comp
+			stitch->pStitchMultiband[0].DstPyrImgGaussian = stitch->EXPO_COMP ? stitch->RGBY2 : rgby_warped;			// for level0: dst image is image after exposure_comp
 			ERROR_CHECK_OBJECT_(stitch->pStitchMultiband[0].DstPyrImgLaplacian = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_RGB4_AMD));
 			ERROR_CHECK_OBJECT_(stitch->pStitchMultiband[0].DstPyrImgLaplacianRec = vxCreateVirtualImage(stitch->graphStitch, stitch->output_rgb_buffer_width, (stitch->output_rgb_buffer_height * stitch->num_cameras), VX_DF_IMAGE_RGBX));
 			//rgb_output;
@@ -1160,7 +1596,8 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 			}
 			// for the lowest level
 			stitch->pStitchMultiband[0].UpscaleAddNode = stitchMultiBandLaplacianReconstructNode(stitch->graphStitch, stitch->num_cameras, stitch->pStitchMultiband[0].valid_array_offset,
-				stitch->pStitchMultiband[0].DstPyrImgLaplacian, stitch->pStitchMultiband[1].DstPyrImgLaplacianRec, stitch->blend_offsets, stitch->pStitchMultiband[0].DstPyrImgLaplacianRec);
+				stitch->pStitchMultiband[0].DstPyrImgLaplacian, stitch->pStitchMultiband[1].DstPyrImgLaplacianRec, stitch->blend_offsets, stitch->pStitchMultiband[0].DstPyrImgLaplacianRec,
+				stitch->pStitchMultiband[0].DstPyrImgGaussian, stitch->blend_interior_offset);
 			ERROR_CHECK_OBJECT_(stitch->pStitchMultiband[0].UpscaleAddNode);
 			// update merge input
 			merge_input = stitch->pStitchMultiband[0].DstPyrImgLaplacianRec;
@@ -1192,17 +1629,24 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 			}
 		}
 		ERROR_CHECK_OBJECT_(stitch->MergeNode);
-		// verify the graph
+		// verify the graphs
+		if (stitch->graphStitchInput) {
+			ERROR_CHECK_STATUS_(vxVerifyGraph(stitch->graphStitchInput));
+		}
 		ERROR_CHECK_STATUS_(vxVerifyGraph(stitch->graphStitch));
+		if (stitch->graphSeamFind) {
+			ERROR_CHECK_STATUS_(vxVerifyGraph(stitch->graphSeamFind));
+		}
 		
 		stitch->SEAM_FIND_TARGET = 0;
 		if (StitchGetEnvironmentVariable("SEAM_FIND_TARGET", textBuffer, sizeof(textBuffer))) { stitch->SEAM_FIND_TARGET = atoi(textBuffer); }
 		// copy RGBY1 data from CPU to GPU because graphStitch expects the data initialized on GPU
-		ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->RGBY1, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
+		ERROR_CHECK_STATUS_(UploadWarpImages(stitch));
 		if (stitch->SEAM_FIND)
 		{
 			ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->new_weight_image, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
 			ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->seamfind_accum_array, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));	
+			ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->seamfind_parent_array, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
 			if (stitch->SEAM_REFRESH)
 			{
 				ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->seamfind_pref_array, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
@@ -1239,7 +1683,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsInitialize(ls_context stitch)
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsReinitialize(ls_context stitch)
 {
 	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
-	if (stitch->scheduled) {
+	if (stitch->scheduled || IsFrameAsyncPending(stitch)) {
 		ls_printf("ERROR: lsReinitialize: can't reinitialize when already scheduled\n");
 		return VX_ERROR_GRAPH_SCHEDULED;
 	}
@@ -1248,13 +1692,27 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsReinitialize(ls_context stitch)
 		return VX_ERROR_NOT_SUPPORTED;
 	}
 
+	// update rig and camera param objects with the latest parameters
+	if (stitch->rig_params_updated) {
+		ERROR_CHECK_STATUS_(vxCopyMatrix(stitch->rig_par_mat, &stitch->rig_par, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST));
+	}
+	if (stitch->camera_params_updated) {
+		ERROR_CHECK_STATUS_(vxCopyMatrix(stitch->cam_par_mat, stitch->camera_par, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST));
+		ERROR_CHECK_STATUS_(vxTruncateArray(stitch->cam_par_array, 0));
+		ERROR_CHECK_STATUS_(vxAddArrayItems(stitch->cam_par_array, stitch->num_cameras, stitch->camera_par, sizeof(camera_params)));
+	}
+	if (stitch->overlay_params_updated && stitch->ovr_par_array) {
+		ERROR_CHECK_STATUS_(vxTruncateArray(stitch->ovr_par_array, 0));
+		ERROR_CHECK_STATUS_(vxAddArrayItems(stitch->ovr_par_array, stitch->num_overlays, stitch->overlay_par, sizeof(camera_params)));
+	}
+
 	if (stitch->rig_params_updated || stitch->camera_params_updated) {
-		// execute graphInitializeStitch to re-initialize tables
+		// execute graphInitializeStitch to re-initialize tables: the initialize_stitch_config node
+		// recomputes the warp tables only for the cameras whose parameters changed
+		// since its previous execution and uploads only the entries of those cameras
 		ERROR_CHECK_STATUS_(vxProcessGraph(stitch->graphInitializeStitch));
-		if (stitch->RGBY1) {
-			// copy RGBY1 data from CPU to GPU because graphStitch expects the data initialized on GPU
-			ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->RGBY1, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
-		}
+		// copy RGBY1 data from CPU to GPU because graphStitch expects the data initialized on GPU
+		ERROR_CHECK_STATUS_(UploadWarpImages(stitch));
 	}
 	if (stitch->overlay_params_updated) {
 		// execute graphOverlay to re-initialize tables
@@ -1279,11 +1737,22 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 	else {
 		ls_context stitch = *pStitch;
 		ERROR_CHECK_STATUS_(IsValidContext(stitch));
+		// stop the lsScheduleFrameAsync thread after the frames in flight are done
+		if (stitch->frameScheduler) {
+			{
+				std::lock_guard<std::mutex> lock(stitch->frameScheduler->mutex);
+				stitch->frameScheduler->exit = true;
+			}
+			stitch->frameScheduler->cond.notify_all();
+			stitch->frameScheduler->thread.join();
+			delete stitch->frameScheduler;
+			stitch->frameScheduler = nullptr;
+		}
 		// graph profile dump if requested
 		if (stitch->live_stitch_attr[LIVE_STITCH_ATTR_PROFILER]) {
-			const char * name[3] = { "graphInitializeStitch", "graphOverlay", "graphStitch" };
-			vx_graph graph[3] = { stitch->graphInitializeStitch, stitch->graphOverlay, stitch->graphStitch };
-			for (int i = 0; i < 3; i++) {
+			const char * name[5] = { "graphInitializeStitch", "graphOverlay", "graphStitchInput", "graphStitch", "graphSeamFind" };
+			vx_graph graph[5] = { stitch->graphInitializeStitch, stitch->graphOverlay, stitch->graphStitchInput, stitch->graphStitch, stitch->graphSeamFind };
+			for (int i = 0; i < 5; i++) {
 				if (graph[i]) {
 					ls_printf("> graph profile: %s\n", name[i]); char fileName[] = "stdout";
 					ERROR_CHECK_STATUS_(vxQueryGraph(graph[i], VX_GRAPH_ATTRIBUTE_AMD_PERFORMANCE_INTERNAL_PROFILE, fileName, 0));
@@ -1317,6 +1786,10 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 		if (stitch->OutputColorConvertNode) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->OutputColorConvertNode));
 
 		//Stitch Mode 2 Release
+		//Delay: the objects in the delays of graphStitchInput are released with the delay
+		if (stitch->RGBY1_delay) { stitch->RGBY1 = nullptr; ERROR_CHECK_STATUS_(vxReleaseDelay(&stitch->RGBY1_delay)); }
+		if (stitch->u8_image_delay) { stitch->u8_image = nullptr; ERROR_CHECK_STATUS_(vxReleaseDelay(&stitch->u8_image_delay)); }
+		if (stitch->loomioCameraAuxDelay) { stitch->loomioCameraAuxData = nullptr; ERROR_CHECK_STATUS_(vxReleaseDelay(&stitch->loomioCameraAuxDelay)); }
 		//Image
 		if (stitch->RGBY1) ERROR_CHECK_STATUS_(vxReleaseImage(&stitch->RGBY1));
 		if (stitch->RGBY2) ERROR_CHECK_STATUS_(vxReleaseImage(&stitch->RGBY2));
@@ -1334,6 +1807,8 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 		if (stitch->OverlapPixelEntry) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->OverlapPixelEntry));
 		if (stitch->valid_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->valid_array));
 		if (stitch->gain_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->gain_array));
+		if (stitch->block_stats_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->block_stats_array));
+		if (stitch->block_gain_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->block_gain_array));
 		//Node
 		if (stitch->WarpNode) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->WarpNode));
 		if (stitch->ExpcompComputeGainNode) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->ExpcompComputeGainNode));
@@ -1356,6 +1831,8 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 		if (stitch->seamfind_valid_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_valid_array));
 		if (stitch->seamfind_weight_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_weight_array));
 		if (stitch->seamfind_accum_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_accum_array));
+		if (stitch->seamfind_parent_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_parent_array));
+		if (stitch->seamfind_cost_tile_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_cost_tile_array));
 		if (stitch->seamfind_pref_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_pref_array));	
 		if (stitch->seamfind_path_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_path_array));
 		if (stitch->seamfind_scene_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->seamfind_scene_array));
@@ -1369,11 +1846,13 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 		if (stitch->SeamfindStep3Node) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->SeamfindStep3Node));
 		if (stitch->SeamfindStep4Node) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->SeamfindStep4Node));
 		if (stitch->SeamfindStep5Node) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->SeamfindStep5Node));
+		if (stitch->SeamfindAnalyzeNode) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->SeamfindAnalyzeNode));
 		//Scalar
 		if (stitch->input_shift) ERROR_CHECK_STATUS_(vxReleaseScalar(&stitch->input_shift));
 		if (stitch->current_frame) ERROR_CHECK_STATUS_(vxReleaseScalar(&stitch->current_frame));
 		if (stitch->scene_threshold) ERROR_CHECK_STATUS_(vxReleaseScalar(&stitch->scene_threshold));
 		if (stitch->flag) ERROR_CHECK_STATUS_(vxReleaseScalar(&stitch->flag));
+		if (stitch->seamfind_flag) ERROR_CHECK_STATUS_(vxReleaseScalar(&stitch->seamfind_flag));
 
 		//Stitch MultiBand
 		//Image
@@ -1382,6 +1861,7 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 		if (stitch->band_weights_array) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->band_weights_array));
 		if (stitch->blend_offsets) ERROR_CHECK_STATUS_(vxReleaseArray(&stitch->blend_offsets));
 		//Node
+		if (stitch->MultibandFusedNode) ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->MultibandFusedNode));
 		if (stitch->MULTIBAND_BLEND && stitch->pStitchMultiband){
 			for (int i = 0; i < stitch->num_bands; i++){
 				if (stitch->pStitchMultiband[i].BlendNode)ERROR_CHECK_STATUS_(vxReleaseNode(&stitch->pStitchMultiband[i].BlendNode));
@@ -1413,6 +1893,8 @@ SHARED_PUBLIC vx_status VX_API_CALL lsReleaseContext(ls_context * pStitch)
 
 		//Graph & Context
 		if (stitch->graphStitch) ERROR_CHECK_STATUS_(vxReleaseGraph(&stitch->graphStitch));
+		if (stitch->graphStitchInput) ERROR_CHECK_STATUS_(vxReleaseGraph(&stitch->graphStitchInput));
+		if (stitch->graphSeamFind) ERROR_CHECK_STATUS_(vxReleaseGraph(&stitch->graphSeamFind));
 		if (stitch->graphInitializeStitch) ERROR_CHECK_STATUS_(vxReleaseGraph(&stitch->graphInitializeStitch));
 		if (stitch->graphOverlay) ERROR_CHECK_STATUS_(vxReleaseGraph(&stitch->graphOverlay));
 		if (stitch->context) ERROR_CHECK_STATUS_(vxReleaseContext(&stitch->context));
@@ -1444,8 +1926,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetCameraBuffer(ls_context stitch,
 	if (stitch->nodeLoomIoCamera) return VX_ERROR_NOT_ALLOCATED;
 
 	// switch the user specified OpenCL buffer into image
-	void * ptr_in[] = { input_buffer ? input_buffer[0] : nullptr };
-	ERROR_CHECK_STATUS_(vxSwapImageHandle(stitch->Img_input, ptr_in, nullptr, 1));
+	ERROR_CHECK_STATUS_(SwapImageHandle(stitch, stitch->Img_input, input_buffer ? input_buffer[0] : nullptr));
 
 	return VX_SUCCESS;
 }
@@ -1456,8 +1937,7 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetOutputBuffer(ls_context stitch,
 	if (stitch->nodeLoomIoOutput) return VX_ERROR_NOT_ALLOCATED;
 
 	// switch the user specified OpenCL buffer into image
-	void * ptr_out[] = { output_buffer ? output_buffer [0] : nullptr };
-	ERROR_CHECK_STATUS_(vxSwapImageHandle(stitch->Img_output, ptr_out, nullptr, 1));
+	ERROR_CHECK_STATUS_(SwapImageHandle(stitch, stitch->Img_output, output_buffer ? output_buffer[0] : nullptr));
 
 	return VX_SUCCESS;
 }
@@ -1468,27 +1948,36 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetOverlayBuffer(ls_context stitch
 	if (stitch->nodeLoomIoOverlay) return VX_ERROR_NOT_ALLOCATED;
 
 	// switch the user specified OpenCL buffer into image
-	void * ptr_overlay[] = { overlay_buffer ? overlay_buffer[0] : nullptr };
-	ERROR_CHECK_STATUS_(vxSwapImageHandle(stitch->Img_overlay, ptr_overlay, nullptr, 1));
+	ERROR_CHECK_STATUS_(SwapImageHandle(stitch, stitch->Img_overlay, overlay_buffer ? overlay_buffer[0] : nullptr));
 
 	return VX_SUCCESS;
 }
 
-//! \brief Schedule next frame
-LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrame(ls_context stitch)
+//! \brief Function to pass the outputs of graphStitchInput to graphStitch: slot 0 written by graphStitchInput becomes slot -1.
+//  Before the call, slot -1 still holds the frame last merged by graphStitch, which graphSeamFind uses.
+static vx_status AgeStitchInput(ls_context stitch)
 {
-	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
-	if (stitch->scheduled) {
-		ls_printf("ERROR: lsScheduleFrame: already scheduled\n");
-		return VX_ERROR_GRAPH_SCHEDULED;
-	}
-	if (stitch->reinitialize_required) {
-		ls_printf("ERROR: lsScheduleFrame: reinitialize required\n");
-		return VX_FAILURE;
+	vx_delay delay[] = { stitch->RGBY1_delay, stitch->u8_image_delay, stitch->loomioCameraAuxDelay };
+	for (size_t i = 0; i < dimof(delay); i++) {
+		if (delay[i]) ERROR_CHECK_STATUS_(vxAgeDelay(delay[i]));
 	}
+	return VX_SUCCESS;
+}
 
+//! \brief Function to update the per-frame data objects before the graph execution.
+static vx_status PrepareFrame(ls_context stitch)
+{
 	// seamfind needs frame counter values to be incremented
 	if (stitch->SEAM_FIND) {
+		// process graphSeamFind when the previous frame has a seam due: it still sees the frame counter and
+		// the warped luma of the previous frame, and its weights are used from this frame onwards
+		vx_uint32 seamfind_flag = 0;
+		ERROR_CHECK_STATUS_(vxReadScalarValue(stitch->seamfind_flag, &seamfind_flag));
+		if (seamfind_flag) {
+			ERROR_CHECK_STATUS_(vxProcessGraph(stitch->graphSeamFind));
+			seamfind_flag = 0;
+			ERROR_CHECK_STATUS_(vxWriteScalarValue(stitch->seamfind_flag, &seamfind_flag));
+		}
 		ERROR_CHECK_STATUS_(vxWriteScalarValue(stitch->current_frame, &stitch->current_frame_value));
 		stitch->current_frame_value++;
 	}
@@ -1499,29 +1988,16 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrame(ls_context stitch)
 		ERROR_CHECK_STATUS_(vxDirective((vx_reference)stitch->A_matrix, VX_DIRECTIVE_AMD_COPY_TO_OPENCL));
 	}
 
-	// start the graph schedule
-	ERROR_CHECK_STATUS_(vxScheduleGraph(stitch->graphStitch));
-	stitch->scheduled = true;
-
 	return VX_SUCCESS;
 }
 
-//! \brief Schedule next frame
-LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForCompletion(ls_context stitch)
+//! \brief Function to process the data objects after the graph execution.
+static vx_status CompleteFrame(ls_context stitch)
 {
-	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
-	if (!stitch->scheduled) {
-		ls_printf("ERROR: lsWaitForCompletion: not scheduled\n");
-		return VX_ERROR_GRAPH_SCHEDULED;
-	}
-
-	// wait for graph completion
-	ERROR_CHECK_STATUS_(vxWaitGraph(stitch->graphStitch));
-	stitch->scheduled = false;
-
 	// debug: dump auxiliary data
 	if (stitch->loomioAuxDumpFile) {
-		vx_array auxList[] = { stitch->loomioCameraAuxData, stitch->loomioOverlayAuxData, stitch->loomioOutputAuxData, stitch->loomioViewingAuxData };
+		vx_array cameraAuxData = stitch->loomioCameraAuxDelay ? (vx_array)vxGetReferenceFromDelay(stitch->loomioCameraAuxDelay, -1) : stitch->loomioCameraAuxData;
+		vx_array auxList[] = { cameraAuxData, stitch->loomioOverlayAuxData, stitch->loomioOutputAuxData, stitch->loomioViewingAuxData };
 		for (size_t i = 0; i < sizeof(auxList) / sizeof(auxList[0]); i++) {
 			if (auxList[i]) {
 				vx_size numItems = 0;
@@ -1542,6 +2018,223 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForCompletion(ls_context stitc
 	return VX_SUCCESS;
 }
 
+//! \brief Function to prepare the merge of a frame on graphStitch after its input processing in graphStitchInput, if any.
+static vx_status PrepareFrameMerge(ls_context stitch)
+{
+	ERROR_CHECK_STATUS_(PrepareFrame(stitch));
+	if (stitch->graphStitchInput) {
+		ERROR_CHECK_STATUS_(AgeStitchInput(stitch));
+	}
+	return VX_SUCCESS;
+}
+
+//! \brief Function to process the frames scheduled with lsScheduleFrameAsync.
+// With graphStitchInput, the input conversion and warp of input_frame run while graphStitch merges output_frame,
+// the frame whose input was processed in the previous call. Without it, both are the same frame processed by graphStitch.
+// The graph_mutex keeps lsSet*Buffer from swapping an image handle while the graphs run.
+static void ProcessFrameAsync(ls_context stitch, ls_frame_request * input_frame, ls_frame_request * output_frame)
+{
+	std::lock_guard<std::mutex> lock(stitch->frameScheduler->graph_mutex);
+	if (input_frame && input_frame->input_buffer) {
+		void * ptr_in[] = { input_frame->input_buffer };
+		input_frame->status = vxSwapImageHandle(stitch->Img_input, ptr_in, nullptr, 1);
+	}
+	if (output_frame && output_frame->output_buffer && output_frame->status == VX_SUCCESS) {
+		void * ptr_out[] = { output_frame->output_buffer };
+		output_frame->status = vxSwapImageHandle(stitch->Img_output, ptr_out, nullptr, 1);
+	}
+	if (!stitch->graphStitchInput) {
+		if (output_frame->status == VX_SUCCESS) output_frame->status = PrepareFrame(stitch);
+		if (output_frame->status == VX_SUCCESS) output_frame->status = vxProcessGraph(stitch->graphStitch);
+		if (output_frame->status == VX_SUCCESS) output_frame->status = CompleteFrame(stitch);
+		return;
+	}
+	// a frame whose input processing failed is not merged, so its slot is reused by input_frame
+	if (output_frame && output_frame->status == VX_SUCCESS) output_frame->status = PrepareFrameMerge(stitch);
+	bool input_scheduled = false;
+	if (input_frame && input_frame->status == VX_SUCCESS) {
+		input_frame->status = vxScheduleGraph(stitch->graphStitchInput);
+		input_scheduled = (input_frame->status == VX_SUCCESS);
+	}
+	if (output_frame && output_frame->status == VX_SUCCESS) output_frame->status = vxProcessGraph(stitch->graphStitch);
+	if (output_frame && output_frame->status == VX_SUCCESS) output_frame->status = CompleteFrame(stitch);
+	if (input_scheduled) input_frame->status = vxWaitGraph(stitch->graphStitchInput);
+}
+
+//! \brief The scheduler thread for lsScheduleFrameAsync: processes the frames in the order scheduled.
+static void FrameSchedulerThread(ls_context stitch)
+{
+	ls_frame_scheduler * scheduler = stitch->frameScheduler;
+	// with graphStitchInput, the frame at the front of the queue is pending from its input processing until its merge
+	bool pending = false;
+	ls_frame_request pending_frame;
+	for (;;) {
+		ls_frame_request frame;
+		bool next = false;
+		{
+			std::unique_lock<std::mutex> lock(scheduler->mutex);
+			// a pending frame is merged without waiting for the next frame: the application may be waiting for it
+			if (!pending) scheduler->cond.wait(lock, [scheduler] { return scheduler->exit || !scheduler->queue.empty(); });
+			size_t index = pending ? 1 : 0;
+			if (scheduler->queue.size() > index) {
+				frame = scheduler->queue[index];
+				next = true;
+			}
+			else if (!pending) break;
+		}
+		ls_frame_request * input_frame = next ? &frame : nullptr;
+		ls_frame_request * output_frame = pending ? &pending_frame : (stitch->graphStitchInput ? nullptr : input_frame);
+		ProcessFrameAsync(stitch, input_frame, output_frame);
+		if (output_frame) {
+			{
+				std::lock_guard<std::mutex> lock(scheduler->mutex);
+				scheduler->status[output_frame->token % LS_FRAME_STATUS_HISTORY] = output_frame->status;
+				scheduler->queue.pop_front();
+				scheduler->completed_count++;
+			}
+			scheduler->cond.notify_all();
+			// the callback runs on this thread: lsScheduleFrameAsync with a full queue and lsWaitForFrame on a
+			// frame not yet completed return VX_ERROR_GRAPH_SCHEDULED when called from it instead of blocking
+			if (output_frame->callback) {
+				output_frame->callback(stitch, output_frame->token, output_frame->status, output_frame->user_data);
+			}
+		}
+		pending = stitch->graphStitchInput && next;
+		if (pending) pending_frame = frame;
+	}
+}
+
+//! \brief Schedule next frame
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrame(ls_context stitch)
+{
+	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
+	if (stitch->scheduled || IsFrameAsyncPending(stitch)) {
+		ls_printf("ERROR: lsScheduleFrame: already scheduled\n");
+		return VX_ERROR_GRAPH_SCHEDULED;
+	}
+	if (stitch->reinitialize_required) {
+		ls_printf("ERROR: lsScheduleFrame: reinitialize required\n");
+		return VX_FAILURE;
+	}
+
+	// without frames in flight, the input processing of the frame is done before its merge is scheduled
+	if (stitch->graphStitchInput) {
+		ERROR_CHECK_STATUS_(vxProcessGraph(stitch->graphStitchInput));
+		ERROR_CHECK_STATUS_(PrepareFrameMerge(stitch));
+	}
+	else {
+		ERROR_CHECK_STATUS_(PrepareFrame(stitch));
+	}
+
+	// start the graph schedule
+	ERROR_CHECK_STATUS_(vxScheduleGraph(stitch->graphStitch));
+	stitch->scheduled = true;
+
+	return VX_SUCCESS;
+}
+
+//! \brief Schedule next frame
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForCompletion(ls_context stitch)
+{
+	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
+	if (!stitch->scheduled) {
+		ls_printf("ERROR: lsWaitForCompletion: not scheduled\n");
+		return VX_ERROR_GRAPH_SCHEDULED;
+	}
+
+	// wait for graph completion
+	ERROR_CHECK_STATUS_(vxWaitGraph(stitch->graphStitch));
+	stitch->scheduled = false;
+
+	ERROR_CHECK_STATUS_(CompleteFrame(stitch));
+
+	return VX_SUCCESS;
+}
+
+//! \brief Schedule next frame without waiting for the previous frames to complete
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrameAsync(ls_context stitch, cl_mem input_buffer, cl_mem output_buffer, stitch_frame_callback_f callback, void * user_data, vx_uint32 * frame_token)
+{
+	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
+	if (stitch->scheduled) {
+		ls_printf("ERROR: lsScheduleFrameAsync: already scheduled with lsScheduleFrame\n");
+		return VX_ERROR_GRAPH_SCHEDULED;
+	}
+	if (stitch->reinitialize_required) {
+		ls_printf("ERROR: lsScheduleFrameAsync: reinitialize required\n");
+		return VX_FAILURE;
+	}
+	if ((input_buffer && stitch->nodeLoomIoCamera) || (output_buffer && stitch->nodeLoomIoOutput)) {
+		ls_printf("ERROR: lsScheduleFrameAsync: buffers can't be specified when LoomIO is active\n");
+		return VX_ERROR_NOT_ALLOCATED;
+	}
+
+	// create the scheduler thread on first use
+	if (!stitch->frameScheduler) {
+		vx_uint32 max_frames_in_flight = (vx_uint32)stitch->live_stitch_attr[LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT];
+		if (max_frames_in_flight < 1 || max_frames_in_flight > 16) {
+			ls_printf("ERROR: lsScheduleFrameAsync: invalid LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT attribute value: %d\n", max_frames_in_flight);
+			return VX_ERROR_INVALID_PARAMETERS;
+		}
+		ERROR_CHECK_ALLOC_(stitch->frameScheduler = new ls_frame_scheduler());
+		stitch->frameScheduler->max_frames_in_flight = max_frames_in_flight;
+		stitch->frameScheduler->next_token = 0;
+		stitch->frameScheduler->completed_count = 0;
+		for (vx_uint32 i = 0; i < LS_FRAME_STATUS_HISTORY; i++)
+			stitch->frameScheduler->status[i] = VX_SUCCESS;
+		stitch->frameScheduler->exit = false;
+		stitch->frameScheduler->thread = std::thread(FrameSchedulerThread, stitch);
+	}
+
+	// wait for a free slot and queue the frame
+	ls_frame_scheduler * scheduler = stitch->frameScheduler;
+	ls_frame_request frame = { 0, input_buffer, output_buffer, callback, user_data, VX_SUCCESS };
+	{
+		std::unique_lock<std::mutex> lock(scheduler->mutex);
+		if (scheduler->queue.size() >= scheduler->max_frames_in_flight && std::this_thread::get_id() == scheduler->thread.get_id()) {
+			// called from a frame callback: the scheduler thread can't free a slot while it waits here
+			ls_printf("ERROR: lsScheduleFrameAsync: no free slot for a frame scheduled from a frame callback\n");
+			return VX_ERROR_GRAPH_SCHEDULED;
+		}
+		scheduler->cond.wait(lock, [scheduler] { return scheduler->queue.size() < scheduler->max_frames_in_flight; });
+		frame.token = scheduler->next_token++;
+		scheduler->queue.push_back(frame);
+	}
+	scheduler->cond.notify_all();
+	if (frame_token) *frame_token = frame.token;
+
+	return VX_SUCCESS;
+}
+
+//! \brief Wait for completion of a frame scheduled with lsScheduleFrameAsync
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForFrame(ls_context stitch, vx_uint32 frame_token)
+{
+	ERROR_CHECK_STATUS_(IsValidContextAndInitialized(stitch));
+	ls_frame_scheduler * scheduler = stitch->frameScheduler;
+	if (!scheduler) {
+		ls_printf("ERROR: lsWaitForFrame: frame %d not scheduled\n", frame_token);
+		return VX_ERROR_INVALID_PARAMETERS;
+	}
+	std::unique_lock<std::mutex> lock(scheduler->mutex);
+	if (frame_token >= scheduler->next_token) {
+		ls_printf("ERROR: lsWaitForFrame: frame %d not scheduled\n", frame_token);
+		return VX_ERROR_INVALID_PARAMETERS;
+	}
+
+	// frames complete in order, so the frame is done when completed_count goes past its token
+	if (scheduler->completed_count <= frame_token && std::this_thread::get_id() == scheduler->thread.get_id()) {
+		// called from a frame callback: the scheduler thread can't complete the frame while it waits here
+		ls_printf("ERROR: lsWaitForFrame: frame %d can't be waited for from a frame callback\n", frame_token);
+		return VX_ERROR_GRAPH_SCHEDULED;
+	}
+	scheduler->cond.wait(lock, [scheduler, frame_token] { return scheduler->completed_count > frame_token; });
+	if (scheduler->completed_count - frame_token > LS_FRAME_STATUS_HISTORY) {
+		ls_printf("ERROR: lsWaitForFrame: status of frame %d is no longer available\n", frame_token);
+		return VX_ERROR_INVALID_PARAMETERS;
+	}
+
+	return scheduler->status[frame_token % LS_FRAME_STATUS_HISTORY];
+}
+
 //! \brief query functions.
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsGetOpenVXContext(ls_context stitch, vx_context  * openvx_context)
 {
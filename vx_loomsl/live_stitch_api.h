@@ -33,11 +33,11 @@ THE SOFTWARE.
 //! \brief The attributes
 enum {
 	LIVE_STITCH_ATTR_PROFILER               =    0,   // profiler attribute: 0:OFF 1:ON
-	LIVE_STITCH_ATTR_EXPCOMP                =    1,   // exp-comp attribute: 0:OFF 1:ON
+	LIVE_STITCH_ATTR_EXPCOMP                =    1,   // exp-comp attribute: 0:OFF 1:ON 2:ON with block gains
 	LIVE_STITCH_ATTR_SEAMFIND               =    2,   // seamfind attribute: 0:OFF 1:ON
 	LIVE_STITCH_ATTR_SEAM_REFRESH           =    3,   // seamfind seam refresh attribute: 0:OFF 1:ON
 	LIVE_STITCH_ATTR_SEAM_COST_SELECT       =    4,   // seamfind cost generate attribute: 0:OpenVX Sobel Mag/Phase 1:Optimized Sobel Mag/Phase
-	LIVE_STITCH_ATTR_MULTIBAND              =    5,   // multiband attribute: 0:OFF 1:ON
+	LIVE_STITCH_ATTR_MULTIBAND              =    5,   // multiband attribute: 0:OFF 1:ON 2:ON with fused pyramid node (CPU)
 	LIVE_STITCH_ATTR_MULTIBAND_NUMBANDS     =    6,   // multiband attribute: numbands 2-6
 	LIVE_STITCH_ATTR_STITCH_MODE            =    7,   // stitch mode: 0:normal 1:quick (default: normal)
 	LIVE_STITCH_ATTR_INPUT_SCALE_FACTOR     =    8,   // input scale factor: use 0.5 or 1.0 (default 1.0)
@@ -49,6 +49,12 @@ enum {
 	LIVE_STITCH_ATTR_CT_SEAM_FREQUENCY      =   14,   // Initialize Stitch Config attribute: 0 - N Frames. Frequency of seam calculation.
 	LIVE_STITCH_ATTR_CT_SEAM_QUALITY        =   15,   // Initialize Stitch Config attribute: 0 - N Flag.   0:Disable Edgeness 1:Enable Edgeness
 	LIVE_STITCH_ATTR_CT_SEAM_STAGGER        =   16,   // Initialize Stitch Config attribute: 0 - N Frames. Stagger the seam calculation by N frames
+	LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT   =   17,   // lsScheduleFrameAsync: maximum number of frames queued 1 - 16 (default 2), 2 or more overlaps the warp of a frame with the merge of the previous frame (normal mode, set before lsInitialize)
+	LIVE_STITCH_ATTR_MULTIBAND_INTERIOR     =   18,   // multiband attribute: 0:OFF 1:ON pyramid only near the overlaps, the other tiles are copied
+	LIVE_STITCH_ATTR_SEAM_SCENE_DURATION    =   19,   // seamfind seam refresh: number of frames the seam stays locked after a scene change (default 150)
+	LIVE_STITCH_ATTR_SEAM_VIEW_SCENE_CHANGE =   20,   // seamfind seam refresh: 0:OFF 1:mark scene changes dark 2:mark scene changes bright
+	LIVE_STITCH_ATTR_SEAM_CORRIDOR          =   21,   // seamfind seam refresh: 0:full search K:search +/-K pixels around the previous seam (CPU), full search on a scene change
+	LIVE_STITCH_ATTR_SEAM_COARSE_SCALE      =   22,   // seamfind: 0:full resolution N:seam on the cost downscaled by N (4 or 8) refined at full resolution (CPU)
 	LIVE_STITCH_ATTR_IO_AUX_DATA_CAPACITY   =   32,   // LoomIO: auxiliary data buffer size in bytes. Default 1024.
 	// Dynamic LoomSL attributes
 	LIVE_STITCH_ATTR_SEAM_THRESHOLD			=	51,    // seamfind seam refresh Threshold: 0 - 100 percentage change
@@ -109,6 +115,9 @@ typedef void(*stitch_log_callback_f)(const char * message);
 //! \brief The stitch context
 typedef struct ls_context_t * ls_context;
 
+//! \brief The frame completion callback function of lsScheduleFrameAsync
+typedef void(*stitch_frame_callback_f)(ls_context stitch, vx_uint32 frame_token, vx_status status, void * user_data);
+
 //! \brief The stitch API linkage
 #ifndef LIVE_STITCH_API_ENTRY
 #define LIVE_STITCH_API_ENTRY extern "C"
@@ -166,6 +175,24 @@ LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetOverlayBuffer(ls_context stitch
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrame(ls_context stitch);
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForCompletion(ls_context stitch);
 
+//! \brief Schedule a frame without waiting for the previous frames to complete
+//     input_buffer   - input opencl buffer for this frame (nullptr: use the current camera buffer)
+//     output_buffer  - output opencl buffer for this frame (nullptr: use the current output buffer)
+//     callback       - called from the scheduler thread when the frame is complete (optional)
+//     frame_token    - returns the token of the frame to be used with lsWaitForFrame (optional)
+//   Up to LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT frames can be queued: the call blocks until
+//   a frame completes when the limit is reached. Frames complete in the order scheduled.
+//   In normal stitch mode with LIVE_STITCH_ATTR_MAX_FRAMES_IN_FLIGHT of 2 or more at lsInitialize,
+//   the input color conversion and warp of the next queued frame run in a separate graph while
+//   the exposure comp, seam find, blend, merge and output conversion of a frame run, using a
+//   second set of warp output images. Otherwise the frames are stitched one at a time.
+//   The callback is called on the scheduler thread after the frame is removed from the queue:
+//   from the callback, lsScheduleFrameAsync with a full queue and lsWaitForFrame on a frame
+//   not yet completed return VX_ERROR_GRAPH_SCHEDULED instead of blocking.
+//   lsWaitForFrame returns the status of that frame, available for the last 64 completed frames.
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsScheduleFrameAsync(ls_context stitch, cl_mem input_buffer, cl_mem output_buffer, stitch_frame_callback_f callback, void * user_data, vx_uint32 * frame_token);
+LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsWaitForFrame(ls_context stitch, vx_uint32 frame_token);
+
 //! \brief access to context specific attributes.
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsSetAttributes(ls_context stitch, vx_uint32 attr_offset, vx_uint32 attr_count, const vx_float32 * attr_ptr);
 LIVE_STITCH_API_ENTRY vx_status VX_API_CALL lsGetAttributes(ls_context stitch, vx_uint32 attr_offset, vx_uint32 attr_count, vx_float32 * attr_ptr);